@@ -4,6 +4,7 @@ in vec4 fColor;
 in vec3 fNormal;
 in vec2 fTexCoord;
 in vec4 fPosition;
+flat in uint fRegion;
 
 out vec4 colorOut;
 
@@ -13,25 +14,34 @@ uniform vec3 uAmbientLight;
 uniform vec3 uEyePosition;
 uniform float uSpecularStrength;
 
-vec3 light(vec3 lightDir, vec3 lightColor, vec3 normal, vec3 eyePosition, vec3 fragPosition, float specularStrength) {
-    float diff = max(dot(normal, -lightDir), 0.0);
-    vec3 diffuse = diff * lightColor * 0.7;
+#include "lighting.glsl"
 
-    vec3 viewDir = normalize(eyePosition - fragPosition);
-    vec3 reflectDir = reflect(lightDir, -normal);
+#ifdef VIRTUAL_TEXTURE
+#include "virtual_texture.glsl"
 
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
-    vec3 specular = specularStrength * spec * lightColor;
+uniform sampler2D uVirtualTexture;
+#endif
 
-    return vec3(specular + diffuse);
-}
+#ifdef TEXTURE_ATLAS
+#include "texture_atlas.glsl"
+
+uniform sampler2DArray uAtlas;
+#endif
 
 void main() {
     vec3 normal = normalize(fNormal);
     vec3 sunDir = normalize(uSunDirection);
     vec3 sunlight = light(sunDir, uSunLight, normal, uEyePosition, fPosition.xyz, uSpecularStrength);
 
-    vec3 combined = (uAmbientLight + sunlight) * fColor.rgb;
+    vec3 albedo = fColor.rgb;
+#ifdef VIRTUAL_TEXTURE
+    albedo *= vtSample(uVirtualTexture, fTexCoord).rgb;
+#endif
+#ifdef TEXTURE_ATLAS
+    albedo *= texture(uAtlas, atlasCoord(fRegion, fTexCoord)).rgb;
+#endif
+
+    vec3 combined = (uAmbientLight + sunlight) * albedo;
 
     colorOut = vec4(combined, 1.0);
 }
\ No newline at end of file
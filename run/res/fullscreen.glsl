@@ -0,0 +1,11 @@
+#version 460 core
+
+// The vertex stage of post processing effects, one triangle covering the screen drawn with RenderGraph::PassContext::drawFullscreenTriangle()
+
+out vec2 fTexCoord;
+
+void main() {
+    vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    fTexCoord   = corner;
+    gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+}
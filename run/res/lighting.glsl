@@ -0,0 +1,16 @@
+vec3 light(vec3 lightDir, vec3 lightColor, vec3 normal, vec3 eyePosition, vec3 fragPosition, float specularStrength) {
+    float diff = max(dot(normal, -lightDir), 0.0);
+    vec3 diffuse = diff * lightColor * 0.7;
+
+#ifdef NO_SPECULAR
+    return diffuse;
+#else
+    vec3 viewDir = normalize(eyePosition - fragPosition);
+    vec3 reflectDir = reflect(lightDir, -normal);
+
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
+    vec3 specular = specularStrength * spec * lightColor;
+
+    return vec3(specular + diffuse);
+#endif
+}
@@ -0,0 +1,22 @@
+// Sampling images packed by a neuron::TextureAtlas, whose regions are bound with TextureAtlas::regionBuffer() and whose layers are one sampler2DArray.
+// Draws of different images can share the texture, so the region comes with the draw, e.g. from the material.
+
+struct AtlasRegion {
+    vec4 rect;  // offset, scale
+    uint layer;
+};
+
+layout(std430, binding = 8) readonly buffer AtlasRegions {
+    AtlasRegion atlasRegions[];
+};
+
+// for texture coordinates as the image had them, in [0, 1]
+vec3 atlasCoord(uint region, vec2 uv) {
+    AtlasRegion r = atlasRegions[region];
+    return vec3(r.rect.xy + clamp(uv, 0.0, 1.0) * r.rect.zw, float(r.layer));
+}
+
+// for meshes already rewritten by TextureAtlas::remap(), which only leaves the layer
+vec3 atlasCoordRemapped(uint region, vec2 uv) {
+    return vec3(uv, float(atlasRegions[region].layer));
+}
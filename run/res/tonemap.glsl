@@ -0,0 +1,15 @@
+#version 460 core
+
+// Exposure and Reinhard, the post processing of the window's camera layer. Drawn with res/fullscreen.glsl
+
+in vec2 fTexCoord;
+
+out vec4 colorOut;
+
+uniform sampler2D uSource;
+uniform float     uExposure;
+
+void main() {
+    vec3 color = texture(uSource, fTexCoord).rgb * uExposure;
+    colorOut   = vec4(color / (1.0 + color), 1.0);
+}
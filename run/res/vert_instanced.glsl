@@ -0,0 +1,40 @@
+#version 460 core
+
+layout(location = 0) in vec4 posIn;
+layout(location = 1) in vec4 colorIn;
+layout(location = 2) in vec4 normalIn;
+layout(location = 3) in vec2 texCoordIn;
+
+// redeclared since the program is also linked as a separable vertex stage
+out gl_PerVertex {
+    vec4 gl_Position;
+};
+
+out vec4 fColor;
+out vec3 fNormal;
+out vec2 fTexCoord;
+out vec4 fPosition;
+flat out uint fRegion;
+
+struct InstanceData {
+    mat4 model;
+    mat4 normal;
+    uint region;
+};
+
+layout(std430, binding = 0) readonly buffer Instances {
+    InstanceData instances[];
+};
+
+uniform mat4 uViewProjection;
+
+void main() {
+    InstanceData instance = instances[gl_BaseInstance + gl_InstanceID];
+
+    gl_Position = uViewProjection * instance.model * posIn;
+    fPosition = gl_Position;
+    fColor = colorIn;
+    fNormal = mat3(instance.normal) * normalIn.xyz;
+    fTexCoord = texCoordIn;
+    fRegion = instance.region;
+}
@@ -0,0 +1,52 @@
+// Sampling a neuron::render::VirtualTexture, bound with VirtualTexture::bind(). Fragment shaders only, it needs derivatives.
+// Every call also marks the page it wanted in the feedback bitmap, which is how the CPU finds out what to stream in.
+
+layout(std430, binding = 6) readonly buffer VtPageTable {
+    ivec4 vtInfo;       // width, height, page size, levels
+    ivec4 vtAtlas;      // slots per row, physical page size, border, sparse
+    ivec4 vtLevels[16]; // first page index, pages across, pages down
+    uint  vtEntries[];  // slot | resident level << 24, 0xFFFFFFFF while nothing covers the page
+};
+
+layout(std430, binding = 7) buffer VtFeedback {
+    uint vtFeedback[];
+};
+
+uint vtPageIndex(vec2 texel, int level) {
+    ivec2 page = min(ivec2(texel / float(vtInfo.z << level)), vtLevels[level].yz - 1);
+    return uint(vtLevels[level].x + page.y * vtLevels[level].y + page.x);
+}
+
+// one fragment in 16 is plenty to find every page on screen, and keeps the atomics down
+void vtRecord(vec2 texel, int level) {
+    if (((int(gl_FragCoord.x) | int(gl_FragCoord.y)) & 3) == 0) {
+        uint index = vtPageIndex(texel, level);
+        atomicOr(vtFeedback[index >> 5], 1u << (index & 31u));
+    }
+}
+
+vec4 vtSample(sampler2D physical, vec2 uv) {
+    vec2  texel = clamp(uv, 0.0, 0.99999) * vec2(vtInfo.xy);
+    vec2  dx    = dFdx(texel);
+    vec2  dy    = dFdy(texel);
+    float lod   = clamp(0.5 * log2(max(dot(dx, dx), dot(dy, dy))), 0.0, float(vtInfo.w - 1));
+    int   level = int(lod);
+    vtRecord(texel, level);
+
+    uint entry = vtEntries[vtPageIndex(texel, level)];
+    if (entry == 0xFFFFFFFFu) {
+        return vec4(0.5, 0.5, 0.5, 1.0); // not even the coarsest level is in yet
+    }
+
+    int resident = int(entry >> 24);
+    if (vtAtlas.w != 0) {
+        return textureLod(physical, uv, max(lod, float(resident)));
+    }
+
+    // the same point on the resident page, in that page's slot of the atlas
+    vec2 levelTexel = texel / float(1 << resident);
+    vec2 inPage     = levelTexel - floor(levelTexel / float(vtInfo.z)) * float(vtInfo.z);
+    uint slot       = entry & 0xFFFFFFu;
+    vec2 origin     = vec2(slot % uint(vtAtlas.x), slot / uint(vtAtlas.x)) * float(vtAtlas.y) + float(vtAtlas.z);
+    return textureLod(physical, (origin + inPage) / vec2(textureSize(physical, 0)), 0.0);
+}
@@ -1,8 +1,27 @@
 #include "neuron/glwrap.hpp"
 #include "neuron/mesh.hpp"
+#include "neuron/pipeline_cache.hpp"
+#include "neuron/program_cache.hpp"
+#include "neuron/shader_batch.hpp"
+#include "neuron/shader_preprocessor.hpp"
+#include "neuron/texture_atlas.hpp"
+#include "neuron/thread_pool.hpp"
+#include "neuron/render/camera_layers.hpp"
+#include "neuron/render/culling.hpp"
+#include "neuron/render/depth_pyramid.hpp"
+#include "neuron/render/instance_batcher.hpp"
+#include "neuron/render/render_graph.hpp"
+#include "neuron/render/software_occlusion.hpp"
+#include "neuron/render/virtual_texture.hpp"
 #include "neuron/window.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <future>
 #include <iostream>
+#include <ranges>
+#include <span>
+#include <unordered_map>
 
 #include <glad/gl.h>
 
@@ -15,10 +34,16 @@
 #include <imgui_impl_opengl3.h>
 
 #include "neuron/asset/asset.hpp"
+#include "neuron/asset/async_loader.hpp"
 #include "neuron/asset/framebuffer.hpp"
+#include "neuron/asset/hot_reload.hpp"
+#include "neuron/asset/import_cache.hpp"
 #include "neuron/asset/mesh.hpp"
 #include "neuron/asset/post_processing_pipeline.hpp"
+#include "neuron/asset/render_target.hpp"
+#include "neuron/asset/residency.hpp"
 #include "neuron/asset/shader.hpp"
+#include "neuron/asset/texture_streamer.hpp"
 
 using neuron::asset::assetTable;
 
@@ -43,23 +68,161 @@ struct Vertex {
     glm::vec2 uv;
 };
 
+// A page of a procedural checkerboard with its border, tinted by level and outlined so streaming is easy to watch. Runs on the thread pool
+neuron::Image virtualTexturePage(const neuron::render::VirtualPage &page, const int border, const int pageSize) {
+    static const glm::vec3 kLevelTints[] = {{1.0f, 1.0f, 1.0f}, {1.0f, 0.6f, 0.6f}, {0.6f, 1.0f, 0.6f}, {0.6f, 0.6f, 1.0f}, {1.0f, 1.0f, 0.6f}, {1.0f, 0.6f, 1.0f}};
+
+    const int     size = pageSize + 2 * border;
+    neuron::Image image{size, size, std::vector<uint8_t>(static_cast<std::size_t>(size) * size * 4)};
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            // in texels of the finest level, so neighbouring pages agree on their borders
+            const int       tx      = std::max(static_cast<int>(page.x) * pageSize + x - border, 0) << page.level;
+            const int       ty      = std::max(static_cast<int>(page.y) * pageSize + y - border, 0) << page.level;
+            const bool      outline = x == border || y == border;
+            const float     shade   = outline ? 0.2f : ((tx >> 10) + (ty >> 10)) % 2 == 0 ? 0.9f : 0.5f;
+            const glm::vec3 color   = shade * kLevelTints[page.level % std::size(kLevelTints)];
+
+            uint8_t *texel = &image.pixels[(static_cast<std::size_t>(y) * size + x) * 4];
+            texel[0]       = static_cast<uint8_t>(color.r * 255.0f);
+            texel[1]       = static_cast<uint8_t>(color.g * 255.0f);
+            texel[2]       = static_cast<uint8_t>(color.b * 255.0f);
+            texel[3]       = 255;
+        }
+    }
+    return image;
+}
+
 int main() {
-    char modelPath[260] = "res/test.glb";
+    char modelPath[260]   = "res/test.glb";
+    char texturePath[260] = "res/textures";
 
     glfw_lib_obj glfw;
 
     const auto window = std::make_shared<neuron::Window>("Wheeeeee!", glm::uvec2{800, 600});
 
-    neuron::asset::AssetHandle<neuron::asset::Shader> shader;
+    neuron::asset::AsyncLoader loader;
 
-    {
-        const auto vsh = neuron::ShaderModule::load("res/vert.glsl", neuron::ShaderModule::Type::Vertex);
-        const auto fsh = neuron::ShaderModule::load("res/frag.glsl", neuron::ShaderModule::Type::Fragment);
+    const auto logLoad = [](const std::string &what) {
+        return [what](const neuron::asset::LoadState state, const std::string &error) {
+            if (state == neuron::asset::LoadState::Failed) {
+                std::cerr << "Failed to load " << what << ": " << error << std::endl;
+            }
+        };
+    };
+
+    const neuron::asset::AsyncLoader::ShaderSources shaderSources{
+        {"res/vert_instanced.glsl", neuron::ShaderModule::Type::Vertex},
+        {"res/frag.glsl", neuron::ShaderModule::Type::Fragment},
+    };
+
+    auto mesh_handle = loader.loadMesh("res/test.glb", logLoad("res/test.glb"));
+    assetTable<neuron::asset::Mesh>()->setStableId(mesh_handle, neuron::asset::stableIdFromPath("res/test.glb"));
+
+    neuron::asset::ResidencyManager residency(loader);
+    residency.setBudget<neuron::asset::Mesh>({.gpuBytes = 512ULL * 1024 * 1024});
+    residency.manageMesh(mesh_handle, "res/test.glb");
+
+    neuron::FileWatcher        watcher;
+    neuron::asset::HotReloader hotReloader(loader, watcher);
+    hotReloader.watchMesh(mesh_handle, "res/test.glb", logLoad("res/test.glb"));
+
+    // The program's variants are separable stage programs put together in pipelines. The features only touch the fragment stage, so every variant shares one
+    // vertex program. Variants are made the first time they're drawn and kept (a failed one as an empty variant) until the shaders are reloaded
+    struct ShaderVariant {
+        std::shared_ptr<neuron::Shader> vertex;
+        std::shared_ptr<neuron::Shader> fragment;
+        const neuron::ProgramPipeline  *pipeline = nullptr;
+    };
+    constexpr uint32_t                          kNoSpecular      = 1 << 0;
+    constexpr uint32_t                          kVirtualTextured = 1 << 1;
+    constexpr uint32_t                          kTextureAtlas    = 1 << 2;
+    neuron::ProgramPipelineCache                pipelines;
+    std::unordered_map<uint32_t, ShaderVariant> shaderVariants;
+    const auto                                  shaderVariant = [&](const uint32_t features) -> const ShaderVariant & {
+        if (const auto it = shaderVariants.find(features); it != shaderVariants.end()) {
+            return it->second;
+        }
 
-        shader = assetTable<neuron::asset::Shader>()->initAsset(neuron::asset::Shader::create(std::vector{vsh, fsh}));
-    }
+        neuron::ShaderDefines defines;
+        if ((features & kNoSpecular) != 0) {
+            defines.emplace_back("NO_SPECULAR", "");
+        }
+        if ((features & kVirtualTextured) != 0) {
+            defines.emplace_back("VIRTUAL_TEXTURE", "");
+        }
+        if ((features & kTextureAtlas) != 0) {
+            defines.emplace_back("TEXTURE_ATLAS", "");
+        }
+
+        ShaderVariant variant;
+        try {
+            variant.vertex   = pipelines.stage(neuron::ShaderPreprocessor::global().process("res/vert_instanced.glsl").source, neuron::ShaderModule::Type::Vertex);
+            variant.fragment = pipelines.stage(neuron::ShaderPreprocessor::global().process("res/frag.glsl", defines).source, neuron::ShaderModule::Type::Fragment);
 
-    auto mesh_handle = assetTable<neuron::asset::Mesh>()->initAsset(neuron::asset::Mesh::load("res/test.glb"));
+            const neuron::PipelineStage stages[] = {{neuron::ShaderModule::Type::Vertex, variant.vertex}, {neuron::ShaderModule::Type::Fragment, variant.fragment}};
+            variant.pipeline                     = &pipelines.pipeline(stages);
+        } catch (const std::exception &e) {
+            std::cerr << "Failed to build shader variant " << features << ": " << e.what() << std::endl;
+            variant = {};
+        }
+        return shaderVariants.emplace(features, std::move(variant)).first->second;
+    };
+
+    // Uncompressed images go through the staging ring and arrive coarse to fine, compressed ones are uploaded whole and never touch the ring
+    neuron::asset::TextureStreamer                                  textureStreamer;
+    neuron::asset::TextureStreamer                                  compressedTextureStreamer({.stagingBytes = 1024 * 1024, .compression = neuron::BcFormat::BC7});
+    std::vector<neuron::asset::AssetHandle<neuron::asset::Texture>> streamedTextures;
+    bool                                                            compressStreamedTextures = true;
+
+    // The small images of the texture directory packed into one array texture, the way an import step would. Packing runs on the pool, the upload here.
+    // With the atlas turned on every copy of the model shows another image and they're still one draw, the image goes with the instance
+    constexpr unsigned int                             kAtlasUnit = 2;
+    std::future<std::unique_ptr<neuron::TextureAtlas>> atlasPacking;
+    std::unique_ptr<neuron::TextureAtlas>              atlas;
+    std::shared_ptr<neuron::Texture>                   atlasTexture;
+    std::unique_ptr<neuron::Buffer>                    atlasRegions;
+    bool                                               useTextureAtlas = false;
+
+    neuron::render::DepthPyramid    depthPyramid;
+    neuron::render::FrustumCuller   culler;
+    neuron::render::InstanceBatcher batcher;
+    bool                            occlusionCulling = true;
+    int                             modelGridSize    = 1;
+    std::vector<glm::mat4>          gridModels;
+
+    // culls against the nearest copies on the CPU until the depth pyramid has a readback
+    constexpr std::size_t                   kMaxSoftwareOccluders = 16;
+    neuron::render::SoftwareOcclusionBuffer softwareOcclusion(256, 128);
+    bool                                    softwareOcclusionUsed = false;
+
+    // a 64k x 64k checkerboard over the model's texture coordinates, made the first time it's turned on
+    constexpr unsigned int                          kVirtualTextureUnit = 1;
+    std::unique_ptr<neuron::render::VirtualTexture> virtualTexture;
+    bool                                            useVirtualTexture = false;
+
+    neuron::render::RenderTargetPool renderTargets;
+    neuron::render::RenderGraph      renderGraph(renderTargets);
+
+    // The camera's layers: the window through a tonemapping effect, and a small preview without any that the debug window shows when it's turned on
+    float                                 exposure          = 1.0f;
+    const auto                            cameraPreview     = neuron::Texture::createStorage2d(256, 192, neuron::Texture::InternalFormat::RGBA8, 1);
+    bool                                  showCameraPreview = false;
+    std::vector<neuron::ecs::CameraLayer> cameraLayers;
+    {
+        const std::vector<std::pair<std::string, neuron::ShaderModule::Type>> sources{
+            {neuron::ShaderPreprocessor::global().process("res/fullscreen.glsl").source, neuron::ShaderModule::Type::Vertex},
+            {neuron::ShaderPreprocessor::global().process("res/tonemap.glsl").source, neuron::ShaderModule::Type::Fragment},
+        };
+        const auto tonemap = assetTable<neuron::asset::Shader>()->initAsset(neuron::asset::Shader::fromSources(sources));
+
+        std::vector<neuron::asset::PostProcessingPipeline::Effect> effects;
+        effects.push_back({.name = "Tonemap", .shader = tonemap, .uniforms = [&exposure](const neuron::Shader &sh) { sh.uniform1f("uExposure", exposure); }});
+        const auto pipeline = assetTable<neuron::asset::PostProcessingPipeline>()->initAsset(std::make_unique<neuron::asset::PostProcessingPipeline>(std::move(effects)));
+
+        cameraLayers.push_back({assetTable<neuron::asset::RenderTarget>()->initAsset(std::make_unique<neuron::asset::RenderTarget>()), pipeline});
+        cameraLayers.push_back({assetTable<neuron::asset::RenderTarget>()->initAsset(std::make_unique<neuron::asset::RenderTarget>(cameraPreview)), {}});
+    }
 
     ImGui::CreateContext();
     ImGui_ImplGlfw_InitForOpenGL(window->handle(), true);
@@ -91,14 +254,72 @@ int main() {
 
     float zoom = 1.0f;
 
+    // Compiles `count` variants of the main program one at a time and then as one batch, bypassing the program cache.
+    // Every run uses new variants so the driver's own cache doesn't skew the second run
+    std::pair<double, double> compileBenchmark{};
+    uint32_t                  compileBenchmarkRun = 0;
+    const auto                benchmarkShaderCompiles = [&](const uint32_t count) {
+        std::vector<neuron::ShaderBatch::Sources> variants;
+        for (uint32_t i = 0; i < count; i++) {
+            neuron::ShaderBatch::Sources sources;
+            for (const auto &[path, type] : shaderSources) {
+                std::string source = neuron::ShaderPreprocessor::global().process(path).source;
+                source.insert(source.find('\n') + 1, "#define BENCHMARK_VARIANT " + std::to_string(compileBenchmarkRun * count + i) + "\n");
+                sources.emplace_back(std::move(source), type);
+            }
+            variants.push_back(std::move(sources));
+        }
+        compileBenchmarkRun++;
+
+        auto start = std::chrono::steady_clock::now();
+        for (const auto &sources : variants) {
+            std::vector<std::shared_ptr<neuron::ShaderModule>> modules;
+            for (const auto &[source, type] : sources) {
+                modules.push_back(std::make_shared<neuron::ShaderModule>(source, type));
+            }
+            const neuron::Shader program(modules);
+        }
+        const double serialMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        // the variants differ from the first half, so this compiles everything again
+        for (auto &sources : variants) {
+            for (auto &source : sources | std::views::keys) {
+                source.insert(source.find('\n') + 1, "#define BENCHMARK_BATCHED\n");
+            }
+        }
+
+        neuron::ShaderBatch batch(nullptr);
+        for (auto &sources : variants) {
+            batch.add(std::move(sources));
+        }
+        batch.submit();
+        batch.wait();
+        return std::pair(serialMs, batch.elapsedMs());
+    };
+
     while (window->isOpen()) {
         neuron::Window::pollEvents();
+        loader.update(2.0);
+        residency.update();
+        hotReloader.update();
+        textureStreamer.update();
+        compressedTextureStreamer.update();
+        if (atlasPacking.valid() && atlasPacking.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            try {
+                atlas        = atlasPacking.get();
+                atlasTexture = atlas->upload();
+                atlasRegions = atlas->regionBuffer();
+            } catch (const std::exception &e) {
+                std::cerr << "Failed to pack " << texturePath << ": " << e.what() << std::endl;
+                atlasTexture = nullptr;
+                atlasRegions = nullptr;
+            }
+        }
+
         int w, h;
         glfwGetFramebufferSize(window->handle(), &w, &h);
-        glViewport(0, 0, w, h);
 
-        glClearColor(0.0, 0.0, 0.0, 1.0);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+        renderTargets.beginFrame();
 
         glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
         glEnable(GL_DEPTH_TEST);
@@ -140,26 +361,96 @@ int main() {
 
         glm::mat4 view = glm::lookAt(eyePosition, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
 
-        glm::mat4 model           = glm::scale(glm::translate(glm::identity<glm::mat4>(), modelPosition), modelScale);
-        glm::mat3 modelNormMatrix = glm::mat3(glm::transpose(glm::inverse(model)));
+        culler.resetStats();
+        culler.setViewProjection(projection * view);
 
+        const bool           atlasTextured = useTextureAtlas && atlasRegions != nullptr;
+        const ShaderVariant &variant       = shaderVariant((specularStrength == 0.0f ? kNoSpecular : 0) | (useVirtualTexture ? kVirtualTextured : 0) |
+                                                           (atlasTextured ? kTextureAtlas : 0));
         {
-            auto sh = shader.getFromGlobal();
-            auto mesh = mesh_handle.getFromGlobal();
+            const std::shared_ptr<neuron::Mesh> mesh = mesh_handle.getFromGlobal()->object();
+
+            // a grid of copies of the model, these all end up in a single instanced draw
+            gridModels.clear();
+            for (int x = 0; x < modelGridSize; x++) {
+                for (int z = 0; z < modelGridSize; z++) {
+                    const glm::vec3 offset = glm::vec3(static_cast<float>(x) - static_cast<float>(modelGridSize - 1) * 0.5f, 0.0f,
+                                                       static_cast<float>(z) - static_cast<float>(modelGridSize - 1) * 0.5f);
+                    gridModels.push_back(glm::scale(glm::translate(glm::identity<glm::mat4>(), modelPosition + offset), modelScale));
+                }
+            }
 
-            sh->object()->use();
-            sh->object()->uniformMatrix4f("uViewProjection", projection * view);
-            sh->object()->uniformMatrix4f("uModel", model);
-            sh->object()->uniformMatrix3f("uModelNormal", modelNormMatrix);
+            const neuron::render::OcclusionBuffer *occlusion = occlusionCulling ? depthPyramid.readback() : nullptr;
+            softwareOcclusionUsed                            = false;
+            if (occlusionCulling && occlusion == nullptr && !mesh->occluderIndices().empty()) {
+                // no readback from the GPU yet, so the copies nearest to the camera occlude the rest. A copy never occludes itself, its bounds are in front of it
+                std::vector<glm::mat4> occluders = gridModels;
+                const std::size_t      count     = std::min(occluders.size(), kMaxSoftwareOccluders);
+                std::ranges::partial_sort(occluders, occluders.begin() + static_cast<std::ptrdiff_t>(count), {},
+                                          [&](const glm::mat4 &model) { return glm::distance(glm::vec3(model[3]), eyePosition); });
+
+                softwareOcclusion.clear(projection * view);
+                for (std::size_t i = 0; i < count; i++) {
+                    softwareOcclusion.rasterizeOccluder(occluders[i], mesh->occluderPositions(), mesh->occluderIndices());
+                }
+                softwareOcclusion.finalize();
+                occlusion             = &softwareOcclusion;
+                softwareOcclusionUsed = true;
+            }
+            culler.setOcclusionBuffer(occlusion);
 
-            sh->object()->uniform3f("uSunDirection", sunDirection);
-            sh->object()->uniform3f("uSunLight", sunColor);
-            sh->object()->uniform3f("uAmbientLight", ambientColor);
-            sh->object()->uniform3f("uEyePosition", eyePosition);
-            sh->object()->uniform1f("uSpecularStrength", specularStrength);
+            for (std::size_t i = 0; i < gridModels.size(); i++) {
+                if (variant.pipeline != nullptr && culler.isVisible(mesh->bounds().transformed(gridModels[i]))) {
+                    const uint32_t region = atlasTextured ? static_cast<uint32_t>(i % atlas->stats().images) : 0;
+                    batcher.submit(mesh_handle, *variant.pipeline, 0, gridModels[i], region);
+                }
+            }
+        }
 
-            mesh->object()->draw();
+        // The preview layer only exists while it's shown, so its blit isn't even declared otherwise. A minimized window still gets a frame, just a
+        // tiny one, so the batcher is flushed
+        const glm::ivec2 size{std::max(w, 1), std::max(h, 1)};
+        const auto       layers = std::span<const neuron::ecs::CameraLayer>(cameraLayers).first(showCameraPreview ? 2 : 1);
+        const auto       camera = neuron::render::addCameraLayerPasses(
+            renderGraph, "Scene", layers, size, [&](const neuron::render::RenderGraph::PassContext &) {
+                // the only pipeline submitted is the current variant's
+                batcher.flush({}, [&](const neuron::ProgramPipeline &, uint32_t) {
+                    variant.vertex->uniformMatrix4f("uViewProjection", projection * view);
+
+                    const neuron::Shader &fragment = *variant.fragment;
+                    fragment.uniform3f("uSunDirection", sunDirection);
+                    fragment.uniform3f("uSunLight", sunColor);
+                    fragment.uniform3f("uAmbientLight", ambientColor);
+                    fragment.uniform3f("uEyePosition", eyePosition);
+                    fragment.uniform1f("uSpecularStrength", specularStrength);
+
+                    if (useVirtualTexture) {
+                        virtualTexture->bind(kVirtualTextureUnit);
+                        fragment.uniform1i("uVirtualTexture", static_cast<int>(kVirtualTextureUnit));
+                    }
+
+                    if (atlasTextured) {
+                        atlasTexture->bind(kAtlasUnit);
+                        atlasRegions->bind_indexed(neuron::Buffer::IndexedTarget::ShaderStorage, neuron::TextureAtlas::kRegionBinding);
+                        fragment.uniform1i("uAtlas", static_cast<int>(kAtlasUnit));
+                    }
+                });
+            });
+
+        // built from this frame's depth and used for culling the next one
+        renderGraph.addPass(
+            "Depth Pyramid",
+            [&](neuron::render::RenderGraph::PassBuilder &builder) {
+                builder.read(camera.depth, neuron::render::ResourceUsage::Sampled);
+                builder.sideEffect();
+            },
+            [&](const neuron::render::RenderGraph::PassContext &context) { depthPyramid.build(context.texture(camera.depth)->handle(), size.x, size.y, projection * view); });
+
+        renderGraph.execute();
+        if (useVirtualTexture) {
+            virtualTexture->update();
         }
+        glViewport(0, 0, w, h);
 
 
         ImGui_ImplGlfw_NewFrame();
@@ -178,6 +469,17 @@ int main() {
 
             ImGui::Text("Basic Lighting & Material");
             ImGui::InputFloat("Specular Strength", &specularStrength);
+            if (ImGui::Checkbox("Virtual Texture", &useVirtualTexture) && useVirtualTexture && !virtualTexture) {
+                constexpr neuron::render::VirtualTextureLayout layout{65536, 65536, 128};
+                virtualTexture = std::make_unique<neuron::render::VirtualTexture>(
+                    layout, [pageSize = layout.pageSize](const neuron::render::VirtualPage &page, const int border) { return virtualTexturePage(page, border, pageSize); });
+            }
+            if (virtualTexture) {
+                const auto vtStats = virtualTexture->stats();
+                ImGui::Text("Pages (%s): %u resident, %u loading, %u requested, %llu evicted, %llu uploaded (%.1f MiB)", vtStats.sparse ? "sparse" : "atlas",
+                            vtStats.cache.resident, vtStats.cache.loading, vtStats.cache.requested, static_cast<unsigned long long>(vtStats.cache.evictions),
+                            static_cast<unsigned long long>(vtStats.uploads), static_cast<double>(vtStats.uploadedBytes) / (1024.0 * 1024.0));
+            }
             ImGui::ColorEdit3("Ambient Light Color", glm::value_ptr(ambientColor));
 
             ImGui::Text("Sun Settings");
@@ -188,20 +490,156 @@ int main() {
 
             ImGui::Text("FPS: %d", static_cast<int>(round(1.0 / deltaTime)));
 
+            ImGui::Spacing();
+            ImGui::Text("Culling");
+            ImGui::Checkbox("Occlusion Culling", &occlusionCulling);
+            ImGui::Text("Tested: %u, Frustum Culled: %u, Occlusion Culled: %u (%s)", culler.stats().tested, culler.stats().frustumCulled, culler.stats().occlusionCulled,
+                        softwareOcclusionUsed ? "software" : "depth pyramid");
+
+            ImGui::Spacing();
+            ImGui::Text("Instancing");
+            ImGui::SliderInt("Model Grid", &modelGridSize, 1, 32);
+            ImGui::Text("Instances: %u, Draw Calls: %u, Ratio: %.1f", batcher.stats().instances, batcher.stats().drawCalls, batcher.stats().ratio());
+
+            ImGui::Spacing();
+            ImGui::Text("Render Graph");
+            const auto &graphStats = renderGraph.stats();
+            ImGui::Text("Passes: %u, Culled: %u, Barriers: %u, Transients: %u", graphStats.passes, graphStats.culled, graphStats.barriers, graphStats.transients);
+            for (const auto &timing : renderGraph.timings()) {
+                ImGui::Text("%s: %.3f ms CPU, %.3f ms GPU", timing.name.c_str(), timing.cpuMs, timing.gpuMs);
+            }
+            const auto targetStats = renderTargets.stats();
+            ImGui::Text("Targets: %u (%u aliased, %u created), %.2f MiB requested, %.2f MiB peak, %.2f MiB pooled", targetStats.targets, targetStats.aliased,
+                        targetStats.created, static_cast<double>(targetStats.requestedBytes) / (1024.0 * 1024.0), static_cast<double>(targetStats.peakBytes) / (1024.0 * 1024.0),
+                        static_cast<double>(targetStats.pooledBytes) / (1024.0 * 1024.0));
+            ImGui::SliderFloat("Exposure", &exposure, 0.1f, 8.0f);
+            ImGui::Checkbox("Camera Preview Layer", &showCameraPreview);
+            if (showCameraPreview) {
+                // GL's rows go bottom up
+                ImGui::Image(static_cast<ImTextureID>(cameraPreview->handle()), ImVec2(static_cast<float>(cameraPreview->width()), static_cast<float>(cameraPreview->height())),
+                             ImVec2(0.0f, 1.0f), ImVec2(1.0f, 0.0f));
+            }
+
+            // sources that didn't change hit the pipeline cache again
             if (ImGui::Button("Reload Shaders")) {
-                const auto vsh = neuron::ShaderModule::load("res/vert.glsl", neuron::ShaderModule::Type::Vertex);
-                const auto fsh = neuron::ShaderModule::load("res/frag.glsl", neuron::ShaderModule::Type::Fragment);
-                assetTable<neuron::asset::Shader>()->replaceAsset(shader, neuron::asset::Shader::create(std::vector{vsh, fsh}));
+                shaderVariants.clear();
             }
+            ImGui::SameLine();
+            const auto &pipelineStats = pipelines.stats();
+            ImGui::Text("Variants: %zu, %zu stage programs, %zu pipelines (%llu stage hits, %llu pipeline hits)", shaderVariants.size(), pipelines.stageCount(),
+                        pipelines.pipelineCount(), static_cast<unsigned long long>(pipelineStats.stageHits), static_cast<unsigned long long>(pipelineStats.pipelineHits));
 
             ImGui::Spacing();
             ImGui::InputText("Model Filename", modelPath, 260);
 
             if (ImGui::Button("Reload Model")) {
                 if (std::filesystem::exists(modelPath)) {
-                    assetTable<neuron::asset::Mesh>()->replaceAsset(mesh_handle, neuron::asset::Mesh::load(modelPath));
+                    loader.reloadMesh(mesh_handle, modelPath, logLoad(modelPath));
+                    residency.manageMesh(mesh_handle, modelPath);
+                    hotReloader.watchMesh(mesh_handle, modelPath, logLoad(modelPath));
+                }
+            }
+
+            if (loader.state(mesh_handle) == neuron::asset::LoadState::Loading) {
+                ImGui::SameLine();
+                ImGui::Text("Loading...");
+            }
+
+            const auto importStats = neuron::asset::ImportCache::global().stats();
+            ImGui::Text("Import Cache: %llu hits (%.1f ms), %llu misses (%.1f ms), %.2f MiB on disk", static_cast<unsigned long long>(importStats.hits),
+                        importStats.hits > 0 ? importStats.cacheLoadMs / static_cast<double>(importStats.hits) : 0.0, static_cast<unsigned long long>(importStats.misses),
+                        importStats.misses > 0 ? importStats.importMs / static_cast<double>(importStats.misses) : 0.0,
+                        static_cast<double>(importStats.bytesOnDisk) / (1024.0 * 1024.0));
+            ImGui::Text("Texture compression: %.1f ms total", importStats.encodeMs);
+            if (ImGui::Button("Clear Import Cache")) {
+                neuron::asset::ImportCache::global().clear();
+            }
+
+            ImGui::Text("Shader Compile Benchmark (%s)", neuron::ShaderBatch::parallelSupported() ? "parallel compile" : "no parallel compile");
+            if (ImGui::Button("Compile 32 Programs")) {
+                compileBenchmark = benchmarkShaderCompiles(32);
+            }
+            ImGui::Text("One at a time: %.1f ms, batched: %.1f ms", compileBenchmark.first, compileBenchmark.second);
+
+            const auto &programStats = neuron::ProgramBinaryCache::global().stats();
+            ImGui::Text("Program Cache: %llu hits (%.1f ms), %llu compiled (%.1f ms), %llu rejected", static_cast<unsigned long long>(programStats.hits), programStats.loadMs,
+                        static_cast<unsigned long long>(programStats.misses), programStats.compileMs, static_cast<unsigned long long>(programStats.rejected));
+            if (ImGui::Button("Clear Program Cache")) {
+                neuron::ProgramBinaryCache::global().clear();
+            }
+
+            ImGui::Spacing();
+            ImGui::InputText("Texture Directory", texturePath, 260);
+            ImGui::Checkbox("Compress to BC7", &compressStreamedTextures);
+            if (ImGui::Button("Stream Textures")) {
+                auto           &streamer = compressStreamedTextures ? compressedTextureStreamer : textureStreamer;
+                std::error_code error;
+                for (const auto &entry : std::filesystem::directory_iterator(texturePath, error)) {
+                    if (const auto extension = entry.path().extension(); extension == ".png" || extension == ".jpg" || extension == ".tga" || extension == ".dds") {
+                        streamedTextures.push_back(streamer.load(entry.path(), 1.0f, true, logLoad(entry.path().string())));
+                    }
                 }
             }
+
+            ImGui::SameLine();
+            ImGui::BeginDisabled(atlasPacking.valid());
+            if (ImGui::Button("Pack Atlas")) {
+                atlasPacking = neuron::ThreadPool::global().submit([directory = std::filesystem::path(texturePath)] {
+                    auto            packed = std::make_unique<neuron::TextureAtlas>();
+                    std::error_code error;
+                    for (const auto &entry : std::filesystem::directory_iterator(directory, error)) {
+                        if (const auto extension = entry.path().extension(); extension == ".png" || extension == ".jpg" || extension == ".tga") {
+                            if (neuron::Image image = neuron::Image::load(entry.path()); packed->accepts(image.width, image.height)) {
+                                packed->add(std::move(image));
+                            }
+                        }
+                    }
+                    packed->pack();
+                    return packed;
+                });
+            }
+            ImGui::EndDisabled();
+
+            ImGui::Text("Textures: %zu requested", streamedTextures.size());
+            if (atlas) {
+                const auto &atlasStats = atlas->stats();
+                ImGui::Text("Atlas: %u images in %u layers, %.1f%% of the texels used, packed in %.1f ms", atlasStats.images, atlasStats.layers,
+                            atlasStats.efficiency() * 100.0f, atlasStats.packMs);
+            }
+            ImGui::BeginDisabled(atlasRegions == nullptr);
+            ImGui::Checkbox("Atlas Textures", &useTextureAtlas);
+            ImGui::EndDisabled();
+            const auto textureStreamerStats = [](const char *name, const neuron::asset::TextureStreamer &streamer) {
+                const auto textureStats = streamer.stats();
+                ImGui::Text("%s: %u decoding, %u streaming, %llu done, %llu failed", name, textureStats.decoding, textureStats.streaming,
+                            static_cast<unsigned long long>(textureStats.completed), static_cast<unsigned long long>(textureStats.failed));
+                ImGui::Text("Uploads: %.2f MiB this frame in %.2f ms, %.1f MiB total, staging %.1f / %.1f MiB", static_cast<double>(textureStats.frameBytes) / (1024.0 * 1024.0),
+                            textureStats.frameMs, static_cast<double>(textureStats.uploadedBytes) / (1024.0 * 1024.0),
+                            static_cast<double>(textureStats.stagingUsed) / (1024.0 * 1024.0), static_cast<double>(textureStats.stagingCapacity) / (1024.0 * 1024.0));
+            };
+            textureStreamerStats("Uncompressed", textureStreamer);
+            textureStreamerStats("BC7", compressedTextureStreamer);
+
+            ImGui::Text("Watching %zu files, %llu hot reloads", watcher.watchedCount(), static_cast<unsigned long long>(hotReloader.reloadCount()));
+
+            ImGui::Spacing();
+            ImGui::Text("Asset Memory");
+            for (const auto &stats : neuron::asset::assetMemoryStats()) {
+                ImGui::Text("%.*s: %u live, %.2f MiB GPU, %.2f MiB CPU, %u pending (%.2f MiB)", static_cast<int>(stats.type.size()), stats.type.data(), stats.count,
+                            static_cast<double>(stats.gpuBytes) / (1024.0 * 1024.0), static_cast<double>(stats.cpuBytes) / (1024.0 * 1024.0), stats.pendingCount,
+                            static_cast<double>(stats.pendingGpuBytes) / (1024.0 * 1024.0));
+            }
+
+            for (const auto &[usage, budget] : residency.budgets()) {
+                ImGui::Text("%.*s budget: %.2f / %.2f MiB GPU", static_cast<int>(usage.type.size()), usage.type.data(), static_cast<double>(usage.gpuBytes) / (1024.0 * 1024.0),
+                            static_cast<double>(budget.gpuBytes) / (1024.0 * 1024.0));
+            }
+
+            const auto &residencyStats = residency.stats();
+            ImGui::Text("Resident: %u, Evicted: %u, Reloading: %u", residencyStats.resident, residencyStats.evicted, residencyStats.reloading);
+            ImGui::Text("Evictions: %llu (%.2f MiB), Reloads: %llu, Failed: %llu", static_cast<unsigned long long>(residencyStats.evictions),
+                        static_cast<double>(residencyStats.evictedBytes) / (1024.0 * 1024.0), static_cast<unsigned long long>(residencyStats.reloads),
+                        static_cast<unsigned long long>(residencyStats.failedLoads));
         }
         ImGui::End();
 
@@ -211,6 +649,8 @@ int main() {
 
         window->swap();
 
+        neuron::asset::collectRetiredAssets();
+
         lastFrame = thisFrame;
         thisFrame = glfwGetTime();
         deltaTime = thisFrame - lastFrame;
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <limits>
+
+#include <glm/glm.hpp>
+
+namespace neuron {
+
+    struct AABB {
+        glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+        glm::vec3 max = glm::vec3(std::numeric_limits<float>::lowest());
+
+        [[nodiscard]] inline bool isEmpty() const { return min.x > max.x || min.y > max.y || min.z > max.z; }
+
+        inline void expand(const glm::vec3 &point) {
+            min = glm::min(min, point);
+            max = glm::max(max, point);
+        }
+
+        [[nodiscard]] inline std::array<glm::vec3, 8> corners() const {
+            return {
+                glm::vec3{min.x, min.y, min.z}, glm::vec3{max.x, min.y, min.z}, glm::vec3{min.x, max.y, min.z}, glm::vec3{max.x, max.y, min.z},
+                glm::vec3{min.x, min.y, max.z}, glm::vec3{max.x, min.y, max.z}, glm::vec3{min.x, max.y, max.z}, glm::vec3{max.x, max.y, max.z},
+            };
+        }
+
+        // transforms the box and returns the box which encloses the result (this can only ever grow the box)
+        [[nodiscard]] inline AABB transformed(const glm::mat4 &matrix) const {
+            const glm::vec3 center  = (min + max) * 0.5f;
+            const glm::vec3 extents = (max - min) * 0.5f;
+
+            const glm::vec3 newCenter = glm::vec3(matrix * glm::vec4(center, 1.0f));
+            const glm::mat3 absolute  = glm::mat3(glm::abs(glm::vec3(matrix[0])), glm::abs(glm::vec3(matrix[1])), glm::abs(glm::vec3(matrix[2])));
+            const glm::vec3 newExtent = absolute * extents;
+
+            return {newCenter - newExtent, newCenter + newExtent};
+        }
+    };
+
+} // namespace neuron
@@ -1,15 +1,24 @@
 #pragma once
 
-#include "neuron/locking_ptr_ref.hpp"
-
+#include "neuron/epoch.hpp"
+#include "neuron/frame_fences.hpp"
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <concepts>
+#include <filesystem>
 #include <memory>
+#include <mutex>
 #include <shared_mutex>
+#include <stdexcept>
+#include <string_view>
 #include <typeindex>
+#include <typeinfo>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace neuron::asset {
 
@@ -23,14 +32,41 @@ namespace neuron::asset {
         Asset(Asset &&other) noexcept            = default;
         Asset &operator=(const Asset &other)     = delete;
         Asset &operator=(Asset &&other) noexcept = default;
+
+        // Sizes for memory accounting. They're read once when the asset is added to a table, so they must not change afterward.
+        [[nodiscard]] virtual std::size_t cpuBytes() const { return 0; }
+
+        [[nodiscard]] virtual std::size_t gpuBytes() const { return 0; }
     };
 
+    /**
+     * A pointer to an asset which keeps the current epoch pinned on this thread. Replacing or releasing the asset never waits for refs, the old asset just
+     * stays alive until every ref taken before the swap is gone. Refs are cheap but can't be handed to another thread.
+     */
     template <std::derived_from<Asset> T>
-    using AssetRef = locking_ptr_ref<T>;
+    class AssetRef {
+    public:
+        inline AssetRef(EpochGuard &&guard, T *asset) : m_Guard(std::move(guard)), m_Asset(asset) {
+        }
+
+        inline T *operator->() const { return m_Asset; }
+
+        inline T &operator*() const { return *m_Asset; }
+
+        [[nodiscard]] inline T *get() const { return m_Asset; }
+
+    private:
+        EpochGuard m_Guard;
+        T         *m_Asset;
+    };
 
     template <std::derived_from<Asset> T>
     class AssetTable;
 
+    template <std::derived_from<Asset> T>
+    class StrongAssetHandle;
+
+    // The low 32 bits are the slot index and the high 32 bits the generation of the slot, which changes every time the slot is released
     template <std::derived_from<Asset> T>
     class AssetHandle {
     public:
@@ -41,7 +77,17 @@ namespace neuron::asset {
         }
 
 
-        inline AssetRef<T> getFromGlobal();
+        inline AssetRef<T> getFromGlobal() const;
+
+        [[nodiscard]] inline handle_t id() const { return handle; }
+
+        [[nodiscard]] inline uint32_t index() const { return static_cast<uint32_t>(handle); }
+
+        [[nodiscard]] inline uint32_t generation() const { return static_cast<uint32_t>(handle >> 32); }
+
+        [[nodiscard]] inline bool isValid() const { return handle != UINT64_MAX; }
+
+        inline bool operator==(const AssetHandle &other) const = default;
 
     private:
         handle_t handle;
@@ -49,47 +95,287 @@ namespace neuron::asset {
         inline explicit AssetHandle(const handle_t handle) : handle(handle) {
         }
 
+        inline AssetHandle(const uint32_t index, const uint32_t generation) : handle(static_cast<handle_t>(generation) << 32 | index) {
+        }
+
         friend class AssetTable<T>;
+        friend class StrongAssetHandle<T>;
+    };
+
+    // A handle of any asset type, for containers that keep track of several types
+    struct AssetKey {
+        std::type_index type;
+        uint64_t        handle;
+
+        bool operator==(const AssetKey &other) const = default;
+    };
+
+    struct AssetKeyHash {
+        inline std::size_t operator()(const AssetKey &key) const { return key.type.hash_code() ^ std::hash<uint64_t>()(key.handle) * 31; }
+    };
+
+    template <std::derived_from<Asset> T>
+    AssetKey assetKey(const AssetHandle<T> handle) {
+        return {typeid(T), handle.id()};
+    }
+
+    // Stable ids are what files use to refer to assets, since handles change from run to run. 0 means "no id".
+    using stable_id_t = uint64_t;
+
+    // FNV-1a of the normalized path
+    inline stable_id_t stableIdFromPath(const std::filesystem::path &path) {
+        stable_id_t hash = 0xcbf29ce484222325ULL;
+        for (const char c : path.lexically_normal().generic_string()) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3ULL;
+        }
+        return hash == 0 ? 1 : hash;
+    }
+
+    struct AssetMemoryStats {
+        std::string_view type;
+        uint32_t         count    = 0;
+        std::size_t      cpuBytes = 0;
+        std::size_t      gpuBytes = 0;
+
+        // replaced or released, waiting for readers and the GPU to be done with them
+        uint32_t    pendingCount    = 0;
+        std::size_t pendingGpuBytes = 0;
     };
 
+    // Asset classes can name themselves for stats with a `static constexpr std::string_view kTypeName`
+    template <std::derived_from<Asset> T>
+    constexpr std::string_view assetTypeName() {
+        if constexpr (requires { T::kTypeName; }) {
+            return T::kTypeName;
+        } else {
+            return typeid(T).name();
+        }
+    }
+
     struct AssetTableBase {
         virtual ~AssetTableBase() = default;
+
+        virtual void collectRetired(uint64_t oldestPinned, uint64_t completedFrame) = 0;
+
+        [[nodiscard]] virtual AssetMemoryStats memoryStats() const = 0;
     };
 
     inline static std::unordered_set<std::shared_ptr<AssetTableBase>> tables_to_delete;
 
 
+    /**
+     * A slot map. Slots live in fixed size pages which never move once allocated, so looking up a handle is a page load, a generation compare and a pointer load,
+     * without any locks. Writers (init, replace, release) are serialized with a mutex.
+     *
+     * Assets added with initShared() are reference counted through StrongAssetHandle and released when the last one goes away. Replaced and released assets
+     * are only destroyed once no reader has them pinned and the GPU has finished the frame they were retired in, so their GL objects are never deleted while in use.
+     */
     template <std::derived_from<Asset> T>
     class AssetTable : public AssetTableBase {
     public:
         using handle_t    = AssetHandle<T>;
         using asset_ref_t = AssetRef<T>;
 
-        ~AssetTable() override = default;
+        static constexpr uint32_t kPageBits = 10;
+        static constexpr uint32_t kPageSize = 1U << kPageBits;
+        static constexpr uint32_t kMaxPages = 1U << 14;
+
+        AssetTable() : m_Pages(std::make_unique<std::atomic<Page *>[]>(kMaxPages)) {
+        }
+
+        ~AssetTable() override {
+            AssetTable *self = this;
+            s_Global.compare_exchange_strong(self, nullptr);
+
+            for (uint32_t i = 0; i < kMaxPages; i++) {
+                Page *page = m_Pages[i].load(std::memory_order_relaxed);
+                if (page == nullptr) {
+                    break; // pages are allocated in order
+                }
+
+                for (auto &slot : page->slots) {
+                    delete slot.asset.load(std::memory_order_relaxed);
+                }
+                delete page;
+            }
+        }
+
+        AssetTable(const AssetTable &other)            = delete;
+        AssetTable &operator=(const AssetTable &other) = delete;
 
         /// Requires that the unique_ptr is moved into the function
         [[nodiscard]] inline handle_t initAsset(std::unique_ptr<T> &&asset) {
-            auto handle = m_Counter++;
-            m_TableMutex.lock();
-            m_Table[handle] = std::move(asset);
-            m_TableMutex.unlock();
-            return handle_t(handle);
+            std::lock_guard lock(m_WriteMutex);
+            return insert(std::move(asset), false);
+        }
+
+        // The asset is released as soon as the last strong handle to it is gone
+        [[nodiscard]] inline StrongAssetHandle<T> initShared(std::unique_ptr<T> &&asset) {
+            std::lock_guard lock(m_WriteMutex);
+            return StrongAssetHandle<T>(insert(std::move(asset), true));
         }
 
         inline void replaceAsset(handle_t handle, std::unique_ptr<T> &&asset) {
-            m_TableMutex.lock();
-            m_Table[handle.handle] = std::move(asset);
-            m_TableMutex.unlock();
+            std::lock_guard lock(m_WriteMutex);
+
+            Slot *slot = findSlot(handle);
+            if (slot == nullptr) {
+                throw std::out_of_range("Replacing an asset through a stale handle");
+            }
+
+            account(asset.get(), 1);
+            retire(slot->asset.exchange(asset.release(), std::memory_order_acq_rel));
+            slot->version.fetch_add(1, std::memory_order_release);
         }
 
+        // throws std::out_of_range for stale or invalid handles
         [[nodiscard]] inline asset_ref_t getAsset(handle_t handle) const {
-            return locking_ptr_ref<T>::from_indexing(m_TableMutex, m_Table, handle.handle);
+            EpochGuard guard; // has to be pinned before the pointer is loaded
+            T         *asset = tryGetAsset(handle);
+            if (asset == nullptr) {
+                throw std::out_of_range("Stale or invalid asset handle");
+            }
+            return asset_ref_t(std::move(guard), asset);
+        }
+
+        // nullptr for stale or invalid handles, never blocks. The caller has to hold an EpochGuard for as long as it uses the pointer
+        [[nodiscard]] inline T *tryGetAsset(handle_t handle) const {
+            const Slot *slot = findSlot(handle);
+            if (slot == nullptr) {
+                return nullptr;
+            }
+
+            // only written when the frame changes, so assets used every frame don't keep bouncing the cache line between threads
+            const uint64_t frame = m_Fences.recordingFrame();
+            if (slot->lastUsed.load(std::memory_order_relaxed) != frame) {
+                slot->lastUsed.store(frame, std::memory_order_relaxed);
+            }
+            return loadAsset(*slot, handle);
+        }
+
+        // tryGetAsset without counting as a use
+        [[nodiscard]] inline T *peekAsset(handle_t handle) const {
+            const Slot *slot = findSlot(handle);
+            return slot == nullptr ? nullptr : loadAsset(*slot, handle);
+        }
+
+        // Changes every time the asset is replaced, so data derived from it can tell it's out of date. 0 for stale handles
+        [[nodiscard]] inline uint32_t version(handle_t handle) const {
+            const Slot *slot = findSlot(handle);
+            return slot == nullptr ? 0 : slot->version.load(std::memory_order_acquire);
+        }
+
+        // the frame the asset was last looked up in, 0 for stale handles
+        [[nodiscard]] inline uint64_t lastUsed(handle_t handle) const {
+            const Slot *slot = findSlot(handle);
+            return slot == nullptr ? 0 : slot->lastUsed.load(std::memory_order_relaxed);
         }
 
         inline void releaseAsset(handle_t handle) {
-            m_TableMutex.lock();
-            m_Table.erase(handle.handle);
-            m_TableMutex.unlock();
+            {
+                std::lock_guard lock(m_WriteMutex);
+
+                Slot *slot = findSlot(handle);
+                if (slot == nullptr) {
+                    return;
+                }
+
+                retire(slot->asset.exchange(nullptr, std::memory_order_acq_rel));
+
+                // bumping the generation is what makes every outstanding handle to this slot stale
+                slot->state.store(static_cast<uint64_t>(handle.generation() + 1) << 32, std::memory_order_release);
+                m_FreeList.push_back(handle.index());
+            }
+
+            std::unique_lock lock(m_StableIdMutex);
+            if (const auto it = m_StableIds.find(handle.handle); it != m_StableIds.end()) {
+                m_StableIdLookup.erase(it->second);
+                m_StableIds.erase(it);
+            }
+        }
+
+        // Takes another strong reference, fails if the asset is gone or its last strong reference is already being dropped
+        [[nodiscard]] inline bool retain(handle_t handle) {
+            Slot *slot = findSlot(handle);
+            if (slot == nullptr) {
+                return false;
+            }
+
+            // generation and count are one word, so this can't resurrect a slot that has been released and reused in the meantime
+            uint64_t state = slot->state.load(std::memory_order_acquire);
+            do {
+                if (state >> 32 != handle.generation() || (state & kRefMask) == 0) {
+                    return false;
+                }
+            } while (!slot->state.compare_exchange_weak(state, state + 1, std::memory_order_acq_rel, std::memory_order_acquire));
+            return true;
+        }
+
+        inline void releaseRef(handle_t handle) {
+            Slot *slot = findSlot(handle);
+            if (slot != nullptr && (slot->state.fetch_sub(1, std::memory_order_acq_rel) & kRefMask) == 1) {
+                releaseAsset(handle);
+            }
+        }
+
+        [[nodiscard]] inline uint32_t refCount(handle_t handle) const {
+            const Slot *slot = findSlot(handle);
+            return slot == nullptr ? 0 : static_cast<uint32_t>(slot->state.load(std::memory_order_acquire) & kRefMask);
+        }
+
+        // Destroys the replaced and released assets that no reader can still see and the GPU is done with. Assets can own GL objects, so this belongs on the GL thread.
+        void collectRetired(const uint64_t oldestPinned, const uint64_t completedFrame) override {
+            std::vector<std::unique_ptr<T>> expired;
+            {
+                std::lock_guard lock(m_WriteMutex);
+                const auto      it = std::ranges::partition(m_Retired, [&](const Retired &retired) {
+                    return retired.epoch >= oldestPinned || retired.frame > completedFrame;
+                }).begin();
+
+                for (auto retired = it; retired != m_Retired.end(); ++retired) {
+                    m_PendingCount.fetch_sub(1, std::memory_order_relaxed);
+                    m_PendingGpuBytes.fetch_sub(retired->asset->gpuBytes(), std::memory_order_relaxed);
+                    expired.push_back(std::move(retired->asset));
+                }
+                m_Retired.erase(it, m_Retired.end());
+            }
+        }
+
+        [[nodiscard]] AssetMemoryStats memoryStats() const override {
+            return {
+                assetTypeName<T>(),
+                m_Count.load(std::memory_order_relaxed),
+                m_CpuBytes.load(std::memory_order_relaxed),
+                m_GpuBytes.load(std::memory_order_relaxed),
+                m_PendingCount.load(std::memory_order_relaxed),
+                m_PendingGpuBytes.load(std::memory_order_relaxed),
+            };
+        }
+
+        // Replaces the handle's previous id, and takes the id away from any other handle that had it
+        inline void setStableId(handle_t handle, const stable_id_t stableId) {
+            std::unique_lock lock(m_StableIdMutex);
+            if (const auto it = m_StableIds.find(handle.handle); it != m_StableIds.end()) {
+                m_StableIdLookup.erase(it->second);
+            }
+            if (const auto it = m_StableIdLookup.find(stableId); it != m_StableIdLookup.end()) {
+                m_StableIds.erase(it->second);
+            }
+            m_StableIds[handle.handle] = stableId;
+            m_StableIdLookup[stableId] = handle.handle;
+        }
+
+        [[nodiscard]] inline stable_id_t stableId(handle_t handle) const {
+            std::shared_lock lock(m_StableIdMutex);
+            const auto       it = m_StableIds.find(handle.handle);
+            return it == m_StableIds.end() ? 0 : it->second;
+        }
+
+        // returns an invalid handle if nothing has that id
+        [[nodiscard]] inline handle_t findByStableId(const stable_id_t stableId) const {
+            std::shared_lock lock(m_StableIdMutex);
+            const auto       it = m_StableIdLookup.find(stableId);
+            return it == m_StableIdLookup.end() ? handle_t() : handle_t(it->second);
         }
 
         inline static std::shared_ptr<AssetTable<T>> globalTable() {
@@ -97,32 +383,261 @@ namespace neuron::asset {
             return globalTable.lock();
         }
 
-        AssetTable() = default;
+        // The global table without going through the weak_ptr, null after cleanupAssetTables()
+        inline static AssetTable *global() {
+            if (AssetTable *table = s_Global.load(std::memory_order_acquire); table != nullptr) [[likely]] {
+                return table;
+            }
+            return globalTable().get();
+        }
 
     private:
+        static constexpr uint64_t kRefMask = 0xFFFFFFFFULL;
+
+        struct Slot {
+            std::atomic<uint64_t> state{0}; // generation in the high half, strong reference count in the low half
+            std::atomic<T *>      asset{nullptr};
+            std::atomic<uint32_t> version{0}; // bumped after every replace
+
+            mutable std::atomic<uint64_t> lastUsed{0};
+        };
+
+        struct Page {
+            std::array<Slot, kPageSize> slots;
+        };
+
+        struct Retired {
+            uint64_t           epoch;
+            uint64_t           frame;
+            std::unique_ptr<T> asset;
+        };
+
+        inline Slot &slotAt(const uint32_t index) const {
+            return m_Pages[index >> kPageBits].load(std::memory_order_acquire)->slots[index & (kPageSize - 1)];
+        }
+
+        inline Slot *findSlot(const handle_t handle) const {
+            const uint32_t index = handle.index();
+            if (index >= kPageSize * kMaxPages) {
+                return nullptr;
+            }
+
+            Page *page = m_Pages[index >> kPageBits].load(std::memory_order_acquire);
+            if (page == nullptr) {
+                return nullptr;
+            }
+
+            Slot &slot = page->slots[index & (kPageSize - 1)];
+            return slot.state.load(std::memory_order_acquire) >> 32 == handle.generation() ? &slot : nullptr;
+        }
+
+        // The slot can be released and reused between findSlot's generation check and loading the pointer, which would hand out the new asset for the
+        // old handle. Releasing bumps the generation before the slot goes back on the free list and insert() publishes the asset after that, so a
+        // load that sees the new asset also sees the new generation
+        inline T *loadAsset(const Slot &slot, const handle_t handle) const {
+            T *asset = slot.asset.load(std::memory_order_acquire);
+            return slot.state.load(std::memory_order_acquire) >> 32 == handle.generation() ? asset : nullptr;
+        }
+
+        // the write mutex must be held
+        inline handle_t insert(std::unique_ptr<T> &&asset, const bool shared) {
+            uint32_t index;
+            if (!m_FreeList.empty()) {
+                index = m_FreeList.back();
+                m_FreeList.pop_back();
+            } else {
+                index = m_SlotCount++;
+                if (index >= kPageSize * kMaxPages) {
+                    throw std::runtime_error("Asset table is full");
+                }
+
+                if ((index & (kPageSize - 1)) == 0) {
+                    m_Pages[index >> kPageBits].store(new Page(), std::memory_order_release);
+                }
+            }
+
+            Slot          &slot       = slotAt(index);
+            const uint32_t generation = static_cast<uint32_t>(slot.state.load(std::memory_order_relaxed) >> 32);
+            slot.state.store(static_cast<uint64_t>(generation) << 32 | (shared ? 1 : 0), std::memory_order_release);
+
+            slot.lastUsed.store(m_Fences.recordingFrame(), std::memory_order_relaxed);
+
+            account(asset.get(), 1);
+            slot.asset.store(asset.release(), std::memory_order_release);
+            return handle_t(index, generation);
+        }
+
+        inline void account(const T *asset, const int sign) {
+            if (asset == nullptr) {
+                return;
+            }
+
+            m_Count.fetch_add(static_cast<uint32_t>(sign), std::memory_order_relaxed);
+            m_CpuBytes.fetch_add(static_cast<std::size_t>(sign) * asset->cpuBytes(), std::memory_order_relaxed);
+            m_GpuBytes.fetch_add(static_cast<std::size_t>(sign) * asset->gpuBytes(), std::memory_order_relaxed);
+        }
+
+        // the write mutex must be held, and the asset must already be unpublished
+        inline void retire(T *asset) {
+            if (asset == nullptr) {
+                return;
+            }
+
+            account(asset, -1);
+            m_PendingCount.fetch_add(1, std::memory_order_relaxed);
+            m_PendingGpuBytes.fetch_add(asset->gpuBytes(), std::memory_order_relaxed);
+            m_Retired.push_back({EpochManager::global().current(), m_Fences.recordingFrame(), std::unique_ptr<T>(asset)});
+        }
+
         inline static std::weak_ptr<AssetTable> new_global() {
             std::shared_ptr<AssetTable> atbl = std::make_shared<AssetTable>();
             tables_to_delete.insert(atbl);
+            s_Global.store(atbl.get(), std::memory_order_release);
             return atbl;
         }
 
-        std::atomic<typename handle_t::handle_t> m_Counter;
+        inline static std::atomic<AssetTable *> s_Global{nullptr};
+
+        std::unique_ptr<std::atomic<Page *>[]> m_Pages;
+
+        const FrameFences &m_Fences = FrameFences::global();
+
+        std::mutex            m_WriteMutex;
+        std::vector<uint32_t> m_FreeList;
+        uint32_t              m_SlotCount = 0;
+        std::vector<Retired>  m_Retired;
+
+        std::atomic<uint32_t>    m_Count{0};
+        std::atomic<std::size_t> m_CpuBytes{0};
+        std::atomic<std::size_t> m_GpuBytes{0};
+        std::atomic<uint32_t>    m_PendingCount{0};
+        std::atomic<std::size_t> m_PendingGpuBytes{0};
 
-        mutable std::shared_mutex                                           m_TableMutex;
-        std::unordered_map<typename handle_t::handle_t, std::unique_ptr<T>> m_Table;
+        mutable std::shared_mutex                                    m_StableIdMutex;
+        std::unordered_map<typename handle_t::handle_t, stable_id_t> m_StableIds;
+        std::unordered_map<stable_id_t, typename handle_t::handle_t> m_StableIdLookup;
     };
 
     template <std::derived_from<Asset> T>
-    std::shared_ptr<AssetTable<T>> assetTable() {
-        return AssetTable<T>::globalTable();
+    AssetTable<T> *assetTable() {
+        return AssetTable<T>::global();
     }
 
     template <std::derived_from<Asset> T>
-    AssetRef<T> AssetHandle<T>::getFromGlobal() {
-        return assetTable<T>()->getAsset(*this);
+    AssetRef<T> AssetHandle<T>::getFromGlobal() const {
+        return AssetTable<T>::global()->getAsset(*this);
+    }
+
+    template <std::derived_from<Asset> T>
+    class WeakAssetHandle;
+
+    // Owns one reference to an asset made with AssetTable::initShared. Converts to a plain AssetHandle for storing in components, which doesn't keep the asset alive.
+    template <std::derived_from<Asset> T>
+    class StrongAssetHandle {
+    public:
+        StrongAssetHandle() = default;
+
+        inline StrongAssetHandle(const StrongAssetHandle &other) : m_Handle(other.m_Handle) {
+            if (m_Handle.isValid() && !AssetTable<T>::global()->retain(m_Handle)) {
+                m_Handle = {};
+            }
+        }
+
+        inline StrongAssetHandle(StrongAssetHandle &&other) noexcept : m_Handle(std::exchange(other.m_Handle, {})) {
+        }
+
+        inline StrongAssetHandle &operator=(StrongAssetHandle other) noexcept {
+            std::swap(m_Handle, other.m_Handle);
+            return *this;
+        }
+
+        inline ~StrongAssetHandle() { reset(); }
+
+        inline void reset() {
+            if (!m_Handle.isValid()) {
+                return;
+            }
+
+            // the table may already be gone during shutdown
+            if (AssetTable<T> *table = AssetTable<T>::global(); table != nullptr) {
+                table->releaseRef(m_Handle);
+            }
+            m_Handle = {};
+        }
+
+        [[nodiscard]] inline AssetHandle<T> handle() const { return m_Handle; }
+
+        inline operator AssetHandle<T>() const { return m_Handle; }
+
+        [[nodiscard]] inline WeakAssetHandle<T> weak() const { return WeakAssetHandle<T>(m_Handle); }
+
+        [[nodiscard]] inline AssetRef<T> getFromGlobal() const { return m_Handle.getFromGlobal(); }
+
+        inline explicit operator bool() const { return m_Handle.isValid(); }
+
+    private:
+        // adopts a reference that was already counted
+        inline explicit StrongAssetHandle(const AssetHandle<T> handle) : m_Handle(handle) {
+        }
+
+        AssetHandle<T> m_Handle;
+
+        friend class AssetTable<T>;
+        friend class WeakAssetHandle<T>;
+    };
+
+    template <std::derived_from<Asset> T>
+    class WeakAssetHandle {
+    public:
+        WeakAssetHandle() = default;
+
+        inline explicit WeakAssetHandle(const AssetHandle<T> handle) : m_Handle(handle) {
+        }
+
+        // an empty handle if the asset is gone
+        [[nodiscard]] inline StrongAssetHandle<T> lock() const {
+            if (m_Handle.isValid() && AssetTable<T>::global()->retain(m_Handle)) {
+                return StrongAssetHandle<T>(m_Handle);
+            }
+            return {};
+        }
+
+        [[nodiscard]] inline bool expired() const { return AssetTable<T>::global()->refCount(m_Handle) == 0; }
+
+        [[nodiscard]] inline AssetHandle<T> handle() const { return m_Handle; }
+
+    private:
+        AssetHandle<T> m_Handle;
+    };
+
+    /**
+     * Destroys the replaced and released assets that no reader can see anymore and the GPU has finished with, in every table,
+     * after fencing the frame that just ended. Call once per frame on the GL thread, after the swap.
+     */
+    inline void collectRetiredAssets() {
+        auto &fences = FrameFences::global();
+        fences.endFrame();
+
+        auto &epochs = EpochManager::global();
+        epochs.advance();
+
+        const uint64_t oldestPinned   = epochs.oldestPinned();
+        const uint64_t completedFrame = fences.completedFrame();
+        for (const auto &table : tables_to_delete) {
+            table->collectRetired(oldestPinned, completedFrame);
+        }
+    }
+
+    [[nodiscard]] inline std::vector<AssetMemoryStats> assetMemoryStats() {
+        std::vector<AssetMemoryStats> stats;
+        for (const auto &table : tables_to_delete) {
+            stats.push_back(table->memoryStats());
+        }
+        return stats;
     }
 
     inline void cleanupAssetTables() {
+        FrameFences::global().clear();
         tables_to_delete.clear();
     }
 } // namespace neuron::asset
@@ -0,0 +1,166 @@
+#include "async_loader.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+
+namespace neuron::asset {
+    namespace {
+        neuron::Mesh::Data placeholderCube() {
+            neuron::Mesh::Data data{};
+            data.mode        = neuron::Mesh::Mode::ElementArray;
+            data.ptype       = neuron::Mesh::PType::Triangles;
+            data.primrestart = false;
+
+            for (int i = 0; i < 8; i++) {
+                const glm::vec3 position(i & 1 ? 0.5f : -0.5f, i & 2 ? 0.5f : -0.5f, i & 4 ? 0.5f : -0.5f);
+                data.vertices.push_back({glm::vec4(position, 1.0f), glm::vec4(1.0f, 0.0f, 1.0f, 1.0f), glm::vec4(glm::normalize(position), 0.0f), glm::vec2(0.0f)});
+            }
+
+            data.indices = {0, 2, 1, 1, 2, 3, 4, 5, 6, 5, 7, 6, 0, 1, 4, 1, 5, 4, 2, 6, 3, 3, 6, 7, 0, 4, 2, 2, 4, 6, 1, 3, 5, 3, 7, 5};
+            return data;
+        }
+    } // namespace
+
+    AsyncLoader::AsyncLoader(ThreadPool &pool) : m_Pool(pool), m_PlaceholderMesh(std::make_shared<neuron::Mesh>(placeholderCube())) {
+    }
+
+    AsyncLoader::~AsyncLoader() = default;
+
+    AssetHandle<Mesh> AsyncLoader::loadMesh(const std::filesystem::path &path, Callback callback) {
+        const auto handle = assetTable<Mesh>()->initAsset(std::make_unique<Mesh>(m_PlaceholderMesh));
+        reloadMesh(handle, path, std::move(callback));
+        return handle;
+    }
+
+    std::shared_future<LoadState> AsyncLoader::reloadMesh(const AssetHandle<Mesh> handle, const std::filesystem::path &path, Callback callback) {
+        return replaceAsync<Mesh>(
+            handle,
+            [path] {
+                return [data = Mesh::loadData(path)] { return std::make_unique<Mesh>(std::make_shared<neuron::Mesh>(data)); };
+            },
+            std::move(callback));
+    }
+
+    AssetHandle<Shader> AsyncLoader::loadShader(const ShaderSources &sources, const AssetHandle<Shader> placeholder, Callback callback, const ShaderDefines &defines) {
+        const auto handle = assetTable<Shader>()->initAsset(std::make_unique<Shader>(placeholder.getFromGlobal()->object()));
+        reloadShader(handle, sources, std::move(callback), defines);
+        return handle;
+    }
+
+    std::shared_future<LoadState>
+    AsyncLoader::reloadShader(const AssetHandle<Shader> handle, const ShaderSources &sources, Callback callback, const ShaderDefines &defines) {
+        return replaceAsync<Shader>(
+            handle,
+            [sources, defines] {
+                std::vector<std::pair<std::string, ShaderModule::Type>> code;
+                for (const auto &[path, type] : sources) {
+                    code.emplace_back(ShaderPreprocessor::global().process(path, defines).source, type);
+                }
+
+                // compiling needs the context, so only the file reads happen on the worker
+                return [code = std::move(code)] { return Shader::fromSources(code); };
+            },
+            std::move(callback));
+    }
+
+    AssetHandle<Shader> AsyncLoader::loadSpirvShader(const ShaderSources &sources, SpecializationConstants constants, const AssetHandle<Shader> placeholder, Callback callback) {
+        const auto handle = assetTable<Shader>()->initAsset(std::make_unique<Shader>(placeholder.getFromGlobal()->object()));
+        reloadSpirvShader(handle, sources, std::move(constants), std::move(callback));
+        return handle;
+    }
+
+    std::shared_future<LoadState>
+    AsyncLoader::reloadSpirvShader(const AssetHandle<Shader> handle, const ShaderSources &sources, SpecializationConstants constants, Callback callback) {
+        return replaceAsync<Shader>(
+            handle,
+            [sources, constants = std::move(constants)] {
+                std::vector<std::pair<std::vector<uint32_t>, ShaderModule::Type>> modules;
+                for (const auto &[path, type] : sources) {
+                    modules.emplace_back(ShaderModule::loadSpirvBinary(path), type);
+                }
+
+                return [modules = std::move(modules), constants] { return Shader::fromSpirv(modules, constants); };
+            },
+            std::move(callback));
+    }
+
+    void AsyncLoader::update(const double budgetMs) {
+        const auto start  = std::chrono::steady_clock::now();
+        const auto budget = std::chrono::duration<double, std::milli>(budgetMs);
+
+        while (true) {
+            std::optional<Pending> pending;
+            {
+                std::lock_guard lock(m_Mutex);
+                const auto      it = std::ranges::find_if(m_Pending, [](const Pending &p) { return p.work.wait_for(std::chrono::seconds(0)) == std::future_status::ready; });
+                if (it == m_Pending.end()) {
+                    return;
+                }
+
+                pending.emplace(std::move(*it));
+                m_Pending.erase(it);
+            }
+
+            try {
+                auto finalize = pending->work.get();
+
+                bool latest;
+                {
+                    std::lock_guard lock(m_Mutex);
+                    const auto      it = m_Status.find(pending->key);
+                    latest             = it != m_Status.end() && it->second.request == pending->request;
+                }
+
+                // a newer load for this handle is on its way, there is no point in uploading this one
+                if (latest) {
+                    finalize();
+                }
+                complete(*pending, LoadState::Ready, {});
+            } catch (const std::exception &e) {
+                complete(*pending, LoadState::Failed, e.what());
+            }
+
+            if (std::chrono::steady_clock::now() - start >= budget) {
+                return;
+            }
+        }
+    }
+
+    std::size_t AsyncLoader::pendingCount() const {
+        std::lock_guard lock(m_Mutex);
+        return m_Pending.size();
+    }
+
+    std::shared_future<LoadState> AsyncLoader::track(AssetKey key, std::future<std::move_only_function<void()>> work, Callback callback) {
+        std::lock_guard lock(m_Mutex);
+
+        const uint64_t request = m_NextRequest++;
+        m_Status[key]          = {request, LoadState::Loading, {}};
+
+        Pending pending{key, request, std::move(work), {}, std::move(callback)};
+        auto    future = pending.promise.get_future().share();
+        m_Pending.push_back(std::move(pending));
+        return future;
+    }
+
+    LoadState AsyncLoader::complete(Pending &pending, LoadState state, const std::string &error) {
+        {
+            std::lock_guard lock(m_Mutex);
+            if (const auto it = m_Status.find(pending.key); it == m_Status.end() || it->second.request != pending.request) {
+                state = LoadState::Superseded;
+            } else if (state == LoadState::Ready) {
+                m_Status.erase(it); // unknown handles report Ready anyway
+            } else {
+                it->second.state = state;
+                it->second.error = error;
+            }
+        }
+
+        pending.promise.set_value(state);
+        if (pending.callback) {
+            pending.callback(state, state == LoadState::Failed ? error : std::string());
+        }
+        return state;
+    }
+} // namespace neuron::asset
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "neuron/asset/asset.hpp"
+#include "neuron/asset/mesh.hpp"
+#include "neuron/asset/shader.hpp"
+#include "neuron/shader_preprocessor.hpp"
+#include "neuron/thread_pool.hpp"
+
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace neuron::asset {
+
+    enum class LoadState {
+        Loading,
+        Ready,
+        Failed,
+        Superseded, // another load for the same handle was started before this one finished
+    };
+
+    /**
+     * Loads assets without stalling the GL thread. A load hands out (or keeps) a handle right away which points at a placeholder, or at the previous asset for reloads,
+     * reads and decodes the files on a thread pool, and then swaps the real asset in from update() on the GL thread, which is also where GL objects get created.
+     * Placeholders share the GL objects of an existing asset, so they cost nothing to make.
+     */
+    class AsyncLoader {
+      public:
+        // called on the GL thread from update(). The error is empty unless the state is Failed
+        using Callback = std::function<void(LoadState state, const std::string &error)>;
+
+        using ShaderSources = std::vector<std::pair<std::filesystem::path, ShaderModule::Type>>;
+
+        // Creates the placeholder mesh, so this has to happen on the GL thread
+        explicit AsyncLoader(ThreadPool &pool = ThreadPool::global());
+        ~AsyncLoader();
+
+        AsyncLoader(const AsyncLoader &other)            = delete;
+        AsyncLoader &operator=(const AsyncLoader &other) = delete;
+
+        // the handle shows a unit cube until the mesh is ready
+        [[nodiscard]] AssetHandle<Mesh> loadMesh(const std::filesystem::path &path, Callback callback = {});
+
+        std::shared_future<LoadState> reloadMesh(AssetHandle<Mesh> handle, const std::filesystem::path &path, Callback callback = {});
+
+        // The handle uses the program of `placeholder` until the new one is ready. Sources go through the ShaderPreprocessor with `defines`
+        [[nodiscard]] AssetHandle<Shader> loadShader(const ShaderSources &sources, AssetHandle<Shader> placeholder, Callback callback = {}, const ShaderDefines &defines = {});
+
+        std::shared_future<LoadState> reloadShader(AssetHandle<Shader> handle, const ShaderSources &sources, Callback callback = {}, const ShaderDefines &defines = {});
+
+        // Like loadShader, but the sources are SPIR-V binaries. Every module is specialized with `constants`, ids a module doesn't have are ignored by GL
+        [[nodiscard]] AssetHandle<Shader> loadSpirvShader(const ShaderSources &sources, SpecializationConstants constants, AssetHandle<Shader> placeholder, Callback callback = {});
+
+        std::shared_future<LoadState> reloadSpirvShader(AssetHandle<Shader> handle, const ShaderSources &sources, SpecializationConstants constants, Callback callback = {});
+
+        /**
+         * The generic version everything above goes through. `decode` runs on a worker and returns the GL thread half of the load, which creates the asset.
+         * Whatever `decode` captures has to be safe to use from another thread.
+         */
+        template <std::derived_from<Asset> T, typename D>
+        std::shared_future<LoadState> replaceAsync(const AssetHandle<T> handle, D decode, Callback callback = {}) {
+            auto work = m_Pool.submit([decode = std::move(decode), handle]() mutable -> std::move_only_function<void()> {
+                std::move_only_function<std::unique_ptr<T>()> finalize = decode();
+                return [handle, finalize = std::move(finalize)]() mutable { assetTable<T>()->replaceAsset(handle, finalize()); };
+            });
+
+            return track(assetKey(handle), std::move(work), std::move(callback));
+        }
+
+        // Finishes loads whose worker part is done, for at most `budgetMs` (but always at least one), and runs their callbacks. GL thread only.
+        void update(double budgetMs = 2.0);
+
+        // of the latest load started for the handle, Ready for handles that were never loaded through this loader
+        template <std::derived_from<Asset> T>
+        [[nodiscard]] LoadState state(const AssetHandle<T> handle) const {
+            std::lock_guard lock(m_Mutex);
+            const auto      it = m_Status.find(assetKey(handle));
+            return it == m_Status.end() ? LoadState::Ready : it->second.state;
+        }
+
+        template <std::derived_from<Asset> T>
+        [[nodiscard]] std::string error(const AssetHandle<T> handle) const {
+            std::lock_guard lock(m_Mutex);
+            const auto      it = m_Status.find(assetKey(handle));
+            return it == m_Status.end() ? std::string() : it->second.error;
+        }
+
+        [[nodiscard]] std::size_t pendingCount() const;
+
+        // the mesh loadMesh hands out until the real one is ready
+        [[nodiscard]] inline std::shared_ptr<neuron::Mesh> placeholderMesh() const { return m_PlaceholderMesh; }
+
+      private:
+        struct Status {
+            uint64_t    request = 0;
+            LoadState   state   = LoadState::Loading;
+            std::string error;
+        };
+
+        struct Pending {
+            AssetKey                                      key;
+            uint64_t                                      request;
+            std::future<std::move_only_function<void()>> work;
+            std::promise<LoadState>                       promise;
+            Callback                                      callback;
+        };
+
+        std::shared_future<LoadState> track(AssetKey key, std::future<std::move_only_function<void()>> work, Callback callback);
+
+        // returns the state the request ended up in
+        LoadState complete(Pending &pending, LoadState state, const std::string &error);
+
+        ThreadPool &m_Pool;
+
+        std::shared_ptr<neuron::Mesh> m_PlaceholderMesh;
+
+        mutable std::mutex                                 m_Mutex;
+        uint64_t                                           m_NextRequest = 1;
+        std::unordered_map<AssetKey, Status, AssetKeyHash> m_Status;
+        std::vector<Pending>                               m_Pending;
+    };
+
+} // namespace neuron::asset
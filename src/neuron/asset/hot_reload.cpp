@@ -0,0 +1,107 @@
+#include "hot_reload.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <ranges>
+
+namespace neuron::asset {
+    HotReloader::HotReloader(AsyncLoader &loader, FileWatcher &watcher) : m_Loader(loader), m_Watcher(watcher) {
+    }
+
+    HotReloader::~HotReloader() {
+        for (const auto &file : m_Dependents | std::views::keys) {
+            m_Watcher.unwatch(file);
+        }
+    }
+
+    void HotReloader::watchShader(const AssetHandle<Shader> handle, const AsyncLoader::ShaderSources &sources, AsyncLoader::Callback callback, const ShaderDefines &defines) {
+        // Preprocesses the sources once to find the includes. This only happens while setting up, reloads do the same on a worker
+        std::vector<std::filesystem::path> files;
+        for (const auto &path : sources | std::views::keys) {
+            try {
+                std::ranges::move(ShaderPreprocessor::global().process(path, defines).files, std::back_inserter(files));
+            } catch (const std::exception &) {
+                // a missing file is still worth watching, it might appear later
+                files.push_back(path);
+            }
+        }
+
+        const auto key = assetKey(handle);
+        setDependencies(key, std::move(files));
+        m_Assets[key].reload = [this, handle, sources, callback = std::move(callback), defines] { reloadShader(handle, sources, callback, defines); };
+    }
+
+    void HotReloader::watchMesh(const AssetHandle<Mesh> handle, const std::filesystem::path &path, AsyncLoader::Callback callback) {
+        const auto key = assetKey(handle);
+        setDependencies(key, {path});
+        m_Assets[key].reload = [this, handle, path, callback = std::move(callback)] { m_Loader.reloadMesh(handle, path, callback); };
+    }
+
+    void HotReloader::update() {
+        std::unordered_set<AssetKey, AssetKeyHash> stale;
+        for (const auto &file : m_Watcher.poll()) {
+            if (const auto it = m_Dependents.find(file.string()); it != m_Dependents.end()) {
+                stale.insert(it->second.begin(), it->second.end());
+            }
+        }
+
+        // an asset is reloaded once, however many of its files changed
+        for (const auto &key : stale) {
+            if (const auto it = m_Assets.find(key); it != m_Assets.end()) {
+                m_ReloadCount++;
+                it->second.reload();
+            }
+        }
+    }
+
+    void HotReloader::setDependencies(const AssetKey &key, std::vector<std::filesystem::path> files) {
+        auto &watched = m_Assets[key];
+        for (const auto &file : watched.files) {
+            const auto it = m_Dependents.find(file.string());
+            if (it != m_Dependents.end() && it->second.erase(key) > 0 && it->second.empty()) {
+                m_Dependents.erase(it);
+                m_Watcher.unwatch(file);
+            }
+        }
+
+        watched.files.clear();
+        for (const auto &file : files) {
+            const auto path = FileWatcher::normalize(file);
+            if (auto &dependents = m_Dependents[path.string()]; dependents.insert(key).second && dependents.size() == 1) {
+                m_Watcher.watch(path);
+            }
+            watched.files.push_back(path);
+        }
+    }
+
+    void HotReloader::reloadShader(const AssetHandle<Shader> handle, const AsyncLoader::ShaderSources &sources, const AsyncLoader::Callback &callback,
+                                   const ShaderDefines &defines) {
+        const auto key   = assetKey(handle);
+        auto       files = std::make_shared<std::vector<std::filesystem::path>>();
+
+        m_Loader.replaceAsync<Shader>(
+            handle,
+            [sources, defines, files] {
+                std::vector<std::pair<std::string, ShaderModule::Type>> code;
+                std::vector<std::filesystem::path>                      read;
+                for (const auto &[path, type] : sources) {
+                    auto preprocessed = ShaderPreprocessor::global().process(path, defines);
+                    code.emplace_back(std::move(preprocessed.source), type);
+                    std::ranges::move(preprocessed.files, std::back_inserter(read));
+                }
+
+                // only once everything was read, so a half done preprocess never replaces the dependencies
+                *files = std::move(read);
+                return [code = std::move(code)] { return Shader::fromSources(code); };
+            },
+            [this, key, files, callback](const LoadState state, const std::string &error) {
+                // includes can be added and removed by the edit that caused the reload, and a failed compile still read them all
+                if (m_Assets.contains(key) && !files->empty()) {
+                    setDependencies(key, std::move(*files));
+                }
+                if (callback) {
+                    callback(state, error);
+                }
+            });
+    }
+} // namespace neuron::asset
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "neuron/asset/async_loader.hpp"
+#include "neuron/file_watcher.hpp"
+
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace neuron::asset {
+
+    /**
+     * Reloads assets when their source files change on disk. Every watched asset knows the files it was built from (for shaders everything the ShaderPreprocessor read,
+     * found again on every reload) and a change to any of them reloads it through the AsyncLoader, so files are read on a worker
+     * and a failed load leaves the previous version in place. Callbacks run from AsyncLoader::update, so the reloader has to outlive the loads it starts.
+     */
+    class HotReloader {
+      public:
+        HotReloader(AsyncLoader &loader, FileWatcher &watcher);
+        ~HotReloader();
+
+        HotReloader(const HotReloader &other)            = delete;
+        HotReloader &operator=(const HotReloader &other) = delete;
+
+        // Watching a handle again replaces its sources
+        void watchShader(AssetHandle<Shader> handle, const AsyncLoader::ShaderSources &sources, AsyncLoader::Callback callback = {}, const ShaderDefines &defines = {});
+
+        void watchMesh(AssetHandle<Mesh> handle, const std::filesystem::path &path, AsyncLoader::Callback callback = {});
+
+        template <std::derived_from<Asset> T>
+        void unwatch(const AssetHandle<T> handle) {
+            setDependencies(assetKey(handle), {});
+            m_Assets.erase(assetKey(handle));
+        }
+
+        // reloads right away, as if one of the sources had changed
+        template <std::derived_from<Asset> T>
+        void reload(const AssetHandle<T> handle) {
+            if (const auto it = m_Assets.find(assetKey(handle)); it != m_Assets.end()) {
+                it->second.reload();
+            }
+        }
+
+        // Starts reloads for the files that changed. GL thread, once per frame
+        void update();
+
+        [[nodiscard]] inline uint64_t reloadCount() const { return m_ReloadCount; }
+
+      private:
+        struct Watched {
+            std::vector<std::filesystem::path> files;
+            std::function<void()>              reload;
+        };
+
+        void setDependencies(const AssetKey &key, std::vector<std::filesystem::path> files);
+
+        void reloadShader(AssetHandle<Shader> handle, const AsyncLoader::ShaderSources &sources, const AsyncLoader::Callback &callback, const ShaderDefines &defines);
+
+        AsyncLoader &m_Loader;
+        FileWatcher &m_Watcher;
+
+        std::unordered_map<AssetKey, Watched, AssetKeyHash>                         m_Assets;
+        std::unordered_map<std::string, std::unordered_set<AssetKey, AssetKeyHash>> m_Dependents; // by normalized file
+        uint64_t                                                                    m_ReloadCount = 0;
+    };
+
+} // namespace neuron::asset
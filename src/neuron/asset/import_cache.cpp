@@ -0,0 +1,442 @@
+#include "import_cache.hpp"
+
+#include "neuron/dds.hpp"
+#include "neuron/hash.hpp"
+#include "neuron/image.hpp"
+#include "neuron/mapped_file.hpp"
+
+#include <assimp/version.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <span>
+#include <thread>
+
+/*
+ * Entry layout (all integers little endian, as written by the host):
+ *
+ *   char[4]  magic "NMIC"
+ *   u32      format version
+ *   u64      key
+ *   u32      size of one vertex
+ *   u32      mesh count
+ *
+ *   per mesh:  u32 mode, u32 primitive type, u32 primitive restart, u32 unused, u64 vertex count, u64 index count, u64 draw count
+ *
+ *   then per mesh its vertices, its indices and its draws as u32 (first index, index count) pairs, each array starting 16 byte aligned,
+ *   so the arrays could be used straight from the mapping.
+ */
+
+namespace neuron::asset {
+    namespace {
+        constexpr char        kMagic[4]         = {'N', 'M', 'I', 'C'};
+        constexpr std::size_t kArrayAlignment   = 16;
+        constexpr auto        kEntryExtension   = ".nmic";
+        constexpr auto        kTextureExtension = ".dds";
+
+        double millisecondsSince(const std::chrono::steady_clock::time_point start) {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        class Writer {
+          public:
+            template <typename T>
+            void write(const T &value) {
+                bytes(&value, sizeof(T));
+            }
+
+            void bytes(const void *data, const std::size_t size) {
+                const auto *begin = static_cast<const std::byte *>(data);
+                m_Buffer.insert(m_Buffer.end(), begin, begin + size);
+            }
+
+            void align(const std::size_t alignment) {
+                if (const std::size_t rem = m_Buffer.size() % alignment; rem != 0) {
+                    m_Buffer.resize(m_Buffer.size() + alignment - rem);
+                }
+            }
+
+            [[nodiscard]] const std::vector<std::byte> &buffer() const { return m_Buffer; }
+
+          private:
+            std::vector<std::byte> m_Buffer;
+        };
+
+        class Reader {
+          public:
+            explicit Reader(const std::span<const std::byte> data) : m_Data(data) {}
+
+            template <typename T>
+            T read() {
+                T value;
+                std::memcpy(&value, take(sizeof(T)), sizeof(T));
+                return value;
+            }
+
+            const std::byte *take(const std::size_t size) {
+                if (size > m_Data.size() - m_Offset) {
+                    throw std::runtime_error("Malformed import cache entry: unexpected end of file");
+                }
+                const std::byte *data = m_Data.data() + m_Offset;
+                m_Offset += size;
+                return data;
+            }
+
+            // `count` elements of `size` bytes, without overflowing on garbage counts
+            const std::byte *takeArray(const uint64_t count, const std::size_t size) {
+                if (count > (m_Data.size() - m_Offset) / size) {
+                    throw std::runtime_error("Malformed import cache entry: array larger than the file");
+                }
+                return take(count * size);
+            }
+
+            void align(const std::size_t alignment) {
+                if (const std::size_t rem = m_Offset % alignment; rem != 0) {
+                    take(alignment - rem);
+                }
+            }
+
+          private:
+            std::span<const std::byte> m_Data;
+            std::size_t                m_Offset = 0;
+        };
+
+        struct MeshHeader {
+            uint32_t mode;
+            uint32_t ptype;
+            uint32_t primrestart;
+            uint32_t unused;
+            uint64_t vertexCount;
+            uint64_t indexCount;
+            uint64_t drawCount;
+        };
+    } // namespace
+
+    ImportCache::ImportCache(Settings settings) : m_Settings(std::move(settings)) {
+    }
+
+    std::vector<neuron::Mesh::Data> ImportCache::loadMeshes(const std::filesystem::path &source) {
+        auto           start = std::chrono::steady_clock::now();
+        const uint64_t key   = this->key(source);
+        const double   hash  = millisecondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        if (auto meshes = read(key)) {
+            std::lock_guard lock(m_Mutex);
+            m_Stats.hits++;
+            m_Stats.hashMs += hash;
+            m_Stats.cacheLoadMs += millisecondsSince(start);
+            return std::move(*meshes);
+        }
+
+        start       = std::chrono::steady_clock::now();
+        auto meshes = neuron::Mesh::Data::loadWithAssimp(source);
+        {
+            std::lock_guard lock(m_Mutex);
+            m_Stats.misses++;
+            m_Stats.hashMs += hash;
+            m_Stats.importMs += millisecondsSince(start);
+        }
+
+        // the cache is only there to make loading faster, failing to fill it shouldn't fail the load
+        try {
+            write(key, meshes);
+        } catch (const std::exception &e) {
+            std::cerr << "Could not write the import cache entry for " << source.string() << ": " << e.what() << std::endl;
+        }
+        return meshes;
+    }
+
+    std::filesystem::path ImportCache::compressedTexture(const std::filesystem::path &source, const BcFormat format, const bool srgb) {
+        auto           start = std::chrono::steady_clock::now();
+        const uint64_t key   = textureKey(source, format, srgb);
+        const double   hash  = millisecondsSince(start);
+        const auto     path  = texturePath(key);
+
+        start = std::chrono::steady_clock::now();
+        if (validTexture(path)) {
+            std::error_code error;
+            std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+
+            std::lock_guard lock(m_Mutex);
+            m_Stats.hits++;
+            m_Stats.hashMs += hash;
+            m_Stats.cacheLoadMs += millisecondsSince(start);
+            return path;
+        }
+
+        start = std::chrono::steady_clock::now();
+        std::vector<BcImage> levels;
+        for (const auto &level : Image::load(source).mipChain(srgb)) {
+            levels.push_back(BcImage::encode(level, format));
+        }
+        {
+            std::lock_guard lock(m_Mutex);
+            m_Stats.misses++;
+            m_Stats.hashMs += hash;
+            m_Stats.encodeMs += millisecondsSince(start);
+        }
+
+        // unlike meshes there is nothing to fall back to, the file is what gets loaded
+        std::filesystem::create_directories(m_Settings.directory);
+        const auto temporary = temporaryPath(path);
+        DdsFile::write(temporary, levels, srgb);
+
+        std::error_code error;
+        std::filesystem::rename(temporary, path, error);
+        if (error) {
+            std::filesystem::remove(temporary, error);
+            return path; // someone else wrote the same entry and it's in use
+        }
+
+        trim();
+        return path;
+    }
+
+    void ImportCache::invalidate(const std::filesystem::path &source) {
+        std::error_code error;
+        std::filesystem::remove(entryPath(key(source)), error);
+    }
+
+    void ImportCache::clear() {
+        std::lock_guard lock(m_Mutex);
+
+        std::error_code error;
+        for (const auto &entry : std::filesystem::directory_iterator(m_Settings.directory, error)) {
+            if (entry.path().extension() == kEntryExtension || entry.path().extension() == kTextureExtension) {
+                std::filesystem::remove(entry.path(), error);
+            }
+        }
+        m_Stats.bytesOnDisk = 0;
+    }
+
+    uint64_t ImportCache::key(const std::filesystem::path &source) const {
+        const MappedFile file(source);
+
+        // anything that changes what the importer produces, or how it's stored, has to be in here
+        const uint32_t settings[] = {
+            kFormatVersion, neuron::Mesh::Data::kAssimpFlags, aiGetVersionMajor(), aiGetVersionMinor(), aiGetVersionRevision(), static_cast<uint32_t>(sizeof(StandardVertex)),
+        };
+        const uint64_t seed = hashBytes(std::as_bytes(std::span(settings)), 0);
+        return hashBytes(file.bytes(), seed);
+    }
+
+    uint64_t ImportCache::textureKey(const std::filesystem::path &source, const BcFormat format, const bool srgb) const {
+        const MappedFile file(source);
+
+        // sRGB changes how the mips are filtered and what the header says, not just the blocks
+        const uint32_t settings[] = {kTextureFormatVersion, static_cast<uint32_t>(format), srgb ? 1U : 0U};
+        const uint64_t seed       = hashBytes(std::as_bytes(std::span(settings)), 0);
+        return hashBytes(file.bytes(), seed);
+    }
+
+    std::filesystem::path ImportCache::entryPath(const uint64_t key) const {
+        char name[17];
+        std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+        return m_Settings.directory / (std::string(name) + kEntryExtension);
+    }
+
+    std::filesystem::path ImportCache::texturePath(const uint64_t key) const {
+        return std::filesystem::path(entryPath(key)).replace_extension(kTextureExtension);
+    }
+
+    ImportCacheStats ImportCache::stats() const {
+        std::lock_guard lock(m_Mutex);
+        return m_Stats;
+    }
+
+    ImportCache &ImportCache::global() {
+        static ImportCache cache(Settings{});
+        return cache;
+    }
+
+    std::optional<std::vector<neuron::Mesh::Data>> ImportCache::read(const uint64_t key) {
+        const auto      path = entryPath(key);
+        std::error_code error;
+        if (!std::filesystem::exists(path, error)) {
+            return std::nullopt;
+        }
+
+        std::vector<neuron::Mesh::Data> meshes;
+        try {
+            const MappedFile file(path);
+            Reader           reader(file.bytes());
+
+            if (std::memcmp(reader.take(sizeof(kMagic)), kMagic, sizeof(kMagic)) != 0) {
+                throw std::runtime_error("Malformed import cache entry: bad magic");
+            }
+            if (reader.read<uint32_t>() != kFormatVersion || reader.read<uint64_t>() != key || reader.read<uint32_t>() != sizeof(StandardVertex)) {
+                throw std::runtime_error("Malformed import cache entry: header doesn't match");
+            }
+
+            const uint32_t          meshCount = reader.read<uint32_t>();
+            std::vector<MeshHeader> headers;
+            for (uint32_t i = 0; i < meshCount; i++) {
+                headers.push_back(reader.read<MeshHeader>());
+                if (headers.back().mode > static_cast<uint32_t>(neuron::Mesh::Mode::ElementArrayMultiDraw)) {
+                    throw std::runtime_error("Malformed import cache entry: unknown mode");
+                }
+            }
+
+            for (const MeshHeader &header : headers) {
+                neuron::Mesh::Data data{};
+                data.mode        = static_cast<neuron::Mesh::Mode>(header.mode);
+                data.ptype       = static_cast<neuron::Mesh::PType>(header.ptype);
+                data.primrestart = header.primrestart != 0;
+
+                reader.align(kArrayAlignment);
+                const auto *vertices = reinterpret_cast<const StandardVertex *>(reader.takeArray(header.vertexCount, sizeof(StandardVertex)));
+                data.vertices.assign(vertices, vertices + header.vertexCount);
+
+                reader.align(kArrayAlignment);
+                const auto *indices = reinterpret_cast<const unsigned int *>(reader.takeArray(header.indexCount, sizeof(unsigned int)));
+                data.indices.assign(indices, indices + header.indexCount);
+
+                reader.align(kArrayAlignment);
+                Reader draws(std::span(reader.takeArray(header.drawCount, 2 * sizeof(uint32_t)), header.drawCount * 2 * sizeof(uint32_t)));
+                data.draws.reserve(header.drawCount);
+                for (uint64_t i = 0; i < header.drawCount; i++) {
+                    const auto first = draws.read<uint32_t>();
+                    data.draws.emplace_back(first, draws.read<uint32_t>());
+                }
+
+                meshes.push_back(std::move(data));
+            }
+        } catch (const std::exception &) {
+            std::filesystem::remove(path, error);
+
+            std::lock_guard lock(m_Mutex);
+            m_Stats.invalidated++;
+            return std::nullopt;
+        }
+
+        // the modification time is what trim() goes by
+        std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+        return meshes;
+    }
+
+    void ImportCache::write(const uint64_t key, const std::vector<neuron::Mesh::Data> &meshes) {
+        Writer writer;
+        writer.bytes(kMagic, sizeof(kMagic));
+        writer.write(kFormatVersion);
+        writer.write(key);
+        writer.write(static_cast<uint32_t>(sizeof(StandardVertex)));
+        writer.write(static_cast<uint32_t>(meshes.size()));
+
+        for (const auto &mesh : meshes) {
+            writer.write(MeshHeader{
+                static_cast<uint32_t>(mesh.mode),
+                static_cast<uint32_t>(mesh.ptype),
+                mesh.primrestart ? 1U : 0U,
+                0,
+                mesh.vertices.size(),
+                mesh.indices.size(),
+                mesh.draws.size(),
+            });
+        }
+
+        for (const auto &mesh : meshes) {
+            writer.align(kArrayAlignment);
+            writer.bytes(mesh.vertices.data(), mesh.vertices.size() * sizeof(StandardVertex));
+            writer.align(kArrayAlignment);
+            writer.bytes(mesh.indices.data(), mesh.indices.size() * sizeof(unsigned int));
+            writer.align(kArrayAlignment);
+            for (const auto &[first, count] : mesh.draws) {
+                writer.write(static_cast<uint32_t>(first));
+                writer.write(static_cast<uint32_t>(count));
+            }
+        }
+
+        std::filesystem::create_directories(m_Settings.directory);
+
+        // written next to the entry and renamed over it, so a reader never maps a half written file
+        const auto path      = entryPath(key);
+        const auto temporary = temporaryPath(path);
+        {
+            std::ofstream file(temporary, std::ios::binary);
+            file.write(reinterpret_cast<const char *>(writer.buffer().data()), static_cast<std::streamsize>(writer.buffer().size()));
+            if (!file) {
+                throw std::runtime_error("Could not write " + temporary.string());
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporary, path, error);
+        if (error) {
+            std::filesystem::remove(temporary, error);
+            return; // someone else wrote the same entry and it's in use, which is just as good
+        }
+
+        trim();
+    }
+
+    bool ImportCache::validTexture(const std::filesystem::path &path) {
+        std::error_code error;
+        if (!std::filesystem::exists(path, error)) {
+            return false;
+        }
+
+        try {
+            const MappedFile file(path);
+            (void)DdsFile::validate(file.bytes());
+            return true;
+        } catch (const std::exception &) {
+            std::filesystem::remove(path, error);
+
+            std::lock_guard lock(m_Mutex);
+            m_Stats.invalidated++;
+            return false;
+        }
+    }
+
+    std::filesystem::path ImportCache::temporaryPath(const std::filesystem::path &path) {
+        auto temporary = path;
+        temporary += ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+        return temporary;
+    }
+
+    void ImportCache::trim() {
+        std::lock_guard lock(m_Mutex);
+
+        struct File {
+            std::filesystem::file_time_type time;
+            uint64_t                        size;
+            std::filesystem::path           path;
+        };
+
+        std::vector<File> files;
+        uint64_t          total = 0;
+        std::error_code   error;
+        for (const auto &entry : std::filesystem::directory_iterator(m_Settings.directory, error)) {
+            if (entry.path().extension() != kEntryExtension && entry.path().extension() != kTextureExtension) {
+                continue;
+            }
+
+            const uint64_t size = entry.file_size(error);
+            const auto     time = entry.last_write_time(error);
+            if (!error) {
+                files.push_back({time, size, entry.path()});
+                total += size;
+            }
+        }
+
+        if (total > m_Settings.maxBytes) {
+            std::ranges::sort(files, {}, &File::time);
+            for (const auto &file : files) {
+                if (total <= m_Settings.maxBytes) {
+                    break;
+                }
+
+                if (std::filesystem::remove(file.path, error)) {
+                    total -= file.size;
+                    m_Stats.evictedFiles++;
+                }
+            }
+        }
+        m_Stats.bytesOnDisk = total;
+    }
+} // namespace neuron::asset
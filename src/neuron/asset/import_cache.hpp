@@ -0,0 +1,93 @@
+#pragma once
+
+#include "neuron/bc_encoder.hpp"
+#include "neuron/mesh.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace neuron::asset {
+
+    struct ImportCacheStats {
+        uint64_t hits         = 0;
+        uint64_t misses       = 0;
+        uint64_t invalidated  = 0; // entries that were unreadable or from another format version
+        uint64_t evictedFiles = 0;
+        uint64_t bytesOnDisk  = 0; // as of the last write
+
+        // totals, so cold (import) and warm (cache) loads can be compared
+        double hashMs      = 0.0;
+        double importMs    = 0.0;
+        double cacheLoadMs = 0.0;
+        double encodeMs    = 0.0; // block compressing textures
+    };
+
+    /**
+     * Caches what assimp makes of model files, keyed by a hash of the file contents together with the importer flags, the assimp version and the cache format,
+     * so changing any of them simply misses. Entries are flat binary files which are mapped rather than read. Writes go through a temporary file and a rename,
+     * so concurrent loads of the same model are fine. The directory is kept under a size cap by deleting the least recently used entries.
+     * Textures are kept the same way, block compressed into .dds files the engine loads directly.
+     */
+    class ImportCache {
+      public:
+        static constexpr uint32_t kFormatVersion        = 1;
+        static constexpr uint32_t kTextureFormatVersion = 1; // bump when the encoder's output changes
+
+        struct Settings {
+            std::filesystem::path directory = ".cache/imports";
+            uint64_t              maxBytes  = 1ULL << 30;
+        };
+
+        explicit ImportCache(Settings settings);
+
+        ImportCache(const ImportCache &other)            = delete;
+        ImportCache &operator=(const ImportCache &other) = delete;
+
+        // Thread safe. Falls back to importing (and fills the cache) if there is no valid entry
+        [[nodiscard]] std::vector<neuron::Mesh::Data> loadMeshes(const std::filesystem::path &source);
+
+        // Thread safe. The path of a .dds file with the whole mip chain of `source` in `format`, encoding it first if there is no valid entry. Encodes on the
+        // calling thread, so it can be called from pool jobs
+        [[nodiscard]] std::filesystem::path compressedTexture(const std::filesystem::path &source, BcFormat format, bool srgb);
+
+        // removes the entry for the current contents of `source`
+        void invalidate(const std::filesystem::path &source);
+
+        void clear();
+
+        [[nodiscard]] uint64_t key(const std::filesystem::path &source) const;
+
+        [[nodiscard]] uint64_t textureKey(const std::filesystem::path &source, BcFormat format, bool srgb) const;
+
+        [[nodiscard]] std::filesystem::path entryPath(uint64_t key) const;
+
+        [[nodiscard]] std::filesystem::path texturePath(uint64_t key) const;
+
+        [[nodiscard]] ImportCacheStats stats() const;
+
+        static ImportCache &global();
+
+      private:
+        // nullopt if there is no usable entry. Broken entries are deleted
+        std::optional<std::vector<neuron::Mesh::Data>> read(uint64_t key);
+
+        void write(uint64_t key, const std::vector<neuron::Mesh::Data> &meshes);
+
+        // false if it isn't there or is broken, in which case it's deleted
+        bool validTexture(const std::filesystem::path &path);
+
+        // with the same hash and extension in the name as `path`, unique to the calling thread
+        [[nodiscard]] static std::filesystem::path temporaryPath(const std::filesystem::path &path);
+
+        void trim();
+
+        Settings m_Settings;
+
+        mutable std::mutex m_Mutex;
+        ImportCacheStats   m_Stats;
+    };
+
+} // namespace neuron::asset
@@ -4,13 +4,23 @@
 
 #include "mesh.hpp"
 
+#include "import_cache.hpp"
+
 namespace neuron::asset {
     std::unique_ptr<Mesh> Mesh::load(const std::filesystem::path &path) {
+        return std::make_unique<Mesh>(std::make_shared<neuron::Mesh>(loadData(path)));
+    }
+
+    neuron::Mesh::Data Mesh::loadData(const std::filesystem::path &path) {
         if (path.extension() == ".nmesh") {
-            return std::make_unique<Mesh>(neuron::Mesh::loadFromNMeshFile(path));
+            return neuron::Mesh::Data::loadFromNMeshFile(path);
         }
 
         // TODO: replace this with a multiloader from assimp
-        return std::make_unique<Mesh>(neuron::Mesh::loadWithAssimp(path)[0]);
+        auto meshes = ImportCache::global().loadMeshes(path);
+        if (meshes.empty()) {
+            throw std::runtime_error("No meshes in " + path.string());
+        }
+        return std::move(meshes[0]);
     }
 }
@@ -8,14 +8,23 @@ namespace neuron::asset {
 
     class Mesh final : public Asset {
     public:
+        static constexpr std::string_view kTypeName = "Mesh";
 
         explicit Mesh(std::shared_ptr<neuron::Mesh> mesh) : m_Mesh(std::move(mesh)) {}
         ~Mesh() override = default;
 
         static std::unique_ptr<Mesh> load(const std::filesystem::path &path);
 
+        // the CPU side of load(), safe to call off the GL thread
+        static neuron::Mesh::Data loadData(const std::filesystem::path &path);
+
         [[nodiscard]] inline std::shared_ptr<neuron::Mesh> object() const { return m_Mesh; }
 
+        // placeholders share one mesh, which every asset showing it counts in full
+        [[nodiscard]] std::size_t cpuBytes() const override { return m_Mesh ? m_Mesh->cpuBytes() : 0; }
+
+        [[nodiscard]] std::size_t gpuBytes() const override { return m_Mesh ? m_Mesh->gpuBytes() : 0; }
+
     private:
         std::shared_ptr<neuron::Mesh> m_Mesh;
     };
@@ -1,5 +1,79 @@
 #include "post_processing_pipeline.hpp"
 
+#include <algorithm>
+#include <cmath>
 
 namespace neuron::asset {
-} // asset
+    namespace {
+        using Resource = render::RenderGraph::Resource;
+
+        int scaled(const int size, const float scale) {
+            return std::max(static_cast<int>(std::lround(static_cast<float>(size) * scale)), 1);
+        }
+
+        // a fullscreen pass from `source` into `target`, or a new target of `desc` when there is none
+        Resource addFullscreenPass(render::RenderGraph &graph, const std::string &name, const Resource source, Resource target, const render::RenderTargetDesc desc,
+                                   std::function<std::shared_ptr<neuron::Shader>()> program, std::function<void(const neuron::Shader &shader)> uniforms,
+                                   std::shared_ptr<Sampler> sampler) {
+            graph.addPass(
+                name,
+                [&](render::RenderGraph::PassBuilder &builder) {
+                    builder.read(source, render::ResourceUsage::Sampled);
+                    if (target == render::RenderGraph::kNoResource) {
+                        target = builder.create(name, desc);
+                    }
+                    builder.write(target, render::ResourceUsage::Attachment);
+                },
+                [source, program = std::move(program), uniforms = std::move(uniforms), sampler = std::move(sampler)](const render::RenderGraph::PassContext &context) {
+                    const std::shared_ptr<neuron::Shader> shader = program();
+                    if (shader == nullptr) {
+                        return;
+                    }
+
+                    glDisable(GL_DEPTH_TEST);
+                    shader->use();
+                    context.texture(source)->bind(0);
+                    sampler->bind(0);
+                    shader->uniform1i("uSource", 0);
+                    if (uniforms) {
+                        uniforms(*shader);
+                    }
+                    context.drawFullscreenTriangle();
+                    glEnable(GL_DEPTH_TEST);
+                });
+            return target;
+        }
+    } // namespace
+
+    Resource PostProcessingPipeline::addPasses(render::RenderGraph &graph, const Resource input, const Resource output) const {
+        if (m_Effects.empty()) {
+            if (output != render::RenderGraph::kNoResource) {
+                graph.addBlitPass("Copy", input, output);
+                return output;
+            }
+            return input;
+        }
+
+        if (m_Sampler == nullptr) {
+            m_Sampler = std::make_shared<Sampler>(Sampler::Settings{
+                .minFilter = Sampler::Filter::Linear,
+                .wrapS     = Sampler::Wrap::ClampToEdge,
+                .wrapT     = Sampler::Wrap::ClampToEdge,
+                .wrapR     = Sampler::Wrap::ClampToEdge,
+            });
+        }
+
+        Resource current = input;
+        for (std::size_t i = 0; i < m_Effects.size(); i++) {
+            const Effect                   &effect = m_Effects[i];
+            const render::RenderTargetDesc &source = graph.desc(current);
+            const render::RenderTargetDesc  desc{scaled(source.width, effect.scale), scaled(source.height, effect.scale), effect.format};
+
+            // the shader is looked up when the pass runs, so hot reloads are picked up
+            const Resource target  = i + 1 == m_Effects.size() ? output : render::RenderGraph::kNoResource;
+            const auto     program = [shader = effect.shader]() -> std::shared_ptr<neuron::Shader> { return shader.isValid() ? shader.getFromGlobal()->object() : nullptr; };
+            current                = addFullscreenPass(graph, effect.name, current, target, desc, program, effect.uniforms, m_Sampler);
+        }
+        return current;
+    }
+} // namespace neuron::asset
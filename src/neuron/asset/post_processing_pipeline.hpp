@@ -1,14 +1,51 @@
 #pragma once
 #include "asset.hpp"
+#include "shader.hpp"
+#include "neuron/render/render_graph.hpp"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace neuron::asset {
 
+    /**
+     * A chain of fullscreen effects, each sampling what the one before it rendered. addPasses() makes it part of a render graph, one pass per effect, with
+     * the results in between as transient targets from the graph's pool.
+     */
     class PostProcessingPipeline final : public Asset {
       public:
-        PostProcessingPipeline();
+        static constexpr std::string_view kTypeName = "PostProcessingPipeline";
+
+        struct Effect {
+            std::string             name;
+            AssetHandle<Shader>     shader; // with res/fullscreen.glsl as the vertex stage, sampling `uSource` on unit 0
+            Texture::InternalFormat format = Texture::InternalFormat::RGBA16F;
+            float                   scale  = 1.0f; // of the size of the input
+
+            // called after the shader is bound, for effect specific uniforms
+            std::function<void(const neuron::Shader &shader)> uniforms;
+        };
+
+        PostProcessingPipeline() = default;
+        explicit PostProcessingPipeline(std::vector<Effect> effects) : m_Effects(std::move(effects)) {}
         ~PostProcessingPipeline() override = default;
 
+        [[nodiscard]] inline const std::vector<Effect> &effects() const { return m_Effects; }
+
+        /**
+         * Adds a pass per effect, starting from `input`. The last one renders into `output`, or into a new transient target if there is none, and that is
+         * what's returned. Without effects `input` is blitted into `output`, or returned as it is. GL thread
+         */
+        render::RenderGraph::Resource addPasses(render::RenderGraph &graph, render::RenderGraph::Resource input,
+                                                render::RenderGraph::Resource output = render::RenderGraph::kNoResource) const;
+
       private:
+        std::vector<Effect> m_Effects;
+
+        // made by the first addPasses(), so the pipeline itself can be made off the GL thread
+        mutable std::shared_ptr<Sampler> m_Sampler;
     };
 
 } // namespace neuron::asset
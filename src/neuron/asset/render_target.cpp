@@ -1,4 +1,18 @@
 #include "render_target.hpp"
 
+#include <stdexcept>
+
 namespace neuron::asset {
-}
+    RenderTarget::RenderTarget(std::shared_ptr<neuron::Texture> color, std::shared_ptr<neuron::Texture> depth) : m_Color(std::move(color)), m_Depth(std::move(depth)) {
+        if (m_Color == nullptr) {
+            throw std::logic_error("Render targets need a color texture, use the default one for the window");
+        }
+        if (m_Depth != nullptr && (m_Depth->width() != m_Color->width() || m_Depth->height() != m_Color->height())) {
+            throw std::runtime_error("Render target depth and color differ in size");
+        }
+    }
+
+    std::size_t RenderTarget::gpuBytes() const {
+        return (m_Color ? m_Color->byteSize() : 0) + (m_Depth ? m_Depth->byteSize() : 0);
+    }
+} // namespace neuron::asset
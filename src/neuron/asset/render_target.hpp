@@ -1,16 +1,34 @@
 #pragma once
 #include "asset.hpp"
-#include "framebuffer.hpp"
+#include "neuron/glwrap.hpp"
+
+#include <memory>
 
 namespace neuron::asset {
 
+    /**
+     * Where a camera layer ends up, either the window or textures of its own a later pass or another layer can sample. The textures are imported into
+     * the render graph every frame, so they are the layer's output rather than transients.
+     */
     class RenderTarget final : public Asset {
       public:
-        RenderTarget();
+        static constexpr std::string_view kTypeName = "RenderTarget";
+
+        // the window
+        RenderTarget() = default;
+        explicit RenderTarget(std::shared_ptr<neuron::Texture> color, std::shared_ptr<neuron::Texture> depth = nullptr);
         ~RenderTarget() override = default;
 
+        [[nodiscard]] inline bool isWindow() const { return m_Color == nullptr; }
+
+        [[nodiscard]] inline const std::shared_ptr<neuron::Texture> &color() const { return m_Color; }
+        [[nodiscard]] inline const std::shared_ptr<neuron::Texture> &depth() const { return m_Depth; }
+
+        [[nodiscard]] std::size_t gpuBytes() const override;
+
       private:
-        AssetHandle<Framebuffer> m_Framebuffer;
+        std::shared_ptr<neuron::Texture> m_Color;
+        std::shared_ptr<neuron::Texture> m_Depth;
     };
 
-} // namespace neuron::assets
+} // namespace neuron::asset
@@ -0,0 +1,114 @@
+#include "residency.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <ranges>
+#include <stdexcept>
+
+namespace neuron::asset {
+    ResidencyManager::ResidencyManager(AsyncLoader &loader) : m_Loader(loader) {
+    }
+
+    void ResidencyManager::manageMesh(const AssetHandle<Mesh> handle, const std::filesystem::path &path) {
+        manage<Mesh>(
+            handle, [placeholder = m_Loader.placeholderMesh()] { return std::make_unique<Mesh>(placeholder); }, [this, handle, path] { return m_Loader.reloadMesh(handle, path); });
+    }
+
+    void ResidencyManager::update() {
+        const uint64_t frame = FrameFences::global().recordingFrame();
+
+        for (auto it = m_Entries.begin(); it != m_Entries.end();) {
+            Entry         &entry    = it->second;
+            const uint64_t lastUsed = entry.lastUsed();
+            if (lastUsed == 0) {
+                it = m_Entries.erase(it); // released
+                continue;
+            }
+
+            if (entry.loading && entry.loading->wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+                const LoadState state = entry.loading->get();
+                entry.loading.reset();
+
+                if (state == LoadState::Failed) {
+                    // stays an evicted placeholder, the loader has the error. It may well have been a passing I/O error, so it's tried again on a later
+                    // use, just not every frame
+                    m_Stats.failedLoads++;
+                    entry.evictedFrame = frame;
+                    entry.retryFrame   = frame + (kRetryFrames << std::min(entry.failures, kMaxRetryDoublings));
+                    entry.failures++;
+                } else {
+                    entry.evicted  = false; // Superseded means a newer load is bringing it back anyway
+                    entry.failures = 0;
+                }
+            } else if (entry.evicted && !entry.loading && lastUsed > entry.evictedFrame && frame >= entry.retryFrame) {
+                entry.loading = entry.reload();
+                m_Stats.reloads++;
+            }
+            ++it;
+        }
+
+        for (const auto &[type, budget] : m_Budgets) {
+            evictOverBudget(type, budget, frame);
+        }
+
+        m_Stats.managed   = static_cast<uint32_t>(m_Entries.size());
+        m_Stats.evicted   = 0;
+        m_Stats.reloading = 0;
+        for (const auto &entry : m_Entries | std::views::values) {
+            if (entry.loading) {
+                m_Stats.reloading++;
+            } else if (entry.evicted) {
+                m_Stats.evicted++;
+            }
+        }
+        m_Stats.resident = m_Stats.managed - m_Stats.evicted - m_Stats.reloading;
+    }
+
+    std::vector<std::pair<AssetMemoryStats, AssetBudget>> ResidencyManager::budgets() const {
+        std::vector<std::pair<AssetMemoryStats, AssetBudget>> budgets;
+        for (const auto &budget : m_Budgets | std::views::values) {
+            budgets.emplace_back(budget.usage(), budget.limits);
+        }
+        return budgets;
+    }
+
+    void ResidencyManager::evictOverBudget(const std::type_index type, const Budget &budget, const uint64_t frame) {
+        AssetMemoryStats usage = budget.usage();
+        const auto       over  = [&] { return usage.cpuBytes > budget.limits.cpuBytes || usage.gpuBytes > budget.limits.gpuBytes; };
+        if (!over()) {
+            return;
+        }
+
+        std::vector<std::pair<uint64_t, Entry *>> candidates;
+        for (auto &entry : m_Entries | std::views::values) {
+            if (entry.type != type || entry.evicted || entry.loading || entry.busy() || entry.referenced()) {
+                continue;
+            }
+
+            if (const uint64_t lastUsed = entry.lastUsed(); lastUsed != 0 && lastUsed + m_GraceFrames < frame) {
+                candidates.emplace_back(lastUsed, &entry);
+            }
+        }
+        std::ranges::sort(candidates, {}, &std::pair<uint64_t, Entry *>::first);
+
+        for (const auto &[lastUsed, entry] : candidates) {
+            if (!over()) {
+                break;
+            }
+
+            const std::size_t bytes = entry->bytes();
+            try {
+                entry->evict();
+            } catch (const std::out_of_range &) {
+                continue; // released since the scan, the next update drops it
+            }
+
+            entry->evicted      = true;
+            entry->evictedFrame = frame;
+            m_Stats.evictions++;
+            m_Stats.evictedBytes += bytes;
+
+            usage = budget.usage();
+        }
+    }
+} // namespace neuron::asset
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "neuron/asset/async_loader.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <optional>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+namespace neuron::asset {
+
+    // live bytes of one asset type, replaced assets waiting for the GPU don't count
+    struct AssetBudget {
+        std::size_t cpuBytes = SIZE_MAX;
+        std::size_t gpuBytes = SIZE_MAX;
+    };
+
+    struct ResidencyStats {
+        uint32_t managed   = 0;
+        uint32_t resident  = 0;
+        uint32_t evicted   = 0;
+        uint32_t reloading = 0;
+
+        uint64_t evictions    = 0;
+        uint64_t reloads      = 0;
+        uint64_t failedLoads  = 0;
+        uint64_t evictedBytes = 0;
+    };
+
+    /**
+     * Keeps asset types under their memory budgets. When a type is over budget, the managed assets of that type which haven't been used for a while and that
+     * no StrongAssetHandle holds are evicted, least recently used first. An evicted handle stays valid and shows a placeholder, and the asset is loaded again
+     * through the AsyncLoader as soon as something looks it up. A reload that fails is tried again on a later use, backing off further after every failure.
+     * Use is tracked by the frame stamp AssetTable keeps per slot, so the draw path doesn't pay anything extra.
+     */
+    class ResidencyManager {
+      public:
+        using Reload = std::function<std::shared_future<LoadState>()>;
+
+        explicit ResidencyManager(AsyncLoader &loader);
+
+        ResidencyManager(const ResidencyManager &other)            = delete;
+        ResidencyManager &operator=(const ResidencyManager &other) = delete;
+
+        template <std::derived_from<Asset> T>
+        void setBudget(const AssetBudget budget) {
+            m_Budgets.insert_or_assign(typeid(T), Budget{budget, [] { return assetTable<T>()->memoryStats(); }});
+        }
+
+        // the mesh is reloaded from `path` after an eviction. Managing a handle again replaces how it's reloaded
+        void manageMesh(AssetHandle<Mesh> handle, const std::filesystem::path &path);
+
+        template <std::derived_from<Asset> T>
+        void manage(const AssetHandle<T> handle, std::function<std::unique_ptr<T>()> placeholder, Reload reload) {
+            Entry entry{
+                typeid(T),
+                [handle] { return assetTable<T>()->lastUsed(handle); },
+                [handle] {
+                    EpochGuard guard;
+                    const T   *asset = assetTable<T>()->peekAsset(handle);
+                    return asset == nullptr ? std::size_t(0) : asset->cpuBytes() + asset->gpuBytes();
+                },
+                [handle, placeholder = std::move(placeholder)] { assetTable<T>()->replaceAsset(handle, placeholder()); },
+                [this, handle] { return m_Loader.state(handle) == LoadState::Loading; },
+                [handle] { return assetTable<T>()->refCount(handle) > 0; },
+                std::move(reload),
+            };
+
+            if (const auto it = m_Entries.find(assetKey(handle)); it != m_Entries.end()) {
+                entry.evicted      = it->second.evicted;
+                entry.evictedFrame = it->second.evictedFrame;
+                entry.failures     = it->second.failures;
+                entry.retryFrame   = it->second.retryFrame;
+                entry.loading      = std::move(it->second.loading);
+            }
+            m_Entries.insert_or_assign(assetKey(handle), std::move(entry));
+        }
+
+        template <std::derived_from<Asset> T>
+        void unmanage(const AssetHandle<T> handle) {
+            m_Entries.erase(assetKey(handle));
+        }
+
+        // Evicts and reloads. GL thread only, once per frame after AsyncLoader::update
+        void update();
+
+        // unused for this many frames before an asset can be evicted
+        inline void setGraceFrames(const uint32_t frames) { m_GraceFrames = frames; }
+
+        [[nodiscard]] std::vector<std::pair<AssetMemoryStats, AssetBudget>> budgets() const;
+
+        [[nodiscard]] inline const ResidencyStats &stats() const { return m_Stats; }
+
+      private:
+        // after a failed reload the next try waits this long, doubling with every failure in a row up to 2^kMaxRetryDoublings times as long
+        static constexpr uint64_t kRetryFrames       = 60;
+        static constexpr uint32_t kMaxRetryDoublings = 6;
+
+        struct Budget {
+            AssetBudget                       limits;
+            std::function<AssetMemoryStats()> usage;
+        };
+
+        struct Entry {
+            std::type_index type;
+
+            std::function<uint64_t()>    lastUsed; // 0 once the handle is stale
+            std::function<std::size_t()> bytes;
+            std::function<void()>        evict;
+            std::function<bool()>        busy;       // the loader is working on the handle for someone else
+            std::function<bool()>        referenced; // held by a StrongAssetHandle
+            Reload                       reload;
+
+            bool                                         evicted      = false;
+            uint64_t                                     evictedFrame = 0;
+            uint32_t                                     failures     = 0; // reloads that failed in a row
+            uint64_t                                     retryFrame   = 0; // no reload before this frame
+            std::optional<std::shared_future<LoadState>> loading      = std::nullopt;
+        };
+
+        void evictOverBudget(std::type_index type, const Budget &budget, uint64_t frame);
+
+        AsyncLoader &m_Loader;
+
+        std::unordered_map<std::type_index, Budget>       m_Budgets;
+        std::unordered_map<AssetKey, Entry, AssetKeyHash> m_Entries;
+        uint32_t                                          m_GraceFrames = 120;
+        ResidencyStats                                    m_Stats;
+    };
+
+} // namespace neuron::asset
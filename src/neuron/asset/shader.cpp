@@ -4,10 +4,25 @@
 
 #include "shader.hpp"
 
+#include "neuron/program_cache.hpp"
+
 
 namespace neuron::asset {
     std::unique_ptr<Shader> Shader::create(const std::vector<std::shared_ptr<neuron::ShaderModule>> &modules) {
         return std::make_unique<Shader>(std::make_shared<neuron::Shader>(modules));
     }
+
+    std::unique_ptr<Shader> Shader::fromSources(const std::vector<std::pair<std::string, neuron::ShaderModule::Type>> &sources) {
+        return std::make_unique<Shader>(ProgramBinaryCache::global().load(sources));
+    }
+
+    std::unique_ptr<Shader> Shader::fromSpirv(const std::vector<std::pair<std::vector<uint32_t>, neuron::ShaderModule::Type>> &modules,
+                                              const neuron::SpecializationConstants &constants) {
+        std::vector<std::shared_ptr<neuron::ShaderModule>> specialized;
+        for (const auto &[code, type] : modules) {
+            specialized.push_back(std::make_shared<neuron::ShaderModule>(code, type, constants));
+        }
+        return create(specialized);
+    }
 } // asset
 // neuron
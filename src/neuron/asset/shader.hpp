@@ -7,6 +7,8 @@
 namespace neuron::asset {
     class Shader : public Asset {
     public:
+        static constexpr std::string_view kTypeName = "Shader";
+
         inline explicit Shader(std::shared_ptr<neuron::Shader> shader) : m_Shader(std::move(shader)) {
         }
 
@@ -16,6 +18,13 @@ namespace neuron::asset {
 
         static std::unique_ptr<Shader> create(const std::vector<std::shared_ptr<neuron::ShaderModule>>& modules);
 
+        // compiles and links already loaded sources, or loads the program from the binary cache. GL thread only
+        static std::unique_ptr<Shader> fromSources(const std::vector<std::pair<std::string, neuron::ShaderModule::Type>>& sources);
+
+        // specializes and links already loaded SPIR-V modules. GL thread only
+        static std::unique_ptr<Shader> fromSpirv(const std::vector<std::pair<std::vector<uint32_t>, neuron::ShaderModule::Type>>& modules,
+                                                 const neuron::SpecializationConstants& constants);
+
     private:
         std::shared_ptr<neuron::Shader> m_Shader;
     };
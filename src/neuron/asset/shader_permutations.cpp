@@ -0,0 +1,63 @@
+#include "shader_permutations.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace neuron::asset {
+    ShaderPermutations::ShaderPermutations(AsyncLoader &loader, AsyncLoader::ShaderSources sources, std::vector<std::string> features, const AssetHandle<Shader> placeholder,
+                                           HotReloader *reloader, AsyncLoader::Callback callback)
+        : m_Loader(loader), m_Reloader(reloader), m_Sources(std::move(sources)), m_Features(std::move(features)), m_Placeholder(placeholder),
+          m_Callback(std::move(callback)) {
+        if (m_Features.size() > kMaxFeatures) {
+            throw std::invalid_argument("A shader can have at most " + std::to_string(kMaxFeatures) + " features");
+        }
+        m_ValidBits = m_Features.size() == kMaxFeatures ? ~Mask(0) : (Mask(1) << m_Features.size()) - 1;
+    }
+
+    ShaderPermutations::Mask ShaderPermutations::feature(const std::string_view name) const {
+        const auto it = std::ranges::find(m_Features, name);
+        if (it == m_Features.end()) {
+            throw std::invalid_argument("Unknown shader feature " + std::string(name));
+        }
+        return Mask(1) << (it - m_Features.begin());
+    }
+
+    AssetHandle<Shader> ShaderPermutations::get(Mask mask) {
+        mask &= m_ValidBits;
+        if (const auto it = m_Variants.find(mask); it != m_Variants.end()) {
+            return it->second;
+        }
+
+        const auto handle = assetTable<Shader>()->initAsset(std::make_unique<Shader>(m_Placeholder.getFromGlobal()->object()));
+        m_Variants.emplace(mask, handle);
+
+        if (m_Reloader != nullptr) {
+            m_Reloader->watchShader(handle, m_Sources, m_Callback, defines(mask));
+            m_Reloader->reload(handle);
+        } else {
+            m_Loader.reloadShader(handle, m_Sources, m_Callback, defines(mask));
+        }
+        return handle;
+    }
+
+    void ShaderPermutations::reload() {
+        for (const auto &[mask, handle] : m_Variants) {
+            if (m_Reloader != nullptr) {
+                m_Reloader->reload(handle);
+            } else {
+                m_Loader.reloadShader(handle, m_Sources, m_Callback, defines(mask));
+            }
+        }
+    }
+
+    ShaderDefines ShaderPermutations::defines(const Mask mask) const {
+        ShaderDefines defines;
+        for (std::size_t i = 0; i < m_Features.size(); i++) {
+            if ((mask & (Mask(1) << i)) != 0) {
+                defines.emplace_back(m_Features[i], "");
+            }
+        }
+        return defines;
+    }
+} // namespace neuron::asset
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "neuron/asset/async_loader.hpp"
+#include "neuron/asset/hot_reload.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace neuron::asset {
+
+    /**
+     * One shader with optional features, each of which is a #define the source can test for. A variant is picked with a bitmask where bit i turns on feature i,
+     * and only the variants that are asked for get compiled: the first get() for a mask hands out a handle showing the placeholder and compiles that variant
+     * through the AsyncLoader, so a feature combination that's never drawn costs nothing. Every variant goes through the program binary cache on its own.
+     * Variant handles are never released, like every other handle the AsyncLoader hands out.
+     */
+    class ShaderPermutations {
+      public:
+        using Mask = uint64_t;
+
+        static constexpr std::size_t kMaxFeatures = 64;
+
+        // New variants are watched by `reloader` if there is one. `callback` is called for every variant that finishes loading
+        ShaderPermutations(AsyncLoader &loader, AsyncLoader::ShaderSources sources, std::vector<std::string> features, AssetHandle<Shader> placeholder,
+                           HotReloader *reloader = nullptr, AsyncLoader::Callback callback = {});
+
+        ShaderPermutations(const ShaderPermutations &other)            = delete;
+        ShaderPermutations &operator=(const ShaderPermutations &other) = delete;
+
+        // the bit of a feature, throws for names that weren't passed to the constructor
+        [[nodiscard]] Mask feature(std::string_view name) const;
+
+        // Bits of features that don't exist are ignored. GL thread only
+        [[nodiscard]] AssetHandle<Shader> get(Mask mask);
+
+        // recompiles every variant that was asked for so far
+        void reload();
+
+        // the defines a variant is compiled with
+        [[nodiscard]] ShaderDefines defines(Mask mask) const;
+
+        [[nodiscard]] inline std::size_t variantCount() const { return m_Variants.size(); }
+
+      private:
+        AsyncLoader               &m_Loader;
+        HotReloader               *m_Reloader;
+        AsyncLoader::ShaderSources m_Sources;
+        std::vector<std::string>   m_Features;
+        AssetHandle<Shader>        m_Placeholder;
+        AsyncLoader::Callback      m_Callback;
+        Mask                       m_ValidBits = 0;
+
+        std::unordered_map<Mask, AssetHandle<Shader>> m_Variants;
+    };
+
+} // namespace neuron::asset
@@ -0,0 +1,25 @@
+#pragma once
+#include "asset.hpp"
+#include "neuron/glwrap.hpp"
+
+#include <memory>
+
+namespace neuron::asset {
+
+    class Texture final : public Asset {
+    public:
+        static constexpr std::string_view kTypeName = "Texture";
+
+        explicit Texture(std::shared_ptr<neuron::Texture> texture) : m_Texture(std::move(texture)) {}
+        ~Texture() override = default;
+
+        [[nodiscard]] inline std::shared_ptr<neuron::Texture> object() const { return m_Texture; }
+
+        // the whole storage, streamed textures count their levels before they arrive
+        [[nodiscard]] std::size_t gpuBytes() const override { return m_Texture ? m_Texture->byteSize() : 0; }
+
+    private:
+        std::shared_ptr<neuron::Texture> m_Texture;
+    };
+
+}
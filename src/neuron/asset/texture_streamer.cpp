@@ -0,0 +1,266 @@
+#include "texture_streamer.hpp"
+
+#include "neuron/asset/import_cache.hpp"
+#include "neuron/image.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <queue>
+#include <ranges>
+
+namespace neuron::asset {
+    TextureStreamer::TextureStreamer(ThreadPool &pool) : TextureStreamer(Settings{}, pool) {
+    }
+
+    TextureStreamer::TextureStreamer(const Settings settings, ThreadPool &pool) : m_Settings(settings), m_Pool(pool), m_Ring(settings.stagingBytes) {
+        constexpr uint8_t grey[4] = {128, 128, 128, 255};
+        m_Placeholder             = neuron::Texture::create2d(1, 1, neuron::Texture::Format::RGBA, neuron::Texture::InternalFormat::RGBA8,
+                                                              neuron::Texture::DataType::UnsignedByte, grey);
+    }
+
+    TextureStreamer::~TextureStreamer() {
+        // workers write into the ring, which has to stay mapped until they're done
+        for (const auto &stream : m_Streams) {
+            if (stream->decoding.valid()) {
+                stream->decoding.wait();
+            }
+        }
+    }
+
+    AssetHandle<Texture> TextureStreamer::load(const std::filesystem::path &path, const float priority, const bool srgb, Callback callback) {
+        const auto handle = assetTable<Texture>()->initAsset(std::make_unique<Texture>(m_Placeholder));
+
+        auto stream      = std::make_unique<Stream>();
+        stream->handle   = handle;
+        stream->priority = priority;
+        stream->srgb     = srgb;
+        stream->callback = std::move(callback);
+        stream->decoding = m_Pool.submit([this, path, srgb] { return decode(path, srgb); });
+        m_Streams.push_back(std::move(stream));
+        return handle;
+    }
+
+    void TextureStreamer::setPriority(const AssetHandle<Texture> handle, const float priority) {
+        for (const auto &stream : m_Streams) {
+            if (stream->handle == handle) {
+                stream->priority = priority;
+            }
+        }
+    }
+
+    void TextureStreamer::update() {
+        const auto     start = std::chrono::steady_clock::now();
+        const uint64_t frame = m_Fences.recordingFrame();
+        m_Ring.reclaim(m_Fences.completedFrame());
+
+        for (const auto &stream : m_Streams) {
+            if (!stream->decoding.valid() || stream->decoding.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                continue;
+            }
+
+            try {
+                auto decoded       = stream->decoding.get();
+                stream->levels     = std::move(decoded.levels);
+                stream->compressed = std::move(decoded.compressed);
+            } catch (const std::exception &e) {
+                finish(*stream, LoadState::Failed, e.what());
+                continue;
+            }
+
+            if (stream->compressed) {
+                stream->next = 0;
+                continue;
+            }
+
+            const auto format = stream->srgb ? neuron::Texture::InternalFormat::SRGB8_ALPHA8 : neuron::Texture::InternalFormat::RGBA8;
+            stream->texture   = std::make_shared<neuron::Texture>(neuron::Texture::Type::Texture2D);
+            stream->texture->storage2d(static_cast<int>(stream->levels.size()), format, stream->levels.front().width, stream->levels.front().height);
+            stream->next = static_cast<int>(stream->levels.size()) - 1;
+        }
+
+        // Staged levels go first, they're what frees up the ring. Then the cheapest per unit of priority
+        using Candidate = std::pair<std::pair<bool, float>, Stream *>;
+        const auto cost = [](const Stream &stream) {
+            const Level &level = stream.levels[stream.next];
+            const float  bytes = static_cast<float>(level.width) * static_cast<float>(level.height) * 4.0f;
+            return std::pair(!level.staged.has_value(), bytes / std::max(stream.priority, 1e-6f));
+        };
+        std::priority_queue<Candidate, std::vector<Candidate>, std::greater<>> candidates;
+        for (const auto &stream : m_Streams) {
+            if (stream->next >= 0 && !stream->compressed) {
+                candidates.emplace(cost(*stream), stream.get());
+            }
+        }
+
+        // compressed files have nothing to stage or stream, they only count against the budget
+        std::size_t uploaded = 0;
+        for (const auto &stream : m_Streams) {
+            if (!stream->compressed || stream->next < 0) {
+                continue;
+            }
+
+            const std::size_t bytes = stream->compressed->info().dataBytes();
+            if (uploaded > 0 && uploaded + bytes > m_Settings.frameBudgetBytes) {
+                break;
+            }
+            uploadCompressed(*stream);
+            uploaded += bytes;
+        }
+
+        m_Ring.buffer().bind(Buffer::Target::PixelUnpack);
+        while (!candidates.empty()) {
+            Stream *stream = candidates.top().second;
+            candidates.pop();
+
+            const Level      &level = stream->levels[stream->next];
+            const std::size_t bytes = level.staged ? level.staged->size : level.pixels.size();
+            if (uploaded > 0 && uploaded + bytes > m_Settings.frameBudgetBytes) {
+                break;
+            }
+            if (!upload(*stream, frame)) {
+                continue; // no room in the ring, it'll be back next frame
+            }
+
+            uploaded += bytes;
+            if (stream->next >= 0) {
+                candidates.emplace(cost(*stream), stream);
+            }
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        std::erase_if(m_Streams, [](const std::unique_ptr<Stream> &stream) { return !stream->decoding.valid() && stream->next < 0; });
+
+        m_Stats.frameBytes = uploaded;
+        m_Stats.frameMs    = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    TextureStreamingStats TextureStreamer::stats() const {
+        TextureStreamingStats stats = m_Stats;
+        for (const auto &stream : m_Streams) {
+            if (stream->decoding.valid()) {
+                stats.decoding++;
+            } else if (stream->next >= 0) {
+                stats.streaming++;
+            }
+        }
+        stats.stagingUsed     = m_Ring.used();
+        stats.stagingCapacity = m_Ring.capacity();
+        return stats;
+    }
+
+    TextureStreamer::Decoded TextureStreamer::decode(const std::filesystem::path &path, const bool srgb) {
+        if (path.extension() == ".dds") {
+            return {{}, std::make_unique<DdsFile>(path, srgb)};
+        }
+        if (m_Settings.compression) {
+            return {{}, std::make_unique<DdsFile>(ImportCache::global().compressedTexture(path, *m_Settings.compression, srgb), srgb)};
+        }
+
+        std::vector<Level> levels;
+        for (auto &image : Image::load(path).mipChain(srgb)) {
+            levels.push_back({image.width, image.height, std::move(image.pixels), std::nullopt});
+        }
+
+        // coarsest first, in the order they'll be uploaded, stopping at the first that doesn't fit so the ring fills in upload order as well
+        for (auto &level : std::views::reverse(levels)) {
+            const auto allocation = m_Ring.allocate(level.pixels.size());
+            if (!allocation) {
+                break;
+            }
+
+            std::memcpy(allocation->data, level.pixels.data(), level.pixels.size());
+            level.staged = allocation;
+            level.pixels = {};
+        }
+        return {std::move(levels), nullptr};
+    }
+
+    void TextureStreamer::uploadCompressed(Stream &stream) {
+        try {
+            stream.texture = stream.compressed->upload();
+            assetTable<Texture>()->replaceAsset(stream.handle, std::make_unique<Texture>(stream.texture));
+        } catch (const std::out_of_range &) {
+            stream.compressed.reset();
+            finish(stream, LoadState::Superseded, {});
+            return;
+        }
+
+        m_Stats.uploadedLevels += stream.compressed->info().subresources.size();
+        m_Stats.uploadedBytes += stream.compressed->info().dataBytes();
+        stream.compressed.reset(); // unmaps the file
+        finish(stream, LoadState::Ready, {});
+    }
+
+    bool TextureStreamer::upload(Stream &stream, const uint64_t frame) {
+        Level &level = stream.levels[stream.next];
+
+        if (!level.staged) {
+            if (level.pixels.size() > m_Ring.capacity()) {
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                stream.texture->subImage2d(stream.next, 0, 0, level.width, level.height, neuron::Texture::Format::RGBA, neuron::Texture::DataType::UnsignedByte,
+                                           level.pixels.data());
+                m_Ring.buffer().bind(Buffer::Target::PixelUnpack);
+                m_Stats.directUploads++;
+            } else {
+                const auto allocation = m_Ring.allocate(level.pixels.size());
+                if (!allocation) {
+                    return false;
+                }
+
+                std::memcpy(allocation->data, level.pixels.data(), level.pixels.size());
+                level.staged = allocation;
+                m_Stats.lateStaged++;
+            }
+        }
+
+        if (level.staged) {
+            // with a buffer bound to GL_PIXEL_UNPACK_BUFFER the pointer is an offset into it
+            stream.texture->subImage2d(stream.next, 0, 0, level.width, level.height, neuron::Texture::Format::RGBA, neuron::Texture::DataType::UnsignedByte,
+                                       reinterpret_cast<const void *>(static_cast<uintptr_t>(level.staged->offset)));
+            m_Ring.release(*level.staged, frame);
+            level.staged.reset();
+        }
+
+        m_Stats.uploadedLevels++;
+        m_Stats.uploadedBytes += static_cast<uint64_t>(level.width) * static_cast<uint64_t>(level.height) * 4;
+        level.pixels = {};
+
+        stream.texture->setBaseLevel(stream.next);
+        if (stream.next == static_cast<int>(stream.levels.size()) - 1) {
+            try {
+                assetTable<Texture>()->replaceAsset(stream.handle, std::make_unique<Texture>(stream.texture));
+            } catch (const std::out_of_range &) {
+                // the handle was released while streaming, the rest of the levels can go
+                finish(stream, LoadState::Superseded, {});
+                return true;
+            }
+        }
+
+        if (--stream.next < 0) {
+            finish(stream, LoadState::Ready, {});
+        }
+        return true;
+    }
+
+    void TextureStreamer::finish(Stream &stream, const LoadState state, const std::string &error) {
+        // staged levels that will never be uploaded give their space back right away
+        for (auto &level : stream.levels) {
+            if (level.staged) {
+                m_Ring.release(*level.staged, 0);
+                level.staged.reset();
+            }
+        }
+
+        stream.next = -1;
+        if (state == LoadState::Ready) {
+            m_Stats.completed++;
+        } else if (state == LoadState::Failed) {
+            m_Stats.failed++;
+        }
+
+        if (stream.callback) {
+            stream.callback(state, error);
+        }
+    }
+} // namespace neuron::asset
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "neuron/asset/async_loader.hpp"
+#include "neuron/asset/texture.hpp"
+#include "neuron/dds.hpp"
+#include "neuron/frame_fences.hpp"
+#include "neuron/staging_ring.hpp"
+#include "neuron/thread_pool.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace neuron::asset {
+
+    struct TextureStreamingStats {
+        uint32_t decoding  = 0;
+        uint32_t streaming = 0; // decoded, with levels left to upload
+        uint64_t completed = 0;
+        uint64_t failed    = 0;
+
+        uint64_t uploadedLevels = 0;
+        uint64_t uploadedBytes  = 0;
+        uint64_t lateStaged     = 0; // levels copied into the ring on the GL thread because it was full when they were decoded
+        uint64_t directUploads  = 0; // levels larger than the whole ring, uploaded from client memory
+
+        std::size_t frameBytes = 0; // of the last update
+        double      frameMs    = 0.0;
+
+        std::size_t stagingUsed     = 0;
+        std::size_t stagingCapacity = 0;
+    };
+
+    /**
+     * Streams textures in without hitches. Images are decoded and their mip chain built on the thread pool, and the worker writes the levels straight into
+     * a persistently mapped StagingRing. update() uploads from the ring with glTextureSubImage2D, up to a byte budget per frame, and the ring space is reused once
+     * the frame's fence has passed. Levels arrive coarse to fine: a texture becomes visible as soon as its 1x1 level is in, and the base level is lowered as finer
+     * levels follow, so sampling never touches a level that isn't there yet. Cheap levels of important textures go first (bytes divided by priority).
+     * Block compressed .dds files skip all of that: they're mapped and validated on a worker and uploaded whole, straight from the mapping.
+     */
+    class TextureStreamer {
+      public:
+        using Callback = AsyncLoader::Callback;
+
+        struct Settings {
+            std::size_t stagingBytes     = 64ULL * 1024 * 1024;
+            std::size_t frameBudgetBytes = 8ULL * 1024 * 1024; // at least one level goes up every update, however big
+
+            // other images are block compressed into the ImportCache the first time they're loaded, and load as .dds from then on
+            std::optional<BcFormat> compression;
+        };
+
+        // GL thread, creates the staging ring and the placeholder
+        explicit TextureStreamer(ThreadPool &pool = ThreadPool::global());
+        explicit TextureStreamer(Settings settings, ThreadPool &pool = ThreadPool::global());
+        ~TextureStreamer();
+
+        TextureStreamer(const TextureStreamer &other)            = delete;
+        TextureStreamer &operator=(const TextureStreamer &other) = delete;
+
+        // The handle shows a grey 1x1 texture until the first level is in. The callback runs once every level is, or when the load fails
+        [[nodiscard]] AssetHandle<Texture> load(const std::filesystem::path &path, float priority = 1.0f, bool srgb = true, Callback callback = {});
+
+        // higher goes first, e.g. the screen area the texture covers
+        void setPriority(AssetHandle<Texture> handle, float priority);
+
+        // Uploads staged levels within the frame budget and swaps in textures whose first level arrived. GL thread, once per frame
+        void update();
+
+        [[nodiscard]] TextureStreamingStats stats() const;
+
+        [[nodiscard]] inline std::shared_ptr<neuron::Texture> placeholder() const { return m_Placeholder; }
+
+      private:
+        struct Level {
+            int                                    width;
+            int                                    height;
+            std::vector<uint8_t>                   pixels; // emptied once staged
+            std::optional<StagingRing::Allocation> staged;
+        };
+
+        struct Decoded {
+            std::vector<Level>       levels; // finest first
+            std::unique_ptr<DdsFile> compressed;
+        };
+
+        struct Stream {
+            AssetHandle<Texture>             handle;
+            float                            priority;
+            bool                             srgb;
+            Callback                         callback;
+            std::future<Decoded>             decoding;
+            std::vector<Level>               levels;
+            std::unique_ptr<DdsFile>         compressed;
+            std::shared_ptr<neuron::Texture> texture;
+            int                              next = -1; // the level to upload next, counting down to 0
+        };
+
+        // Runs on a worker: decodes, builds the mips and stages the coarsest levels, as many as fit in the ring
+        Decoded decode(const std::filesystem::path &path, bool srgb);
+
+        void uploadCompressed(Stream &stream);
+
+        // false if the ring has no room for the level right now
+        bool upload(Stream &stream, uint64_t frame);
+
+        void finish(Stream &stream, LoadState state, const std::string &error);
+
+        Settings           m_Settings;
+        ThreadPool        &m_Pool;
+        const FrameFences &m_Fences = FrameFences::global();
+
+        StagingRing                      m_Ring;
+        std::shared_ptr<neuron::Texture> m_Placeholder;
+
+        std::vector<std::unique_ptr<Stream>> m_Streams;
+        TextureStreamingStats                m_Stats;
+    };
+
+} // namespace neuron::asset
@@ -0,0 +1,657 @@
+#include "bc_encoder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <future>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define NEURON_BC_SSE 1
+#endif
+
+/*
+ * Block layouts (little endian, texel i is x = i % 4, y = i / 4):
+ *
+ *   BC1 colour  u16 endpoint 0, u16 endpoint 1 (both RGB565), then 2 bit indices. Endpoint 0 > endpoint 1 selects the 4 colour mode, the only one written
+ *   BC4 channel u8 endpoint 0, u8 endpoint 1, then 3 bit indices. Endpoint 0 > endpoint 1 selects 8 interpolated values, the only mode written
+ *   BC3         a BC4 block for alpha, then a BC1 block for colour
+ *   BC5         a BC4 block for red, then one for green
+ *   BC7 mode 6  7 bits of mode (0000001), RGBA endpoints as 7 bits each (R0 R1 G0 G1 B0 B1 A0 A1), one p-bit per endpoint as the low bit of all its channels,
+ *               then 4 bit indices except for texel 0, which has 3 bits and an implied top bit of 0
+ */
+
+namespace neuron {
+    namespace {
+        constexpr int kTexels = 16;
+
+        using Vec4 = std::array<float, 4>;
+
+        // which channels an encoding step looks at
+        constexpr Vec4 kRgb  = {1.0f, 1.0f, 1.0f, 0.0f};
+        constexpr Vec4 kRgba = {1.0f, 1.0f, 1.0f, 1.0f};
+
+        // where each index sits between endpoint 0 and endpoint 1
+        constexpr float kBc1Weights[4]   = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+        constexpr float kBc4Weights[8]   = {0.0f, 1.0f, 1.0f / 7.0f, 2.0f / 7.0f, 3.0f / 7.0f, 4.0f / 7.0f, 5.0f / 7.0f, 6.0f / 7.0f};
+        constexpr int   kBc7Weights[16]  = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+        constexpr int   kBc7Mode6        = 0x40;
+        constexpr int   kRefitIterations = 2;
+
+        // one 4x4 block as floats, channel major so four texels fill a vector
+        struct Block {
+            alignas(16) float c[4][kTexels];
+        };
+
+        struct Palette {
+            float entries[16][4] = {};
+            int   size           = 0;
+        };
+
+        class BitWriter {
+          public:
+            explicit BitWriter(std::byte *out) : m_Out(out) {}
+
+            // expects the output to be zeroed
+            void write(const uint32_t value, const int bits) {
+                for (int i = 0; i < bits; i++, m_Bit++) {
+                    if ((value >> i & 1) != 0) {
+                        m_Out[m_Bit / 8] |= static_cast<std::byte>(1 << m_Bit % 8);
+                    }
+                }
+            }
+
+          private:
+            std::byte *m_Out;
+            int        m_Bit = 0;
+        };
+
+        class BitReader {
+          public:
+            explicit BitReader(const std::byte *in) : m_In(in) {}
+
+            uint32_t read(const int bits) {
+                uint32_t value = 0;
+                for (int i = 0; i < bits; i++, m_Bit++) {
+                    value |= static_cast<uint32_t>(std::to_integer<int>(m_In[m_Bit / 8]) >> m_Bit % 8 & 1) << i;
+                }
+                return value;
+            }
+
+          private:
+            const std::byte *m_In;
+            int              m_Bit = 0;
+        };
+
+        Block fetch(const Image &image, const int bx, const int by) {
+            Block block;
+            for (int i = 0; i < kTexels; i++) {
+                const int      x     = std::min(bx * 4 + i % 4, image.width - 1);
+                const int      y     = std::min(by * 4 + i / 4, image.height - 1);
+                const uint8_t *texel = &image.pixels[(static_cast<std::size_t>(y) * image.width + x) * 4];
+                for (int c = 0; c < 4; c++) {
+                    block.c[c][i] = texel[c];
+                }
+            }
+            return block;
+        }
+
+        float clampUnorm(const float value) {
+            return std::clamp(value, 0.0f, 255.0f);
+        }
+
+        // The nearest palette entry for every texel, by squared distance over the channels with a non zero weight. Returns the summed error
+        float nearest(const Block &block, const Palette &palette, const Vec4 &weights, uint8_t (&indices)[kTexels]) {
+            alignas(16) float errors[kTexels];
+            alignas(16) float chosen[kTexels];
+#ifdef NEURON_BC_SSE
+            // four texels at a time, one channel per vector
+            __m128 best[4], bestIndex[4], weight[4];
+            for (int q = 0; q < 4; q++) {
+                best[q]      = _mm_set1_ps(FLT_MAX);
+                bestIndex[q] = _mm_setzero_ps();
+                weight[q]    = _mm_set1_ps(weights[q]);
+            }
+
+            for (int e = 0; e < palette.size; e++) {
+                const __m128 index    = _mm_set1_ps(static_cast<float>(e));
+                const __m128 entry[4] = {_mm_set1_ps(palette.entries[e][0]), _mm_set1_ps(palette.entries[e][1]), _mm_set1_ps(palette.entries[e][2]),
+                                         _mm_set1_ps(palette.entries[e][3])};
+                for (int q = 0; q < 4; q++) {
+                    __m128 distance = _mm_setzero_ps();
+                    for (int c = 0; c < 4; c++) {
+                        const __m128 d = _mm_sub_ps(_mm_load_ps(&block.c[c][q * 4]), entry[c]);
+                        distance       = _mm_add_ps(distance, _mm_mul_ps(_mm_mul_ps(d, d), weight[c]));
+                    }
+
+                    const __m128 closer = _mm_cmplt_ps(distance, best[q]);
+                    best[q]             = _mm_min_ps(distance, best[q]);
+                    bestIndex[q]        = _mm_or_ps(_mm_and_ps(closer, index), _mm_andnot_ps(closer, bestIndex[q]));
+                }
+            }
+
+            for (int q = 0; q < 4; q++) {
+                _mm_store_ps(errors + q * 4, best[q]);
+                _mm_store_ps(chosen + q * 4, bestIndex[q]);
+            }
+#else
+            for (int i = 0; i < kTexels; i++) {
+                errors[i] = FLT_MAX;
+                chosen[i] = 0.0f;
+                for (int e = 0; e < palette.size; e++) {
+                    float distance = 0.0f;
+                    for (int c = 0; c < 4; c++) {
+                        const float d = block.c[c][i] - palette.entries[e][c];
+                        distance += d * d * weights[c];
+                    }
+                    if (distance < errors[i]) {
+                        errors[i] = distance;
+                        chosen[i] = static_cast<float>(e);
+                    }
+                }
+            }
+#endif
+            float total = 0.0f;
+            for (int i = 0; i < kTexels; i++) {
+                indices[i] = static_cast<uint8_t>(chosen[i]);
+                total += errors[i];
+            }
+            return total;
+        }
+
+        // The ends of the line through the texels along their principal axis, at the outermost projections. Both are the mean for a flat block
+        std::pair<Vec4, Vec4> principalEndpoints(const Block &block, const Vec4 &weights) {
+            Vec4 mean{};
+            for (int c = 0; c < 4; c++) {
+                for (int i = 0; i < kTexels; i++) {
+                    mean[c] += block.c[c][i];
+                }
+                mean[c] /= kTexels;
+            }
+
+            float covariance[4][4] = {};
+            for (int i = 0; i < kTexels; i++) {
+                float d[4];
+                for (int c = 0; c < 4; c++) {
+                    d[c] = (block.c[c][i] - mean[c]) * weights[c];
+                }
+                for (int a = 0; a < 4; a++) {
+                    for (int b = 0; b < 4; b++) {
+                        covariance[a][b] += d[a] * d[b];
+                    }
+                }
+            }
+
+            // power iteration, which converges quickly enough for a 4x4 matrix
+            Vec4 axis = weights;
+            for (int iteration = 0; iteration < 8; iteration++) {
+                Vec4  next{};
+                float largest = 0.0f;
+                for (int a = 0; a < 4; a++) {
+                    for (int b = 0; b < 4; b++) {
+                        next[a] += covariance[a][b] * axis[b];
+                    }
+                    largest = std::max(largest, std::abs(next[a]));
+                }
+                if (largest < 1e-6f) {
+                    return {mean, mean};
+                }
+                for (int c = 0; c < 4; c++) {
+                    axis[c] = next[c] / largest;
+                }
+            }
+
+            const float length = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2] + axis[3] * axis[3]);
+            float       lowest = FLT_MAX, highest = -FLT_MAX;
+            for (int i = 0; i < kTexels; i++) {
+                float t = 0.0f;
+                for (int c = 0; c < 4; c++) {
+                    t += (block.c[c][i] - mean[c]) * axis[c] / length;
+                }
+                lowest  = std::min(lowest, t);
+                highest = std::max(highest, t);
+            }
+
+            Vec4 from, to;
+            for (int c = 0; c < 4; c++) {
+                from[c] = clampUnorm(mean[c] + axis[c] / length * lowest);
+                to[c]   = clampUnorm(mean[c] + axis[c] / length * highest);
+            }
+            return {from, to};
+        }
+
+        // Least squares endpoints for the indices already chosen, `weights` being where each index sits between them. false if the system is singular
+        bool refit(const Block &block, const uint8_t (&indices)[kTexels], const float *weights, Vec4 &e0, Vec4 &e1) {
+            float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+            Vec4  ax{}, bx{};
+            for (int i = 0; i < kTexels; i++) {
+                const float t = weights[indices[i]];
+                const float s = 1.0f - t;
+                aa += s * s;
+                ab += s * t;
+                bb += t * t;
+                for (int c = 0; c < 4; c++) {
+                    ax[c] += s * block.c[c][i];
+                    bx[c] += t * block.c[c][i];
+                }
+            }
+
+            const float determinant = aa * bb - ab * ab;
+            if (std::abs(determinant) < 1e-6f) {
+                return false;
+            }
+            for (int c = 0; c < 4; c++) {
+                e0[c] = clampUnorm((ax[c] * bb - bx[c] * ab) / determinant);
+                e1[c] = clampUnorm((bx[c] * aa - ax[c] * ab) / determinant);
+            }
+            return true;
+        }
+
+        uint16_t to565(const Vec4 &colour) {
+            const auto r = static_cast<uint16_t>(std::lround(colour[0] * 31.0f / 255.0f));
+            const auto g = static_cast<uint16_t>(std::lround(colour[1] * 63.0f / 255.0f));
+            const auto b = static_cast<uint16_t>(std::lround(colour[2] * 31.0f / 255.0f));
+            return static_cast<uint16_t>(r << 11 | g << 5 | b);
+        }
+
+        std::array<int, 3> from565(const uint16_t colour) {
+            const int r = colour >> 11, g = colour >> 5 & 63, b = colour & 31;
+            return {r << 3 | r >> 2, g << 2 | g >> 4, b << 3 | b >> 2};
+        }
+
+        // what a decoder makes of a BC1 block's endpoints, index 3 being transparent black in the 3 colour mode
+        std::array<std::array<int, 4>, 4> bc1Colours(const uint16_t c0, const uint16_t c1, const bool allowThreeColour) {
+            const auto a = from565(c0), b = from565(c1);
+
+            std::array<std::array<int, 4>, 4> colours{};
+            for (int c = 0; c < 3; c++) {
+                colours[0][c] = a[c];
+                colours[1][c] = b[c];
+                if (c0 > c1 || !allowThreeColour) {
+                    colours[2][c] = (2 * a[c] + b[c]) / 3;
+                    colours[3][c] = (a[c] + 2 * b[c]) / 3;
+                } else {
+                    colours[2][c] = (a[c] + b[c]) / 2;
+                }
+            }
+            colours[0][3] = colours[1][3] = colours[2][3] = 255;
+            colours[3][3]                                 = c0 > c1 || !allowThreeColour ? 255 : 0;
+            return colours;
+        }
+
+        int bc4Value(const int a0, const int a1, const int index) {
+            if (index < 2) {
+                return index == 0 ? a0 : a1;
+            }
+            if (a0 > a1) {
+                return ((8 - index) * a0 + (index - 1) * a1 + 3) / 7;
+            }
+            if (index < 6) {
+                return ((6 - index) * a0 + (index - 1) * a1 + 2) / 5;
+            }
+            return index == 6 ? 0 : 255;
+        }
+
+        int bc7Value(const int e0, const int e1, const int index) {
+            return ((64 - kBc7Weights[index]) * e0 + kBc7Weights[index] * e1 + 32) >> 6;
+        }
+
+        void encodeColour(const Block &block, std::byte *out) {
+            auto [e0, e1] = principalEndpoints(block, kRgb);
+
+            uint16_t best0 = 0, best1 = 0;
+            uint8_t  bestIndices[kTexels] = {};
+            float    bestError            = FLT_MAX;
+            for (int iteration = 0; iteration < kRefitIterations; iteration++) {
+                uint16_t c0 = to565(e0), c1 = to565(e1);
+                if (c0 < c1) {
+                    std::swap(c0, c1);
+                    std::swap(e0, e1);
+                }
+
+                // equal endpoints would select the 3 colour mode, which index 0 alone is fine with
+                const auto colours = bc1Colours(c0, c1, false);
+                Palette    palette;
+                palette.size = c0 == c1 ? 1 : 4;
+                for (int e = 0; e < palette.size; e++) {
+                    for (int c = 0; c < 3; c++) {
+                        palette.entries[e][c] = static_cast<float>(colours[e][c]);
+                    }
+                }
+
+                uint8_t     indices[kTexels];
+                const float error = nearest(block, palette, kRgb, indices);
+                if (error < bestError) {
+                    bestError = error;
+                    best0     = c0;
+                    best1     = c1;
+                    std::ranges::copy(indices, bestIndices);
+                }
+                if (c0 == c1 || !refit(block, indices, kBc1Weights, e0, e1)) {
+                    break;
+                }
+            }
+
+            BitWriter writer(out);
+            writer.write(best0, 16);
+            writer.write(best1, 16);
+            for (const uint8_t index : bestIndices) {
+                writer.write(index, 2);
+            }
+        }
+
+        void encodeChannel(const Block &block, const int channel, std::byte *out) {
+            Vec4 weights{};
+            weights[channel] = 1.0f;
+
+            Vec4 e0{}, e1{};
+            e0[channel] = *std::ranges::max_element(block.c[channel]);
+            e1[channel] = *std::ranges::min_element(block.c[channel]);
+
+            int     best0 = 0, best1 = 0;
+            uint8_t bestIndices[kTexels] = {};
+            float   bestError            = FLT_MAX;
+            for (int iteration = 0; iteration < kRefitIterations; iteration++) {
+                const int a0 = static_cast<int>(std::lround(e0[channel]));
+                const int a1 = static_cast<int>(std::lround(e1[channel]));
+                if (a0 <= a1 && iteration > 0) {
+                    break; // the refit crossed the endpoints over, which would switch modes
+                }
+
+                Palette palette;
+                palette.size = a0 > a1 ? 8 : 1;
+                for (int e = 0; e < palette.size; e++) {
+                    palette.entries[e][channel] = static_cast<float>(bc4Value(a0, a1, e));
+                }
+
+                uint8_t     indices[kTexels];
+                const float error = nearest(block, palette, weights, indices);
+                if (error < bestError) {
+                    bestError = error;
+                    best0     = a0;
+                    best1     = a1;
+                    std::ranges::copy(indices, bestIndices);
+                }
+                if (a0 <= a1 || !refit(block, indices, kBc4Weights, e0, e1)) {
+                    break;
+                }
+            }
+
+            BitWriter writer(out);
+            writer.write(best0, 8);
+            writer.write(best1, 8);
+            for (const uint8_t index : bestIndices) {
+                writer.write(index, 3);
+            }
+        }
+
+        void encodeBc7(const Block &block, std::byte *out) {
+            struct Candidate {
+                int     endpoints[2][4]  = {}; // 7 bits
+                int     pbits[2]         = {};
+                uint8_t indices[kTexels] = {};
+                float   error            = FLT_MAX;
+            };
+
+            float weights[16];
+            for (int i = 0; i < 16; i++) {
+                weights[i] = static_cast<float>(kBc7Weights[i]) / 64.0f;
+            }
+
+            auto [e0, e1] = principalEndpoints(block, kRgba);
+            Candidate best;
+            for (int iteration = 0; iteration < kRefitIterations; iteration++) {
+                const Candidate previous = best;
+
+                // the p-bits are shared by all channels of an endpoint, so all four combinations are worth a try
+                for (int p = 0; p < 4; p++) {
+                    Candidate candidate;
+                    candidate.pbits[0] = p & 1;
+                    candidate.pbits[1] = p >> 1;
+                    for (int c = 0; c < 4; c++) {
+                        candidate.endpoints[0][c] = std::clamp(static_cast<int>(std::lround((e0[c] - candidate.pbits[0]) / 2.0f)), 0, 127);
+                        candidate.endpoints[1][c] = std::clamp(static_cast<int>(std::lround((e1[c] - candidate.pbits[1]) / 2.0f)), 0, 127);
+                    }
+
+                    Palette palette;
+                    palette.size = 16;
+                    for (int e = 0; e < 16; e++) {
+                        for (int c = 0; c < 4; c++) {
+                            palette.entries[e][c] = static_cast<float>(
+                                bc7Value(candidate.endpoints[0][c] << 1 | candidate.pbits[0], candidate.endpoints[1][c] << 1 | candidate.pbits[1], e));
+                        }
+                    }
+
+                    candidate.error = nearest(block, palette, kRgba, candidate.indices);
+                    if (candidate.error < best.error) {
+                        best = candidate;
+                    }
+                }
+
+                if (best.error >= previous.error || !refit(block, best.indices, weights, e0, e1)) {
+                    break;
+                }
+            }
+
+            // texel 0 has no room for the top bit of its index, so it has to be clear
+            if (best.indices[0] >= 8) {
+                std::swap(best.endpoints[0], best.endpoints[1]);
+                std::swap(best.pbits[0], best.pbits[1]);
+                for (uint8_t &index : best.indices) {
+                    index = static_cast<uint8_t>(15 - index);
+                }
+            }
+
+            BitWriter writer(out);
+            writer.write(kBc7Mode6, 7);
+            for (int c = 0; c < 4; c++) {
+                writer.write(best.endpoints[0][c], 7);
+                writer.write(best.endpoints[1][c], 7);
+            }
+            writer.write(best.pbits[0], 1);
+            writer.write(best.pbits[1], 1);
+            for (int i = 0; i < kTexels; i++) {
+                writer.write(best.indices[i], i == 0 ? 3 : 4);
+            }
+        }
+
+        using Texels = uint8_t[kTexels][4];
+
+        void decodeColour(const std::byte *in, Texels &texels, const bool allowThreeColour) {
+            BitReader  reader(in);
+            const auto c0      = static_cast<uint16_t>(reader.read(16));
+            const auto c1      = static_cast<uint16_t>(reader.read(16));
+            const auto colours = bc1Colours(c0, c1, allowThreeColour);
+            for (auto &texel : texels) {
+                const auto &colour = colours[reader.read(2)];
+                for (int c = 0; c < 4; c++) {
+                    texel[c] = static_cast<uint8_t>(colour[c]);
+                }
+            }
+        }
+
+        void decodeChannel(const std::byte *in, const int channel, Texels &texels) {
+            BitReader reader(in);
+            const int a0 = static_cast<int>(reader.read(8));
+            const int a1 = static_cast<int>(reader.read(8));
+            for (auto &texel : texels) {
+                texel[channel] = static_cast<uint8_t>(bc4Value(a0, a1, static_cast<int>(reader.read(3))));
+            }
+        }
+
+        void decodeBc7(const std::byte *in, Texels &texels) {
+            BitReader reader(in);
+            if (reader.read(7) != kBc7Mode6) {
+                throw std::runtime_error("Only BC7 mode 6 blocks can be decoded");
+            }
+
+            int endpoints[2][4];
+            for (int c = 0; c < 4; c++) {
+                endpoints[0][c] = static_cast<int>(reader.read(7)) << 1;
+                endpoints[1][c] = static_cast<int>(reader.read(7)) << 1;
+            }
+            const int p0 = static_cast<int>(reader.read(1));
+            const int p1 = static_cast<int>(reader.read(1));
+
+            for (int i = 0; i < kTexels; i++) {
+                const int index = static_cast<int>(reader.read(i == 0 ? 3 : 4));
+                for (int c = 0; c < 4; c++) {
+                    texels[i][c] = static_cast<uint8_t>(bc7Value(endpoints[0][c] | p0, endpoints[1][c] | p1, index));
+                }
+            }
+        }
+    } // namespace
+
+    std::size_t BcImage::blockBytes(const BcFormat format) {
+        return format == BcFormat::BC1 || format == BcFormat::BC4 ? 8 : 16;
+    }
+
+    int BcImage::channels(const BcFormat format) {
+        switch (format) {
+        case BcFormat::BC1:
+            return 3;
+        case BcFormat::BC4:
+            return 1;
+        case BcFormat::BC5:
+            return 2;
+        default:
+            return 4;
+        }
+    }
+
+    std::string_view BcImage::name(const BcFormat format) {
+        constexpr std::string_view names[] = {"bc1", "bc3", "bc4", "bc5", "bc7"};
+        return names[static_cast<int>(format)];
+    }
+
+    std::optional<BcFormat> BcImage::parse(const std::string_view name) {
+        for (const BcFormat format : {BcFormat::BC1, BcFormat::BC3, BcFormat::BC4, BcFormat::BC5, BcFormat::BC7}) {
+            if (BcImage::name(format) == name) {
+                return format;
+            }
+        }
+        return std::nullopt;
+    }
+
+    BcImage BcImage::encode(const Image &image, const BcFormat format, ThreadPool *pool) {
+        if (image.width <= 0 || image.height <= 0 || image.pixels.size() != static_cast<std::size_t>(image.width) * static_cast<std::size_t>(image.height) * 4) {
+            throw std::runtime_error("Can't encode an empty or malformed image");
+        }
+
+        BcImage result;
+        result.format = format;
+        result.width  = image.width;
+        result.height = image.height;
+
+        const int         blocksX = (image.width + 3) / 4;
+        const int         blocksY = (image.height + 3) / 4;
+        const std::size_t bytes   = blockBytes(format);
+        result.blocks.resize(static_cast<std::size_t>(blocksX) * static_cast<std::size_t>(blocksY) * bytes);
+
+        const auto encodeRows = [&](const int first, const int last) {
+            for (int by = first; by < last; by++) {
+                for (int bx = 0; bx < blocksX; bx++) {
+                    const Block block = fetch(image, bx, by);
+                    std::byte  *out   = &result.blocks[(static_cast<std::size_t>(by) * blocksX + bx) * bytes];
+                    switch (format) {
+                    case BcFormat::BC1:
+                        encodeColour(block, out);
+                        break;
+                    case BcFormat::BC3:
+                        encodeChannel(block, 3, out);
+                        encodeColour(block, out + 8);
+                        break;
+                    case BcFormat::BC4:
+                        encodeChannel(block, 0, out);
+                        break;
+                    case BcFormat::BC5:
+                        encodeChannel(block, 0, out);
+                        encodeChannel(block, 1, out + 8);
+                        break;
+                    case BcFormat::BC7:
+                        encodeBc7(block, out);
+                        break;
+                    }
+                }
+            }
+        };
+
+        if (pool == nullptr || pool->threadCount() <= 1 || blocksY == 1) {
+            encodeRows(0, blocksY);
+            return result;
+        }
+
+        // a few jobs per worker, so rows that take longer even out
+        const int                      rowsPerJob = std::max(1, blocksY / (static_cast<int>(pool->threadCount()) * 4));
+        std::vector<std::future<void>> jobs;
+        for (int row = 0; row < blocksY; row += rowsPerJob) {
+            jobs.push_back(pool->submit([&encodeRows, row, rowsPerJob, blocksY] { encodeRows(row, std::min(row + rowsPerJob, blocksY)); }));
+        }
+
+        // every job refers to this frame, so all of them have to be done before anything is rethrown
+        for (auto &job : jobs) {
+            job.wait();
+        }
+        for (auto &job : jobs) {
+            job.get();
+        }
+        return result;
+    }
+
+    Image BcImage::decode() const {
+        const int blocksX = (width + 3) / 4;
+        const int blocksY = (height + 3) / 4;
+        if (blocks.size() != static_cast<std::size_t>(blocksX) * static_cast<std::size_t>(blocksY) * blockBytes(format)) {
+            throw std::runtime_error("Block data doesn't match the image size");
+        }
+
+        Image image;
+        image.width  = width;
+        image.height = height;
+        image.pixels.resize(static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * 4);
+
+        for (int by = 0; by < blocksY; by++) {
+            for (int bx = 0; bx < blocksX; bx++) {
+                const std::byte *in = &blocks[(static_cast<std::size_t>(by) * blocksX + bx) * blockBytes(format)];
+
+                Texels texels;
+                for (auto &texel : texels) {
+                    texel[0] = texel[1] = texel[2] = 0;
+                    texel[3]                       = 255;
+                }
+
+                switch (format) {
+                case BcFormat::BC1:
+                    decodeColour(in, texels, true);
+                    break;
+                case BcFormat::BC3:
+                    decodeColour(in + 8, texels, false);
+                    decodeChannel(in, 3, texels);
+                    break;
+                case BcFormat::BC4:
+                    decodeChannel(in, 0, texels);
+                    break;
+                case BcFormat::BC5:
+                    decodeChannel(in, 0, texels);
+                    decodeChannel(in + 8, 1, texels);
+                    break;
+                case BcFormat::BC7:
+                    decodeBc7(in, texels);
+                    break;
+                }
+
+                // the padding texels of edge blocks are dropped
+                for (int i = 0; i < kTexels; i++) {
+                    const int x = bx * 4 + i % 4, y = by * 4 + i / 4;
+                    if (x < width && y < height) {
+                        std::copy_n(texels[i], 4, &image.pixels[(static_cast<std::size_t>(y) * width + x) * 4]);
+                    }
+                }
+            }
+        }
+        return image;
+    }
+} // namespace neuron
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "neuron/image.hpp"
+#include "neuron/thread_pool.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace neuron {
+
+    enum class BcFormat {
+        BC1, // RGB, alpha is dropped
+        BC3, // RGBA
+        BC4, // R
+        BC5, // RG, for normal maps
+        BC7, // RGBA, better colour than BC1/BC3 for twice the size of BC1
+    };
+
+    // one level of a block compressed image, 4x4 blocks row by row
+    struct BcImage {
+        BcFormat               format = BcFormat::BC7;
+        int                    width  = 0;
+        int                    height = 0;
+        std::vector<std::byte> blocks;
+
+        [[nodiscard]] static std::size_t blockBytes(BcFormat format);
+
+        // the channels of an RGBA image the format keeps, which is what quality should be measured on
+        [[nodiscard]] static int channels(BcFormat format);
+
+        [[nodiscard]] static std::string_view name(BcFormat format);
+
+        [[nodiscard]] static std::optional<BcFormat> parse(std::string_view name);
+
+        // Edges that aren't a multiple of 4 are padded by repeating the last row and column. With a pool the block rows are split among its workers and this
+        // waits for them, so it must not be called from a job of the same pool
+        [[nodiscard]] static BcImage encode(const Image &image, BcFormat format, ThreadPool *pool = nullptr);
+
+        // Back to RGBA8, to measure what the encoder lost. Missing channels come out as 0 and alpha as 255. Only BC7 mode 6 is understood, which is the only
+        // mode encode() writes
+        [[nodiscard]] Image decode() const;
+    };
+
+} // namespace neuron
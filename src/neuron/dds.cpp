@@ -0,0 +1,321 @@
+#include "dds.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+/*
+ * File layout (little endian):
+ *
+ *   char[4]  magic "DDS "
+ *   124 byte DDS_HEADER, with a 32 byte DDS_PIXELFORMAT at offset 72
+ *   20 byte DDS_HEADER_DXT10, only if the pixel format's FourCC is "DX10"
+ *
+ *   then for every array element, for every cube face, every mip level from the largest down, each a tight run of 4x4 blocks
+ */
+
+namespace neuron {
+    namespace {
+        constexpr uint32_t kMagic           = 0x20534444; // "DDS "
+        constexpr uint32_t kHeaderSize      = 124;
+        constexpr uint32_t kPixelFormatSize = 32;
+        constexpr int      kMaxSize         = 16384;
+
+        constexpr uint32_t kFlagsRequired    = 0x1007; // caps, height, width and pixel format
+        constexpr uint32_t kFlagMipMapCount  = 0x20000;
+        constexpr uint32_t kFlagLinearSize   = 0x80000;
+        constexpr uint32_t kPixelFourCC      = 0x4;
+        constexpr uint32_t kCapsTexture      = 0x1000;
+        constexpr uint32_t kCapsMipMap       = 0x400008; // mipmap and complex
+        constexpr uint32_t kCaps2Cubemap     = 0x200;
+        constexpr uint32_t kCaps2AllFaces    = 0xFC00;
+        constexpr uint32_t kCaps2Volume      = 0x200000;
+        constexpr uint32_t kDimensionTexture = 3;
+        constexpr uint32_t kMiscTextureCube  = 0x4;
+
+        constexpr uint32_t fourCC(const char (&code)[5]) {
+            return static_cast<uint32_t>(code[0]) | static_cast<uint32_t>(code[1]) << 8 | static_cast<uint32_t>(code[2]) << 16 | static_cast<uint32_t>(code[3]) << 24;
+        }
+
+        struct Format {
+            Texture::InternalFormat format;
+            std::size_t             blockBytes;
+        };
+
+        Format legacyFormat(const uint32_t code, const bool srgb) {
+            using F = Texture::InternalFormat;
+            switch (code) {
+            case fourCC("DXT1"):
+                return {srgb ? F::COMPRESSED_SRGB_ALPHA_S3TC_DXT1 : F::COMPRESSED_RGBA_S3TC_DXT1, 8};
+            case fourCC("DXT2"):
+            case fourCC("DXT3"):
+                return {srgb ? F::COMPRESSED_SRGB_ALPHA_S3TC_DXT3 : F::COMPRESSED_RGBA_S3TC_DXT3, 16};
+            case fourCC("DXT4"):
+            case fourCC("DXT5"):
+                return {srgb ? F::COMPRESSED_SRGB_ALPHA_S3TC_DXT5 : F::COMPRESSED_RGBA_S3TC_DXT5, 16};
+            case fourCC("ATI1"):
+            case fourCC("BC4U"):
+                return {F::COMPRESSED_RED_RGTC1, 8};
+            case fourCC("BC4S"):
+                return {F::COMPRESSED_SIGNED_RED_RGTC1, 8};
+            case fourCC("ATI2"):
+            case fourCC("BC5U"):
+                return {F::COMPRESSED_RG_RGTC2, 16};
+            case fourCC("BC5S"):
+                return {F::COMPRESSED_SIGNED_RG_RGTC2, 16};
+            default:
+                throw std::runtime_error("Malformed DDS file: unsupported FourCC, only block compressed formats can be loaded");
+            }
+        }
+
+        Format dxgiFormat(const uint32_t dxgi) {
+            using F = Texture::InternalFormat;
+            switch (dxgi) {
+            case 70: // BC1 typeless, unorm, srgb
+            case 71:
+                return {F::COMPRESSED_RGBA_S3TC_DXT1, 8};
+            case 72:
+                return {F::COMPRESSED_SRGB_ALPHA_S3TC_DXT1, 8};
+            case 73: // BC2
+            case 74:
+                return {F::COMPRESSED_RGBA_S3TC_DXT3, 16};
+            case 75:
+                return {F::COMPRESSED_SRGB_ALPHA_S3TC_DXT3, 16};
+            case 76: // BC3
+            case 77:
+                return {F::COMPRESSED_RGBA_S3TC_DXT5, 16};
+            case 78:
+                return {F::COMPRESSED_SRGB_ALPHA_S3TC_DXT5, 16};
+            case 79: // BC4 typeless, unorm, snorm
+            case 80:
+                return {F::COMPRESSED_RED_RGTC1, 8};
+            case 81:
+                return {F::COMPRESSED_SIGNED_RED_RGTC1, 8};
+            case 82: // BC5
+            case 83:
+                return {F::COMPRESSED_RG_RGTC2, 16};
+            case 84:
+                return {F::COMPRESSED_SIGNED_RG_RGTC2, 16};
+            case 94: // BC6H typeless, unsigned, signed
+            case 95:
+                return {F::COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT, 16};
+            case 96:
+                return {F::COMPRESSED_RGB_BPTC_SIGNED_FLOAT, 16};
+            case 97: // BC7 typeless, unorm, srgb
+            case 98:
+                return {F::COMPRESSED_RGBA_BPTC_UNORM, 16};
+            case 99:
+                return {F::COMPRESSED_SRGB_ALPHA_BPTC_UNORM, 16};
+            default:
+                throw std::runtime_error("Malformed DDS file: unsupported DXGI format " + std::to_string(dxgi) + ", only BC1 to BC7 can be loaded");
+            }
+        }
+
+        uint32_t dxgiCode(const BcFormat format, const bool srgb) {
+            switch (format) {
+            case BcFormat::BC1:
+                return srgb ? 72 : 71;
+            case BcFormat::BC3:
+                return srgb ? 78 : 77;
+            case BcFormat::BC4:
+                return 80;
+            case BcFormat::BC5:
+                return 83;
+            case BcFormat::BC7:
+                return srgb ? 99 : 98;
+            }
+            return 0;
+        }
+
+        class Reader {
+          public:
+            explicit Reader(const std::span<const std::byte> data) : m_Data(data) {}
+
+            uint32_t u32(const std::size_t offset) const {
+                if (offset + 4 > m_Data.size()) {
+                    throw std::runtime_error("Malformed DDS file: truncated header");
+                }
+                uint32_t value;
+                std::memcpy(&value, m_Data.data() + offset, 4);
+                return value;
+            }
+
+          private:
+            std::span<const std::byte> m_Data;
+        };
+    } // namespace
+
+    std::size_t DdsInfo::dataBytes() const {
+        std::size_t bytes = 0;
+        for (const auto &subresource : subresources) {
+            bytes += subresource.size;
+        }
+        return bytes;
+    }
+
+    DdsFile::DdsFile(const std::filesystem::path &path, const bool srgb) : m_File(path) {
+        try {
+            m_Info = validate(m_File.bytes(), srgb);
+        } catch (const std::exception &e) {
+            throw std::runtime_error(std::string(e.what()) + " (" + path.string() + ")");
+        }
+    }
+
+    std::shared_ptr<Texture> DdsFile::upload() const {
+        auto texture = std::make_shared<Texture>(m_Info.type);
+        switch (m_Info.type) {
+        case Texture::Type::Texture2D:
+        case Texture::Type::TextureCubeMap:
+            texture->storage2d(m_Info.levels, m_Info.format, m_Info.width, m_Info.height);
+            break;
+        default:
+            texture->storage3d(m_Info.levels, m_Info.format, m_Info.width, m_Info.height, m_Info.layers * m_Info.faces);
+            break;
+        }
+
+        // the pointers are into the mapping, so nothing can be bound as the unpack buffer
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        for (const auto &sub : m_Info.subresources) {
+            const std::byte *data = m_File.bytes().data() + sub.offset;
+            if (m_Info.type == Texture::Type::Texture2D) {
+                texture->compressedSubImage2d(sub.level, 0, 0, sub.width, sub.height, sub.size, data);
+            } else {
+                texture->compressedSubImage3d(sub.level, 0, 0, sub.layer, sub.width, sub.height, 1, sub.size, data);
+            }
+        }
+        return texture;
+    }
+
+    DdsInfo DdsFile::validate(const std::span<const std::byte> file, const bool srgb) {
+        const Reader reader(file);
+        if (reader.u32(0) != kMagic) {
+            throw std::runtime_error("Malformed DDS file: bad magic");
+        }
+
+        // header fields, as offsets from the start of the file
+        const std::size_t header = 4;
+        if (reader.u32(header) != kHeaderSize || reader.u32(header + 72) != kPixelFormatSize) {
+            throw std::runtime_error("Malformed DDS file: bad header size");
+        }
+
+        const uint32_t flags       = reader.u32(header + 4);
+        const uint32_t height      = reader.u32(header + 8);
+        const uint32_t width       = reader.u32(header + 12);
+        const uint32_t mipCount    = reader.u32(header + 24);
+        const uint32_t pixelFlags  = reader.u32(header + 76);
+        const uint32_t pixelFourCC = reader.u32(header + 80);
+        const uint32_t caps2       = reader.u32(header + 108);
+
+        if ((pixelFlags & kPixelFourCC) == 0) {
+            throw std::runtime_error("Malformed DDS file: uncompressed pixel formats aren't supported");
+        }
+        if (width == 0 || height == 0 || width > kMaxSize || height > kMaxSize) {
+            throw std::runtime_error("Malformed DDS file: size " + std::to_string(width) + "x" + std::to_string(height) + " out of range");
+        }
+        if ((caps2 & kCaps2Volume) != 0) {
+            throw std::runtime_error("Malformed DDS file: volume textures aren't supported");
+        }
+
+        DdsInfo info;
+        info.width  = static_cast<int>(width);
+        info.height = static_cast<int>(height);
+        info.levels = (flags & kFlagMipMapCount) != 0 ? std::max(static_cast<int>(mipCount), 1) : 1;
+        if (info.levels > Texture::mipLevels(info.width, info.height)) {
+            throw std::runtime_error("Malformed DDS file: more mip levels than the size allows");
+        }
+
+        bool        cube       = (caps2 & kCaps2Cubemap) != 0;
+        std::size_t dataOffset = header + kHeaderSize;
+        if (pixelFourCC == fourCC("DX10")) {
+            const std::size_t dx10 = dataOffset;
+            dataOffset += 20;
+
+            const Format format = dxgiFormat(reader.u32(dx10));
+            info.format         = format.format;
+            info.blockBytes     = format.blockBytes;
+
+            if (reader.u32(dx10 + 4) != kDimensionTexture) {
+                throw std::runtime_error("Malformed DDS file: only 2D textures are supported");
+            }
+            cube        = (reader.u32(dx10 + 8) & kMiscTextureCube) != 0;
+            info.layers = static_cast<int>(std::max(reader.u32(dx10 + 12), 1U));
+            if (info.layers > 2048) {
+                throw std::runtime_error("Malformed DDS file: too many array elements");
+            }
+        } else {
+            const Format format = legacyFormat(pixelFourCC, srgb);
+            info.format         = format.format;
+            info.blockBytes     = format.blockBytes;
+
+            if (cube && (caps2 & kCaps2AllFaces) != kCaps2AllFaces) {
+                throw std::runtime_error("Malformed DDS file: cube maps need all six faces");
+            }
+        }
+
+        if (cube && width != height) {
+            throw std::runtime_error("Malformed DDS file: cube map faces have to be square");
+        }
+        info.faces = cube ? 6 : 1;
+        if (cube) {
+            info.type = info.layers > 1 ? Texture::Type::TextureCubeMapArray : Texture::Type::TextureCubeMap;
+        } else {
+            info.type = info.layers > 1 ? Texture::Type::Texture2DArray : Texture::Type::Texture2D;
+        }
+
+        // the sizes are bounded above, so none of this can overflow
+        std::size_t offset = dataOffset;
+        for (int layer = 0; layer < info.layers * info.faces; layer++) {
+            for (int level = 0; level < info.levels; level++) {
+                const int         w    = std::max(info.width >> level, 1);
+                const int         h    = std::max(info.height >> level, 1);
+                const std::size_t size = static_cast<std::size_t>((w + 3) / 4) * static_cast<std::size_t>((h + 3) / 4) * info.blockBytes;
+                if (size > file.size() - std::min(offset, file.size())) {
+                    throw std::runtime_error("Malformed DDS file: level " + std::to_string(level) + " of layer " + std::to_string(layer) + " is past the end of the file");
+                }
+
+                info.subresources.push_back({layer, level, w, h, offset, size});
+                offset += size;
+            }
+        }
+        return info;
+    }
+
+    void DdsFile::write(const std::filesystem::path &path, const std::span<const BcImage> levels, const bool srgb) {
+        if (levels.empty()) {
+            throw std::runtime_error("A DDS file needs at least one level");
+        }
+        for (std::size_t i = 1; i < levels.size(); i++) {
+            if (levels[i].format != levels[0].format || levels[i].width != std::max(levels[0].width >> i, 1) || levels[i].height != std::max(levels[0].height >> i, 1)) {
+                throw std::runtime_error("The levels of a DDS file have to be a mip chain of one format");
+            }
+        }
+
+        uint32_t header[1 + kHeaderSize / 4 + 5] = {}; // magic, DDS_HEADER, DDS_HEADER_DXT10
+
+        header[0]  = kMagic;
+        header[1]  = kHeaderSize;
+        header[2]  = kFlagsRequired | kFlagMipMapCount | kFlagLinearSize;
+        header[3]  = static_cast<uint32_t>(levels[0].height);
+        header[4]  = static_cast<uint32_t>(levels[0].width);
+        header[5]  = static_cast<uint32_t>(levels[0].blocks.size());
+        header[7]  = static_cast<uint32_t>(levels.size());
+        header[19] = kPixelFormatSize;
+        header[20] = kPixelFourCC;
+        header[21] = fourCC("DX10");
+        header[27] = kCapsTexture | (levels.size() > 1 ? kCapsMipMap : 0);
+        header[32] = dxgiCode(levels[0].format, srgb);
+        header[33] = kDimensionTexture;
+        header[35] = 1; // array size
+
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char *>(header), sizeof(header));
+        for (const auto &level : levels) {
+            file.write(reinterpret_cast<const char *>(level.blocks.data()), static_cast<std::streamsize>(level.blocks.size()));
+        }
+        if (!file) {
+            throw std::runtime_error("Could not write " + path.string());
+        }
+    }
+} // namespace neuron
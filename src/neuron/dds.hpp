@@ -0,0 +1,65 @@
+#pragma once
+
+#include "neuron/bc_encoder.hpp"
+#include "neuron/glwrap.hpp"
+#include "neuron/mapped_file.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace neuron {
+
+    struct DdsInfo {
+        struct Subresource {
+            int         layer; // array element * faces + face
+            int         level;
+            int         width;
+            int         height;
+            std::size_t offset; // into the file
+            std::size_t size;
+        };
+
+        Texture::Type           type = Texture::Type::Texture2D; // 2D, 2D array, cube map or cube map array
+        Texture::InternalFormat format = Texture::InternalFormat::COMPRESSED_RGBA_S3TC_DXT1;
+        int                     width  = 0;
+        int                     height = 0;
+        int                     layers = 1; // array elements
+        int                     faces  = 1;
+        int                     levels = 1;
+        std::size_t             blockBytes = 8;
+
+        std::vector<Subresource> subresources; // in file order
+
+        [[nodiscard]] std::size_t dataBytes() const;
+    };
+
+    /**
+     * A block compressed DDS file (BC1 to BC7, legacy FourCC or DX10 header), mapped and checked on construction so that can happen off the GL thread.
+     * upload() hands the mapped blocks to glCompressedTextureSubImage* as they are, nothing gets decoded or copied on the CPU.
+     */
+    class DdsFile {
+      public:
+        // Legacy headers don't say whether the colour is sRGB, `srgb` decides for them. DX10 headers always do
+        explicit DdsFile(const std::filesystem::path &path, bool srgb = false);
+
+        [[nodiscard]] inline const DdsInfo &info() const { return m_Info; }
+
+        // Immutable storage with every level and layer in the file. GL thread
+        [[nodiscard]] std::shared_ptr<Texture> upload() const;
+
+        // Checks the headers and that every level is inside the file, without GL. Throws std::runtime_error describing the first problem
+        [[nodiscard]] static DdsInfo validate(std::span<const std::byte> file, bool srgb = false);
+
+        // A 2D texture with a DX10 header, `levels` being a mip chain from the largest down. Throws std::runtime_error if it can't be written
+        static void write(const std::filesystem::path &path, std::span<const BcImage> levels, bool srgb);
+
+      private:
+        MappedFile m_File;
+        DdsInfo    m_Info;
+    };
+
+} // namespace neuron
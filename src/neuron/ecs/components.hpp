@@ -1,8 +1,11 @@
 #pragma once
 
+#include "neuron/aabb.hpp"
 #include "neuron/asset/asset.hpp"
+#include "neuron/asset/mesh.hpp"
 #include "neuron/asset/post_processing_pipeline.hpp"
 #include "neuron/asset/render_target.hpp"
+#include "neuron/asset/shader.hpp"
 
 
 #include <flecs/addons/cpp/flecs.hpp>
@@ -39,6 +42,7 @@ namespace neuron::ecs {
     // the system will update this on everything which has any parent node along its path to the root of its part of the tree which contains a `Visibility` component
     struct CalculatedVisibility {
         bool visible;
+        bool visibleForChildren; // differs from `visible` when a `Visibility` with `onlySelf` is set
     };
 
     // the system will calculate the position *after* the transform stack and place it in here
@@ -46,6 +50,29 @@ namespace neuron::ecs {
         glm::vec3 position;
     };
 
+    // object space bounds, used for culling together with the GlobalTransformMatrix
+    struct Bounds {
+        AABB local;
+    };
+
+    // On entities whose Bounds come from their MeshRenderer, which the transform phase keeps in sync when the mesh is loaded, reloaded or evicted. Remove
+    // it to set Bounds by hand
+    struct MeshBounds {
+        uint64_t mesh    = UINT64_MAX; // the handle and asset version the bounds are from
+        uint32_t version = 0;
+    };
+
+    // written by the cull phase for everything which has Bounds
+    struct CullState {
+        bool culled;
+    };
+
+    struct MeshRenderer {
+        asset::AssetHandle<asset::Mesh>   mesh;
+        asset::AssetHandle<asset::Shader> shader;
+        uint32_t                          material = 0;
+    };
+
     struct RenderOnCameraLayer {
         flecs::entity cameraLayer; // camera layers are represented as entities which are related to an entity with a camera component
     };
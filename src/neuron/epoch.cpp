@@ -0,0 +1,76 @@
+#include "epoch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+
+namespace neuron {
+    uint64_t EpochManager::oldestPinned() const {
+        // pairs with the fence after pinning, so objects unpublished before this call are either seen as pinned or were never loaded
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        uint64_t oldest = UINT64_MAX;
+        for (const auto &record : m_Records) {
+            if (const uint64_t pinned = record.pinned.load(std::memory_order_seq_cst); pinned != 0) {
+                oldest = std::min(oldest, pinned);
+            }
+        }
+        return oldest;
+    }
+
+    EpochManager &EpochManager::global() {
+        static EpochManager manager;
+        return manager;
+    }
+
+    EpochManager::ThreadState::~ThreadState() {
+        if (record != nullptr) {
+            record->pinned.store(0, std::memory_order_release);
+            record->used.store(false, std::memory_order_release);
+        }
+    }
+
+    EpochManager::ThreadState &EpochManager::threadState() {
+        thread_local ThreadState state;
+        if (state.record == nullptr) {
+            for (auto &record : m_Records) {
+                bool expected = false;
+                if (record.used.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                    state.record = &record;
+                    break;
+                }
+            }
+
+            if (state.record == nullptr) {
+                throw std::runtime_error("Too many threads are using epoch based reclamation");
+            }
+        }
+        return state;
+    }
+
+    EpochGuard::EpochGuard() {
+        auto &manager = EpochManager::global();
+        auto &state   = manager.threadState();
+        if (state.depth++ == 0) {
+            // A seq_cst store alone doesn't keep the acquire loads of shared pointers after it from being reordered before it, the fence does. Without
+            // it a writer could miss the pin in oldestPinned() while this thread already loaded the pointer being retired
+            state.record->pinned.store(manager.current(), std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+
+    EpochGuard::~EpochGuard() {
+        if (!m_Active) {
+            return;
+        }
+
+        auto &state = EpochManager::global().threadState();
+        if (--state.depth == 0) {
+            state.record->pinned.store(0, std::memory_order_release);
+        }
+    }
+
+    EpochGuard::EpochGuard(EpochGuard &&other) noexcept {
+        other.m_Active = false;
+    }
+} // namespace neuron
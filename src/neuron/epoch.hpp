@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace neuron {
+
+    /**
+     * Epoch based reclamation. Readers pin the current epoch with an EpochGuard while they use shared objects, writers unpublish an object and retire it
+     * tagged with the current epoch, and a retired object can be destroyed once every pinned reader is in a later epoch, since those readers started after it was unpublished.
+     * Pinning never blocks and nested guards on one thread only cost a counter.
+     */
+    class EpochManager {
+      public:
+        static constexpr std::size_t kMaxThreads = 256;
+
+        [[nodiscard]] inline uint64_t current() const { return m_Epoch.load(std::memory_order_seq_cst); }
+
+        // moves the global epoch forward, returns the new one
+        inline uint64_t advance() { return m_Epoch.fetch_add(1, std::memory_order_seq_cst) + 1; }
+
+        // the oldest epoch any thread is pinned in, UINT64_MAX if none is. Objects retired in an earlier epoch are safe to destroy
+        [[nodiscard]] uint64_t oldestPinned() const;
+
+        static EpochManager &global();
+
+      private:
+        friend class EpochGuard;
+
+        // there is only the global one, since every thread keeps a single record for it
+        EpochManager() = default;
+
+        struct alignas(64) ThreadRecord {
+            std::atomic<uint64_t> pinned{0}; // 0 when not pinned
+            std::atomic<bool>     used{false};
+        };
+
+        struct ThreadState {
+            ThreadRecord *record = nullptr;
+            uint32_t      depth  = 0;
+
+            ~ThreadState();
+        };
+
+        ThreadState &threadState();
+
+        std::atomic<uint64_t>                  m_Epoch{1};
+        std::array<ThreadRecord, kMaxThreads> m_Records;
+    };
+
+    // Pins the current epoch on this thread for its lifetime. Moving it to another thread is not allowed.
+    class EpochGuard {
+      public:
+        EpochGuard();
+        ~EpochGuard();
+
+        EpochGuard(const EpochGuard &other)            = delete;
+        EpochGuard &operator=(const EpochGuard &other) = delete;
+        EpochGuard(EpochGuard &&other) noexcept;
+        EpochGuard &operator=(EpochGuard &&other) = delete;
+
+      private:
+        bool m_Active = true;
+    };
+
+} // namespace neuron
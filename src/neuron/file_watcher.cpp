@@ -0,0 +1,171 @@
+#include "file_watcher.hpp"
+
+#include <array>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace neuron {
+    FileWatcher::FileWatcher(const std::chrono::milliseconds debounce) : m_Debounce(debounce) {
+#ifdef __linux__
+        m_Inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (m_Inotify < 0) {
+            throw std::runtime_error("Could not initialize inotify");
+        }
+#endif
+        m_Thread = std::jthread([this](const std::stop_token &stop) { run(stop); });
+    }
+
+    FileWatcher::~FileWatcher() {
+        // the thread has to be gone before the descriptor is
+        m_Thread.request_stop();
+        m_Thread.join();
+#ifdef __linux__
+        close(m_Inotify);
+#endif
+    }
+
+    void FileWatcher::watch(const std::filesystem::path &file) {
+        const auto      path = normalize(file);
+        std::lock_guard lock(m_Mutex);
+
+        WatchedFile &watched = m_Files[path.string()];
+        if (watched.references++ > 0) {
+            return;
+        }
+
+#ifdef __linux__
+        const std::string directory = path.parent_path().string();
+        if (const auto it = m_DirectoryWatches.find(directory); it != m_DirectoryWatches.end()) {
+            m_Directories[it->second].references++;
+            return;
+        }
+
+        const int descriptor = inotify_add_watch(m_Inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE);
+        if (descriptor < 0) {
+            m_Files.erase(path.string());
+            throw std::runtime_error("Could not watch " + directory);
+        }
+
+        // a directory that was watched before can come back with its old descriptor
+        Directory &watchedDirectory = m_Directories[descriptor];
+        watchedDirectory.path       = directory;
+        watchedDirectory.references++;
+        m_DirectoryWatches[directory] = descriptor;
+#else
+        std::error_code error;
+        const auto      time = std::filesystem::last_write_time(path, error);
+        if (!error) {
+            watched.lastWriteTime = time;
+        }
+#endif
+    }
+
+    void FileWatcher::unwatch(const std::filesystem::path &file) {
+        const auto      path = normalize(file);
+        std::lock_guard lock(m_Mutex);
+
+        const auto it = m_Files.find(path.string());
+        if (it == m_Files.end() || --it->second.references > 0) {
+            return;
+        }
+        m_Files.erase(it);
+
+#ifdef __linux__
+        const auto directory = m_DirectoryWatches.find(path.parent_path().string());
+        if (directory == m_DirectoryWatches.end()) {
+            return;
+        }
+
+        if (--m_Directories[directory->second].references == 0) {
+            inotify_rm_watch(m_Inotify, directory->second);
+            m_Directories.erase(directory->second);
+            m_DirectoryWatches.erase(directory);
+        }
+#endif
+    }
+
+    std::vector<std::filesystem::path> FileWatcher::poll() {
+        const auto      now = clock::now();
+        std::lock_guard lock(m_Mutex);
+
+        std::vector<std::filesystem::path> settled;
+        for (auto &[path, watched] : m_Files) {
+            if (watched.lastChange && now - *watched.lastChange >= m_Debounce) {
+                watched.lastChange.reset();
+                settled.emplace_back(path);
+            }
+        }
+        return settled;
+    }
+
+    std::size_t FileWatcher::watchedCount() const {
+        std::lock_guard lock(m_Mutex);
+        return m_Files.size();
+    }
+
+    std::filesystem::path FileWatcher::normalize(const std::filesystem::path &file) {
+        return std::filesystem::absolute(file).lexically_normal();
+    }
+
+    void FileWatcher::changed(const std::string &file) {
+        if (const auto it = m_Files.find(file); it != m_Files.end()) {
+            it->second.lastChange = clock::now();
+        }
+    }
+
+#ifdef __linux__
+    void FileWatcher::run(const std::stop_token &stop) {
+        alignas(inotify_event) std::array<char, 16 * 1024> buffer{};
+
+        while (!stop.stop_requested()) {
+            pollfd descriptor{m_Inotify, POLLIN, 0};
+            if (::poll(&descriptor, 1, 100) <= 0) {
+                continue; // timed out, so the stop token gets checked regularly
+            }
+
+            while (true) {
+                const ssize_t length = read(m_Inotify, buffer.data(), buffer.size());
+                if (length <= 0) {
+                    break;
+                }
+
+                std::lock_guard lock(m_Mutex);
+                for (ssize_t offset = 0; offset < length;) {
+                    const auto *event = reinterpret_cast<const inotify_event *>(buffer.data() + offset);
+                    offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+                    const auto directory = m_Directories.find(event->wd);
+                    if (event->len == 0 || directory == m_Directories.end()) {
+                        continue;
+                    }
+                    changed((std::filesystem::path(directory->second.path) / event->name).string());
+                }
+            }
+        }
+    }
+#else
+    void FileWatcher::run(const std::stop_token &stop) {
+        while (!stop.stop_requested()) {
+            std::this_thread::sleep_for(std::max(m_Debounce / 2, std::chrono::milliseconds(10)));
+
+            std::lock_guard lock(m_Mutex);
+            for (auto &[path, watched] : m_Files) {
+                std::error_code error;
+                const auto      time = std::filesystem::last_write_time(path, error);
+                if (!error && time != watched.lastWriteTime) {
+                    // the first time a file shows up isn't a change
+                    if (watched.lastWriteTime) {
+                        changed(path);
+                    }
+                    watched.lastWriteTime = time;
+                }
+            }
+        }
+    }
+#endif
+} // namespace neuron
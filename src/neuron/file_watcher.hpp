@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace neuron {
+
+    /**
+     * Watches files for changes on a background thread, with inotify on Linux and by polling modification times elsewhere.
+     * Directories are watched rather than the files themselves, so editors that save by writing a new file and renaming it over the old one are picked up too.
+     * Changes are debounced: a file is reported once it has been left alone for the debounce interval, so a burst of writes becomes one report.
+     */
+    class FileWatcher {
+      public:
+        explicit FileWatcher(std::chrono::milliseconds debounce = std::chrono::milliseconds(150));
+        ~FileWatcher();
+
+        FileWatcher(const FileWatcher &other)            = delete;
+        FileWatcher &operator=(const FileWatcher &other) = delete;
+
+        // Watching a file more than once needs as many unwatch() calls
+        void watch(const std::filesystem::path &file);
+
+        void unwatch(const std::filesystem::path &file);
+
+        // the files that changed and have settled since the last call, in no particular order. Paths are absolute and normalized
+        [[nodiscard]] std::vector<std::filesystem::path> poll();
+
+        [[nodiscard]] std::size_t watchedCount() const;
+
+        static std::filesystem::path normalize(const std::filesystem::path &file);
+
+      private:
+        using clock = std::chrono::steady_clock;
+
+        struct WatchedFile {
+            uint32_t                                        references = 0;
+            std::optional<clock::time_point>                lastChange;
+            std::optional<std::filesystem::file_time_type> lastWriteTime; // only used when polling
+        };
+
+        // the mutex must be held
+        void changed(const std::string &file);
+
+        void run(const std::stop_token &stop);
+
+        std::chrono::milliseconds m_Debounce;
+
+        mutable std::mutex                           m_Mutex;
+        std::unordered_map<std::string, WatchedFile> m_Files;
+
+#ifdef __linux__
+        struct Directory {
+            std::string path;
+            uint32_t    references = 0;
+        };
+
+        int                                  m_Inotify = -1;
+        std::unordered_map<int, Directory>   m_Directories; // by watch descriptor
+        std::unordered_map<std::string, int> m_DirectoryWatches;
+#endif
+
+        std::jthread m_Thread;
+    };
+
+} // namespace neuron
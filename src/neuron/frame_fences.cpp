@@ -0,0 +1,43 @@
+#include "frame_fences.hpp"
+
+#include <glad/gl.h>
+
+namespace neuron {
+    void FrameFences::endFrame() {
+        const uint64_t frame = m_RecordingFrame.load(std::memory_order_relaxed);
+        m_Fences.emplace_back(frame, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+        m_RecordingFrame.store(frame + 1, std::memory_order_release);
+
+        poll();
+    }
+
+    void FrameFences::poll() {
+        // fences signal in order, so the first one that isn't done ends the search
+        while (!m_Fences.empty()) {
+            const auto [frame, fence] = m_Fences.front();
+            const GLenum result       = glClientWaitSync(static_cast<GLsync>(fence), 0, 0);
+            if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED) {
+                break;
+            }
+
+            glDeleteSync(static_cast<GLsync>(fence));
+            m_Fences.pop_front();
+            m_CompletedFrame.store(frame, std::memory_order_release);
+        }
+    }
+
+    void FrameFences::clear() {
+        glFinish();
+
+        for (const auto &[frame, fence] : m_Fences) {
+            glDeleteSync(static_cast<GLsync>(fence));
+        }
+        m_Fences.clear();
+        m_CompletedFrame.store(m_RecordingFrame.load(std::memory_order_acquire) - 1, std::memory_order_release);
+    }
+
+    FrameFences &FrameFences::global() {
+        static FrameFences fences;
+        return fences;
+    }
+} // namespace neuron
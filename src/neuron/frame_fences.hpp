@@ -0,0 +1,39 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <utility>
+
+namespace neuron {
+
+    /**
+     * A fence at the end of every frame, so CPU side code can tell which frames the GPU has finished with. Frame numbers start at 1;
+     * anything used while recording frame N is safe to delete on the GPU side once completedFrame() >= N. The query side is lock free, endFrame() is GL thread only.
+     */
+    class FrameFences {
+      public:
+        [[nodiscard]] inline uint64_t recordingFrame() const { return m_RecordingFrame.load(std::memory_order_acquire); }
+
+        [[nodiscard]] inline uint64_t completedFrame() const { return m_CompletedFrame.load(std::memory_order_acquire); }
+
+        // Puts a fence behind everything submitted for the current frame, starts the next one and collects signaled fences. Never waits.
+        void endFrame();
+
+        // deletes the outstanding fences, for shutdown while the context still exists
+        void clear();
+
+        static FrameFences &global();
+
+      private:
+        FrameFences() = default;
+
+        void poll();
+
+        std::atomic<uint64_t> m_RecordingFrame{1};
+        std::atomic<uint64_t> m_CompletedFrame{0};
+
+        std::deque<std::pair<uint64_t, void *>> m_Fences; // GLsync, kept opaque so this header doesn't need GL
+    };
+
+} // namespace neuron
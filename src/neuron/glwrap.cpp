@@ -1,14 +1,38 @@
 #include "glwrap.hpp"
 
+#include <algorithm>
+#include <bit>
 #include <fstream>
 #include <iostream>
 
 namespace neuron {
+    namespace {
+        constexpr uint32_t kSpirvMagic = 0x07230203;
+
+        void checkCompileStatus(const unsigned int shader, const std::string_view what) {
+            int status;
+            glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+            if (status == GL_FALSE) {
+                int length;
+                glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+                std::string ilog;
+                ilog.resize(length);
+                glGetShaderInfoLog(shader, length, &length, ilog.data());
+                throw std::runtime_error("Failed to " + std::string(what) + " shader: " + std::string(ilog));
+            }
+        }
+    } // namespace
+
     Buffer::Buffer(const std::size_t size, const void *data, const Usage usage) : m_Buffer(~0U), m_CurrentUsage(usage), m_CurrentSize(size) {
         glCreateBuffers(1, &m_Buffer);
         glNamedBufferData(m_Buffer, static_cast<intptr_t>(size), data, static_cast<GLenum>(usage));
     }
 
+    Buffer::Buffer(const std::size_t size, const void *data, const Storage storage) : m_Buffer(~0U), m_CurrentUsage(Usage::StaticDraw), m_CurrentSize(size), m_Immutable(true) {
+        glCreateBuffers(1, &m_Buffer);
+        glNamedBufferStorage(m_Buffer, static_cast<intptr_t>(size), data, storage.flags);
+    }
+
     Buffer::~Buffer() {
         glDeleteBuffers(1, &m_Buffer);
     }
@@ -26,6 +50,10 @@ namespace neuron {
     }
 
     void Buffer::set(const std::size_t size, const void *data) {
+        if (m_Immutable && size != m_CurrentSize) {
+            throw std::logic_error("Buffers with immutable storage can't be resized");
+        }
+
         if (size != m_CurrentSize) {
             glNamedBufferData(m_Buffer, static_cast<intptr_t>(size), data, static_cast<GLenum>(m_CurrentUsage));
             m_CurrentSize = size;
@@ -35,6 +63,11 @@ namespace neuron {
     }
 
     void Buffer::set(const std::size_t size, const void *data, const Usage usage) {
+        if (m_Immutable) {
+            set(size, data);
+            return;
+        }
+
         if (size != m_CurrentSize || usage != m_CurrentUsage) {
             glNamedBufferData(m_Buffer, static_cast<intptr_t>(size), data, static_cast<GLenum>(usage));
             m_CurrentSize  = size;
@@ -44,6 +77,18 @@ namespace neuron {
         }
     }
 
+    void *Buffer::map(const std::size_t offset, const std::size_t length, const GLbitfield access) const {
+        void *data = glMapNamedBufferRange(m_Buffer, static_cast<intptr_t>(offset), static_cast<intptr_t>(length), access);
+        if (data == nullptr) {
+            throw std::runtime_error("Failed to map buffer");
+        }
+        return data;
+    }
+
+    void Buffer::unmap() const {
+        glUnmapNamedBuffer(m_Buffer);
+    }
+
     VertexArray::VertexArray(const VertexLayout &vertexLayout, const std::shared_ptr<Buffer> &elementBuffer) : m_VertexArray(~0U), m_HasElementBuffer(elementBuffer != nullptr) {
         glCreateVertexArrays(1, &m_VertexArray);
 
@@ -74,16 +119,34 @@ namespace neuron {
         const auto pcode = code.data();
         glShaderSource(m_Shader, 1, &pcode, nullptr);
         glCompileShader(m_Shader);
+        try {
+            checkCompileStatus(m_Shader, "compile");
+        } catch (...) {
+            glDeleteShader(m_Shader);
+            throw;
+        }
+    }
 
-        int status;
-        glGetShaderiv(m_Shader, GL_COMPILE_STATUS, &status);
-        if (status == GL_FALSE) {
-            int length;
-            glGetShaderiv(m_Shader, GL_INFO_LOG_LENGTH, &length);
-            std::string ilog;
-            ilog.resize(length);
-            glGetShaderInfoLog(m_Shader, length, &length, ilog.data());
-            throw std::runtime_error("Failed to compile shader: " + std::string(ilog));
+    ShaderModule::ShaderModule(const std::span<const uint32_t> spirv, Type type, const SpecializationConstants &constants, const std::string &entryPoint) : m_Shader(0) {
+        if (!spirvSupported()) {
+            throw std::runtime_error("SPIR-V shaders need OpenGL 4.6 or ARB_gl_spirv");
+        }
+
+        m_Shader = glCreateShader(static_cast<GLenum>(type));
+        glShaderBinary(1, &m_Shader, GL_SHADER_BINARY_FORMAT_SPIR_V, spirv.data(), static_cast<GLsizei>(spirv.size_bytes()));
+
+        const auto count = static_cast<GLuint>(constants.ids().size());
+        if (GLAD_GL_VERSION_4_6) {
+            glSpecializeShader(m_Shader, entryPoint.c_str(), count, constants.ids().data(), constants.values().data());
+        } else {
+            glSpecializeShaderARB(m_Shader, entryPoint.c_str(), count, constants.ids().data(), constants.values().data());
+        }
+
+        try {
+            checkCompileStatus(m_Shader, "specialize");
+        } catch (...) {
+            glDeleteShader(m_Shader);
+            throw;
         }
     }
 
@@ -92,6 +155,10 @@ namespace neuron {
     }
 
     std::shared_ptr<ShaderModule> ShaderModule::load(const std::filesystem::path &path, Type type) {
+        return std::make_shared<ShaderModule>(loadSource(path), type);
+    }
+
+    std::string ShaderModule::loadSource(const std::filesystem::path &path) {
         std::ifstream file(path, std::ios::ate);
         if (!file.is_open()) {
             throw std::runtime_error("Failed to open " + path.string());
@@ -103,13 +170,103 @@ namespace neuron {
         file.seekg(0, std::ios::beg).read(source.data(), end);
         file.close();
 
-        return std::make_shared<ShaderModule>(source, type);
+        return source;
+    }
+
+    std::shared_ptr<ShaderModule> ShaderModule::loadSpirv(const std::filesystem::path &path, Type type, const SpecializationConstants &constants) {
+        return std::make_shared<ShaderModule>(loadSpirvBinary(path), type, constants);
+    }
+
+    std::vector<uint32_t> ShaderModule::loadSpirvBinary(const std::filesystem::path &path) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open " + path.string());
+        }
+
+        const std::streamsize size = file.tellg();
+        if (size < 20 || size % 4 != 0) {
+            throw std::runtime_error("Malformed SPIR-V binary " + path.string() + ": size is not a whole number of words");
+        }
+
+        std::vector<uint32_t> words(static_cast<std::size_t>(size) / 4);
+        file.seekg(0, std::ios::beg).read(reinterpret_cast<char *>(words.data()), size);
+        if (!file) {
+            throw std::runtime_error("Failed to read " + path.string());
+        }
+
+        // GL takes the module in host byte order, a swapped magic means it was written for the other one
+        if (words[0] != kSpirvMagic) {
+            throw std::runtime_error("Malformed SPIR-V binary " + path.string() + (words[0] == std::byteswap(kSpirvMagic) ? ": wrong byte order" : ": bad magic"));
+        }
+        return words;
+    }
+
+    bool ShaderModule::spirvSupported() {
+        return GLAD_GL_VERSION_4_6 || GLAD_GL_ARB_gl_spirv;
+    }
+
+    SpecializationConstants &SpecializationConstants::set(const uint32_t id, const bool value) {
+        return setBits(id, value ? 1 : 0);
+    }
+
+    SpecializationConstants &SpecializationConstants::set(const uint32_t id, const int32_t value) {
+        return setBits(id, std::bit_cast<uint32_t>(value));
+    }
+
+    SpecializationConstants &SpecializationConstants::set(const uint32_t id, const uint32_t value) {
+        return setBits(id, value);
+    }
+
+    SpecializationConstants &SpecializationConstants::set(const uint32_t id, const float value) {
+        return setBits(id, std::bit_cast<uint32_t>(value));
+    }
+
+    SpecializationConstants &SpecializationConstants::setBits(const uint32_t id, const uint32_t bits) {
+        for (std::size_t i = 0; i < m_Ids.size(); i++) {
+            if (m_Ids[i] == id) {
+                m_Values[i] = bits;
+                return *this;
+            }
+        }
+
+        m_Ids.push_back(id);
+        m_Values.push_back(bits);
+        return *this;
     }
 
     Shader::~Shader() {
         glDeleteProgram(m_Program);
     }
 
+    std::shared_ptr<Shader> Shader::fromBinary(const GLenum format, const std::span<const std::byte> binary, const ProgramParameters &parameters) {
+        const unsigned int program = glCreateProgram();
+        glProgramParameteri(program, GL_PROGRAM_SEPARABLE, parameters.separable);
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, parameters.binaryRetrievable);
+        glProgramBinary(program, format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+        int status;
+        glGetProgramiv(program, GL_LINK_STATUS, &status);
+        if (status != GL_TRUE) {
+            glDeleteProgram(program);
+            return nullptr;
+        }
+        return adopt(program);
+    }
+
+    std::shared_ptr<Shader> Shader::adopt(const unsigned int program) {
+        return std::shared_ptr<Shader>(new Shader(program));
+    }
+
+    std::vector<std::byte> Shader::binary(GLenum &format) const {
+        int length = 0;
+        glGetProgramiv(m_Program, GL_PROGRAM_BINARY_LENGTH, &length);
+
+        std::vector<std::byte> binary(length);
+        glGetProgramBinary(m_Program, length, &length, &format, binary.data());
+        binary.resize(length);
+        return binary;
+    }
+
     int Shader::getUniformLocation(const std::string_view &name) const {
         return glGetUniformLocation(m_Program, name.data());
     }
@@ -302,6 +459,56 @@ namespace neuron {
         glUseProgram(m_Program);
     }
 
+    ProgramPipeline::ProgramPipeline() {
+        glCreateProgramPipelines(1, &m_Pipeline);
+    }
+
+    ProgramPipeline::~ProgramPipeline() {
+        glDeleteProgramPipelines(1, &m_Pipeline);
+    }
+
+    void ProgramPipeline::useStage(const ShaderModule::Type stage, const Shader &program) const {
+        glUseProgramStages(m_Pipeline, stageBit(stage), program.handle());
+    }
+
+    void ProgramPipeline::bind() const {
+        glUseProgram(0);
+        glBindProgramPipeline(m_Pipeline);
+    }
+
+    void ProgramPipeline::validate() const {
+        glValidateProgramPipeline(m_Pipeline);
+
+        int status;
+        glGetProgramPipelineiv(m_Pipeline, GL_VALIDATE_STATUS, &status);
+        if (status != GL_TRUE) {
+            glGetProgramPipelineiv(m_Pipeline, GL_INFO_LOG_LENGTH, &status);
+
+            std::string info_log;
+            info_log.resize(status);
+            glGetProgramPipelineInfoLog(m_Pipeline, status, &status, info_log.data());
+            throw std::runtime_error("Invalid program pipeline: " + info_log);
+        }
+    }
+
+    GLbitfield ProgramPipeline::stageBit(const ShaderModule::Type stage) {
+        switch (stage) {
+        case ShaderModule::Type::Vertex:
+            return GL_VERTEX_SHADER_BIT;
+        case ShaderModule::Type::Fragment:
+            return GL_FRAGMENT_SHADER_BIT;
+        case ShaderModule::Type::Geometry:
+            return GL_GEOMETRY_SHADER_BIT;
+        case ShaderModule::Type::TessellationControl:
+            return GL_TESS_CONTROL_SHADER_BIT;
+        case ShaderModule::Type::TessellationEvaluation:
+            return GL_TESS_EVALUATION_SHADER_BIT;
+        case ShaderModule::Type::Compute:
+            return GL_COMPUTE_SHADER_BIT;
+        }
+        throw std::invalid_argument("Unknown shader stage");
+    }
+
     Texture::Texture(const Type type) : m_Texture(~0U), m_Type(type) {
         glCreateTextures(static_cast<GLenum>(type), 1, &m_Texture);
     }
@@ -314,25 +521,288 @@ namespace neuron {
         glBindTexture(static_cast<GLenum>(m_Type), m_Texture);
     }
 
+    void Texture::bind(const unsigned int unit) const {
+        glBindTextureUnit(unit, m_Texture);
+    }
+
     std::shared_ptr<Texture> Texture::create2d(const int width, const int height, const Format format, const InternalFormat internal_format, const DataType dataType,
                                                const void *data) {
         auto texture = std::make_shared<Texture>(Type::Texture2D);
-        texture->image2d(width, height);
+        texture->storage2d(1, internal_format, width, height);
+        if (data != nullptr) {
+            texture->subImage2d(0, 0, 0, width, height, format, dataType, data);
+        }
+        return texture;
+    }
+
+    std::shared_ptr<Texture> Texture::createStorage2d(const int width, const int height, const InternalFormat internalFormat, const int levels) {
+        auto texture = std::make_shared<Texture>(Type::Texture2D);
+        texture->storage2d(levels > 0 ? levels : mipLevels(width, height), internalFormat, width, height);
+        return texture;
+    }
+
+    std::shared_ptr<Texture> Texture::createArray2d(const int width, const int height, const int layers, const InternalFormat internalFormat, const int levels) {
+        auto texture = std::make_shared<Texture>(Type::Texture2DArray);
+        texture->storage3d(levels > 0 ? levels : mipLevels(width, height), internalFormat, width, height, layers);
         return texture;
     }
 
+    std::shared_ptr<Texture> Texture::createMultisample2d(const int width, const int height, const int samples, const InternalFormat internalFormat) {
+        auto texture = std::make_shared<Texture>(Type::Texture2DMS);
+        texture->storage2dMultisample(samples, internalFormat, width, height);
+        return texture;
+    }
+
+    std::shared_ptr<Texture> Texture::createCube(const int size, const InternalFormat internalFormat, const int levels) {
+        auto texture = std::make_shared<Texture>(Type::TextureCubeMap);
+        texture->storage2d(levels > 0 ? levels : mipLevels(size, size), internalFormat, size, size);
+        return texture;
+    }
+
+    void Texture::storage2d(const int levels, const InternalFormat internalFormat, const int width, const int height) {
+        if (m_Immutable) {
+            throw std::logic_error("Texture storage can only be allocated once");
+        }
+
+        glTextureStorage2D(m_Texture, levels, static_cast<GLenum>(internalFormat), width, height);
+        m_InternalFormat = internalFormat;
+        m_Width          = width;
+        m_Height         = height;
+        m_Depth          = 1;
+        m_Levels         = levels;
+        m_Immutable      = true;
+    }
+
+    void Texture::storage3d(const int levels, const InternalFormat internalFormat, const int width, const int height, const int depth) {
+        if (m_Immutable) {
+            throw std::logic_error("Texture storage can only be allocated once");
+        }
+        if (m_Type == Type::TextureCubeMapArray && depth % 6 != 0) {
+            throw std::invalid_argument("Cube map arrays need six layers per cube");
+        }
+
+        glTextureStorage3D(m_Texture, levels, static_cast<GLenum>(internalFormat), width, height, depth);
+        m_InternalFormat = internalFormat;
+        m_Width          = width;
+        m_Height         = height;
+        m_Depth          = depth;
+        m_Levels         = levels;
+        m_Immutable      = true;
+    }
+
+    void Texture::storage2dMultisample(const int samples, const InternalFormat internalFormat, const int width, const int height) {
+        if (m_Immutable) {
+            throw std::logic_error("Texture storage can only be allocated once");
+        }
+
+        glTextureStorage2DMultisample(m_Texture, samples, static_cast<GLenum>(internalFormat), width, height, GL_TRUE);
+        m_InternalFormat = internalFormat;
+        m_Width          = width;
+        m_Height         = height;
+        m_Depth          = 1;
+        m_Levels         = 1;
+        m_Samples        = samples;
+        m_Immutable      = true;
+    }
+
+    void Texture::subImage2d(const int level, const int x, const int y, const int width, const int height, const Format format, const DataType dataType,
+                             const void *data) const {
+        // cube map faces are layers to DSA
+        if (m_Type == Type::TextureCubeMap) {
+            throw std::logic_error("Cube map faces are uploaded with subImage3d, with the face as z");
+        }
+        glTextureSubImage2D(m_Texture, level, x, y, width, height, static_cast<GLenum>(format), static_cast<GLenum>(dataType), data);
+    }
+
+    void Texture::subImage3d(const int level, const int x, const int y, const int z, const int width, const int height, const int depth, const Format format,
+                             const DataType dataType, const void *data) const {
+        glTextureSubImage3D(m_Texture, level, x, y, z, width, height, depth, static_cast<GLenum>(format), static_cast<GLenum>(dataType), data);
+    }
+
+    void Texture::compressedSubImage2d(const int level, const int x, const int y, const int width, const int height, const std::size_t size, const void *data) const {
+        glCompressedTextureSubImage2D(m_Texture, level, x, y, width, height, static_cast<GLenum>(m_InternalFormat), static_cast<GLsizei>(size), data);
+    }
+
+    void Texture::compressedSubImage3d(const int level, const int x, const int y, const int z, const int width, const int height, const int depth, const std::size_t size,
+                                       const void *data) const {
+        glCompressedTextureSubImage3D(m_Texture, level, x, y, z, width, height, depth, static_cast<GLenum>(m_InternalFormat), static_cast<GLsizei>(size), data);
+    }
+
+    void Texture::generateMipmaps() const {
+        glGenerateTextureMipmap(m_Texture);
+    }
+
+    void Texture::setBaseLevel(const int level) const {
+        glTextureParameteri(m_Texture, GL_TEXTURE_BASE_LEVEL, level);
+    }
+
     void Texture::image2d(const int width, const int height, const Format format, const InternalFormat internalFormat, const DataType dataType, const void *data) const {
         image2d(width, height, 0, format, internalFormat, dataType, data);
     }
 
     void Texture::image2d(const int width, const int height, const int level, const Format format, const InternalFormat internal_format, const DataType dataType,
                           const void *data) const {
+        if (m_Immutable) {
+            throw std::logic_error("Texture::image2d on a texture with immutable storage, use subImage2d");
+        }
+
         bind();
         glTexImage2D(static_cast<GLenum>(m_Type), level, static_cast<GLint>(internal_format), width, height, 0, static_cast<GLenum>(format), static_cast<GLenum>(dataType), data);
         glBindTexture(static_cast<GLenum>(m_Type), 0);
     }
 
-    Renderbuffer::Renderbuffer(Texture::InternalFormat internalFormat, const int width, const int height, const int samples) : m_Renderbuffer(~0U) {
+    int Texture::mipLevels(const int width, const int height, const int depth) {
+        int levels = 1;
+        for (int size = std::max({width, height, depth}); size > 1; size /= 2) {
+            levels++;
+        }
+        return levels;
+    }
+
+    std::size_t Texture::levelBytes(const InternalFormat internalFormat, const int width, const int height, const int depth) {
+        const auto texels = static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * static_cast<std::size_t>(depth);
+        const auto blocks = static_cast<std::size_t>((width + 3) / 4) * static_cast<std::size_t>((height + 3) / 4) * static_cast<std::size_t>(depth);
+
+        switch (internalFormat) {
+        case InternalFormat::R8:
+        case InternalFormat::R8_SNORM:
+        case InternalFormat::R8I:
+        case InternalFormat::R8UI:
+        case InternalFormat::R3_G3_B2:
+            return texels;
+        case InternalFormat::R16:
+        case InternalFormat::R16_SNORM:
+        case InternalFormat::R16F:
+        case InternalFormat::R16I:
+        case InternalFormat::R16UI:
+        case InternalFormat::RG8:
+        case InternalFormat::RG8_SNORM:
+        case InternalFormat::RG8I:
+        case InternalFormat::RG8UI:
+        case InternalFormat::RGBA4:
+        case InternalFormat::RGB5_A1:
+        case InternalFormat::DEPTH_COMPONENT16:
+            return texels * 2;
+        case InternalFormat::RGB8:
+        case InternalFormat::RGB8_SNORM:
+        case InternalFormat::RGB8I:
+        case InternalFormat::RGB8UI:
+        case InternalFormat::SRGB8:
+            return texels * 3;
+        case InternalFormat::RGB16_SNORM:
+        case InternalFormat::RGB16F:
+        case InternalFormat::RGB16I:
+        case InternalFormat::RGB16UI:
+            return texels * 6;
+        case InternalFormat::RG32F:
+        case InternalFormat::RG32I:
+        case InternalFormat::RG32UI:
+        case InternalFormat::RGBA16:
+        case InternalFormat::RGBA16F:
+        case InternalFormat::RGBA16I:
+        case InternalFormat::RGBA16UI:
+        case InternalFormat::DEPTH32F_STENCIL8: // the stencil is padded out
+            return texels * 8;
+        case InternalFormat::RGB32F:
+        case InternalFormat::RGB32I:
+        case InternalFormat::RGB32UI:
+            return texels * 12;
+        case InternalFormat::RGBA32F:
+        case InternalFormat::RGBA32I:
+        case InternalFormat::RGBA32UI:
+            return texels * 16;
+        case InternalFormat::COMPRESSED_RED_RGTC1:
+        case InternalFormat::COMPRESSED_SIGNED_RED_RGTC1:
+        case InternalFormat::COMPRESSED_RGB_S3TC_DXT1:
+        case InternalFormat::COMPRESSED_RGBA_S3TC_DXT1:
+        case InternalFormat::COMPRESSED_SRGB_S3TC_DXT1:
+        case InternalFormat::COMPRESSED_SRGB_ALPHA_S3TC_DXT1:
+            return blocks * 8;
+        case InternalFormat::COMPRESSED_RG_RGTC2:
+        case InternalFormat::COMPRESSED_SIGNED_RG_RGTC2:
+        case InternalFormat::COMPRESSED_RGBA_S3TC_DXT3:
+        case InternalFormat::COMPRESSED_RGBA_S3TC_DXT5:
+        case InternalFormat::COMPRESSED_SRGB_ALPHA_S3TC_DXT3:
+        case InternalFormat::COMPRESSED_SRGB_ALPHA_S3TC_DXT5:
+        case InternalFormat::COMPRESSED_RGBA_BPTC_UNORM:
+        case InternalFormat::COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+        case InternalFormat::COMPRESSED_RGB_BPTC_SIGNED_FLOAT:
+        case InternalFormat::COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT:
+            return blocks * 16;
+        default:
+            return texels * 4;
+        }
+    }
+
+    std::size_t Texture::byteSize() const {
+        std::size_t bytes = 0;
+        for (int level = 0; level < m_Levels; level++) {
+            // array layers and cube faces don't shrink with the level
+            const int height = m_Type == Type::Texture1DArray ? m_Height : std::max(m_Height >> level, 1);
+            const int depth  = m_Type == Type::Texture3D ? std::max(m_Depth >> level, 1) : m_Depth;
+            bytes += levelBytes(m_InternalFormat, std::max(m_Width >> level, 1), height, depth);
+        }
+        bytes *= static_cast<std::size_t>(std::max(m_Samples, 1));
+        return m_Type == Type::TextureCubeMap ? bytes * 6 : bytes;
+    }
+
+    bool Texture::isDepthFormat(const InternalFormat internalFormat) {
+        switch (internalFormat) {
+        case InternalFormat::DEPTH_COMPONENT16:
+        case InternalFormat::DEPTH_COMPONENT24:
+        case InternalFormat::DEPTH_COMPONENT32F:
+        case InternalFormat::DEPTH24_STENCIL8:
+        case InternalFormat::DEPTH32F_STENCIL8:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    bool Texture::hasStencil(const InternalFormat internalFormat) {
+        return internalFormat == InternalFormat::DEPTH24_STENCIL8 || internalFormat == InternalFormat::DEPTH32F_STENCIL8;
+    }
+
+    Sampler::Sampler() : Sampler(Settings{}) {
+    }
+
+    Sampler::Sampler(const Settings &settings) : m_Settings(settings) {
+        glCreateSamplers(1, &m_Sampler);
+        glSamplerParameteri(m_Sampler, GL_TEXTURE_MIN_FILTER, static_cast<GLint>(settings.minFilter));
+        glSamplerParameteri(m_Sampler, GL_TEXTURE_MAG_FILTER, static_cast<GLint>(settings.magFilter));
+        glSamplerParameteri(m_Sampler, GL_TEXTURE_WRAP_S, static_cast<GLint>(settings.wrapS));
+        glSamplerParameteri(m_Sampler, GL_TEXTURE_WRAP_T, static_cast<GLint>(settings.wrapT));
+        glSamplerParameteri(m_Sampler, GL_TEXTURE_WRAP_R, static_cast<GLint>(settings.wrapR));
+        glSamplerParameterf(m_Sampler, GL_TEXTURE_MIN_LOD, settings.minLod);
+        glSamplerParameterf(m_Sampler, GL_TEXTURE_MAX_LOD, settings.maxLod);
+        glSamplerParameterfv(m_Sampler, GL_TEXTURE_BORDER_COLOR, ::glm::value_ptr(settings.borderColor));
+
+        if (settings.maxAnisotropy > 1.0f) {
+            float limit = 1.0f;
+            glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &limit);
+            glSamplerParameterf(m_Sampler, GL_TEXTURE_MAX_ANISOTROPY, std::min(settings.maxAnisotropy, limit));
+        }
+
+        if (settings.depthCompare) {
+            glSamplerParameteri(m_Sampler, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+            glSamplerParameteri(m_Sampler, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+        }
+    }
+
+    Sampler::~Sampler() {
+        glDeleteSamplers(1, &m_Sampler);
+    }
+
+    void Sampler::bind(const unsigned int unit) const {
+        glBindSampler(unit, m_Sampler);
+    }
+
+    void Sampler::unbind(const unsigned int unit) {
+        glBindSampler(unit, 0);
+    }
+
+    Renderbuffer::Renderbuffer(Texture::InternalFormat internalFormat, const int width, const int height, const int samples)
+        : m_Renderbuffer(~0U), m_InternalFormat(internalFormat), m_Width(width), m_Height(height), m_Samples(std::max(samples, 0)) {
         glCreateRenderbuffers(1, &m_Renderbuffer);
         if (samples <= 0) {
             glNamedRenderbufferStorage(m_Renderbuffer, static_cast<GLenum>(internalFormat), width, height);
@@ -351,6 +821,10 @@ namespace neuron {
 
     void Renderbuffer::unbind() {}
 
+    std::size_t Renderbuffer::byteSize() const {
+        return Texture::levelBytes(m_InternalFormat, m_Width, m_Height) * static_cast<std::size_t>(std::max(m_Samples, 1));
+    }
+
     Framebuffer::Framebuffer() : m_Framebuffer(~0U) {
         glCreateFramebuffers(1, &m_Framebuffer);
     }
@@ -386,4 +860,25 @@ namespace neuron {
     void Framebuffer::attach_depth_stencil_texture(const std::shared_ptr<Texture> &texture, const int level) const {
         glNamedFramebufferTexture(m_Framebuffer, GL_DEPTH_STENCIL_ATTACHMENT, texture->handle(), level);
     }
+
+    void Framebuffer::attach_color_renderbuffer(const std::shared_ptr<Renderbuffer> &renderbuffer, const uint8_t index) const {
+        glNamedFramebufferRenderbuffer(m_Framebuffer, GL_COLOR_ATTACHMENT0 + index, GL_RENDERBUFFER, renderbuffer->handle());
+    }
+
+    void Framebuffer::attach_depth_renderbuffer(const std::shared_ptr<Renderbuffer> &renderbuffer) const {
+        glNamedFramebufferRenderbuffer(m_Framebuffer, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, renderbuffer->handle());
+    }
+
+    void Framebuffer::attach_depth_stencil_renderbuffer(const std::shared_ptr<Renderbuffer> &renderbuffer) const {
+        glNamedFramebufferRenderbuffer(m_Framebuffer, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, renderbuffer->handle());
+    }
+
+    void Framebuffer::draw_buffers(const std::span<const uint8_t> indices) const {
+        std::vector<GLenum> buffers;
+        buffers.reserve(indices.size());
+        for (const uint8_t index : indices) {
+            buffers.push_back(index == kNoDrawBuffer ? GL_NONE : GL_COLOR_ATTACHMENT0 + index);
+        }
+        glNamedFramebufferDrawBuffers(m_Framebuffer, static_cast<GLsizei>(buffers.size()), buffers.data());
+    }
 } // namespace neuron
@@ -4,7 +4,9 @@
 #include <filesystem>
 #include <glad/gl.h>
 #include <memory>
+#include <span>
 #include <stdexcept>
+#include <string>
 #include <string_view>
 #include <vector>
 
@@ -51,9 +53,18 @@ namespace neuron {
             StreamCopy  = GL_STREAM_COPY,
         };
 
+        // Immutable storage from glNamedBufferStorage, `flags` being GL_MAP_*_BIT, GL_DYNAMIC_STORAGE_BIT and GL_CLIENT_STORAGE_BIT. It can't be resized
+        struct Storage {
+            GLbitfield flags = 0;
+        };
+
         Buffer(std::size_t size, const void *data, Usage usage = Usage::StaticDraw);
+        Buffer(std::size_t size, const void *data, Storage storage);
         ~Buffer();
 
+        Buffer(const Buffer &other)            = delete;
+        Buffer &operator=(const Buffer &other) = delete;
+
         template <typename T>
         static std::shared_ptr<Buffer> create(const std::vector<T> &data, Usage usage = Usage::StaticDraw) {
             return std::make_shared<Buffer>(data.size() * sizeof(T), data.data(), usage);
@@ -94,12 +105,19 @@ namespace neuron {
             set(bufsize, data.data(), usage);
         }
 
+        // A persistent mapping stays valid until unmap(), and can be written from any thread
+        [[nodiscard]] void *map(std::size_t offset, std::size_t length, GLbitfield access) const;
+        void                unmap() const;
+
+        [[nodiscard]] inline std::size_t size() const noexcept { return m_CurrentSize; }
+
         inline unsigned int handle() const noexcept { return m_Buffer; };
 
       private:
         unsigned int m_Buffer;
         Usage        m_CurrentUsage;
         std::size_t  m_CurrentSize;
+        bool         m_Immutable = false;
     };
 
     struct VertexBinding {
@@ -136,6 +154,28 @@ namespace neuron {
         bool         m_HasElementBuffer;
     };
 
+    // Values for the specialization constants of a SPIR-V module, by constant id. Every value is passed as 32 bits, the way GL expects them
+    class SpecializationConstants {
+      public:
+        // setting an id again replaces its value
+        SpecializationConstants &set(uint32_t id, bool value);
+        SpecializationConstants &set(uint32_t id, int32_t value);
+        SpecializationConstants &set(uint32_t id, uint32_t value);
+        SpecializationConstants &set(uint32_t id, float value);
+
+        [[nodiscard]] inline std::span<const uint32_t> ids() const noexcept { return m_Ids; }
+
+        [[nodiscard]] inline std::span<const uint32_t> values() const noexcept { return m_Values; }
+
+        [[nodiscard]] inline bool empty() const noexcept { return m_Ids.empty(); }
+
+      private:
+        SpecializationConstants &setBits(uint32_t id, uint32_t bits);
+
+        std::vector<uint32_t> m_Ids;
+        std::vector<uint32_t> m_Values;
+    };
+
     class ShaderModule {
       public:
         enum class Type {
@@ -149,12 +189,29 @@ namespace neuron {
 
 
         ShaderModule(std::string_view code, Type type);
+
+        // Specializes a SPIR-V module instead of compiling GLSL, needs GL 4.6 or ARB_gl_spirv
+        ShaderModule(std::span<const uint32_t> spirv, Type type, const SpecializationConstants &constants = {}, const std::string &entryPoint = "main");
+
         ~ShaderModule();
 
+        ShaderModule(const ShaderModule &other)            = delete;
+        ShaderModule &operator=(const ShaderModule &other) = delete;
+
         [[nodiscard]] inline unsigned int handle() const noexcept { return m_Shader; };
 
         [[nodiscard]] static std::shared_ptr<ShaderModule> load(const std::filesystem::path &path, Type type);
 
+        // just reads the file, so it is safe off the GL thread
+        [[nodiscard]] static std::string loadSource(const std::filesystem::path &path);
+
+        [[nodiscard]] static std::shared_ptr<ShaderModule> loadSpirv(const std::filesystem::path &path, Type type, const SpecializationConstants &constants = {});
+
+        // Reads and checks a SPIR-V file, safe off the GL thread like loadSource
+        [[nodiscard]] static std::vector<uint32_t> loadSpirvBinary(const std::filesystem::path &path);
+
+        [[nodiscard]] static bool spirvSupported();
+
       private:
         unsigned int m_Shader;
     };
@@ -164,6 +221,9 @@ namespace neuron {
 
     struct ProgramParameters {
         bool separable = false;
+
+        // lets binary() be called on the linked program
+        bool binaryRetrievable = false;
     };
 
     class Shader {
@@ -207,6 +267,7 @@ namespace neuron {
             }
 
             glProgramParameteri(m_Program, GL_PROGRAM_SEPARABLE, parameters.separable);
+            glProgramParameteri(m_Program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, parameters.binaryRetrievable);
 
             glLinkProgram(m_Program);
 
@@ -382,24 +443,63 @@ namespace neuron {
 
         void use() const;
 
+        // A program from glGetProgramBinary output, null if the driver rejects it (which it may do after any driver update)
+        static std::shared_ptr<Shader> fromBinary(GLenum format, std::span<const std::byte> binary, const ProgramParameters &parameters = {});
+
+        // takes ownership of a program that was linked successfully elsewhere
+        static std::shared_ptr<Shader> adopt(unsigned int program);
+
+        // needs ProgramParameters::binaryRetrievable when linking
+        [[nodiscard]] std::vector<std::byte> binary(GLenum &format) const;
+
+        [[nodiscard]] inline unsigned int handle() const noexcept { return m_Program; }
+
       private:
+        explicit Shader(const unsigned int program) : m_Program(program) {}
+
         unsigned int m_Program = ~0U;
     };
 
+    // Combines separable programs (ProgramParameters::separable) stage by stage, so one vertex program can be paired with any fragment program without linking the pair
+    class ProgramPipeline {
+      public:
+        ProgramPipeline();
+        ~ProgramPipeline();
+
+        ProgramPipeline(const ProgramPipeline &other)            = delete;
+        ProgramPipeline &operator=(const ProgramPipeline &other) = delete;
+
+        // `program` has to contain the stage and to stay alive for as long as the pipeline uses it
+        void useStage(ShaderModule::Type stage, const Shader &program) const;
+
+        // and unbinds the current program, which would otherwise take precedence over the pipeline
+        void bind() const;
+
+        // throws with the validation log if the stages don't fit together
+        void validate() const;
+
+        [[nodiscard]] static GLbitfield stageBit(ShaderModule::Type stage);
+
+        [[nodiscard]] inline unsigned int handle() const noexcept { return m_Pipeline; }
+
+      private:
+        unsigned int m_Pipeline = ~0U;
+    };
+
     class Texture {
       public:
         enum class Type {
-            Texture1D,
-            Texture2D,
-            Texture3D,
-            Texture1DArray,
-            Texture2DArray,
-            TextureRectangle,
-            TextureCubeMap,
-            TextureCubeMapArray,
-            TextureBuffer,
-            Texture2DMS,
-            Texture2DMSArray,
+            Texture1D           = GL_TEXTURE_1D,
+            Texture2D           = GL_TEXTURE_2D,
+            Texture3D           = GL_TEXTURE_3D,
+            Texture1DArray      = GL_TEXTURE_1D_ARRAY,
+            Texture2DArray      = GL_TEXTURE_2D_ARRAY,
+            TextureRectangle    = GL_TEXTURE_RECTANGLE,
+            TextureCubeMap      = GL_TEXTURE_CUBE_MAP,
+            TextureCubeMapArray = GL_TEXTURE_CUBE_MAP_ARRAY,
+            TextureBuffer       = GL_TEXTURE_BUFFER,
+            Texture2DMS         = GL_TEXTURE_2D_MULTISAMPLE,
+            Texture2DMSArray    = GL_TEXTURE_2D_MULTISAMPLE_ARRAY,
         };
 
         enum class Format {
@@ -481,19 +581,36 @@ namespace neuron {
             RGBA32I        = GL_RGBA32I,
             RGBA32UI       = GL_RGBA32UI,
 
+            DEPTH_COMPONENT16  = GL_DEPTH_COMPONENT16,
+            DEPTH_COMPONENT24  = GL_DEPTH_COMPONENT24,
+            DEPTH_COMPONENT32F = GL_DEPTH_COMPONENT32F,
+            DEPTH24_STENCIL8   = GL_DEPTH24_STENCIL8,
+            DEPTH32F_STENCIL8  = GL_DEPTH32F_STENCIL8,
+
             COMPRESSED_RED                     = GL_COMPRESSED_RED,
             COMPRESSED_RG                      = GL_COMPRESSED_RG,
             COMPRESSED_RGB                     = GL_COMPRESSED_RGB,
             COMPRESSED_RGBA                    = GL_COMPRESSED_RGBA,
             COMPRESSED_SRGB                    = GL_COMPRESSED_SRGB,
             COMPRESSED_SRGB_ALPHA              = GL_COMPRESSED_SRGB_ALPHA,
+            COMPRESSED_RED_RGTC1               = GL_COMPRESSED_RED_RGTC1,
             COMPRESSED_SIGNED_RED_RGTC1        = GL_COMPRESSED_SIGNED_RED_RGTC1,
-            COMPRESSED_RG_RGTC2                = GL_COMPRESSED_SIGNED_RG_RGTC2,
+            COMPRESSED_RG_RGTC2                = GL_COMPRESSED_RG_RGTC2,
             COMPRESSED_SIGNED_RG_RGTC2         = GL_COMPRESSED_SIGNED_RG_RGTC2,
             COMPRESSED_RGBA_BPTC_UNORM         = GL_COMPRESSED_RGBA_BPTC_UNORM,
             COMPRESSED_SRGB_ALPHA_BPTC_UNORM   = GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM,
             COMPRESSED_RGB_BPTC_SIGNED_FLOAT   = GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT,
             COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT = GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT,
+
+            // EXT_texture_compression_s3tc and EXT_texture_sRGB, which every desktop driver has
+            COMPRESSED_RGB_S3TC_DXT1        = GL_COMPRESSED_RGB_S3TC_DXT1_EXT,
+            COMPRESSED_RGBA_S3TC_DXT1       = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,
+            COMPRESSED_RGBA_S3TC_DXT3       = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT,
+            COMPRESSED_RGBA_S3TC_DXT5       = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,
+            COMPRESSED_SRGB_S3TC_DXT1       = GL_COMPRESSED_SRGB_S3TC_DXT1_EXT,
+            COMPRESSED_SRGB_ALPHA_S3TC_DXT1 = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT,
+            COMPRESSED_SRGB_ALPHA_S3TC_DXT3 = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT,
+            COMPRESSED_SRGB_ALPHA_S3TC_DXT5 = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT,
         };
 
         enum class DataType {
@@ -510,18 +627,146 @@ namespace neuron {
         explicit Texture(Type type);
         ~Texture();
 
+        Texture(const Texture &other)            = delete;
+        Texture &operator=(const Texture &other) = delete;
+
+        // Immutable storage with a single level, filled with `data` if there is any
         static std::shared_ptr<Texture> create2d(int width, int height, Format format = Format::RGBA, InternalFormat internal_format = InternalFormat::RGBA8, DataType dataType = DataType::UnsignedByte, const void *data = nullptr);
 
+        // `levels` 0 means the whole mip chain
+        static std::shared_ptr<Texture> createStorage2d(int width, int height, InternalFormat internalFormat, int levels = 0);
+        static std::shared_ptr<Texture> createArray2d(int width, int height, int layers, InternalFormat internalFormat, int levels = 0);
+        static std::shared_ptr<Texture> createCube(int size, InternalFormat internalFormat, int levels = 0);
+        static std::shared_ptr<Texture> createMultisample2d(int width, int height, int samples, InternalFormat internalFormat);
+
+        /**
+         * Immutable storage for every level at once, which spares the driver completeness checks and reallocations. Can only happen once per texture.
+         * storage2d is for 2D, rectangle, cube map (width == height) and 1D array textures (height is the layer count),
+         * storage3d for 3D, 2D array and cube map array textures (depth is the layer count, six per cube)
+         */
+        void storage2d(int levels, InternalFormat internalFormat, int width, int height);
+        void storage3d(int levels, InternalFormat internalFormat, int width, int height, int depth);
+
+        // for 2D multisample textures, which have a single level and can only be rendered to and fetched from
+        void storage2dMultisample(int samples, InternalFormat internalFormat, int width, int height);
+
+        // z is the layer for arrays, the face for cube maps and layer * 6 + face for cube map arrays
+        void subImage2d(int level, int x, int y, int width, int height, Format format, DataType dataType, const void *data) const;
+        void subImage3d(int level, int x, int y, int z, int width, int height, int depth, Format format, DataType dataType, const void *data) const;
+
+        // `size` is the byte size of the compressed blocks, the format is the one the storage was made with
+        void compressedSubImage2d(int level, int x, int y, int width, int height, std::size_t size, const void *data) const;
+        void compressedSubImage3d(int level, int x, int y, int z, int width, int height, int depth, std::size_t size, const void *data) const;
+
+        // fills every level below the base from level 0
+        void generateMipmaps() const;
+
+        // Sampling is limited to levels from `level` down, so levels that haven't been filled yet are never read
+        void setBaseLevel(int level) const;
+
+        // Mutable storage for a single level. Prefer storage2d and subImage2d, this doesn't work on immutable textures
         void image2d(int width, int height, Format format = Format::RGBA, InternalFormat internalFormat = InternalFormat::RGBA8, DataType dataType = DataType::UnsignedByte, const void *data = nullptr) const;
         void image2d(int width, int height, int level, Format format = Format::RGBA, InternalFormat internal_format = InternalFormat::RGBA8, DataType dataType = DataType::UnsignedByte, const void *data = nullptr) const;
 
         void bind() const;
 
+        void bind(unsigned int unit) const;
+
+        // levels in a full mip chain for the size
+        [[nodiscard]] static int mipLevels(int width, int height = 1, int depth = 1);
+
+        // of one level, block compressed formats are counted in whole blocks. Formats this doesn't know are counted as 4 bytes per texel
+        [[nodiscard]] static std::size_t levelBytes(InternalFormat internalFormat, int width, int height, int depth = 1);
+
+        // the sized depth and depth stencil formats
+        [[nodiscard]] static bool isDepthFormat(InternalFormat internalFormat);
+        [[nodiscard]] static bool hasStencil(InternalFormat internalFormat);
+
+        // of the whole storage, 0 until storage2d, storage3d or storage2dMultisample. Multisampled storage counts every sample
+        [[nodiscard]] std::size_t byteSize() const;
+
+        [[nodiscard]] inline Type type() const { return m_Type; }
+
+        [[nodiscard]] inline int width() const { return m_Width; }
+
+        [[nodiscard]] inline int height() const { return m_Height; }
+
+        [[nodiscard]] inline int depth() const { return m_Depth; }
+
+        [[nodiscard]] inline int levels() const { return m_Levels; }
+
+        // 0 unless the storage is multisampled
+        [[nodiscard]] inline int samples() const { return m_Samples; }
+
+        [[nodiscard]] inline InternalFormat internalFormat() const { return m_InternalFormat; }
+
+        [[nodiscard]] inline bool immutable() const { return m_Immutable; }
+
         [[nodiscard]] inline unsigned int handle() const { return m_Texture; };
 
       private:
-        unsigned int m_Texture;
-        Type         m_Type;
+        unsigned int   m_Texture;
+        Type           m_Type;
+        InternalFormat m_InternalFormat = InternalFormat::RGBA8;
+        int            m_Width          = 0;
+        int            m_Height         = 0;
+        int            m_Depth          = 0;
+        int            m_Levels         = 0;
+        int            m_Samples        = 0;
+        bool           m_Immutable      = false;
+    };
+
+    // Sampling state kept apart from the texture, so one texture can be sampled in several ways and a handful of samplers serve every texture
+    class Sampler {
+      public:
+        enum class Filter {
+            Nearest              = GL_NEAREST,
+            Linear               = GL_LINEAR,
+            NearestMipmapNearest = GL_NEAREST_MIPMAP_NEAREST,
+            LinearMipmapNearest  = GL_LINEAR_MIPMAP_NEAREST,
+            NearestMipmapLinear  = GL_NEAREST_MIPMAP_LINEAR,
+            LinearMipmapLinear   = GL_LINEAR_MIPMAP_LINEAR,
+        };
+
+        enum class Wrap {
+            Repeat            = GL_REPEAT,
+            MirroredRepeat    = GL_MIRRORED_REPEAT,
+            ClampToEdge       = GL_CLAMP_TO_EDGE,
+            ClampToBorder     = GL_CLAMP_TO_BORDER,
+            MirrorClampToEdge = GL_MIRROR_CLAMP_TO_EDGE,
+        };
+
+        struct Settings {
+            Filter    minFilter     = Filter::LinearMipmapLinear;
+            Filter    magFilter     = Filter::Linear;
+            Wrap      wrapS         = Wrap::Repeat;
+            Wrap      wrapT         = Wrap::Repeat;
+            Wrap      wrapR         = Wrap::Repeat;
+            float     maxAnisotropy = 1.0f; // clamped to what the driver allows
+            float     minLod        = -1000.0f;
+            float     maxLod        = 1000.0f;
+            glm::vec4 borderColor   = glm::vec4(0.0f);
+            bool      depthCompare  = false; // for sampler2DShadow and friends, compares with GL_LEQUAL
+        };
+
+        Sampler();
+        explicit Sampler(const Settings &settings);
+        ~Sampler();
+
+        Sampler(const Sampler &other)            = delete;
+        Sampler &operator=(const Sampler &other) = delete;
+
+        void bind(unsigned int unit) const;
+
+        static void unbind(unsigned int unit);
+
+        [[nodiscard]] inline const Settings &settings() const { return m_Settings; }
+
+        [[nodiscard]] inline unsigned int handle() const { return m_Sampler; }
+
+      private:
+        unsigned int m_Sampler = ~0U;
+        Settings     m_Settings;
     };
 
     class Renderbuffer {
@@ -535,8 +780,23 @@ namespace neuron {
 
         [[nodiscard]] inline unsigned int handle() const { return m_Renderbuffer; };
 
+        [[nodiscard]] inline Texture::InternalFormat internalFormat() const { return m_InternalFormat; }
+
+        [[nodiscard]] inline int width() const { return m_Width; }
+
+        [[nodiscard]] inline int height() const { return m_Height; }
+
+        [[nodiscard]] inline int samples() const { return m_Samples; }
+
+        // counting every sample
+        [[nodiscard]] std::size_t byteSize() const;
+
     private:
-        unsigned int m_Renderbuffer;
+        unsigned int            m_Renderbuffer;
+        Texture::InternalFormat m_InternalFormat;
+        int                     m_Width;
+        int                     m_Height;
+        int                     m_Samples;
     };
 
     class Framebuffer {
@@ -560,6 +820,16 @@ namespace neuron {
         void attach_stencil_texture(const std::shared_ptr<Texture>& texture, int level = 0) const;
         void attach_depth_stencil_texture(const std::shared_ptr<Texture>& texture, int level = 0) const;
 
+        void attach_color_renderbuffer(const std::shared_ptr<Renderbuffer>& renderbuffer, uint8_t index) const;
+        void attach_depth_renderbuffer(const std::shared_ptr<Renderbuffer>& renderbuffer) const;
+        void attach_depth_stencil_renderbuffer(const std::shared_ptr<Renderbuffer>& renderbuffer) const;
+
+        // for draw_buffers(), an output that isn't written anywhere
+        static constexpr uint8_t kNoDrawBuffer = UINT8_MAX;
+
+        // which color attachments fragment outputs 0, 1, ... go to, kNoDrawBuffer for GL_NONE
+        void draw_buffers(std::span<const uint8_t> indices) const;
+
         [[nodiscard]] inline unsigned int handle() const { return m_Framebuffer; };
     private:
         unsigned int m_Framebuffer;
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+namespace neuron {
+
+    // Not cryptographic, just a quick 64 bit hash for cache keys. Chain calls through `seed` to hash several pieces
+    inline uint64_t hashBytes(const std::span<const std::byte> bytes, uint64_t seed = 0) {
+        constexpr uint64_t kMultiplier = 0x9E3779B97F4A7C15ULL;
+
+        uint64_t    hash = seed;
+        std::size_t i    = 0;
+        for (; i + sizeof(uint64_t) <= bytes.size(); i += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, bytes.data() + i, sizeof(word));
+            hash = std::rotl((hash ^ word) * kMultiplier, 29);
+        }
+        for (; i < bytes.size(); i++) {
+            hash = (hash ^ static_cast<uint8_t>(bytes[i])) * 0x100000001B3ULL;
+        }
+
+        hash ^= bytes.size();
+        hash ^= hash >> 33;
+        hash *= 0xFF51AFD7ED558CCDULL;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    inline uint64_t hashString(const std::string_view string, const uint64_t seed = 0) {
+        return hashBytes(std::as_bytes(std::span(string.data(), string.size())), seed);
+    }
+
+} // namespace neuron
@@ -0,0 +1,125 @@
+#include "image.hpp"
+
+#include "neuron/mapped_file.hpp"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace neuron {
+    namespace {
+        const std::array<float, 256> &srgbToLinear() {
+            static const std::array<float, 256> table = [] {
+                std::array<float, 256> values{};
+                for (int i = 0; i < 256; i++) {
+                    const float c = static_cast<float>(i) / 255.0f;
+                    values[i]     = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+                }
+                return values;
+            }();
+            return table;
+        }
+
+        uint8_t linearToSrgb(const float value) {
+            const float c = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+            return static_cast<uint8_t>(std::clamp(c * 255.0f + 0.5f, 0.0f, 255.0f));
+        }
+    } // namespace
+
+    Image Image::load(const std::filesystem::path &path) {
+        const MappedFile file(path);
+        try {
+            return decode(file.bytes());
+        } catch (const std::exception &e) {
+            throw std::runtime_error("Could not load image " + path.string() + ": " + e.what());
+        }
+    }
+
+    Image Image::decode(const std::span<const std::byte> encoded) {
+        int      width, height, channels;
+        stbi_uc *data = stbi_load_from_memory(reinterpret_cast<const stbi_uc *>(encoded.data()), static_cast<int>(encoded.size()), &width, &height, &channels, 4);
+        if (data == nullptr) {
+            throw std::runtime_error(stbi_failure_reason());
+        }
+
+        Image image;
+        image.width  = width;
+        image.height = height;
+        image.pixels.assign(data, data + static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * 4);
+        stbi_image_free(data);
+        return image;
+    }
+
+    Image Image::downsample(const bool srgb) const {
+        Image next;
+        next.width  = std::max(width / 2, 1);
+        next.height = std::max(height / 2, 1);
+        next.pixels.resize(static_cast<std::size_t>(next.width) * static_cast<std::size_t>(next.height) * 4);
+
+        const auto &toLinear = srgbToLinear();
+
+        // a source dimension of 1 doesn't shrink, an odd one folds its last texel into the last output texel
+        const auto footprint = [](const int out, const int size, const int outSize) {
+            const int first = size == 1 ? 0 : out * 2;
+            const int last  = size == 1 ? 0 : out == outSize - 1 ? size - 1 : first + 1;
+            return std::pair(first, last);
+        };
+
+        for (int y = 0; y < next.height; y++) {
+            const auto [y0, y1] = footprint(y, height, next.height);
+            for (int x = 0; x < next.width; x++) {
+                const auto [x0, x1] = footprint(x, width, next.width);
+
+                float sum[4] = {};
+                for (int sy = y0; sy <= y1; sy++) {
+                    for (int sx = x0; sx <= x1; sx++) {
+                        const uint8_t *texel = &pixels[(static_cast<std::size_t>(sy) * width + sx) * 4];
+                        for (int c = 0; c < 4; c++) {
+                            // alpha is always linear
+                            sum[c] += srgb && c < 3 ? toLinear[texel[c]] : static_cast<float>(texel[c]) / 255.0f;
+                        }
+                    }
+                }
+
+                const float scale = 1.0f / static_cast<float>((y1 - y0 + 1) * (x1 - x0 + 1));
+                uint8_t    *out   = &next.pixels[(static_cast<std::size_t>(y) * next.width + x) * 4];
+                for (int c = 0; c < 4; c++) {
+                    out[c] = srgb && c < 3 ? linearToSrgb(sum[c] * scale) : static_cast<uint8_t>(std::clamp(sum[c] * scale * 255.0f + 0.5f, 0.0f, 255.0f));
+                }
+            }
+        }
+        return next;
+    }
+
+    std::vector<Image> Image::mipChain(const bool srgb) && {
+        std::vector<Image> levels;
+        levels.push_back(std::move(*this));
+        while (levels.back().width > 1 || levels.back().height > 1) {
+            levels.push_back(levels.back().downsample(srgb));
+        }
+        return levels;
+    }
+
+    double Image::psnr(const Image &other, const int channels) const {
+        if (other.width != width || other.height != height) {
+            throw std::runtime_error("Images of different sizes can't be compared");
+        }
+
+        double squared = 0.0;
+        for (std::size_t i = 0; i < pixels.size(); i += 4) {
+            for (int c = 0; c < channels; c++) {
+                const double difference = static_cast<double>(pixels[i + c]) - static_cast<double>(other.pixels[i + c]);
+                squared += difference * difference;
+            }
+        }
+
+        const double mse = squared / (static_cast<double>(pixels.size() / 4) * channels);
+        return mse == 0.0 ? std::numeric_limits<double>::infinity() : 10.0 * std::log10(255.0 * 255.0 / mse);
+    }
+} // namespace neuron
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace neuron {
+
+    // 8 bit RGBA pixels, rows top to bottom and tightly packed
+    struct Image {
+        int                  width  = 0;
+        int                  height = 0;
+        std::vector<uint8_t> pixels;
+
+        // PNG, JPEG, TGA, BMP, PSD, GIF, HDR (tone mapped to 8 bits) and PNM through stb_image. Only reads files, so it's safe off the GL thread
+        [[nodiscard]] static Image load(const std::filesystem::path &path);
+
+        [[nodiscard]] static Image decode(std::span<const std::byte> encoded);
+
+        // The next mip level, a 2x2 box filter (3 wide along odd edges so nothing is dropped). With `srgb` the filtering happens on linear values
+        [[nodiscard]] Image downsample(bool srgb) const;
+
+        // this image followed by every smaller level down to 1x1
+        [[nodiscard]] std::vector<Image> mipChain(bool srgb) &&;
+
+        // Peak signal to noise ratio in dB against an image of the same size, over the first `channels` channels. Infinite if they're identical
+        [[nodiscard]] double psnr(const Image &other, int channels = 4) const;
+
+        [[nodiscard]] inline std::size_t byteSize() const { return pixels.size(); }
+    };
+
+} // namespace neuron
@@ -0,0 +1,117 @@
+#include "mapped_file.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace neuron {
+#ifdef _WIN32
+    MappedFile::MappedFile(const std::filesystem::path &path) {
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Could not open file " + path.string());
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) {
+            CloseHandle(file);
+            throw std::runtime_error("Could not get the size of " + path.string());
+        }
+        m_Size = static_cast<std::size_t>(size.QuadPart);
+
+        // empty files can't be mapped, they just have no bytes
+        if (m_Size > 0) {
+            m_Mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (m_Mapping != nullptr) {
+                m_Data = static_cast<const std::byte *>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+            }
+        }
+        CloseHandle(file);
+
+        if (m_Size > 0 && m_Data == nullptr) {
+            unmap();
+            throw std::runtime_error("Could not map " + path.string());
+        }
+    }
+
+    void MappedFile::unmap() {
+        if (m_Data != nullptr) {
+            UnmapViewOfFile(m_Data);
+        }
+        if (m_Mapping != nullptr) {
+            CloseHandle(m_Mapping);
+        }
+        m_Data    = nullptr;
+        m_Mapping = nullptr;
+        m_Size    = 0;
+    }
+#else
+    MappedFile::MappedFile(const std::filesystem::path &path) {
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Could not open file " + path.string());
+        }
+
+        struct stat info {};
+        if (fstat(fd, &info) != 0) {
+            close(fd);
+            throw std::runtime_error("Could not get the size of " + path.string());
+        }
+        m_Size = static_cast<std::size_t>(info.st_size);
+
+        // empty files can't be mapped, they just have no bytes
+        if (m_Size > 0) {
+            void *data = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                close(fd);
+                throw std::runtime_error("Could not map " + path.string());
+            }
+            m_Data = static_cast<const std::byte *>(data);
+        }
+        close(fd); // the mapping keeps its own reference
+    }
+
+    void MappedFile::unmap() {
+        if (m_Data != nullptr) {
+            munmap(const_cast<std::byte *>(m_Data), m_Size);
+        }
+        m_Data = nullptr;
+        m_Size = 0;
+    }
+#endif
+
+    MappedFile::~MappedFile() {
+        unmap();
+    }
+
+    MappedFile::MappedFile(MappedFile &&other) noexcept
+        : m_Data(std::exchange(other.m_Data, nullptr)), m_Size(std::exchange(other.m_Size, 0))
+#ifdef _WIN32
+          ,
+          m_Mapping(std::exchange(other.m_Mapping, nullptr))
+#endif
+    {
+    }
+
+    MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+        if (this != &other) {
+            unmap();
+            m_Data = std::exchange(other.m_Data, nullptr);
+            m_Size = std::exchange(other.m_Size, 0);
+#ifdef _WIN32
+            m_Mapping = std::exchange(other.m_Mapping, nullptr);
+#endif
+        }
+        return *this;
+    }
+} // namespace neuron
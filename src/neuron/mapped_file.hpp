@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace neuron {
+
+    // A whole file mapped read only. The bytes stay valid for the lifetime of the object, the file must not be modified while it's mapped.
+    class MappedFile {
+      public:
+        explicit MappedFile(const std::filesystem::path &path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile &other)            = delete;
+        MappedFile &operator=(const MappedFile &other) = delete;
+        MappedFile(MappedFile &&other) noexcept;
+        MappedFile &operator=(MappedFile &&other) noexcept;
+
+        [[nodiscard]] inline std::span<const std::byte> bytes() const { return {m_Data, m_Size}; }
+
+        [[nodiscard]] inline std::size_t size() const { return m_Size; }
+
+      private:
+        void unmap();
+
+        const std::byte *m_Data = nullptr;
+        std::size_t      m_Size = 0;
+#ifdef _WIN32
+        void *m_Mapping = nullptr;
+#endif
+    };
+
+} // namespace neuron
@@ -7,6 +7,7 @@
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 
+#include <numeric>
 #include <span>
 
 namespace neuron {
@@ -188,6 +189,10 @@ namespace neuron {
         m_VertexBuffer = Buffer::create(data.vertices);
         m_VertexCount  = data.vertices.size();
 
+        for (const auto &vertex : data.vertices) {
+            m_Bounds.expand(glm::vec3(vertex.position));
+        }
+
         if (m_Mode == Mode::ElementArray || m_Mode == Mode::ElementArrayMultiDraw) {
             m_ElementBuffer  = Buffer::create(data.indices);
             m_IndexCount     = data.indices.size();
@@ -201,12 +206,29 @@ namespace neuron {
                 draws.push_back({count, 1, start, 0, 0});
             }
 
-            m_DrawBuffer = Buffer::create(draws);
-            m_DrawCount  = draws.size();
+            m_DrawBuffer   = Buffer::create(draws);
+            m_DrawCount    = draws.size();
+            m_DrawCommands = std::move(draws);
         }
 
         m_PType = data.ptype;
 
+        // primitive restart only matters for strips and fans, so a triangle list's indices can be used as they are
+        const std::size_t triangles = (m_Mode == Mode::Array ? data.vertices.size() : data.indices.size()) / 3;
+        if (m_PType == PType::Triangles && triangles > 0 && triangles <= kMaxOccluderTriangles) {
+            m_OccluderPositions.reserve(data.vertices.size());
+            for (const auto &vertex : data.vertices) {
+                m_OccluderPositions.emplace_back(vertex.position);
+            }
+
+            if (m_Mode == Mode::Array) {
+                m_OccluderIndices.resize(triangles * 3);
+                std::iota(m_OccluderIndices.begin(), m_OccluderIndices.end(), 0U);
+            } else {
+                m_OccluderIndices.assign(data.indices.begin(), data.indices.begin() + static_cast<std::ptrdiff_t>(triangles * 3));
+            }
+        }
+
         m_VertexArray = std::make_shared<VertexArray>(
             VertexLayout{
                 .bindings = {{
@@ -251,14 +273,24 @@ namespace neuron {
     }
 
     std::vector<std::shared_ptr<Mesh>> Mesh::loadWithAssimp(const std::filesystem::path &path) {
+        std::vector<std::shared_ptr<Mesh>> meshes;
+        for (const auto &meshData : Data::loadWithAssimp(path)) {
+            meshes.push_back(std::make_shared<Mesh>(meshData));
+        }
+        return meshes;
+    }
+
+    const unsigned int Mesh::Data::kAssimpFlags = aiProcess_CalcTangentSpace | aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_SortByPType;
+
+    std::vector<Mesh::Data> Mesh::Data::loadWithAssimp(const std::filesystem::path &path) {
         Assimp::Importer importer;
-        const aiScene *  scene = importer.ReadFile(path.string(), aiProcess_CalcTangentSpace | aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_SortByPType);
+        const aiScene *  scene = importer.ReadFile(path.string(), kAssimpFlags);
 
         if (scene == nullptr) {
             throw std::runtime_error("Failed to load model");
         }
 
-        std::vector<std::shared_ptr<Mesh>> meshes;
+        std::vector<Data> meshes;
 
         for (std::size_t i = 0; i < scene->mNumMeshes; i++) {
             aiMesh *   mesh = scene->mMeshes[i];
@@ -321,7 +353,7 @@ namespace neuron {
             meshData.mode        = Mode::ElementArray;
             meshData.primrestart = false;
 
-            meshes.push_back(std::make_shared<Mesh>(meshData));
+            meshes.push_back(std::move(meshData));
         }
 
         return meshes;
@@ -352,5 +384,47 @@ namespace neuron {
         }
     }
 
+    void Mesh::prepareDraw() const {
+        m_VertexArray->bind();
+
+        if (m_Mode != Mode::Array && m_SetPrimrestart) {
+            glEnable(GL_PRIMITIVE_RESTART);
+            glPrimitiveRestartIndex(~0U);
+        }
+    }
+
+    bool Mesh::appendInstancedCommands(std::vector<DrawElementsIndirectCommand> &commands, const GLuint instanceCount, const GLuint baseInstance) const {
+        if (m_Mode == Mode::ElementArray) {
+            commands.push_back({static_cast<GLuint>(m_IndexCount), instanceCount, 0, 0, baseInstance});
+            return true;
+        }
+
+        if (m_Mode == Mode::ElementArrayMultiDraw) {
+            for (const auto &draw : m_DrawCommands) {
+                commands.push_back({draw.count, instanceCount, draw.firstIndex, draw.baseVertex, baseInstance});
+            }
+            return true;
+        }
+
+        return false;
+    }
+
+    void Mesh::drawIndirect(const std::size_t firstCommand, const std::size_t commandCount) const {
+        prepareDraw();
+
+        const auto offset = reinterpret_cast<const void *>(firstCommand * sizeof(DrawElementsIndirectCommand));
+        glMultiDrawElementsIndirect(static_cast<GLenum>(m_PType), GL_UNSIGNED_INT, offset, static_cast<GLsizei>(commandCount), 0);
+    }
+
+    void Mesh::drawInstanced(const GLuint instanceCount, const GLuint baseInstance) const {
+        prepareDraw();
+
+        if (m_Mode == Mode::Array) {
+            glDrawArraysInstancedBaseInstance(static_cast<GLenum>(m_PType), 0, static_cast<GLsizei>(m_VertexCount), static_cast<GLsizei>(instanceCount), baseInstance);
+        } else {
+            glDrawElementsInstancedBaseInstance(static_cast<GLenum>(m_PType), static_cast<GLsizei>(m_IndexCount), GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(instanceCount), baseInstance);
+        }
+    }
+
 
 } // namespace neuron
@@ -4,9 +4,11 @@
 
 #include <filesystem>
 #include <glm/glm.hpp>
+#include <span>
 #include <string_view>
 #include <vector>
 
+#include "neuron/aabb.hpp"
 #include "neuron/glwrap.hpp"
 
 namespace neuron {
@@ -43,8 +45,21 @@ namespace neuron {
             std::vector<std::pair<unsigned int, unsigned int>> draws;
 
             static Data loadFromNMeshFile(const std::filesystem::path &path);
+
+            // CPU side only, so unlike Mesh::loadWithAssimp this is fine to call off the GL thread
+            static std::vector<Data> loadWithAssimp(const std::filesystem::path &path);
+
+            // the post processing steps loadWithAssimp runs, which the import cache keys on
+            static const unsigned int kAssimpFlags;
+
+            [[nodiscard]] inline std::size_t sizeInBytes() const {
+                return vertices.size() * sizeof(StandardVertex) + indices.size() * sizeof(unsigned int) + draws.size() * sizeof(std::pair<unsigned int, unsigned int>);
+            }
         };
 
+        // larger triangle lists aren't kept for software occlusion, they'd cost more to rasterize than they save
+        static constexpr std::size_t kMaxOccluderTriangles = 1 << 16;
+
         explicit Mesh(const Data &data);
         ~Mesh() = default;
 
@@ -54,22 +69,52 @@ namespace neuron {
 
         void draw();
 
+        // Appends the indirect commands for drawing `instanceCount` instances starting at `baseInstance`. Returns false (and appends nothing) for meshes that don't draw with elements.
+        bool appendInstancedCommands(std::vector<DrawElementsIndirectCommand> &commands, GLuint instanceCount, GLuint baseInstance) const;
+
+        // Draws `commandCount` commands starting at `firstCommand` from the currently bound draw indirect buffer
+        void drawIndirect(std::size_t firstCommand, std::size_t commandCount) const;
+
+        void drawInstanced(GLuint instanceCount, GLuint baseInstance) const;
+
+        // size of the vertex, element and indirect buffers
+        [[nodiscard]] inline std::size_t gpuBytes() const {
+            return m_VertexCount * sizeof(StandardVertex) + m_IndexCount * sizeof(unsigned int) + m_DrawCommands.size() * sizeof(DrawElementsIndirectCommand);
+        }
+
+        // object space bounds of all vertices
+        [[nodiscard]] inline const AABB &bounds() const { return m_Bounds; }
+
+        // A CPU copy of the triangles for SoftwareOcclusionBuffer, empty unless the mesh is a triangle list of at most kMaxOccluderTriangles
+        [[nodiscard]] inline std::span<const glm::vec3> occluderPositions() const { return m_OccluderPositions; }
+
+        [[nodiscard]] inline std::span<const unsigned int> occluderIndices() const { return m_OccluderIndices; }
+
+        [[nodiscard]] inline std::size_t cpuBytes() const { return m_OccluderPositions.size() * sizeof(glm::vec3) + m_OccluderIndices.size() * sizeof(unsigned int); }
 
       private:
+        void prepareDraw() const;
+
         Mode m_Mode;
 
         std::shared_ptr<Buffer>      m_VertexBuffer;
         std::shared_ptr<Buffer>      m_ElementBuffer;
         std::shared_ptr<VertexArray> m_VertexArray;
 
-        std::shared_ptr<Buffer> m_DrawBuffer;
+        std::shared_ptr<Buffer>                  m_DrawBuffer;
+        std::vector<DrawElementsIndirectCommand> m_DrawCommands;
 
-        std::size_t m_VertexCount;
-        std::size_t m_IndexCount;
-        std::size_t m_DrawCount;
+        std::size_t m_VertexCount = 0;
+        std::size_t m_IndexCount  = 0;
+        std::size_t m_DrawCount   = 0;
 
         PType m_PType;
         bool  m_SetPrimrestart;
+
+        AABB m_Bounds;
+
+        std::vector<glm::vec3>    m_OccluderPositions;
+        std::vector<unsigned int> m_OccluderIndices;
     };
 
 } // namespace neuron
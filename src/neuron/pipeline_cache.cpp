@@ -0,0 +1,73 @@
+#include "pipeline_cache.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace neuron {
+    ProgramPipelineCache::ProgramPipelineCache(ProgramBinaryCache *binaries) : m_Binaries(binaries) {
+    }
+
+    std::shared_ptr<Shader> ProgramPipelineCache::stage(const std::string &source, const ShaderModule::Type type) {
+        // exact for the same reason as the pipeline keys, the source is copied once per lookup but a miss costs a compile anyway
+        std::string key = std::to_string(static_cast<GLenum>(type)) + ":" + source;
+        if (const auto it = m_Stages.find(key); it != m_Stages.end()) {
+            m_Stats.stageHits++;
+            return it->second;
+        }
+
+        const ProgramParameters           parameters{.separable = true};
+        const ProgramBinaryCache::Sources sources{{source, type}};
+
+        std::shared_ptr<Shader> program;
+        if (m_Binaries != nullptr) {
+            program = m_Binaries->load(sources, parameters);
+        } else {
+            program = std::make_shared<Shader>(parameters, std::vector{std::make_shared<ShaderModule>(source, type)});
+        }
+
+        m_Stats.stageMisses++;
+        m_Stages.emplace(std::move(key), program);
+        return program;
+    }
+
+    const ProgramPipeline &ProgramPipelineCache::pipeline(const std::span<const PipelineStage> stages) {
+        if (stages.empty()) {
+            throw std::invalid_argument("A program pipeline needs at least one stage");
+        }
+
+        std::vector<PipelineStage> sorted(stages.begin(), stages.end());
+        std::ranges::sort(sorted, {}, [](const PipelineStage &stage) { return static_cast<GLenum>(stage.type); });
+
+        // exact, rather than hashed, since a collision here would silently draw with the wrong program
+        std::string key;
+        for (const auto &[type, program] : sorted) {
+            if (program == nullptr) {
+                throw std::invalid_argument("Program pipeline stage without a program");
+            }
+            key += std::to_string(static_cast<GLenum>(type)) + ":" + std::to_string(program->handle()) + ";";
+        }
+
+        if (const auto it = m_Pipelines.find(key); it != m_Pipelines.end()) {
+            m_Stats.pipelineHits++;
+            return *it->second.pipeline;
+        }
+
+        Entry entry{std::make_unique<ProgramPipeline>(), {}};
+        for (const auto &[type, program] : sorted) {
+            entry.pipeline->useStage(type, *program);
+            entry.programs.push_back(program);
+        }
+#ifndef NDEBUG
+        // validation also checks the bound state (samplers and such), which is only meaningful here in debug builds where it catches interface mismatches
+        entry.pipeline->validate();
+#endif
+
+        m_Stats.pipelineMisses++;
+        return *m_Pipelines.emplace(std::move(key), std::move(entry)).first->second.pipeline;
+    }
+
+    void ProgramPipelineCache::clear() {
+        m_Pipelines.clear();
+        m_Stages.clear();
+    }
+} // namespace neuron
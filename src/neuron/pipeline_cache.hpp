@@ -0,0 +1,66 @@
+#pragma once
+
+#include "neuron/glwrap.hpp"
+#include "neuron/program_cache.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace neuron {
+
+    struct PipelineStage {
+        ShaderModule::Type      type;
+        std::shared_ptr<Shader> program; // linked with ProgramParameters::separable
+    };
+
+    struct PipelineCacheStats {
+        uint64_t pipelineHits   = 0;
+        uint64_t pipelineMisses = 0;
+        uint64_t stageHits      = 0;
+        uint64_t stageMisses    = 0; // stage programs built, each one link instead of one per combination
+    };
+
+    /**
+     * Single stage separable programs and the pipelines combining them. Stage programs are keyed by their stage and full final source and go through the program binary cache,
+     * pipelines are keyed by which program sits in which stage, so N vertex and M fragment variants cost N + M links and at most N * M cheap pipeline objects
+     * instead of N * M links. Everything is kept until clear(), which is what keeps the program handles in the keys unique. GL thread only.
+     */
+    class ProgramPipelineCache {
+      public:
+        explicit ProgramPipelineCache(ProgramBinaryCache *binaries = &ProgramBinaryCache::global());
+
+        ProgramPipelineCache(const ProgramPipelineCache &other)            = delete;
+        ProgramPipelineCache &operator=(const ProgramPipelineCache &other) = delete;
+
+        // throws if the source doesn't compile or link
+        [[nodiscard]] std::shared_ptr<Shader> stage(const std::string &source, ShaderModule::Type type);
+
+        // In debug builds the pipeline is validated when it's first made, which throws if the stages don't fit together. The order of `stages` doesn't matter
+        [[nodiscard]] const ProgramPipeline &pipeline(std::span<const PipelineStage> stages);
+
+        void clear();
+
+        [[nodiscard]] inline std::size_t pipelineCount() const { return m_Pipelines.size(); }
+
+        [[nodiscard]] inline std::size_t stageCount() const { return m_Stages.size(); }
+
+        [[nodiscard]] inline const PipelineCacheStats &stats() const { return m_Stats; }
+
+      private:
+        struct Entry {
+            std::unique_ptr<ProgramPipeline>     pipeline;
+            std::vector<std::shared_ptr<Shader>> programs; // kept alive for the pipeline
+        };
+
+        ProgramBinaryCache *m_Binaries;
+
+        std::unordered_map<std::string, std::shared_ptr<Shader>> m_Stages;    // by stage and full source
+        std::unordered_map<std::string, Entry>                    m_Pipelines; // by (stage, program) pairs
+        PipelineCacheStats                                        m_Stats;
+    };
+
+} // namespace neuron
@@ -0,0 +1,195 @@
+#include "program_cache.hpp"
+
+#include "neuron/hash.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+/*
+ * Entry layout (integers as written by the host):
+ *
+ *   char[4]  magic "NPRG"
+ *   u32      format version
+ *   u64      key
+ *   u32      binary format
+ *   u32      binary length
+ *   bytes    binary
+ */
+
+namespace neuron {
+    namespace {
+        constexpr char kMagic[4]       = {'N', 'P', 'R', 'G'};
+        constexpr auto kEntryExtension = ".nprg";
+
+        struct Header {
+            char     magic[4];
+            uint32_t version;
+            uint64_t key;
+            uint32_t format;
+            uint32_t length;
+        };
+
+        double millisecondsSince(const std::chrono::steady_clock::time_point start) {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        std::string_view glString(const GLenum name) {
+            const auto *string = reinterpret_cast<const char *>(glGetString(name));
+            return string == nullptr ? std::string_view() : std::string_view(string);
+        }
+    } // namespace
+
+    ProgramBinaryCache::ProgramBinaryCache(std::filesystem::path directory) : m_Directory(std::move(directory)) {
+    }
+
+    std::shared_ptr<Shader> ProgramBinaryCache::load(const Sources &sources, ProgramParameters parameters) {
+        const uint64_t key = this->key(sources, parameters);
+        if (auto shader = loadBinary(key, parameters)) {
+            return shader;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+
+        std::vector<std::shared_ptr<ShaderModule>> modules;
+        for (const auto &[source, type] : sources) {
+            modules.push_back(std::make_shared<ShaderModule>(source, type));
+        }
+
+        parameters.binaryRetrievable = m_Supported;
+        auto shader                  = std::make_shared<Shader>(parameters, modules);
+        store(key, *shader, millisecondsSince(start));
+        return shader;
+    }
+
+    std::shared_ptr<Shader> ProgramBinaryCache::loadBinary(const uint64_t key, const ProgramParameters &parameters) {
+        if (!m_Supported) {
+            return nullptr;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        auto       shader = read(key, parameters);
+        if (shader != nullptr) {
+            m_Stats.hits++;
+            m_Stats.loadMs += millisecondsSince(start);
+        }
+        return shader;
+    }
+
+    void ProgramBinaryCache::store(const uint64_t key, const Shader &shader, const double compileMs) {
+        m_Stats.misses++;
+        m_Stats.compileMs += compileMs;
+        if (!m_Supported) {
+            return;
+        }
+
+        // the cache only makes startup faster, failing to fill it shouldn't fail the load
+        try {
+            write(key, shader);
+        } catch (const std::exception &e) {
+            std::cerr << "Could not write the program cache entry: " << e.what() << std::endl;
+        }
+    }
+
+    uint64_t ProgramBinaryCache::key(const Sources &sources, const ProgramParameters &parameters) {
+        if (!m_DriverHash) {
+            int formats = 0;
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+            m_Supported = formats > 0;
+
+            uint64_t hash = hashString(glString(GL_VENDOR), kFormatVersion);
+            hash          = hashString(glString(GL_RENDERER), hash);
+            m_DriverHash  = hashString(glString(GL_VERSION), hash);
+        }
+
+        uint64_t hash = *m_DriverHash ^ (parameters.separable ? 1 : 0);
+        for (const auto &[source, type] : sources) {
+            hash = hashString(source, hash ^ static_cast<uint64_t>(type));
+        }
+        return hash;
+    }
+
+    void ProgramBinaryCache::clear() {
+        std::error_code error;
+        for (const auto &entry : std::filesystem::directory_iterator(m_Directory, error)) {
+            if (entry.path().extension() == kEntryExtension) {
+                std::filesystem::remove(entry.path(), error);
+            }
+        }
+    }
+
+    ProgramBinaryCache &ProgramBinaryCache::global() {
+        static ProgramBinaryCache cache(".cache/programs");
+        return cache;
+    }
+
+    std::filesystem::path ProgramBinaryCache::entryPath(const uint64_t key) const {
+        char name[17];
+        std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+        return m_Directory / (std::string(name) + kEntryExtension);
+    }
+
+    std::shared_ptr<Shader> ProgramBinaryCache::read(const uint64_t key, const ProgramParameters &parameters) {
+        const auto    path = entryPath(key);
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            return nullptr;
+        }
+
+        Header header{};
+        file.read(reinterpret_cast<char *>(&header), sizeof(header));
+
+        // the length is checked against the file first, a broken entry shouldn't turn into a huge allocation
+        std::error_code        error;
+        const auto             size = std::filesystem::file_size(path, error);
+        std::vector<std::byte> binary(file && !error && size - sizeof(header) >= header.length ? header.length : 0);
+        file.read(reinterpret_cast<char *>(binary.data()), static_cast<std::streamsize>(binary.size()));
+
+        std::shared_ptr<Shader> shader;
+        if (file && std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 && header.version == kFormatVersion && header.key == key) {
+            shader = Shader::fromBinary(header.format, binary, parameters);
+        }
+
+        if (shader == nullptr) {
+            // broken, or made by a driver that has since changed in a way its version string doesn't show. It gets written again after compiling
+            file.close();
+            std::filesystem::remove(path, error);
+            m_Stats.rejected++;
+        }
+        return shader;
+    }
+
+    void ProgramBinaryCache::write(const uint64_t key, const Shader &shader) const {
+        GLenum     format = 0;
+        const auto binary = shader.binary(format);
+        if (binary.empty()) {
+            return;
+        }
+
+        Header header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kFormatVersion;
+        header.key     = key;
+        header.format  = format;
+        header.length  = static_cast<uint32_t>(binary.size());
+
+        std::filesystem::create_directories(m_Directory);
+
+        // written next to the entry and renamed over it, so a crash halfway doesn't leave a broken entry behind
+        const auto path      = entryPath(key);
+        auto       temporary = path;
+        temporary += ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary);
+            file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char *>(binary.data()), static_cast<std::streamsize>(binary.size()));
+            if (!file) {
+                throw std::runtime_error("Could not write " + temporary.string());
+            }
+        }
+
+        std::filesystem::rename(temporary, path);
+    }
+} // namespace neuron
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "neuron/glwrap.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace neuron {
+
+    struct ProgramCacheStats {
+        uint64_t hits     = 0;
+        uint64_t misses   = 0;
+        uint64_t rejected = 0; // binaries the driver wouldn't take, which were compiled again
+
+        double compileMs = 0.0;
+        double loadMs    = 0.0;
+    };
+
+    /**
+     * Caches linked programs on disk with glGetProgramBinary. Entries are keyed by a hash of the final sources of every stage (so anything #defined into them counts),
+     * the program parameters and the GL vendor, renderer and version strings, since binaries only work with the driver that made them.
+     * Drivers may still reject a binary, in which case the program is compiled from source and the entry written again. GL thread only.
+     */
+    class ProgramBinaryCache {
+      public:
+        static constexpr uint32_t kFormatVersion = 1;
+
+        using Sources = std::vector<std::pair<std::string, ShaderModule::Type>>;
+
+        explicit ProgramBinaryCache(std::filesystem::path directory);
+
+        ProgramBinaryCache(const ProgramBinaryCache &other)            = delete;
+        ProgramBinaryCache &operator=(const ProgramBinaryCache &other) = delete;
+
+        // throws if the sources don't compile or link, like building the program directly would
+        [[nodiscard]] std::shared_ptr<Shader> load(const Sources &sources, ProgramParameters parameters = {});
+
+        [[nodiscard]] uint64_t key(const Sources &sources, const ProgramParameters &parameters);
+
+        // The two halves of load() for callers that compile themselves. null if there's no usable entry
+        [[nodiscard]] std::shared_ptr<Shader> loadBinary(uint64_t key, const ProgramParameters &parameters);
+
+        // the program has to have been linked with ProgramParameters::binaryRetrievable. Never throws
+        void store(uint64_t key, const Shader &shader, double compileMs);
+
+        // false until the first key() call, and on drivers without any binary formats
+        [[nodiscard]] inline bool supported() const { return m_Supported; }
+
+        void clear();
+
+        [[nodiscard]] inline const ProgramCacheStats &stats() const { return m_Stats; }
+
+        static ProgramBinaryCache &global();
+
+      private:
+        [[nodiscard]] std::filesystem::path entryPath(uint64_t key) const;
+
+        std::shared_ptr<Shader> read(uint64_t key, const ProgramParameters &parameters);
+
+        void write(uint64_t key, const Shader &shader) const;
+
+        std::filesystem::path   m_Directory;
+        std::optional<uint64_t> m_DriverHash; // needs a context, so it's only made on first use
+        bool                    m_Supported = false;
+        ProgramCacheStats       m_Stats;
+    };
+
+} // namespace neuron
@@ -0,0 +1,47 @@
+#include "camera_layers.hpp"
+
+#include <string>
+
+namespace neuron::render {
+    CameraTargets addCameraLayerPasses(RenderGraph &graph, const std::string_view camera, const std::span<const ecs::CameraLayer> layers, const glm::ivec2 size,
+                                       DrawScene drawScene, const Texture::InternalFormat colorFormat) {
+        const std::string name(camera);
+
+        RenderGraph::Resource color = RenderGraph::kNoResource;
+        RenderGraph::Resource depth = RenderGraph::kNoResource;
+        graph.addPass(
+            name,
+            [&](RenderGraph::PassBuilder &builder) {
+                color = builder.create(name + " Color", {size.x, size.y, colorFormat});
+                depth = builder.create(name + " Depth", {size.x, size.y, Texture::InternalFormat::DEPTH24_STENCIL8});
+                builder.write(color, ResourceUsage::Attachment);
+                builder.write(depth, ResourceUsage::Attachment);
+            },
+            [drawScene = std::move(drawScene)](const RenderGraph::PassContext &context) {
+                glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+                drawScene(context);
+            });
+
+        // every layer on the window shares one import, so the graph orders their writes to it
+        RenderGraph::Resource backbuffer = RenderGraph::kNoResource;
+        for (const ecs::CameraLayer &layer : layers) {
+            RenderGraph::Resource output;
+            if (!layer.renderTarget.isValid() || layer.renderTarget.getFromGlobal()->isWindow()) {
+                if (backbuffer == RenderGraph::kNoResource) {
+                    backbuffer = graph.importBackbuffer(size.x, size.y);
+                }
+                output = backbuffer;
+            } else {
+                output = graph.importTexture(name + " Layer", layer.renderTarget.getFromGlobal()->color());
+            }
+
+            if (layer.postProcessingPipeline.isValid()) {
+                layer.postProcessingPipeline.getFromGlobal()->addPasses(graph, color, output);
+            } else {
+                graph.addBlitPass(name + " Resolve", color, output);
+            }
+        }
+        return {color, depth};
+    }
+} // namespace neuron::render
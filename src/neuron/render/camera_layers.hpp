@@ -0,0 +1,28 @@
+#pragma once
+
+#include "neuron/ecs/components.hpp"
+#include "neuron/render/render_graph.hpp"
+
+#include <functional>
+#include <span>
+#include <string_view>
+
+namespace neuron::render {
+
+    // draws the camera's view into the bound targets, which are cleared already
+    using DrawScene = std::function<void(const RenderGraph::PassContext &context)>;
+
+    // what the camera rendered into, for passes that read its depth or color as well as the layers do
+    struct CameraTargets {
+        RenderGraph::Resource color = RenderGraph::kNoResource;
+        RenderGraph::Resource depth = RenderGraph::kNoResource;
+    };
+
+    /**
+     * Renders a camera once into transient color and depth targets and adds every layer's post processing on top of that, each ending in the layer's
+     * render target, or the window when it has none. Layers nothing ends up in are culled by the graph along with their effects. GL thread
+     */
+    CameraTargets addCameraLayerPasses(RenderGraph &graph, std::string_view camera, std::span<const ecs::CameraLayer> layers, glm::ivec2 size, DrawScene drawScene,
+                                       Texture::InternalFormat colorFormat = Texture::InternalFormat::RGBA16F);
+
+} // namespace neuron::render
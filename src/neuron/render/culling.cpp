@@ -0,0 +1,85 @@
+#include "culling.hpp"
+
+namespace neuron::render {
+    bool OcclusionBuffer::isOccluded(const AABB &worldBounds) const {
+        glm::vec2 ndcMin(std::numeric_limits<float>::max());
+        glm::vec2 ndcMax(std::numeric_limits<float>::lowest());
+        float     nearest = 1.0f;
+
+        for (const auto &corner : worldBounds.corners()) {
+            const glm::vec4 clip = m_ViewProjection * glm::vec4(corner, 1.0f);
+            if (clip.w <= 1e-5f) {
+                return false; // crosses the near plane, we can't say anything useful about it
+            }
+
+            const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+            ndcMin              = glm::min(ndcMin, glm::vec2(ndc));
+            ndcMax              = glm::max(ndcMax, glm::vec2(ndc));
+            nearest             = glm::min(nearest, ndc.z * 0.5f + 0.5f);
+        }
+
+        if (ndcMax.x < -1.0f || ndcMax.y < -1.0f || ndcMin.x > 1.0f || ndcMin.y > 1.0f) {
+            return false; // offscreen for this buffer, leave it to the frustum
+        }
+
+        return isRectOccluded(glm::clamp(ndcMin, glm::vec2(-1.0f), glm::vec2(1.0f)), glm::clamp(ndcMax, glm::vec2(-1.0f), glm::vec2(1.0f)), nearest);
+    }
+
+    Frustum::Frustum(const glm::mat4 &viewProjection) {
+        const auto row = [&](const int i) { return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]); };
+
+        m_Planes[0] = row(3) + row(0);
+        m_Planes[1] = row(3) - row(0);
+        m_Planes[2] = row(3) + row(1);
+        m_Planes[3] = row(3) - row(1);
+        m_Planes[4] = row(3) + row(2);
+        m_Planes[5] = row(3) - row(2);
+
+        for (auto &plane : m_Planes) {
+            plane /= glm::length(glm::vec3(plane));
+        }
+    }
+
+    bool Frustum::intersects(const AABB &worldBounds) const {
+        for (const auto &plane : m_Planes) {
+            // the corner furthest along the plane normal, if even that one is outside then the whole box is
+            const glm::vec3 positive = glm::vec3(plane.x >= 0.0f ? worldBounds.max.x : worldBounds.min.x, plane.y >= 0.0f ? worldBounds.max.y : worldBounds.min.y,
+                                                 plane.z >= 0.0f ? worldBounds.max.z : worldBounds.min.z);
+            if (glm::dot(glm::vec3(plane), positive) + plane.w < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void FrustumCuller::setViewProjection(const glm::mat4 &viewProjection) {
+        m_Frustum = Frustum(viewProjection);
+    }
+
+    bool FrustumCuller::isVisible(const AABB &worldBounds) {
+        m_Stats.tested++;
+
+        switch (classify(worldBounds)) {
+        case CullResult::FrustumCulled:
+            m_Stats.frustumCulled++;
+            return false;
+        case CullResult::OcclusionCulled:
+            m_Stats.occlusionCulled++;
+            return false;
+        default:
+            return true;
+        }
+    }
+
+    CullResult FrustumCuller::classify(const AABB &worldBounds) const {
+        if (!m_Frustum.intersects(worldBounds)) {
+            return CullResult::FrustumCulled;
+        }
+
+        if (m_OcclusionBuffer != nullptr && m_OcclusionBuffer->isOccluded(worldBounds)) {
+            return CullResult::OcclusionCulled;
+        }
+
+        return CullResult::Visible;
+    }
+} // namespace neuron::render
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "neuron/aabb.hpp"
+
+#include <array>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+namespace neuron::render {
+
+    /**
+     * A conservative, CPU-readable depth buffer which can answer "is everything inside this screen rectangle closer than `depth`".
+     * Depths are window-space ([0, 1], larger is further away) and every implementation must only ever report a rect as occluded when it really is.
+     */
+    class OcclusionBuffer {
+      public:
+        virtual ~OcclusionBuffer() = default;
+
+        [[nodiscard]] virtual bool isRectOccluded(const glm::vec2 &ndcMin, const glm::vec2 &ndcMax, float nearestDepth) const = 0;
+
+        // Bounds are projected with the matrix the buffer was rendered with, not the current camera, so a buffer from the previous frame stays correct for static geometry.
+        [[nodiscard]] bool isOccluded(const AABB &worldBounds) const;
+
+        [[nodiscard]] inline const glm::mat4 &viewProjection() const { return m_ViewProjection; }
+
+        inline void setViewProjection(const glm::mat4 &viewProjection) { m_ViewProjection = viewProjection; }
+
+      protected:
+        glm::mat4 m_ViewProjection{1.0f};
+    };
+
+    class Frustum {
+      public:
+        Frustum() = default;
+        explicit Frustum(const glm::mat4 &viewProjection);
+
+        [[nodiscard]] bool intersects(const AABB &worldBounds) const;
+
+      private:
+        // left, right, bottom, top, near, far. xyz is the (inward facing) normal, w is the distance
+        std::array<glm::vec4, 6> m_Planes{};
+    };
+
+    enum class CullResult { Visible, FrustumCulled, OcclusionCulled };
+
+    struct CullingStats {
+        uint32_t tested          = 0;
+        uint32_t frustumCulled   = 0;
+        uint32_t occlusionCulled = 0;
+    };
+
+    /**
+     * Frustum culling with an optional occlusion stage afterward. The occlusion buffer can be either the read back depth pyramid of the previous frame or a software rasterized occluder buffer.
+     */
+    class FrustumCuller {
+      public:
+        FrustumCuller() = default;
+
+        void setViewProjection(const glm::mat4 &viewProjection);
+
+        // The buffer is not owned and must live until the next call to this or the end of culling. Pass nullptr to turn occlusion culling off.
+        inline void setOcclusionBuffer(const OcclusionBuffer *buffer) { m_OcclusionBuffer = buffer; }
+
+        [[nodiscard]] bool isVisible(const AABB &worldBounds);
+
+        // Doesn't touch the stats, so this is safe to call from multiple threads at once
+        [[nodiscard]] CullResult classify(const AABB &worldBounds) const;
+
+        inline void resetStats() { m_Stats = {}; }
+
+        [[nodiscard]] inline const CullingStats &stats() const { return m_Stats; }
+
+      private:
+        Frustum                m_Frustum;
+        const OcclusionBuffer *m_OcclusionBuffer = nullptr;
+        CullingStats           m_Stats;
+    };
+
+} // namespace neuron::render
@@ -0,0 +1,213 @@
+#include "depth_pyramid.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace neuron::render {
+    namespace {
+        constexpr int kReadbackMaxWidth = 128;
+
+        constexpr auto kCopyShaderSource = R"glsl(#version 460 core
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(binding = 0) uniform sampler2D uDepth;
+layout(binding = 1, r32f) uniform writeonly image2D uDest;
+
+void main() {
+    ivec2 dst = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(dst, imageSize(uDest)))) return;
+    imageStore(uDest, dst, vec4(texelFetch(uDepth, dst, 0).r));
+}
+)glsl";
+
+        // Takes the max of the 2x2 footprint. When the source size is odd the last row/column of the destination also has to cover the leftover source texels, otherwise those would get lost.
+        constexpr auto kDownsampleShaderSource = R"glsl(#version 460 core
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(binding = 0, r32f) uniform readonly image2D uSource;
+layout(binding = 1, r32f) uniform writeonly image2D uDest;
+
+float fetch(ivec2 p, ivec2 limit) {
+    return imageLoad(uSource, min(p, limit)).r;
+}
+
+void main() {
+    ivec2 dst     = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 dstSize = imageSize(uDest);
+    if (any(greaterThanEqual(dst, dstSize))) return;
+
+    ivec2 srcSize = imageSize(uSource);
+    ivec2 limit   = srcSize - 1;
+    ivec2 src     = dst * 2;
+
+    float d = max(max(fetch(src, limit), fetch(src + ivec2(1, 0), limit)), max(fetch(src + ivec2(0, 1), limit), fetch(src + ivec2(1, 1), limit)));
+
+    bool extraX = (srcSize.x & 1) != 0 && dst.x == dstSize.x - 1;
+    bool extraY = (srcSize.y & 1) != 0 && dst.y == dstSize.y - 1;
+    if (extraX) {
+        d = max(d, max(fetch(src + ivec2(2, 0), limit), fetch(src + ivec2(2, 1), limit)));
+    }
+    if (extraY) {
+        d = max(d, max(fetch(src + ivec2(0, 2), limit), fetch(src + ivec2(1, 2), limit)));
+    }
+    if (extraX && extraY) {
+        d = max(d, fetch(src + ivec2(2, 2), limit));
+    }
+
+    imageStore(uDest, dst, vec4(d));
+}
+)glsl";
+
+        std::shared_ptr<Shader> compileCompute(const char *source) {
+            return std::make_shared<Shader>(std::vector{std::make_shared<ShaderModule>(source, ShaderModule::Type::Compute)});
+        }
+
+        GLuint groupCount(const int size) {
+            return static_cast<GLuint>((size + 7) / 8);
+        }
+    } // namespace
+
+    bool HiZReadback::isRectOccluded(const glm::vec2 &ndcMin, const glm::vec2 &ndcMax, const float nearestDepth) const {
+        if (m_Depths.empty()) {
+            return false;
+        }
+
+        // grown by a texel on each side since the coarse levels of odd sized pyramids don't line up exactly with the screen
+        const int x0 = std::clamp(static_cast<int>((ndcMin.x * 0.5f + 0.5f) * static_cast<float>(m_Width)) - 1, 0, m_Width - 1);
+        const int x1 = std::clamp(static_cast<int>((ndcMax.x * 0.5f + 0.5f) * static_cast<float>(m_Width)) + 1, 0, m_Width - 1);
+        const int y0 = std::clamp(static_cast<int>((ndcMin.y * 0.5f + 0.5f) * static_cast<float>(m_Height)) - 1, 0, m_Height - 1);
+        const int y1 = std::clamp(static_cast<int>((ndcMax.y * 0.5f + 0.5f) * static_cast<float>(m_Height)) + 1, 0, m_Height - 1);
+
+        for (int y = y0; y <= y1; y++) {
+            const float *row = m_Depths.data() + static_cast<std::size_t>(y) * m_Width;
+            for (int x = x0; x <= x1; x++) {
+                if (row[x] >= nearestDepth) {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    DepthPyramid::DepthPyramid() {
+        m_CopyShader         = compileCompute(kCopyShaderSource);
+        m_DownsampleShader   = compileCompute(kDownsampleShaderSource);
+        m_ResolveFramebuffer = std::make_unique<Framebuffer>();
+    }
+
+    DepthPyramid::~DepthPyramid() {
+        if (m_ReadbackFence != nullptr) {
+            glDeleteSync(m_ReadbackFence);
+        }
+        glDeleteTextures(1, &m_Pyramid);
+        glDeleteTextures(1, &m_ResolveDepth);
+    }
+
+    void DepthPyramid::resize(const int width, const int height) {
+        if (width == m_Width && height == m_Height) {
+            return;
+        }
+
+        glDeleteTextures(1, &m_Pyramid);
+        glDeleteTextures(1, &m_ResolveDepth);
+
+        m_Width    = width;
+        m_Height   = height;
+        m_MipCount = std::bit_width(static_cast<unsigned int>(std::max(width, height)));
+
+        glCreateTextures(GL_TEXTURE_2D, 1, &m_Pyramid);
+        glTextureStorage2D(m_Pyramid, m_MipCount, GL_R32F, width, height);
+        glTextureParameteri(m_Pyramid, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+        glTextureParameteri(m_Pyramid, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        // has to match the default framebuffer's depth format for the blit to be allowed
+        glCreateTextures(GL_TEXTURE_2D, 1, &m_ResolveDepth);
+        glTextureStorage2D(m_ResolveDepth, 1, GL_DEPTH24_STENCIL8, width, height);
+        glNamedFramebufferTexture(m_ResolveFramebuffer->handle(), GL_DEPTH_STENCIL_ATTACHMENT, m_ResolveDepth, 0);
+
+        m_ReadbackLevel = 0;
+        while (std::max(width >> m_ReadbackLevel, 1) > kReadbackMaxWidth && m_ReadbackLevel + 1 < m_MipCount) {
+            m_ReadbackLevel++;
+        }
+        m_ReadbackSize = {std::max(width >> m_ReadbackLevel, 1), std::max(height >> m_ReadbackLevel, 1)};
+
+        m_ReadbackBuffer = std::make_unique<Buffer>(static_cast<std::size_t>(m_ReadbackSize.x) * m_ReadbackSize.y * sizeof(float), nullptr, Buffer::Usage::StreamRead);
+        if (m_ReadbackFence != nullptr) {
+            glDeleteSync(m_ReadbackFence);
+            m_ReadbackFence = nullptr;
+        }
+        m_Readback.m_Depths.clear();
+    }
+
+    void DepthPyramid::captureDefaultFramebuffer(const int width, const int height, const glm::mat4 &viewProjection) {
+        if (width <= 0 || height <= 0) {
+            return;
+        }
+
+        resize(width, height);
+        glBlitNamedFramebuffer(0, m_ResolveFramebuffer->handle(), 0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+        build(m_ResolveDepth, width, height, viewProjection);
+    }
+
+    void DepthPyramid::build(const unsigned int depthTexture, const int width, const int height, const glm::mat4 &viewProjection) {
+        resize(width, height);
+
+        m_CopyShader->use();
+        glBindTextureUnit(0, depthTexture);
+        glBindImageTexture(1, m_Pyramid, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+        glDispatchCompute(groupCount(width), groupCount(height), 1);
+
+        m_DownsampleShader->use();
+        for (int level = 1; level < m_MipCount; level++) {
+            glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+            glBindImageTexture(0, m_Pyramid, level - 1, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+            glBindImageTexture(1, m_Pyramid, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+            glDispatchCompute(groupCount(std::max(width >> level, 1)), groupCount(std::max(height >> level, 1)), 1);
+        }
+
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_PIXEL_BUFFER_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT);
+
+        requestReadback(viewProjection);
+    }
+
+    void DepthPyramid::requestReadback(const glm::mat4 &viewProjection) {
+        pollReadback();
+        if (m_ReadbackFence != nullptr) {
+            return; // the last one is still in flight, don't queue up more work behind it
+        }
+
+        m_ReadbackBuffer->bind(Buffer::Target::PixelPack);
+        glGetTextureImage(m_Pyramid, m_ReadbackLevel, GL_RED, GL_FLOAT, m_ReadbackSize.x * m_ReadbackSize.y * static_cast<int>(sizeof(float)), nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        m_ReadbackFence          = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        m_ReadbackViewProjection = viewProjection;
+    }
+
+    void DepthPyramid::pollReadback() {
+        if (m_ReadbackFence == nullptr) {
+            return;
+        }
+
+        const GLenum result = glClientWaitSync(m_ReadbackFence, 0, 0);
+        if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED) {
+            return;
+        }
+
+        glDeleteSync(m_ReadbackFence);
+        m_ReadbackFence = nullptr;
+
+        m_Readback.m_Width  = m_ReadbackSize.x;
+        m_Readback.m_Height = m_ReadbackSize.y;
+        m_Readback.m_Depths.resize(static_cast<std::size_t>(m_ReadbackSize.x) * m_ReadbackSize.y);
+        glGetNamedBufferSubData(m_ReadbackBuffer->handle(), 0, static_cast<GLsizeiptr>(m_Readback.m_Depths.size() * sizeof(float)), m_Readback.m_Depths.data());
+        m_Readback.setViewProjection(m_ReadbackViewProjection);
+    }
+
+    const OcclusionBuffer *DepthPyramid::readback() {
+        pollReadback();
+        return m_Readback.isEmpty() ? nullptr : &m_Readback;
+    }
+} // namespace neuron::render
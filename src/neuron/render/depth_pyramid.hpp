@@ -0,0 +1,78 @@
+#pragma once
+
+#include "neuron/glwrap.hpp"
+#include "neuron/render/culling.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace neuron::render {
+
+    // A CPU copy of one (coarse) level of the depth pyramid. Every texel holds the furthest depth of the area it covers.
+    class HiZReadback final : public OcclusionBuffer {
+      public:
+        HiZReadback() = default;
+        ~HiZReadback() override = default;
+
+        [[nodiscard]] bool isRectOccluded(const glm::vec2 &ndcMin, const glm::vec2 &ndcMax, float nearestDepth) const override;
+
+        [[nodiscard]] inline bool isEmpty() const { return m_Depths.empty(); }
+
+      private:
+        int                m_Width  = 0;
+        int                m_Height = 0;
+        std::vector<float> m_Depths;
+
+        friend class DepthPyramid;
+    };
+
+    /**
+     * Hierarchical Z buffer: every mip level holds the max (furthest) depth of the 2x2 texels below it. It gets built from the depth of the previous frame with a compute downsample chain,
+     * and one coarse level is asynchronously read back so the frustum culler can test bounds against it on the CPU without stalling.
+     */
+    class DepthPyramid {
+      public:
+        DepthPyramid();
+        ~DepthPyramid();
+
+        DepthPyramid(const DepthPyramid &other)            = delete;
+        DepthPyramid &operator=(const DepthPyramid &other) = delete;
+
+        // Resolves the depth of the default framebuffer into an internal texture and builds the pyramid from that.
+        void captureDefaultFramebuffer(int width, int height, const glm::mat4 &viewProjection);
+
+        // `depthTexture` must be a single sampled depth texture of the given size.
+        void build(unsigned int depthTexture, int width, int height, const glm::mat4 &viewProjection);
+
+        // The most recent readback which has finished on the GPU, or nullptr if there is none yet. Valid until the next call to build().
+        [[nodiscard]] const OcclusionBuffer *readback();
+
+        [[nodiscard]] inline unsigned int handle() const { return m_Pyramid; }
+
+        [[nodiscard]] inline int mipCount() const { return m_MipCount; }
+
+      private:
+        void resize(int width, int height);
+        void requestReadback(const glm::mat4 &viewProjection);
+        void pollReadback();
+
+        std::shared_ptr<Shader> m_CopyShader;
+        std::shared_ptr<Shader> m_DownsampleShader;
+
+        std::unique_ptr<Framebuffer> m_ResolveFramebuffer;
+
+        unsigned int m_Pyramid      = 0;
+        unsigned int m_ResolveDepth = 0;
+        int          m_Width        = 0;
+        int          m_Height       = 0;
+        int          m_MipCount     = 0;
+
+        std::unique_ptr<Buffer> m_ReadbackBuffer;
+        GLsync                  m_ReadbackFence = nullptr;
+        int                     m_ReadbackLevel = 0;
+        glm::ivec2              m_ReadbackSize{0};
+        glm::mat4               m_ReadbackViewProjection{1.0f};
+        HiZReadback             m_Readback;
+    };
+
+} // namespace neuron::render
@@ -0,0 +1,131 @@
+#include "instance_batcher.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+
+namespace neuron::render {
+    namespace {
+        struct Group {
+            asset::AssetHandle<asset::Mesh>   mesh;
+            asset::AssetHandle<asset::Shader> shader;
+            const ProgramPipeline            *pipeline;
+            uint32_t                          material;
+            GLuint                            baseInstance;
+            GLuint                            instanceCount;
+            std::size_t                       firstCommand;
+            std::size_t                       commandCount;
+            bool                              indirect;
+        };
+
+        // shader asset submissions have no pipeline and sort first
+        GLuint programKey(const ProgramPipeline *pipeline) {
+            return pipeline == nullptr ? 0 : pipeline->handle();
+        }
+
+        template <typename T>
+        void upload(std::unique_ptr<Buffer> &buffer, const std::vector<T> &data) {
+            if (buffer == nullptr) {
+                buffer = std::make_unique<Buffer>(data.size() * sizeof(T), data.data(), Buffer::Usage::StreamDraw);
+            } else {
+                buffer->set(data);
+            }
+        }
+    } // namespace
+
+    void InstanceBatcher::submit(const asset::AssetHandle<asset::Mesh> &mesh, const asset::AssetHandle<asset::Shader> &shader, const uint32_t material, const glm::mat4 &transform,
+                                 const uint32_t region) {
+        m_Submissions.push_back({mesh, shader, nullptr, material, transform, region});
+    }
+
+    void InstanceBatcher::submit(const asset::AssetHandle<asset::Mesh> &mesh, const ProgramPipeline &pipeline, const uint32_t material, const glm::mat4 &transform,
+                                 const uint32_t region) {
+        m_Submissions.push_back({mesh, {}, &pipeline, material, transform, region});
+    }
+
+    void InstanceBatcher::flush(const MaterialBinder &bindMaterial, const PipelineMaterialBinder &bindPipelineMaterial) {
+        m_Stats = {};
+        if (m_Submissions.empty()) {
+            return;
+        }
+
+        // program first so that program switches are minimized as well. Pipelines are ordered by handle, which is stable within the frame
+        m_Order.resize(m_Submissions.size());
+        std::iota(m_Order.begin(), m_Order.end(), 0U);
+        std::ranges::sort(m_Order, [&](const uint32_t a, const uint32_t b) {
+            const auto &sa = m_Submissions[a];
+            const auto &sb = m_Submissions[b];
+            return std::tuple(sa.shader.id(), programKey(sa.pipeline), sa.material, sa.mesh.id()) <
+                   std::tuple(sb.shader.id(), programKey(sb.pipeline), sb.material, sb.mesh.id());
+        });
+
+        m_Instances.clear();
+        m_Commands.clear();
+
+        std::vector<Group> groups;
+        for (std::size_t i = 0; i < m_Order.size();) {
+            const Submission &first = m_Submissions[m_Order[i]];
+
+            Group group{first.mesh, first.shader, first.pipeline, first.material, static_cast<GLuint>(m_Instances.size()), 0, m_Commands.size(), 0, false};
+            for (; i < m_Order.size(); i++) {
+                const Submission &submission = m_Submissions[m_Order[i]];
+                if (!(submission.mesh == group.mesh && submission.shader == group.shader && submission.pipeline == group.pipeline && submission.material == group.material)) {
+                    break;
+                }
+
+                m_Instances.push_back({submission.transform, glm::mat4(glm::transpose(glm::inverse(glm::mat3(submission.transform)))), submission.region, {}});
+                group.instanceCount++;
+            }
+
+            group.indirect     = group.mesh.getFromGlobal()->object()->appendInstancedCommands(m_Commands, group.instanceCount, group.baseInstance);
+            group.commandCount = m_Commands.size() - group.firstCommand;
+            groups.push_back(group);
+        }
+
+        upload(m_InstanceBuffer, m_Instances);
+        m_InstanceBuffer->bind_indexed(Buffer::IndexedTarget::ShaderStorage, kInstanceBinding);
+
+        if (!m_Commands.empty()) {
+            upload(m_IndirectBuffer, m_Commands);
+            m_IndirectBuffer->bind(Buffer::Target::DrawIndirect);
+        }
+
+        const Group *previous = nullptr;
+        for (const auto &group : groups) {
+            const bool programChanged = previous == nullptr || !(previous->shader == group.shader) || previous->pipeline != group.pipeline;
+            if (group.pipeline != nullptr) {
+                if (programChanged) {
+                    group.pipeline->bind();
+                }
+
+                if (bindPipelineMaterial && (programChanged || previous->material != group.material)) {
+                    bindPipelineMaterial(*group.pipeline, group.material);
+                }
+            } else {
+                auto shader = group.shader.getFromGlobal();
+                if (programChanged) {
+                    shader->object()->use();
+                }
+
+                if (bindMaterial && (programChanged || previous->material != group.material)) {
+                    bindMaterial(*shader->object(), group.material);
+                }
+            }
+
+            const auto mesh = group.mesh.getFromGlobal();
+            if (group.indirect) {
+                mesh->object()->drawIndirect(group.firstCommand, group.commandCount);
+            } else {
+                mesh->object()->drawInstanced(group.instanceCount, group.baseInstance);
+            }
+
+            previous = &group;
+        }
+
+        m_Stats.instances = static_cast<uint32_t>(m_Submissions.size());
+        m_Stats.groups    = static_cast<uint32_t>(groups.size());
+        m_Stats.drawCalls = static_cast<uint32_t>(groups.size());
+
+        m_Submissions.clear();
+    }
+} // namespace neuron::render
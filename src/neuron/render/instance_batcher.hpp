@@ -0,0 +1,77 @@
+#pragma once
+
+#include "neuron/asset/mesh.hpp"
+#include "neuron/asset/shader.hpp"
+#include "neuron/glwrap.hpp"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace neuron::render {
+
+    // Per instance data as it is laid out in the instance storage buffer (std430). The normal matrix is padded out to a mat4.
+    struct InstanceData {
+        glm::mat4 model;
+        glm::mat4 normal;
+        uint32_t  region; // the texture atlas region of the instance's image, see res/texture_atlas.glsl
+        uint32_t  padding[3];
+    };
+
+    struct InstancingStats {
+        uint32_t instances = 0;
+        uint32_t groups    = 0;
+        uint32_t drawCalls = 0;
+
+        [[nodiscard]] inline float ratio() const { return drawCalls == 0 ? 0.0f : static_cast<float>(instances) / static_cast<float>(drawCalls); }
+    };
+
+    /**
+     * Collects draws for a frame and merges the ones which share a (mesh, program, material) into a single instanced draw. The program is either a shader asset or
+     * a program pipeline, which has to stay alive until the flush. Every instance carries a texture atlas region, so draws that only differ in which image
+     * of an atlas they show share their material and stay one group.
+     * Transforms are written into one storage buffer at binding `kInstanceBinding`, shaders find their instance with `gl_BaseInstance + gl_InstanceID` (see res/vert_instanced.glsl).
+     */
+    class InstanceBatcher {
+      public:
+        static constexpr unsigned int kInstanceBinding = 0;
+
+        // called whenever the shader or material changes between groups, after the shader has been bound
+        using MaterialBinder = std::function<void(const Shader &shader, uint32_t material)>;
+        // the same for pipelines, uniforms go to the stage programs that use them
+        using PipelineMaterialBinder = std::function<void(const ProgramPipeline &pipeline, uint32_t material)>;
+
+        InstanceBatcher() = default;
+
+        void submit(const asset::AssetHandle<asset::Mesh> &mesh, const asset::AssetHandle<asset::Shader> &shader, uint32_t material, const glm::mat4 &transform,
+                    uint32_t region = 0);
+        void submit(const asset::AssetHandle<asset::Mesh> &mesh, const ProgramPipeline &pipeline, uint32_t material, const glm::mat4 &transform, uint32_t region = 0);
+
+        // Draws everything submitted since the last flush and clears the submissions
+        void flush(const MaterialBinder &bindMaterial = {}, const PipelineMaterialBinder &bindPipelineMaterial = {});
+
+        [[nodiscard]] inline const InstancingStats &stats() const { return m_Stats; }
+
+      private:
+        struct Submission {
+            asset::AssetHandle<asset::Mesh>   mesh;
+            asset::AssetHandle<asset::Shader> shader;
+            const ProgramPipeline            *pipeline; // null when drawn with `shader`
+            uint32_t                          material;
+            glm::mat4                         transform;
+            uint32_t                          region;
+        };
+
+        std::vector<Submission> m_Submissions;
+        std::vector<uint32_t>   m_Order;
+
+        std::vector<InstanceData>                m_Instances;
+        std::vector<DrawElementsIndirectCommand> m_Commands;
+
+        std::unique_ptr<Buffer> m_InstanceBuffer;
+        std::unique_ptr<Buffer> m_IndirectBuffer;
+
+        InstancingStats m_Stats;
+    };
+
+} // namespace neuron::render
@@ -0,0 +1,460 @@
+#include "render_graph.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <ranges>
+#include <stdexcept>
+
+namespace neuron::render {
+    namespace {
+        constexpr uint32_t kNone = UINT32_MAX;
+
+        // what GL needs before an access can see writes from image stores or storage buffers
+        GLbitfield usageBarrier(const ResourceUsage usage) {
+            switch (usage) {
+            case ResourceUsage::Attachment:
+                return GL_FRAMEBUFFER_BARRIER_BIT;
+            case ResourceUsage::Sampled:
+                return GL_TEXTURE_FETCH_BARRIER_BIT;
+            case ResourceUsage::Image:
+                return GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+            case ResourceUsage::Storage:
+                return GL_SHADER_STORAGE_BARRIER_BIT;
+            case ResourceUsage::Uniform:
+                return GL_UNIFORM_BARRIER_BIT;
+            case ResourceUsage::Indirect:
+                return GL_COMMAND_BARRIER_BIT;
+            case ResourceUsage::Transfer:
+                return GL_TEXTURE_UPDATE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT | GL_PIXEL_BUFFER_BARRIER_BIT;
+            }
+            return GL_ALL_BARRIER_BITS;
+        }
+
+        constexpr GLbitfield kEveryUsageBarrier = GL_FRAMEBUFFER_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT |
+                                                  GL_SHADER_STORAGE_BARRIER_BIT | GL_UNIFORM_BARRIER_BIT | GL_COMMAND_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT |
+                                                  GL_BUFFER_UPDATE_BARRIER_BIT | GL_PIXEL_BUFFER_BARRIER_BIT;
+
+        // writes that bypass the caches GL keeps coherent on its own
+        bool incoherent(const ResourceUsage usage) {
+            return usage == ResourceUsage::Image || usage == ResourceUsage::Storage;
+        }
+    } // namespace
+
+    RenderGraph::Resource RenderGraph::PassBuilder::create(const std::string_view name, const RenderTargetDesc &desc) {
+        if (desc.width <= 0 || desc.height <= 0) {
+            throw std::logic_error("Render graph target '" + std::string(name) + "' needs a size");
+        }
+        m_Graph.m_Resources.push_back({.name = std::string(name), .kind = ResourceKind::Transient, .desc = desc});
+        return static_cast<Resource>(m_Graph.m_Resources.size() - 1);
+    }
+
+    void RenderGraph::PassBuilder::read(const Resource resource, const ResourceUsage usage) {
+        m_Graph.addAccess(m_Pass, {resource, usage, false});
+    }
+
+    void RenderGraph::PassBuilder::write(const Resource resource, const ResourceUsage usage) {
+        m_Graph.addAccess(m_Pass, {resource, usage, true});
+    }
+
+    void RenderGraph::PassBuilder::sideEffect() {
+        m_Graph.m_Passes[m_Pass].sideEffect = true;
+    }
+
+    const std::shared_ptr<Texture> &RenderGraph::PassContext::texture(const Resource resource) const {
+        const auto &node = m_Graph.m_Resources.at(resource);
+        if (node.texture == nullptr) {
+            throw std::logic_error("Render graph resource '" + node.name + "' isn't a texture alive in this pass");
+        }
+        return node.texture;
+    }
+
+    const std::shared_ptr<Buffer> &RenderGraph::PassContext::buffer(const Resource resource) const {
+        const auto &node = m_Graph.m_Resources.at(resource);
+        if (node.buffer == nullptr) {
+            throw std::logic_error("Render graph resource '" + node.name + "' isn't a buffer");
+        }
+        return node.buffer;
+    }
+
+    void RenderGraph::PassContext::drawFullscreenTriangle() const {
+        m_Graph.m_EmptyVertexArray->bind();
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+    }
+
+    RenderGraph::RenderGraph(RenderTargetPool &pool) : m_Pool(pool), m_EmptyVertexArray(std::make_unique<VertexArray>(VertexLayout{})) {}
+
+    RenderGraph::~RenderGraph() {
+        for (const auto &frame : m_TimingFrames) {
+            if (!frame.queries.empty()) {
+                glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+            }
+        }
+    }
+
+    RenderGraph::Resource RenderGraph::importTexture(const std::string_view name, std::shared_ptr<Texture> texture) {
+        const RenderTargetDesc desc{texture->width(), texture->height(), texture->internalFormat(), texture->samples(), false};
+        m_Resources.push_back({.name = std::string(name), .kind = ResourceKind::Texture, .desc = desc, .texture = texture, .attachment = {desc, texture, nullptr}});
+        return static_cast<Resource>(m_Resources.size() - 1);
+    }
+
+    RenderGraph::Resource RenderGraph::importBuffer(const std::string_view name, std::shared_ptr<Buffer> buffer) {
+        m_Resources.push_back({.name = std::string(name), .kind = ResourceKind::Buffer, .buffer = std::move(buffer)});
+        return static_cast<Resource>(m_Resources.size() - 1);
+    }
+
+    RenderGraph::Resource RenderGraph::importBackbuffer(const int width, const int height) {
+        m_Resources.push_back({.name = "Backbuffer", .kind = ResourceKind::Backbuffer, .desc = {.width = width, .height = height}});
+        return static_cast<Resource>(m_Resources.size() - 1);
+    }
+
+    void RenderGraph::addPass(std::string name, const Setup &setup, Execute execute) {
+        m_Passes.push_back({std::move(name), std::move(execute), {}, false});
+        PassBuilder builder(*this, static_cast<uint32_t>(m_Passes.size() - 1));
+        setup(builder);
+    }
+
+    void RenderGraph::addBlitPass(std::string name, const Resource source, const Resource target) {
+        const auto setup = [source, target](PassBuilder &builder) {
+            builder.read(source, ResourceUsage::Transfer);
+            builder.write(target, ResourceUsage::Transfer);
+        };
+        addPass(std::move(name), setup, [this, source, target](const PassContext &) {
+            const RenderTargetDesc &from  = m_Resources[source].desc;
+            const RenderTargetDesc &to    = m_Resources[target].desc;
+            const bool              depth = Texture::isDepthFormat(from.format);
+            const bool              same  = from.width == to.width && from.height == to.height;
+            glBlitNamedFramebuffer(framebufferFor(source), framebufferFor(target), 0, 0, from.width, from.height, 0, 0, to.width, to.height,
+                                   depth ? GL_DEPTH_BUFFER_BIT : GL_COLOR_BUFFER_BIT, depth || same ? GL_NEAREST : GL_LINEAR);
+        });
+    }
+
+    const RenderTargetDesc &RenderGraph::desc(const Resource resource) const {
+        return m_Resources.at(resource).desc;
+    }
+
+    void RenderGraph::execute() {
+        collectTimings();
+        m_Stats = {.passes = static_cast<uint32_t>(m_Passes.size())};
+
+        // whatever last frame wrote incoherently and nothing read since
+        GLbitfield leftover = 0;
+        for (const GLbitfield covered : m_Covered | std::views::values) {
+            leftover |= kEveryUsageBarrier & ~covered;
+        }
+        if (leftover != 0) {
+            glMemoryBarrier(leftover);
+            m_Stats.barriers++;
+        }
+        m_Covered.clear();
+
+        const std::vector<uint32_t> order = compile();
+        m_Stats.culled                    = m_Stats.passes - static_cast<uint32_t>(order.size());
+
+        // transients live from the first pass touching them to the last
+        std::vector<uint32_t> first(m_Resources.size(), kNone);
+        std::vector<uint32_t> last(m_Resources.size(), kNone);
+        for (uint32_t position = 0; position < order.size(); position++) {
+            for (const Access &access : m_Passes[order[position]].accesses) {
+                if (m_Resources[access.resource].kind == ResourceKind::Transient) {
+                    first[access.resource] = std::min(first[access.resource], position);
+                    last[access.resource]  = position;
+                }
+            }
+        }
+        m_Stats.transients = static_cast<uint32_t>(std::ranges::count_if(first, [](const uint32_t position) { return position != kNone; }));
+
+        TimingFrame &timing = m_TimingFrames[m_NextTimingFrame];
+        m_NextTimingFrame   = (m_NextTimingFrame + 1) % kTimingFrames;
+        if (const std::size_t needed = order.size() + 1; timing.queries.size() < needed) {
+            const std::size_t existing = timing.queries.size();
+            timing.queries.resize(needed);
+            glCreateQueries(GL_TIMESTAMP, static_cast<GLsizei>(needed - existing), timing.queries.data() + existing);
+        }
+        timing.passes.clear();
+        timing.pending = false; // if it never came back, it's dropped
+
+        for (uint32_t position = 0; position < order.size(); position++) {
+            const PassNode &pass = m_Passes[order[position]];
+
+            for (const Access &access : pass.accesses) {
+                ResourceNode &node = m_Resources[access.resource];
+                if (first[access.resource] == position && node.pooled == nullptr) {
+                    node.pooled  = &m_Pool.acquire(node.desc);
+                    node.texture = node.pooled->texture;
+                }
+            }
+
+            GLbitfield barriers = 0;
+            for (const Access &access : pass.accesses) {
+                barriers |= barrierFor(access);
+            }
+            if (barriers != 0) {
+                glMemoryBarrier(barriers);
+                for (GLbitfield &covered : m_Covered | std::views::values) {
+                    covered |= barriers;
+                }
+                m_Stats.barriers++;
+            }
+
+            glm::ivec2 size{0};
+            bindAttachments(pass, size);
+
+            glQueryCounter(timing.queries[position], GL_TIMESTAMP);
+            const auto start = std::chrono::steady_clock::now();
+            pass.execute(PassContext(*this, size));
+            timing.passes.push_back({pass.name, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(), 0.0});
+
+            for (const Access &access : pass.accesses) {
+                if (access.write && incoherent(access.usage)) {
+                    m_Covered[object(access.resource)] = 0;
+                }
+            }
+
+            for (const Access &access : pass.accesses) {
+                ResourceNode &node = m_Resources[access.resource];
+                if (last[access.resource] == position && node.pooled != nullptr) {
+                    m_Pool.release(*node.pooled);
+                    node.pooled  = nullptr;
+                    node.texture = nullptr;
+                }
+            }
+        }
+        glQueryCounter(timing.queries[order.size()], GL_TIMESTAMP);
+        timing.pending = true;
+
+        Framebuffer::unbind();
+        m_Passes.clear();
+        m_Resources.clear();
+    }
+
+    void RenderGraph::addAccess(const uint32_t pass, const Access &access) {
+        if (access.resource >= m_Resources.size()) {
+            throw std::logic_error("Render pass '" + m_Passes[pass].name + "' uses a resource that isn't in the graph");
+        }
+
+        const ResourceNode &node   = m_Resources[access.resource];
+        const bool          buffer = node.kind == ResourceKind::Buffer;
+        bool                valid  = false;
+        switch (access.usage) {
+        case ResourceUsage::Attachment:
+            valid = !buffer;
+            break;
+        case ResourceUsage::Sampled:
+        case ResourceUsage::Image:
+            valid = !buffer && node.kind != ResourceKind::Backbuffer && !node.desc.renderbuffer;
+            break;
+        case ResourceUsage::Storage:
+        case ResourceUsage::Uniform:
+        case ResourceUsage::Indirect:
+            valid = buffer;
+            break;
+        case ResourceUsage::Transfer:
+            valid = true;
+            break;
+        }
+        if (!valid) {
+            throw std::logic_error("Render pass '" + m_Passes[pass].name + "' can't use '" + node.name + "' that way");
+        }
+        m_Passes[pass].accesses.push_back(access);
+    }
+
+    std::vector<uint32_t> RenderGraph::compile() {
+        const auto count = static_cast<uint32_t>(m_Passes.size());
+
+        // data dependencies (reading or building on another pass's writes) keep passes alive, orderings only keep overwrites after earlier reads
+        std::vector<std::vector<uint32_t>> producers(count);
+        std::vector<std::vector<uint32_t>> before(count);
+        std::vector<uint32_t>              lastWriter(m_Resources.size(), kNone);
+        std::vector<std::vector<uint32_t>> readers(m_Resources.size());
+        for (uint32_t pass = 0; pass < count; pass++) {
+            for (const Access &access : m_Passes[pass].accesses) {
+                const uint32_t writer = lastWriter[access.resource];
+                if (writer != kNone && writer != pass) {
+                    producers[pass].push_back(writer);
+                } else if (writer == kNone && !access.write && m_Resources[access.resource].kind == ResourceKind::Transient) {
+                    throw std::logic_error("Render pass '" + m_Passes[pass].name + "' reads '" + m_Resources[access.resource].name + "' before anything writes it");
+                }
+
+                if (!access.write) {
+                    readers[access.resource].push_back(pass);
+                    continue;
+                }
+                for (const uint32_t reader : readers[access.resource]) {
+                    if (reader != pass) {
+                        before[pass].push_back(reader);
+                    }
+                }
+                readers[access.resource].clear();
+                lastWriter[access.resource] = pass;
+            }
+        }
+
+        // what the frame is for, and everything it needs
+        std::vector<bool>     kept(count, false);
+        std::vector<uint32_t> stack;
+        for (uint32_t pass = 0; pass < count; pass++) {
+            const bool output = std::ranges::any_of(m_Passes[pass].accesses, [this](const Access &access) {
+                return access.write && m_Resources[access.resource].kind != ResourceKind::Transient;
+            });
+            if (output || m_Passes[pass].sideEffect) {
+                kept[pass] = true;
+                stack.push_back(pass);
+            }
+        }
+        while (!stack.empty()) {
+            const uint32_t pass = stack.back();
+            stack.pop_back();
+            for (const uint32_t producer : producers[pass]) {
+                if (!kept[producer]) {
+                    kept[producer] = true;
+                    stack.push_back(producer);
+                }
+            }
+        }
+
+        return schedule(kept, producers, before);
+    }
+
+    std::vector<uint32_t> RenderGraph::schedule(const std::vector<bool> &kept, const std::vector<std::vector<uint32_t>> &producers,
+                                                const std::vector<std::vector<uint32_t>> &before) {
+        const auto count = static_cast<uint32_t>(kept.size());
+
+        // Of the passes that are ready, the one whose inputs were produced last goes first, which keeps transients short lived so the pool can hand their
+        // memory on sooner. Ties go to declaration order
+        std::vector<uint32_t> order;
+        std::vector<uint32_t> position(count, kNone);
+        while (true) {
+            uint32_t best      = kNone;
+            int64_t  bestInput = -1;
+            for (uint32_t pass = 0; pass < count; pass++) {
+                if (!kept[pass] || position[pass] != kNone) {
+                    continue;
+                }
+                const auto scheduled = [&](const uint32_t other) { return !kept[other] || position[other] != kNone; };
+                if (!std::ranges::all_of(producers[pass], scheduled) || !std::ranges::all_of(before[pass], scheduled)) {
+                    continue;
+                }
+
+                int64_t input = -1;
+                for (const uint32_t producer : producers[pass]) {
+                    input = std::max(input, static_cast<int64_t>(position[producer]));
+                }
+                if (best == kNone || input > bestInput) {
+                    best      = pass;
+                    bestInput = input;
+                }
+            }
+            if (best == kNone) {
+                break;
+            }
+            position[best] = static_cast<uint32_t>(order.size());
+            order.push_back(best);
+        }
+
+        // every edge points at an earlier declared pass, so this is a bug in building them rather than something a frame can ask for
+        if (const auto keptCount = static_cast<std::size_t>(std::ranges::count(kept, true)); order.size() < keptCount) {
+            throw std::logic_error("Render graph passes depend on each other in a cycle, " + std::to_string(keptCount - order.size()) + " of them can't be ordered");
+        }
+        return order;
+    }
+
+    GLbitfield RenderGraph::barrierFor(const Access &access) {
+        const auto covered = m_Covered.find(object(access.resource));
+        if (covered == m_Covered.end()) {
+            return 0;
+        }
+        return usageBarrier(access.usage) & ~covered->second;
+    }
+
+    void RenderGraph::bindAttachments(const PassNode &pass, glm::ivec2 &size) {
+        std::vector<Resource> attachments;
+        for (const Access &access : pass.accesses) {
+            if (access.usage == ResourceUsage::Attachment && std::ranges::find(attachments, access.resource) == attachments.end()) {
+                attachments.push_back(access.resource);
+            }
+        }
+        if (attachments.empty()) {
+            return;
+        }
+
+        const ResourceNode &front = m_Resources[attachments.front()];
+        size                      = {front.desc.width, front.desc.height};
+
+        if (std::ranges::any_of(attachments, [this](const Resource resource) { return m_Resources[resource].kind == ResourceKind::Backbuffer; })) {
+            if (attachments.size() > 1) {
+                throw std::logic_error("Render pass '" + pass.name + "' can't render to the backbuffer and other targets at once");
+            }
+            Framebuffer::unbind();
+        } else {
+            std::vector<const RenderTargetPool::Target *> colors;
+            const RenderTargetPool::Target               *depth = nullptr;
+            for (const Resource resource : attachments) {
+                if (Texture::isDepthFormat(m_Resources[resource].desc.format)) {
+                    depth = &target(resource);
+                } else {
+                    colors.push_back(&target(resource));
+                }
+            }
+            m_Pool.framebuffer(colors, depth).bind();
+        }
+        glViewport(0, 0, size.x, size.y);
+    }
+
+    const RenderTargetPool::Target &RenderGraph::target(const Resource resource) const {
+        const ResourceNode &node = m_Resources[resource];
+        if (node.pooled != nullptr) {
+            return *node.pooled;
+        }
+        if (node.kind != ResourceKind::Texture) {
+            throw std::logic_error("Render graph resource '" + node.name + "' isn't a texture alive in this pass");
+        }
+        return node.attachment;
+    }
+
+    GLuint RenderGraph::framebufferFor(const Resource resource) const {
+        if (m_Resources[resource].kind == ResourceKind::Backbuffer) {
+            return 0;
+        }
+
+        const RenderTargetPool::Target &attachment = target(resource);
+        if (Texture::isDepthFormat(attachment.desc.format)) {
+            return m_Pool.framebuffer({}, &attachment).handle();
+        }
+        const RenderTargetPool::Target *colors[] = {&attachment};
+        return m_Pool.framebuffer(colors).handle();
+    }
+
+    void RenderGraph::collectTimings() {
+        // oldest first, the GPU finishes them in order
+        for (std::size_t i = 0; i < kTimingFrames; i++) {
+            TimingFrame &frame = m_TimingFrames[(m_NextTimingFrame + i) % kTimingFrames];
+            if (!frame.pending) {
+                continue;
+            }
+
+            GLint available = 0;
+            glGetQueryObjectiv(frame.queries[frame.passes.size()], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available == 0) {
+                break;
+            }
+
+            std::vector<GLuint64> timestamps(frame.passes.size() + 1);
+            for (std::size_t query = 0; query < timestamps.size(); query++) {
+                glGetQueryObjectui64v(frame.queries[query], GL_QUERY_RESULT, &timestamps[query]);
+            }
+            for (std::size_t pass = 0; pass < frame.passes.size(); pass++) {
+                frame.passes[pass].gpuMs = static_cast<double>(timestamps[pass + 1] - timestamps[pass]) / 1e6;
+            }
+            m_Timings     = frame.passes;
+            frame.pending = false;
+        }
+    }
+
+    const void *RenderGraph::object(const Resource resource) const {
+        const ResourceNode &node = m_Resources[resource];
+        if (node.buffer != nullptr) {
+            return node.buffer.get();
+        }
+        return node.texture.get();
+    }
+} // namespace neuron::render
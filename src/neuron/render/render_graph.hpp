@@ -0,0 +1,209 @@
+#pragma once
+
+#include "neuron/glwrap.hpp"
+#include "neuron/render/render_target_pool.hpp"
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace neuron::render {
+
+    // How a pass touches a resource, which decides the barrier it needs after an incoherent write
+    enum class ResourceUsage {
+        Attachment, // rendered to, or depth tested against
+        Sampled,    // texture() and texelFetch()
+        Image,      // imageLoad() and imageStore()
+        Storage,    // buffers as SSBOs
+        Uniform,    // buffers as UBOs
+        Indirect,   // buffers as draw or dispatch indirect arguments
+        Transfer,   // copies, blits, clears and readbacks
+    };
+
+    struct RenderPassTiming {
+        std::string name;
+        double      cpuMs = 0.0;
+        double      gpuMs = 0.0;
+    };
+
+    struct RenderGraphStats {
+        uint32_t passes     = 0; // declared
+        uint32_t culled     = 0;
+        uint32_t barriers   = 0; // glMemoryBarrier calls
+        uint32_t transients = 0;
+    };
+
+    /**
+     * A frame described as passes and the resources they read and write, rebuilt every frame. execute() culls passes nothing depends on, orders the rest,
+     * takes transient targets from a RenderTargetPool for exactly the passes between their first and last use (so later passes can reuse them), binds the
+     * attachments, issues glMemoryBarrier before reads of image and storage writes, and times every pass on the CPU and the GPU.
+     *
+     * Passes that write an imported resource or are marked as having side effects are what the frame is for, everything else is only kept if they need it.
+     * A pass runs after every earlier declared pass that writes what it reads, or touches what it writes.
+     */
+    class RenderGraph {
+      public:
+        using Resource = uint32_t;
+
+        static constexpr Resource kNoResource = UINT32_MAX;
+
+        class PassBuilder {
+          public:
+            // a target from the pool, for the passes between the first and the last using it
+            [[nodiscard]] Resource create(std::string_view name, const RenderTargetDesc &desc);
+
+            void read(Resource resource, ResourceUsage usage);
+            void write(Resource resource, ResourceUsage usage);
+
+            // keeps the pass even if nothing reads what it writes
+            void sideEffect();
+
+          private:
+            PassBuilder(RenderGraph &graph, uint32_t pass) : m_Graph(graph), m_Pass(pass) {}
+
+            RenderGraph &m_Graph;
+            uint32_t     m_Pass;
+
+            friend class RenderGraph;
+        };
+
+        class PassContext {
+          public:
+            [[nodiscard]] const std::shared_ptr<Texture> &texture(Resource resource) const;
+
+            [[nodiscard]] const std::shared_ptr<Buffer> &buffer(Resource resource) const;
+
+            // of the attachments, which is also the viewport
+            [[nodiscard]] inline glm::ivec2 size() const { return m_Size; }
+
+            // three vertices from gl_VertexID, see res/fullscreen.glsl
+            void drawFullscreenTriangle() const;
+
+          private:
+            PassContext(const RenderGraph &graph, const glm::ivec2 size) : m_Graph(graph), m_Size(size) {}
+
+            const RenderGraph &m_Graph;
+            glm::ivec2         m_Size;
+
+            friend class RenderGraph;
+        };
+
+        using Setup   = std::function<void(PassBuilder &builder)>;
+        using Execute = std::function<void(const PassContext &context)>;
+
+        explicit RenderGraph(RenderTargetPool &pool);
+        ~RenderGraph();
+
+        RenderGraph(const RenderGraph &other)            = delete;
+        RenderGraph &operator=(const RenderGraph &other) = delete;
+
+        [[nodiscard]] Resource importTexture(std::string_view name, std::shared_ptr<Texture> texture);
+        [[nodiscard]] Resource importBuffer(std::string_view name, std::shared_ptr<Buffer> buffer);
+
+        // the window's framebuffer, which can only be an attachment or read by a transfer
+        [[nodiscard]] Resource importBackbuffer(int width, int height);
+
+        void addPass(std::string name, const Setup &setup, Execute execute);
+
+        // Copies `source` into `target` with glBlitNamedFramebuffer, scaling if the sizes differ and resolving if `source` is multisampled
+        void addBlitPass(std::string name, Resource source, Resource target);
+
+        // sizes of imported textures and the backbuffer are filled in from them
+        [[nodiscard]] const RenderTargetDesc &desc(Resource resource) const;
+
+        // Compiles and runs every pass added since the last call, then forgets them. GL thread
+        void execute();
+
+        // the passes that ran, in order, as of the newest frame the GPU has finished
+        [[nodiscard]] inline const std::vector<RenderPassTiming> &timings() const { return m_Timings; }
+
+        [[nodiscard]] inline const RenderGraphStats &stats() const { return m_Stats; }
+
+        [[nodiscard]] inline RenderTargetPool &pool() const { return m_Pool; }
+
+      private:
+        static constexpr std::size_t kTimingFrames = 4;
+
+        enum class ResourceKind { Transient, Texture, Buffer, Backbuffer };
+
+        struct ResourceNode {
+            std::string              name;
+            ResourceKind             kind = ResourceKind::Transient;
+            RenderTargetDesc         desc{};
+            std::shared_ptr<Texture> texture = nullptr; // imported, or the pooled one while it's alive
+            std::shared_ptr<Buffer>  buffer  = nullptr;
+
+            const RenderTargetPool::Target *pooled     = nullptr;
+            RenderTargetPool::Target        attachment = {}; // for imported textures
+        };
+
+        struct Access {
+            Resource      resource;
+            ResourceUsage usage;
+            bool          write;
+        };
+
+        struct PassNode {
+            std::string         name;
+            Execute             execute;
+            std::vector<Access> accesses;
+            bool                sideEffect = false;
+        };
+
+        // timestamp queries of one frame, read once they're available so nothing waits on the GPU
+        struct TimingFrame {
+            std::vector<GLuint>           queries;
+            std::vector<RenderPassTiming> passes;
+            bool                          pending = false;
+        };
+
+        // checks the usage fits the resource
+        void addAccess(uint32_t pass, const Access &access);
+
+        // passes in the order they'll run, without the culled ones
+        [[nodiscard]] std::vector<uint32_t> compile();
+
+        // Orders the kept passes after their producers and the passes listed in `before`. Throws if they can't all be ordered
+        [[nodiscard]] static std::vector<uint32_t> schedule(const std::vector<bool> &kept, const std::vector<std::vector<uint32_t>> &producers,
+                                                            const std::vector<std::vector<uint32_t>> &before);
+
+        // the glMemoryBarrier bits an access still needs after incoherent writes to the same texture or buffer
+        [[nodiscard]] GLbitfield barrierFor(const Access &access);
+
+        void bindAttachments(const PassNode &pass, glm::ivec2 &size);
+
+        // the target of a texture resource while it's alive
+        [[nodiscard]] const RenderTargetPool::Target &target(Resource resource) const;
+
+        // with the resource as its only attachment, 0 for the backbuffer
+        [[nodiscard]] GLuint framebufferFor(Resource resource) const;
+
+        // publishes the newest frame whose timestamps are in, and drops the older ones
+        void collectTimings();
+
+        [[nodiscard]] const void *object(Resource resource) const;
+
+        RenderTargetPool &m_Pool;
+
+        std::vector<ResourceNode> m_Resources;
+        std::vector<PassNode>     m_Passes;
+
+        // incoherent writes per texture or buffer, and the barrier bits issued since
+        std::unordered_map<const void *, GLbitfield> m_Covered;
+
+        std::unique_ptr<VertexArray> m_EmptyVertexArray;
+
+        std::array<TimingFrame, kTimingFrames> m_TimingFrames;
+        std::size_t                            m_NextTimingFrame = 0;
+        std::vector<RenderPassTiming>          m_Timings;
+        RenderGraphStats                       m_Stats;
+
+        friend struct RenderGraphTest;
+    };
+
+} // namespace neuron::render
@@ -0,0 +1,165 @@
+#include "render_target_pool.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace neuron::render {
+    std::size_t RenderTargetDesc::byteSize() const {
+        return Texture::levelBytes(format, width, height) * static_cast<std::size_t>(std::max(samples, 1));
+    }
+
+    RenderTargetPool::RenderTargetPool() : RenderTargetPool(Settings{}) {}
+
+    RenderTargetPool::RenderTargetPool(const Settings settings) : m_Settings(settings) {}
+
+    void RenderTargetPool::beginFrame() {
+        m_Frame++;
+        for (const auto &entry : m_Entries) {
+            entry->inUse = false;
+        }
+        m_InUseBytes = 0;
+
+        const auto idle = [this](const uint64_t lastFrame) { return lastFrame + m_Settings.maxIdleFrames < m_Frame; };
+        for (const auto &entry : m_Entries) {
+            if (!idle(entry->lastFrame)) {
+                continue;
+            }
+            const uint64_t key = attachmentKey(&entry->target);
+            std::erase_if(m_Framebuffers, [key](const auto &framebuffer) { return std::ranges::find(framebuffer.first, key) != framebuffer.first.end(); });
+        }
+        std::erase_if(m_Framebuffers, [&idle](const auto &framebuffer) { return idle(framebuffer.second.lastFrame); });
+        m_Stats.destroyed += std::erase_if(m_Entries, [&idle](const auto &entry) { return idle(entry->lastFrame); });
+
+        m_Stats.acquired       = 0;
+        m_Stats.aliased        = 0;
+        m_Stats.created        = 0;
+        m_Stats.requestedBytes = 0;
+        m_Stats.peakBytes      = 0;
+    }
+
+    const RenderTargetPool::Target &RenderTargetPool::acquire(const RenderTargetDesc &desc) {
+        if (desc.width <= 0 || desc.height <= 0) {
+            throw std::runtime_error("Render targets need a size");
+        }
+
+        // one released earlier this frame first, so memory that's already been touched is reused before memory from last frame
+        Entry *chosen = nullptr;
+        for (const auto &entry : m_Entries) {
+            if (!entry->inUse && entry->target.desc == desc && (chosen == nullptr || entry->lastFrame > chosen->lastFrame)) {
+                chosen = entry.get();
+            }
+        }
+
+        if (chosen == nullptr) {
+            auto entry         = std::make_unique<Entry>();
+            entry->target.desc = desc;
+            if (desc.renderbuffer) {
+                entry->target.renderbuffer = std::make_shared<Renderbuffer>(desc.format, desc.width, desc.height, desc.samples);
+            } else if (desc.samples > 0) {
+                entry->target.texture = Texture::createMultisample2d(desc.width, desc.height, desc.samples, desc.format);
+            } else {
+                entry->target.texture = Texture::createStorage2d(desc.width, desc.height, desc.format, 1);
+            }
+            chosen = m_Entries.emplace_back(std::move(entry)).get();
+            m_Stats.created++;
+        } else if (chosen->lastFrame == m_Frame) {
+            m_Stats.aliased++;
+        }
+
+        chosen->inUse     = true;
+        chosen->lastFrame = m_Frame;
+
+        const std::size_t bytes = desc.byteSize();
+        m_InUseBytes += bytes;
+        m_Stats.acquired++;
+        m_Stats.requestedBytes += bytes;
+        m_Stats.peakBytes = std::max(m_Stats.peakBytes, m_InUseBytes);
+        return chosen->target;
+    }
+
+    void RenderTargetPool::release(const Target &target) {
+        const auto entry = std::ranges::find_if(m_Entries, [&target](const auto &entry) { return &entry->target == &target; });
+        if (entry == m_Entries.end() || !(*entry)->inUse) {
+            throw std::logic_error("Released a render target the pool didn't hand out");
+        }
+        (*entry)->inUse = false;
+        m_InUseBytes -= target.desc.byteSize();
+    }
+
+    const Framebuffer &RenderTargetPool::framebuffer(const std::span<const Target *const> colors, const Target *depth) {
+        FramebufferKey key;
+        key.reserve(colors.size() + 1);
+        for (const Target *color : colors) {
+            key.push_back(attachmentKey(color));
+        }
+        key.push_back(attachmentKey(depth));
+
+        auto &cached     = m_Framebuffers[key];
+        cached.lastFrame = m_Frame;
+        if (cached.framebuffer != nullptr) {
+            return *cached.framebuffer;
+        }
+
+        cached.framebuffer = std::make_unique<Framebuffer>();
+
+        const Framebuffer   &framebuffer = *cached.framebuffer;
+        // slot i stays output i, so a null slot is a GL_NONE rather than shifting the outputs after it onto the wrong attachments
+        std::vector<uint8_t> drawBuffers(colors.size(), Framebuffer::kNoDrawBuffer);
+        for (std::size_t i = 0; i < colors.size(); i++) {
+            const Target *color = colors[i];
+            if (color == nullptr) {
+                continue;
+            }
+            cached.attachments.push_back(*color);
+            const auto index = static_cast<uint8_t>(i);
+            if (color->renderbuffer) {
+                framebuffer.attach_color_renderbuffer(color->renderbuffer, index);
+            } else {
+                framebuffer.attach_color_texture(color->texture, index);
+            }
+            drawBuffers[i] = index;
+        }
+        framebuffer.draw_buffers(drawBuffers);
+
+        if (depth != nullptr) {
+            cached.attachments.push_back(*depth);
+            const bool stencil = Texture::hasStencil(depth->desc.format);
+            if (depth->renderbuffer && stencil) {
+                framebuffer.attach_depth_stencil_renderbuffer(depth->renderbuffer);
+            } else if (depth->renderbuffer) {
+                framebuffer.attach_depth_renderbuffer(depth->renderbuffer);
+            } else if (stencil) {
+                framebuffer.attach_depth_stencil_texture(depth->texture);
+            } else {
+                framebuffer.attach_depth_texture(depth->texture);
+            }
+        }
+
+        if (!framebuffer.is_complete()) {
+            m_Framebuffers.erase(key);
+            throw std::runtime_error("Pooled render targets make an incomplete framebuffer, mixed sizes or sample counts?");
+        }
+        return framebuffer;
+    }
+
+    RenderTargetPoolStats RenderTargetPool::stats() const {
+        RenderTargetPoolStats stats = m_Stats;
+        stats.targets               = static_cast<uint32_t>(m_Entries.size());
+        stats.framebuffers          = static_cast<uint32_t>(m_Framebuffers.size());
+        stats.pooledBytes           = 0;
+        for (const auto &entry : m_Entries) {
+            stats.pooledBytes += entry->target.desc.byteSize();
+        }
+        return stats;
+    }
+
+    uint64_t RenderTargetPool::attachmentKey(const Target *target) {
+        if (target == nullptr) {
+            return 0;
+        }
+        if (target->renderbuffer) {
+            return (1ULL << 32) | target->renderbuffer->handle();
+        }
+        return target->texture->handle();
+    }
+} // namespace neuron::render
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "neuron/glwrap.hpp"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace neuron::render {
+
+    struct RenderTargetDesc {
+        int                     width        = 0;
+        int                     height       = 0;
+        Texture::InternalFormat format       = Texture::InternalFormat::RGBA8;
+        int                     samples      = 0;
+        bool                    renderbuffer = false; // can't be sampled afterwards, which is fine for depth nobody reads
+
+        [[nodiscard]] std::size_t byteSize() const;
+
+        bool operator==(const RenderTargetDesc &other) const = default;
+    };
+
+    struct RenderTargetPoolStats {
+        uint32_t targets      = 0; // alive, in use or not
+        uint32_t framebuffers = 0;
+
+        // this frame
+        uint32_t acquired = 0;
+        uint32_t aliased  = 0; // handed a target an earlier pass of the same frame had released
+        uint32_t created  = 0;
+
+        uint64_t destroyed = 0;
+
+        uint64_t requestedBytes = 0; // this frame, what every acquisition would have cost as its own allocation
+        uint64_t peakBytes      = 0; // this frame, the most acquired at once
+        uint64_t pooledBytes    = 0; // what the pool actually holds
+
+        [[nodiscard]] inline float savings() const { return requestedBytes == 0 ? 0.0f : 1.0f - static_cast<float>(pooledBytes) / static_cast<float>(requestedBytes); }
+    };
+
+    /**
+     * Textures and renderbuffers for passes that only need them within a frame. acquire() hands out a free target with the same descriptor or makes one, and
+     * release() gives it back as soon as the last pass reading it is done, so a later pass of the same frame can render into the same memory. That is as
+     * close as GL gets to aliasing, it has no way to place two resources in one allocation. Targets survive the frame and are handed out again next frame,
+     * and are deleted once they've gone unused for a few frames, e.g. after a resize.
+     *
+     * Framebuffers are cached by their attachments, which they keep alive so a recycled GL name can't match a stale entry. They're deleted along with a
+     * pooled attachment, or once unused for as many frames as targets.
+     */
+    class RenderTargetPool {
+      public:
+        struct Settings {
+            uint32_t maxIdleFrames = 3;
+        };
+
+        struct Target {
+            RenderTargetDesc              desc;
+            std::shared_ptr<Texture>      texture; // unless desc.renderbuffer
+            std::shared_ptr<Renderbuffer> renderbuffer;
+        };
+
+        RenderTargetPool();
+        explicit RenderTargetPool(Settings settings);
+
+        RenderTargetPool(const RenderTargetPool &other)            = delete;
+        RenderTargetPool &operator=(const RenderTargetPool &other) = delete;
+
+        // Everything still acquired goes back to the pool, targets idle for too long are deleted and the frame's stats start over. GL thread
+        void beginFrame();
+
+        // Stays valid until it's released or the frame ends. GL thread
+        [[nodiscard]] const Target &acquire(const RenderTargetDesc &desc);
+
+        void release(const Target &target);
+
+        // A framebuffer with `colors` on attachments 0, 1, ... as the draw buffers and `depth` on the depth (and stencil) attachment. Any can be null. The
+        // targets don't have to come from the pool
+        [[nodiscard]] const Framebuffer &framebuffer(std::span<const Target *const> colors, const Target *depth = nullptr);
+
+        [[nodiscard]] RenderTargetPoolStats stats() const;
+
+      private:
+        struct Entry {
+            Target   target;
+            bool     inUse     = false;
+            uint64_t lastFrame = 0; // the last frame it was acquired in
+        };
+
+        struct CachedFramebuffer {
+            std::unique_ptr<Framebuffer> framebuffer;
+            std::vector<Target>          attachments;
+            uint64_t                     lastFrame = 0;
+        };
+
+        // attachments as (renderbuffer << 32 | handle), colors first, then depth or 0
+        using FramebufferKey = std::vector<uint64_t>;
+
+        [[nodiscard]] static uint64_t attachmentKey(const Target *target);
+
+        Settings m_Settings;
+        uint64_t m_Frame      = 0;
+        uint64_t m_InUseBytes = 0;
+
+        std::vector<std::unique_ptr<Entry>>         m_Entries;
+        std::map<FramebufferKey, CachedFramebuffer> m_Framebuffers;
+        RenderTargetPoolStats                       m_Stats;
+    };
+
+} // namespace neuron::render
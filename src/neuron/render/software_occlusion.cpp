@@ -0,0 +1,176 @@
+#include "software_occlusion.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define NEURON_OCCLUSION_SSE 1
+#endif
+
+namespace neuron::render {
+    namespace {
+        // E(p) = a * p.x + b * p.y + c, positive on the inside of a counter-clockwise edge
+        struct EdgeFunction {
+            float a, b, c;
+
+            EdgeFunction(const glm::vec3 &from, const glm::vec3 &to) : a(-(to.y - from.y)), b(to.x - from.x), c(-(a * from.x + b * from.y)) {}
+        };
+
+        int roundUp(const int value, const int multiple) {
+            return (value + multiple - 1) / multiple * multiple;
+        }
+    } // namespace
+
+    SoftwareOcclusionBuffer::SoftwareOcclusionBuffer(const int width, const int height)
+        : m_Width(roundUp(std::max(width, 1), kTileSize)), m_Height(roundUp(std::max(height, 1), kTileSize)), m_TilesX(m_Width / kTileSize), m_TilesY(m_Height / kTileSize),
+          m_Depths(static_cast<std::size_t>(m_Width) * m_Height, 1.0f), m_TileMax(static_cast<std::size_t>(m_TilesX) * m_TilesY, 1.0f) {}
+
+    void SoftwareOcclusionBuffer::clear(const glm::mat4 &viewProjection) {
+        std::ranges::fill(m_Depths, 1.0f);
+        std::ranges::fill(m_TileMax, 1.0f);
+        m_ViewProjection = viewProjection;
+    }
+
+    void SoftwareOcclusionBuffer::rasterizeOccluder(const glm::mat4 &model, const std::span<const glm::vec3> vertices, const std::span<const unsigned int> indices) {
+        const glm::mat4 mvp = m_ViewProjection * model;
+
+        // w <= 0 marks vertices behind the camera
+        std::vector<glm::vec4> screen;
+        screen.reserve(vertices.size());
+        for (const auto &vertex : vertices) {
+            const glm::vec4 clip = mvp * glm::vec4(vertex, 1.0f);
+            if (clip.w <= 1e-5f) {
+                screen.emplace_back(0.0f, 0.0f, 0.0f, 0.0f);
+                continue;
+            }
+
+            const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+            screen.emplace_back((ndc.x * 0.5f + 0.5f) * static_cast<float>(m_Width), (ndc.y * 0.5f + 0.5f) * static_cast<float>(m_Height), ndc.z * 0.5f + 0.5f, 1.0f);
+        }
+
+        for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+            const glm::vec4 &v0 = screen[indices[i]];
+            const glm::vec4 &v1 = screen[indices[i + 1]];
+            const glm::vec4 &v2 = screen[indices[i + 2]];
+            if (v0.w == 0.0f || v1.w == 0.0f || v2.w == 0.0f) {
+                continue;
+            }
+
+            rasterizeTriangle(glm::vec3(v0), glm::vec3(v1), glm::vec3(v2));
+        }
+    }
+
+    void SoftwareOcclusionBuffer::rasterizeTriangle(const glm::vec3 &v0, const glm::vec3 &v1, const glm::vec3 &v2) {
+        const EdgeFunction e12(v1, v2); // weight of v0
+        const EdgeFunction e20(v2, v0); // weight of v1
+        const EdgeFunction e01(v0, v1); // weight of v2
+
+        const float area = e01.a * v2.x + e01.b * v2.y + e01.c;
+        if (area <= 0.0f) {
+            return; // back facing or degenerate
+        }
+
+        const float invArea = 1.0f / area;
+        const float za      = (e12.a * v0.z + e20.a * v1.z + e01.a * v2.z) * invArea;
+        const float zb      = (e12.b * v0.z + e20.b * v1.z + e01.b * v2.z) * invArea;
+        const float zc      = (e12.c * v0.z + e20.c * v1.z + e01.c * v2.z) * invArea;
+
+        const int minX = std::max(static_cast<int>(std::floor(std::min({v0.x, v1.x, v2.x}))), 0) & ~3;
+        const int maxX = std::min(static_cast<int>(std::ceil(std::max({v0.x, v1.x, v2.x}))), m_Width - 1);
+        const int minY = std::max(static_cast<int>(std::floor(std::min({v0.y, v1.y, v2.y}))), 0);
+        const int maxY = std::min(static_cast<int>(std::ceil(std::max({v0.y, v1.y, v2.y}))), m_Height - 1);
+        if (minX > maxX || minY > maxY) {
+            return;
+        }
+
+#ifdef NEURON_OCCLUSION_SSE
+        const __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+        const __m128 zero    = _mm_setzero_ps();
+        const __m128 a0      = _mm_set1_ps(e12.a);
+        const __m128 a1      = _mm_set1_ps(e20.a);
+        const __m128 a2      = _mm_set1_ps(e01.a);
+        const __m128 az      = _mm_set1_ps(za);
+
+        for (int y = minY; y <= maxY; y++) {
+            const float  py   = static_cast<float>(y) + 0.5f;
+            const __m128 row0 = _mm_set1_ps(e12.b * py + e12.c);
+            const __m128 row1 = _mm_set1_ps(e20.b * py + e20.c);
+            const __m128 row2 = _mm_set1_ps(e01.b * py + e01.c);
+            const __m128 rowz = _mm_set1_ps(zb * py + zc);
+            float       *row  = m_Depths.data() + static_cast<std::size_t>(y) * m_Width;
+
+            // the width is a multiple of 4 and minX is aligned down, so this never runs past the row
+            for (int x = minX; x <= maxX; x += 4) {
+                const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+
+                const __m128 w0     = _mm_add_ps(_mm_mul_ps(a0, px), row0);
+                const __m128 w1     = _mm_add_ps(_mm_mul_ps(a1, px), row1);
+                const __m128 w2     = _mm_add_ps(_mm_mul_ps(a2, px), row2);
+                const __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(w0, zero), _mm_cmpge_ps(w1, zero)), _mm_cmpge_ps(w2, zero));
+                if (_mm_movemask_ps(inside) == 0) {
+                    continue;
+                }
+
+                const __m128 depth   = _mm_add_ps(_mm_mul_ps(az, px), rowz);
+                const __m128 old     = _mm_loadu_ps(row + x);
+                const __m128 nearest = _mm_min_ps(old, depth);
+                _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, old)));
+            }
+        }
+#else
+        for (int y = minY; y <= maxY; y++) {
+            const float py  = static_cast<float>(y) + 0.5f;
+            float      *row = m_Depths.data() + static_cast<std::size_t>(y) * m_Width;
+
+            for (int x = minX; x <= maxX; x++) {
+                const float px = static_cast<float>(x) + 0.5f;
+                if (e12.a * px + e12.b * py + e12.c < 0.0f || e20.a * px + e20.b * py + e20.c < 0.0f || e01.a * px + e01.b * py + e01.c < 0.0f) {
+                    continue;
+                }
+
+                row[x] = std::min(row[x], za * px + zb * py + zc);
+            }
+        }
+#endif
+    }
+
+    void SoftwareOcclusionBuffer::finalize() {
+        for (int ty = 0; ty < m_TilesY; ty++) {
+            for (int tx = 0; tx < m_TilesX; tx++) {
+                float maxDepth = 0.0f;
+                for (int y = ty * kTileSize; y < (ty + 1) * kTileSize; y++) {
+                    const float *row = m_Depths.data() + static_cast<std::size_t>(y) * m_Width + tx * kTileSize;
+                    maxDepth         = std::max(maxDepth, *std::max_element(row, row + kTileSize));
+                }
+                m_TileMax[static_cast<std::size_t>(ty) * m_TilesX + tx] = maxDepth;
+            }
+        }
+    }
+
+    bool SoftwareOcclusionBuffer::isRectOccluded(const glm::vec2 &ndcMin, const glm::vec2 &ndcMax, const float nearestDepth) const {
+        const int x0 = std::clamp(static_cast<int>((ndcMin.x * 0.5f + 0.5f) * static_cast<float>(m_Width)), 0, m_Width - 1);
+        const int x1 = std::clamp(static_cast<int>((ndcMax.x * 0.5f + 0.5f) * static_cast<float>(m_Width)), 0, m_Width - 1);
+        const int y0 = std::clamp(static_cast<int>((ndcMin.y * 0.5f + 0.5f) * static_cast<float>(m_Height)), 0, m_Height - 1);
+        const int y1 = std::clamp(static_cast<int>((ndcMax.y * 0.5f + 0.5f) * static_cast<float>(m_Height)), 0, m_Height - 1);
+
+        for (int ty = y0 / kTileSize; ty <= y1 / kTileSize; ty++) {
+            for (int tx = x0 / kTileSize; tx <= x1 / kTileSize; tx++) {
+                if (m_TileMax[static_cast<std::size_t>(ty) * m_TilesX + tx] < nearestDepth) {
+                    continue; // everything in this tile is in front of the object
+                }
+
+                for (int y = std::max(y0, ty * kTileSize); y <= std::min(y1, (ty + 1) * kTileSize - 1); y++) {
+                    const float *row = m_Depths.data() + static_cast<std::size_t>(y) * m_Width;
+                    for (int x = std::max(x0, tx * kTileSize); x <= std::min(x1, (tx + 1) * kTileSize - 1); x++) {
+                        if (row[x] >= nearestDepth) {
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+} // namespace neuron::render
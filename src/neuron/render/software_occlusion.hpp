@@ -0,0 +1,49 @@
+#pragma once
+
+#include "neuron/render/culling.hpp"
+
+#include <span>
+#include <vector>
+
+namespace neuron::render {
+
+    /**
+     * Coarse software rasterized depth buffer for occluders, for when there is no previous frame depth to use (or no GPU at all).
+     * Occluders are rasterized 4 pixels at a time with SSE (when available), keeping the nearest depth per pixel, and finalize() builds per-tile maxima so occlusion tests can reject whole tiles at once.
+     */
+    class SoftwareOcclusionBuffer final : public OcclusionBuffer {
+      public:
+        static constexpr int kTileSize = 8;
+
+        // the width is rounded up to a multiple of the tile size
+        SoftwareOcclusionBuffer(int width, int height);
+        ~SoftwareOcclusionBuffer() override = default;
+
+        void clear(const glm::mat4 &viewProjection);
+
+        // Triangles are expected to be counter-clockwise, back faces are skipped. Triangles which cross the near plane are dropped (so they just don't occlude anything).
+        void rasterizeOccluder(const glm::mat4 &model, std::span<const glm::vec3> vertices, std::span<const unsigned int> indices);
+
+        // Has to be called after rasterizing all occluders and before testing against the buffer.
+        void finalize();
+
+        [[nodiscard]] bool isRectOccluded(const glm::vec2 &ndcMin, const glm::vec2 &ndcMax, float nearestDepth) const override;
+
+        [[nodiscard]] inline int width() const { return m_Width; }
+
+        [[nodiscard]] inline int height() const { return m_Height; }
+
+        [[nodiscard]] inline std::span<const float> depths() const { return m_Depths; }
+
+      private:
+        void rasterizeTriangle(const glm::vec3 &v0, const glm::vec3 &v1, const glm::vec3 &v2);
+
+        int                m_Width;
+        int                m_Height;
+        int                m_TilesX;
+        int                m_TilesY;
+        std::vector<float> m_Depths;
+        std::vector<float> m_TileMax;
+    };
+
+} // namespace neuron::render
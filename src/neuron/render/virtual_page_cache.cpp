@@ -0,0 +1,251 @@
+#include "virtual_page_cache.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+namespace neuron::render {
+    int VirtualTextureLayout::levels() const {
+        int level = 0;
+        while (pagesX(level) > 1 || pagesY(level) > 1) {
+            level++;
+        }
+        return level + 1;
+    }
+
+    int VirtualTextureLayout::pagesX(const int level) const {
+        return (std::max(width >> level, 1) + pageSize - 1) / pageSize;
+    }
+
+    int VirtualTextureLayout::pagesY(const int level) const {
+        return (std::max(height >> level, 1) + pageSize - 1) / pageSize;
+    }
+
+    uint32_t VirtualTextureLayout::pageCount() const {
+        return levelOffset(levels());
+    }
+
+    uint32_t VirtualTextureLayout::index(const VirtualPage &page) const {
+        return levelOffset(static_cast<int>(page.level)) + page.y * static_cast<uint32_t>(pagesX(static_cast<int>(page.level))) + page.x;
+    }
+
+    VirtualPage VirtualTextureLayout::page(uint32_t index) const {
+        uint32_t level = 0;
+        while (true) {
+            const auto across = static_cast<uint32_t>(pagesX(static_cast<int>(level)));
+            const auto count  = across * static_cast<uint32_t>(pagesY(static_cast<int>(level)));
+            if (index < count || count == 1) {
+                return {index % across, index / across, level};
+            }
+            index -= count;
+            level++;
+        }
+    }
+
+    uint32_t VirtualTextureLayout::levelOffset(const int level) const {
+        uint32_t offset = 0;
+        for (int l = 0; l < level; l++) {
+            offset += static_cast<uint32_t>(pagesX(l)) * static_cast<uint32_t>(pagesY(l));
+        }
+        return offset;
+    }
+
+    VirtualPageCache::VirtualPageCache(const VirtualTextureLayout &layout, const uint32_t slots) : m_Layout(layout) {
+        if (layout.width <= 0 || layout.height <= 0 || layout.pageSize <= 0) {
+            throw std::runtime_error("Virtual texture layouts need a size and a page size");
+        }
+
+        m_Levels = layout.levels();
+        if (slots < 2) {
+            throw std::runtime_error("A virtual texture needs more physical pages than its pinned coarsest level");
+        }
+
+        const uint32_t count = layout.pageCount();
+        m_States.assign(count, State::Missing);
+        m_PageSlots.assign(count, kNoSlot);
+        m_Seen.assign(count, UINT64_MAX);
+        m_Slots.resize(slots);
+
+        for (int level = 0; level < m_Levels; level++) {
+            m_Table.emplace_back(static_cast<std::size_t>(layout.pagesX(level)) * static_cast<std::size_t>(layout.pagesY(level)));
+        }
+        m_Dirty.assign(m_Levels, true);
+
+        request(count - 1);
+    }
+
+    void VirtualPageCache::feedback(const std::span<const uint32_t> pages, const uint64_t frame) {
+        // requests nobody took are stale by now
+        for (const uint32_t index : m_Requests) {
+            if (m_States[index] == State::Requested) {
+                m_States[index] = State::Missing;
+            }
+        }
+        m_Requests.clear();
+
+        for (const uint32_t requested : pages) {
+            if (requested >= m_States.size()) {
+                continue;
+            }
+
+            // the ancestors are the fallback while a page loads, so they're needed just as much
+            VirtualPage page = m_Layout.page(requested);
+            while (true) {
+                const uint32_t index = m_Layout.index(page);
+                if (m_Seen[index] == frame) {
+                    break; // and so were its ancestors
+                }
+                m_Seen[index] = frame;
+
+                if (m_States[index] == State::Resident) {
+                    m_Slots[m_PageSlots[index]].lastUsed = frame;
+                } else if (m_States[index] == State::Missing) {
+                    request(index);
+                }
+
+                if (static_cast<int>(page.level) + 1 >= m_Levels) {
+                    break;
+                }
+                page = {page.x / 2, page.y / 2, page.level + 1};
+            }
+        }
+
+        if (const uint32_t pinned = static_cast<uint32_t>(m_States.size()) - 1; m_States[pinned] == State::Missing) {
+            request(pinned);
+        }
+        m_Stats.requested = static_cast<uint32_t>(m_Requests.size());
+    }
+
+    std::vector<VirtualPage> VirtualPageCache::takeRequests(const std::size_t count) {
+        std::ranges::stable_sort(m_Requests, std::greater<>(), [this](const uint32_t index) { return m_Layout.page(index).level; });
+
+        std::vector<VirtualPage> pages;
+        const std::size_t        taken = std::min(count, m_Requests.size());
+        for (std::size_t i = 0; i < taken; i++) {
+            m_States[m_Requests[i]] = State::Loading;
+            pages.push_back(m_Layout.page(m_Requests[i]));
+        }
+        m_Requests.erase(m_Requests.begin(), m_Requests.begin() + static_cast<std::ptrdiff_t>(taken));
+        return pages;
+    }
+
+    std::optional<VirtualPageCache::Insertion> VirtualPageCache::insert(const VirtualPage &page, const uint64_t frame) {
+        if (static_cast<int>(page.level) >= m_Levels || static_cast<int>(page.x) >= m_Layout.pagesX(static_cast<int>(page.level)) ||
+            static_cast<int>(page.y) >= m_Layout.pagesY(static_cast<int>(page.level))) {
+            return std::nullopt;
+        }
+
+        const uint32_t index = m_Layout.index(page);
+        if (m_States[index] != State::Loading) {
+            return std::nullopt;
+        }
+
+        // a free slot, otherwise the least recently used one the frame didn't ask for
+        uint32_t chosen = kNoSlot;
+        for (uint32_t i = 0; i < m_Slots.size(); i++) {
+            const Slot &slot = m_Slots[i];
+            if (slot.page == UINT32_MAX) {
+                chosen = i;
+                break;
+            }
+            if (!slot.pinned && slot.lastUsed < frame && (chosen == kNoSlot || slot.lastUsed < m_Slots[chosen].lastUsed)) {
+                chosen = i;
+            }
+        }
+        if (chosen == kNoSlot) {
+            m_States[index] = State::Missing;
+            m_Stats.dropped++;
+            return std::nullopt;
+        }
+
+        Insertion insertion{chosen, std::nullopt};
+        Slot     &slot = m_Slots[chosen];
+        if (slot.page != UINT32_MAX) {
+            const VirtualPage evicted = m_Layout.page(slot.page);
+            m_States[slot.page]       = State::Missing;
+            m_PageSlots[slot.page]    = kNoSlot;
+            slot.page                 = UINT32_MAX;
+            updateTable(evicted);
+
+            insertion.evicted = evicted;
+            m_Stats.evictions++;
+        }
+
+        slot               = {index, frame, static_cast<int>(page.level) == m_Levels - 1};
+        m_States[index]    = State::Resident;
+        m_PageSlots[index] = chosen;
+        updateTable(page);
+
+        m_Stats.inserted++;
+        return insertion;
+    }
+
+    void VirtualPageCache::cancel(const VirtualPage &page) {
+        if (const uint32_t index = m_Layout.index(page); index < m_States.size() && m_States[index] == State::Loading) {
+            m_States[index] = State::Missing;
+        }
+    }
+
+    std::optional<uint32_t> VirtualPageCache::slot(const VirtualPage &page) const {
+        const uint32_t index = m_Layout.index(page);
+        if (index >= m_States.size() || m_States[index] != State::Resident) {
+            return std::nullopt;
+        }
+        return m_PageSlots[index];
+    }
+
+    std::span<const VirtualPageCache::Entry> VirtualPageCache::pageTable(const int level) const {
+        return m_Table[level];
+    }
+
+    std::vector<int> VirtualPageCache::takeDirtyLevels() {
+        std::vector<int> levels;
+        for (int level = 0; level < m_Levels; level++) {
+            if (m_Dirty[level]) {
+                levels.push_back(level);
+                m_Dirty[level] = false;
+            }
+        }
+        return levels;
+    }
+
+    VirtualPageCacheStats VirtualPageCache::stats() const {
+        VirtualPageCacheStats stats = m_Stats;
+        stats.resident              = static_cast<uint32_t>(std::ranges::count_if(m_Slots, [](const Slot &slot) { return slot.page != UINT32_MAX; }));
+        stats.loading               = static_cast<uint32_t>(std::ranges::count(m_States, State::Loading));
+        return stats;
+    }
+
+    void VirtualPageCache::request(const uint32_t index) {
+        m_States[index] = State::Requested;
+        m_Requests.push_back(index);
+    }
+
+    void VirtualPageCache::updateTable(const VirtualPage &page) {
+        // top down, so the parent of every entry is already up to date
+        for (int level = static_cast<int>(page.level); level >= 0; level--) {
+            const int      shift  = static_cast<int>(page.level) - level;
+            const int      across = m_Layout.pagesX(level);
+            const int      x0     = static_cast<int>(page.x) << shift;
+            const int      y0     = static_cast<int>(page.y) << shift;
+            const int      x1     = std::min(static_cast<int>(page.x + 1) << shift, across);
+            const int      y1     = std::min(static_cast<int>(page.y + 1) << shift, m_Layout.pagesY(level));
+            const uint32_t offset = m_Layout.levelOffset(level);
+
+            for (int y = y0; y < y1; y++) {
+                for (int x = x0; x < x1; x++) {
+                    const uint32_t index = offset + static_cast<uint32_t>(y * across + x);
+                    Entry         &entry = m_Table[level][y * across + x];
+                    if (m_States[index] == State::Resident) {
+                        entry = {m_PageSlots[index], static_cast<uint32_t>(level)};
+                    } else if (level + 1 < m_Levels) {
+                        entry = m_Table[level + 1][(y / 2) * m_Layout.pagesX(level + 1) + x / 2];
+                    } else {
+                        entry = {};
+                    }
+                }
+            }
+            m_Dirty[level] = true;
+        }
+    }
+} // namespace neuron::render
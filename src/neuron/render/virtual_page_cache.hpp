@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace neuron::render {
+
+    struct VirtualPage {
+        uint32_t x     = 0;
+        uint32_t y     = 0;
+        uint32_t level = 0;
+
+        auto operator<=>(const VirtualPage &other) const = default;
+    };
+
+    // A virtual texture cut into square pages, with mip levels down to the first one a single page covers
+    struct VirtualTextureLayout {
+        int width    = 0;
+        int height   = 0;
+        int pageSize = 128;
+
+        [[nodiscard]] int levels() const;
+
+        [[nodiscard]] int pagesX(int level) const;
+
+        [[nodiscard]] int pagesY(int level) const;
+
+        // over every level
+        [[nodiscard]] uint32_t pageCount() const;
+
+        // Finest level first, row major within a level. Page tables and feedback on the GPU are numbered the same way
+        [[nodiscard]] uint32_t index(const VirtualPage &page) const;
+
+        [[nodiscard]] VirtualPage page(uint32_t index) const;
+
+        // index of the first page of `level`
+        [[nodiscard]] uint32_t levelOffset(int level) const;
+    };
+
+    struct VirtualPageCacheStats {
+        uint32_t resident  = 0;
+        uint32_t loading   = 0;
+        uint32_t requested = 0; // missing pages the last feedback asked for
+
+        uint64_t inserted  = 0;
+        uint64_t evictions = 0;
+        uint64_t dropped   = 0; // loaded pages with no slot to go to, they're requested again if still needed
+    };
+
+    /**
+     * The CPU half of virtual texturing, with no GL in it so it can be driven and checked on its own. feedback() takes the pages the GPU asked for and turns
+     * the missing ones into requests, coarsest first, after their coarser ancestors so every page has a fallback on screen while it loads. Loaded pages go
+     * into a fixed number of physical slots, evicting the least recently requested page. The coarsest level is pinned, so there is always something to show.
+     * The page table says for every page which slot to sample and at what level, the page itself or the nearest resident ancestor.
+     */
+    class VirtualPageCache {
+      public:
+        static constexpr uint32_t kNoSlot = UINT32_MAX;
+
+        struct Entry {
+            uint32_t slot  = kNoSlot;
+            uint32_t level = 0;
+        };
+
+        struct Insertion {
+            uint32_t                   slot;
+            std::optional<VirtualPage> evicted;
+        };
+
+        // `slots` has to leave room beyond the pinned coarsest level, otherwise this throws std::runtime_error
+        VirtualPageCache(const VirtualTextureLayout &layout, uint32_t slots);
+
+        // Page indices the GPU sampled while rendering `frame`, duplicates are fine. Replaces the requests of the previous feedback
+        void feedback(std::span<const uint32_t> pages, uint64_t frame);
+
+        // Up to `count` of the outstanding requests, coarsest first. They count as loading until insert() or cancel()
+        [[nodiscard]] std::vector<VirtualPage> takeRequests(std::size_t count);
+
+        // A loaded page gets a slot. nullopt if it wasn't loading or every slot was used during `frame`
+        [[nodiscard]] std::optional<Insertion> insert(const VirtualPage &page, uint64_t frame);
+
+        // the load failed, the page goes back to missing
+        void cancel(const VirtualPage &page);
+
+        [[nodiscard]] std::optional<uint32_t> slot(const VirtualPage &page) const;
+
+        [[nodiscard]] std::span<const Entry> pageTable(int level) const;
+
+        // levels whose page table changed since the last call, finest first
+        [[nodiscard]] std::vector<int> takeDirtyLevels();
+
+        [[nodiscard]] inline const VirtualTextureLayout &layout() const { return m_Layout; }
+
+        [[nodiscard]] inline uint32_t slotCount() const { return static_cast<uint32_t>(m_Slots.size()); }
+
+        [[nodiscard]] VirtualPageCacheStats stats() const;
+
+      private:
+        enum class State : uint8_t {
+            Missing,
+            Requested,
+            Loading,
+            Resident,
+        };
+
+        struct Slot {
+            uint32_t page     = UINT32_MAX; // index, UINT32_MAX when free
+            uint64_t lastUsed = 0;
+            bool     pinned   = false;
+        };
+
+        void request(uint32_t index);
+
+        // recomputes the entries of the page and everything finer underneath it
+        void updateTable(const VirtualPage &page);
+
+        VirtualTextureLayout m_Layout;
+        int                  m_Levels;
+
+        std::vector<State>    m_States;    // per page index
+        std::vector<uint32_t> m_PageSlots; // per page index
+        std::vector<uint64_t> m_Seen;      // per page index, the last feedback frame that asked for it
+        std::vector<Slot>     m_Slots;
+        std::vector<uint32_t> m_Requests;
+
+        std::vector<std::vector<Entry>> m_Table; // per level
+        std::vector<bool>               m_Dirty; // per level
+
+        VirtualPageCacheStats m_Stats;
+    };
+
+} // namespace neuron::render
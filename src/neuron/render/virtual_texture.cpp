@@ -0,0 +1,259 @@
+#include "virtual_texture.hpp"
+
+#include "neuron/frame_fences.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+namespace neuron::render {
+    namespace {
+        constexpr uint32_t kNoEntry = 0xFFFFFFFF;
+
+        Sampler::Settings physicalSampler(const bool sparse) {
+            Sampler::Settings settings;
+            settings.minFilter = sparse ? Sampler::Filter::LinearMipmapLinear : Sampler::Filter::Linear;
+            settings.wrapS     = Sampler::Wrap::ClampToEdge;
+            settings.wrapT     = Sampler::Wrap::ClampToEdge;
+            return settings;
+        }
+    } // namespace
+
+    VirtualTexture::VirtualTexture(const VirtualTextureLayout &layout, PageLoader loader, ThreadPool &pool) : VirtualTexture(layout, Settings{}, std::move(loader), pool) {
+    }
+
+    VirtualTexture::VirtualTexture(const VirtualTextureLayout &layout, const Settings settings, PageLoader loader, ThreadPool &pool)
+        : m_Cache(layout, settings.physicalPages), m_Settings(settings), m_Loader(std::move(loader)), m_Pool(pool) {
+        if (layout.levels() > kMaxLevels) {
+            throw std::runtime_error("Virtual texture has more levels than the page table can describe, use bigger pages");
+        }
+
+        m_Sparse = settings.allowSparse && createSparse();
+        if (!m_Sparse) {
+            createAtlas();
+        }
+        m_Sampler = std::make_unique<Sampler>(physicalSampler(m_Sparse));
+
+        PageTableHeader header{};
+        header.info  = {layout.width, layout.height, layout.pageSize, layout.levels()};
+        header.atlas = {m_AtlasColumns, layout.pageSize + 2 * kBorder, kBorder, m_Sparse ? 1 : 0};
+        for (int level = 0; level < layout.levels(); level++) {
+            header.levels[level] = {static_cast<int>(layout.levelOffset(level)), layout.pagesX(level), layout.pagesY(level), 0};
+        }
+
+        const std::vector<uint32_t> entries(layout.pageCount(), kNoEntry);
+        m_PageTable = std::make_unique<Buffer>(sizeof(header) + entries.size() * sizeof(uint32_t), nullptr, Buffer::Storage{GL_DYNAMIC_STORAGE_BIT});
+        glNamedBufferSubData(m_PageTable->handle(), 0, sizeof(header), &header);
+        glNamedBufferSubData(m_PageTable->handle(), sizeof(header), static_cast<GLsizeiptr>(entries.size() * sizeof(uint32_t)), entries.data());
+
+        m_FeedbackWords.resize((layout.pageCount() + 31) / 32);
+        const std::size_t feedbackBytes = m_FeedbackWords.size() * sizeof(uint32_t);
+        m_Feedback                      = std::make_unique<Buffer>(feedbackBytes, m_FeedbackWords.data(), Buffer::Storage{0});
+        for (auto &readback : m_Readbacks) {
+            readback.buffer = std::make_unique<Buffer>(feedbackBytes, nullptr, Buffer::Storage{0});
+        }
+    }
+
+    VirtualTexture::~VirtualTexture() {
+        // the jobs call the loader, which goes away with this
+        for (auto &load : m_Loads) {
+            load.image.wait();
+        }
+    }
+
+    void VirtualTexture::bind(const unsigned int unit) const {
+        m_Physical->bind(unit);
+        m_Sampler->bind(unit);
+        m_PageTable->bind_indexed(Buffer::IndexedTarget::ShaderStorage, kPageTableBinding);
+        m_Feedback->bind_indexed(Buffer::IndexedTarget::ShaderStorage, kFeedbackBinding);
+    }
+
+    void VirtualTexture::update() {
+        const uint64_t frame = FrameFences::global().recordingFrame();
+        readFeedback(FrameFences::global().completedFrame());
+
+        // If every readback is still in flight the GPU is behind, and the bits stay in the feedback buffer for the next try
+        if (Readback &readback = m_Readbacks[m_NextReadback]; readback.frame == 0) {
+            glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+            glCopyNamedBufferSubData(m_Feedback->handle(), readback.buffer->handle(), 0, 0, static_cast<GLsizeiptr>(m_Feedback->size()));
+            glClearNamedBufferData(m_Feedback->handle(), GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+            readback.frame = frame;
+            m_NextReadback = (m_NextReadback + 1) % kReadbacks;
+        }
+
+        // finished loads first, in the order they were asked for, since that's coarsest first
+        uint32_t uploads = 0;
+        for (auto it = m_Loads.begin(); it != m_Loads.end() && uploads < m_Settings.uploadsPerFrame;) {
+            if (it->image.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                ++it;
+                continue;
+            }
+
+            const VirtualPage page = it->page;
+            Image             image;
+            try {
+                image = it->image.get();
+            } catch (const std::exception &) {
+                image = {};
+            }
+            it = m_Loads.erase(it);
+
+            const int expected = m_Sparse ? m_Cache.layout().pageSize : m_Cache.layout().pageSize + 2 * kBorder;
+            if (image.width != expected || image.height != expected) {
+                m_Cache.cancel(page);
+                m_Stats.failedLoads++;
+                continue;
+            }
+
+            if (const auto insertion = m_Cache.insert(page, m_FeedbackFrame)) {
+                if (insertion->evicted && m_Sparse) {
+                    commit(*insertion->evicted, false);
+                }
+                upload(page, image, insertion->slot);
+                uploads++;
+            }
+        }
+
+        // a couple of frames worth of loads in flight keeps the uploads busy without loading pages nobody wants any more
+        const std::size_t inFlight = 2 * static_cast<std::size_t>(m_Settings.uploadsPerFrame);
+        if (m_Loads.size() < inFlight) {
+            for (const auto &page : m_Cache.takeRequests(inFlight - m_Loads.size())) {
+                m_Loads.push_back({page, m_Pool.submit([this, page] { return m_Loader(page, m_Sparse ? 0 : kBorder); })});
+            }
+        }
+
+        uploadPageTable();
+    }
+
+    VirtualTextureStats VirtualTexture::stats() const {
+        VirtualTextureStats stats = m_Stats;
+        stats.cache               = m_Cache.stats();
+        stats.sparse              = m_Sparse;
+        return stats;
+    }
+
+    bool VirtualTexture::createSparse() {
+        if (!GLAD_GL_ARB_sparse_texture) {
+            return false;
+        }
+
+        const auto &layout = m_Cache.layout();
+        GLint       pageX = 0, pageY = 0;
+        glGetInternalformativ(GL_TEXTURE_2D, GL_RGBA8, GL_VIRTUAL_PAGE_SIZE_X_ARB, 1, &pageX);
+        glGetInternalformativ(GL_TEXTURE_2D, GL_RGBA8, GL_VIRTUAL_PAGE_SIZE_Y_ARB, 1, &pageY);
+        if (pageX <= 0 || pageY <= 0 || layout.pageSize % pageX != 0 || layout.pageSize % pageY != 0) {
+            return false; // pages would share sparse pages, which can only be committed together
+        }
+
+        m_Physical = std::make_shared<Texture>(Texture::Type::Texture2D);
+        glTextureParameteri(m_Physical->handle(), GL_TEXTURE_SPARSE_ARB, GL_TRUE);
+        glTextureParameteri(m_Physical->handle(), GL_VIRTUAL_PAGE_SIZE_INDEX_ARB, 0);
+        m_Physical->storage2d(layout.levels(), Texture::InternalFormat::RGBA8, layout.width, layout.height);
+
+        // levels smaller than a sparse page share the mip tail, which can only be committed as a whole
+        glGetTextureParameteriv(m_Physical->handle(), GL_NUM_SPARSE_LEVELS_ARB, &m_SparseLevels);
+        if (m_SparseLevels < layout.levels()) {
+            m_Physical->bind();
+            glTexPageCommitmentARB(GL_TEXTURE_2D, m_SparseLevels, 0, 0, 0, std::max(layout.width >> m_SparseLevels, 1), std::max(layout.height >> m_SparseLevels, 1), 1,
+                                   GL_TRUE);
+        }
+        return true;
+    }
+
+    void VirtualTexture::createAtlas() {
+        const int physical = m_Cache.layout().pageSize + 2 * kBorder;
+        m_AtlasColumns     = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(m_Cache.slotCount()))));
+        m_Physical         = Texture::createStorage2d(m_AtlasColumns * physical, m_AtlasColumns * physical, Texture::InternalFormat::RGBA8, 1);
+    }
+
+    void VirtualTexture::readFeedback(const uint64_t completedFrame) {
+        Readback *newest = nullptr;
+        for (auto &readback : m_Readbacks) {
+            if (readback.frame != 0 && readback.frame <= completedFrame) {
+                if (newest == nullptr || readback.frame > newest->frame) {
+                    newest = &readback;
+                }
+            }
+        }
+        if (newest == nullptr) {
+            return;
+        }
+
+        // the fence has passed, so this doesn't wait
+        glGetNamedBufferSubData(newest->buffer->handle(), 0, static_cast<GLsizeiptr>(m_FeedbackWords.size() * sizeof(uint32_t)), m_FeedbackWords.data());
+
+        std::vector<uint32_t> pages;
+        for (std::size_t word = 0; word < m_FeedbackWords.size(); word++) {
+            for (uint32_t bits = m_FeedbackWords[word]; bits != 0; bits &= bits - 1) {
+                pages.push_back(static_cast<uint32_t>(word * 32) + static_cast<uint32_t>(std::countr_zero(bits)));
+            }
+        }
+        m_FeedbackFrame       = newest->frame;
+        m_Stats.feedbackPages = static_cast<uint32_t>(pages.size());
+        m_Cache.feedback(pages, m_FeedbackFrame);
+
+        for (auto &readback : m_Readbacks) {
+            if (readback.frame != 0 && readback.frame <= newest->frame) {
+                readback.frame = 0;
+            }
+        }
+    }
+
+    void VirtualTexture::upload(const VirtualPage &page, const Image &image, const uint32_t slot) {
+        // the pixels are in client memory
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        if (m_Sparse) {
+            const auto &layout = m_Cache.layout();
+            const int   level  = static_cast<int>(page.level);
+            const int   x      = static_cast<int>(page.x) * layout.pageSize;
+            const int   y      = static_cast<int>(page.y) * layout.pageSize;
+            const int   width  = std::min(layout.pageSize, std::max(layout.width >> level, 1) - x);
+            const int   height = std::min(layout.pageSize, std::max(layout.height >> level, 1) - y);
+
+            commit(page, true);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, image.width);
+            m_Physical->subImage2d(level, x, y, width, height, Texture::Format::RGBA, Texture::DataType::UnsignedByte, image.pixels.data());
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        } else {
+            const int physical = image.width;
+            m_Physical->subImage2d(0, static_cast<int>(slot) % m_AtlasColumns * physical, static_cast<int>(slot) / m_AtlasColumns * physical, physical, physical,
+                                   Texture::Format::RGBA, Texture::DataType::UnsignedByte, image.pixels.data());
+        }
+
+        m_Stats.uploads++;
+        m_Stats.uploadedBytes += image.byteSize();
+    }
+
+    void VirtualTexture::commit(const VirtualPage &page, const bool commit) const {
+        const int level = static_cast<int>(page.level);
+        if (level >= m_SparseLevels) {
+            return; // in the mip tail
+        }
+
+        const auto &layout = m_Cache.layout();
+        const int   x      = static_cast<int>(page.x) * layout.pageSize;
+        const int   y      = static_cast<int>(page.y) * layout.pageSize;
+        const int   width  = std::min(layout.pageSize, std::max(layout.width >> level, 1) - x);
+        const int   height = std::min(layout.pageSize, std::max(layout.height >> level, 1) - y);
+
+        m_Physical->bind();
+        glTexPageCommitmentARB(GL_TEXTURE_2D, level, x, y, 0, width, height, 1, commit ? GL_TRUE : GL_FALSE);
+    }
+
+    void VirtualTexture::uploadPageTable() {
+        const auto           &layout = m_Cache.layout();
+        std::vector<uint32_t> entries;
+        for (const int level : m_Cache.takeDirtyLevels()) {
+            entries.clear();
+            for (const auto &entry : m_Cache.pageTable(level)) {
+                entries.push_back(entry.slot == VirtualPageCache::kNoSlot ? kNoEntry : entry.slot | entry.level << 24);
+            }
+
+            const std::size_t offset = sizeof(PageTableHeader) + layout.levelOffset(level) * sizeof(uint32_t);
+            glNamedBufferSubData(m_PageTable->handle(), static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(entries.size() * sizeof(uint32_t)), entries.data());
+        }
+    }
+} // namespace neuron::render
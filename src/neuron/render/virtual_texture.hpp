@@ -0,0 +1,124 @@
+#pragma once
+
+#include "neuron/glwrap.hpp"
+#include "neuron/image.hpp"
+#include "neuron/render/virtual_page_cache.hpp"
+#include "neuron/thread_pool.hpp"
+
+#include <array>
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace neuron::render {
+
+    struct VirtualTextureStats {
+        VirtualPageCacheStats cache;
+
+        bool     sparse        = false;
+        uint32_t feedbackPages = 0; // distinct pages the last feedback asked for
+        uint64_t uploads       = 0;
+        uint64_t uploadedBytes = 0;
+        uint64_t failedLoads   = 0;
+    };
+
+    /**
+     * A texture far larger than memory, of which only the pages that were actually sampled are loaded. Shaders include res/virtual_texture.glsl and call
+     * vtSample(), which reads the page table and marks the page it wanted in a feedback bitmap. update() reads the bitmap back a few frames later (without
+     * waiting on the GPU), hands it to a VirtualPageCache, loads the missing pages on the pool and uploads a few per frame.
+     *
+     * With ARB_sparse_texture (and a page size that's a multiple of the sparse page size) the texture is one sparse mip chain, and pages are committed and
+     * decommitted as they come and go. Otherwise pages live in the slots of an atlas, each with a border of its neighbours so bilinear filtering doesn't
+     * bleed, and the shader finds them through the page table.
+     */
+    class VirtualTexture {
+      public:
+        // what virtual_texture.glsl expects
+        static constexpr unsigned int kPageTableBinding = 6;
+        static constexpr unsigned int kFeedbackBinding  = 7;
+        static constexpr int          kBorder           = 1;
+        static constexpr int          kMaxLevels        = 16;
+
+        // RGBA8 texels of the page with `border` texels of its neighbours around it, so pageSize + 2 * border square, clamped at the edges. Runs on a worker
+        using PageLoader = std::function<Image(const VirtualPage &page, int border)>;
+
+        struct Settings {
+            uint32_t physicalPages   = 256;
+            uint32_t uploadsPerFrame = 16;
+            bool     allowSparse     = true;
+        };
+
+        VirtualTexture(const VirtualTextureLayout &layout, PageLoader loader, ThreadPool &pool = ThreadPool::global());
+        VirtualTexture(const VirtualTextureLayout &layout, Settings settings, PageLoader loader, ThreadPool &pool = ThreadPool::global());
+        ~VirtualTexture();
+
+        VirtualTexture(const VirtualTexture &other)            = delete;
+        VirtualTexture &operator=(const VirtualTexture &other) = delete;
+
+        // the physical texture on `unit`, the page table and feedback buffers on their bindings
+        void bind(unsigned int unit) const;
+
+        // GL thread, once per frame after everything sampling the texture has been drawn
+        void update();
+
+        [[nodiscard]] inline bool sparse() const { return m_Sparse; }
+
+        [[nodiscard]] inline const VirtualPageCache &cache() const { return m_Cache; }
+
+        [[nodiscard]] VirtualTextureStats stats() const;
+
+      private:
+        static constexpr std::size_t kReadbacks = 3;
+
+        // the head of the page table buffer, as std430 lays it out
+        struct PageTableHeader {
+            glm::ivec4 info;  // width, height, page size, levels
+            glm::ivec4 atlas; // slots per row, physical page size, border, sparse
+            glm::ivec4 levels[kMaxLevels]; // first page index, pages across, pages down
+        };
+
+        struct Load {
+            VirtualPage        page;
+            std::future<Image> image;
+        };
+
+        struct Readback {
+            std::unique_ptr<Buffer> buffer;
+            uint64_t                frame = 0; // 0 when free
+        };
+
+        bool createSparse();
+        void createAtlas();
+
+        // the newest readback the GPU is done with goes to the cache, older ones are dropped
+        void readFeedback(uint64_t completedFrame);
+
+        void upload(const VirtualPage &page, const Image &image, uint32_t slot);
+        void commit(const VirtualPage &page, bool commit) const;
+        void uploadPageTable();
+
+        VirtualPageCache m_Cache;
+        Settings         m_Settings;
+        PageLoader       m_Loader;
+        ThreadPool      &m_Pool;
+
+        bool m_Sparse       = false;
+        int  m_SparseLevels = 0; // levels below this one are in the mip tail, committed for good
+        int  m_AtlasColumns = 1;
+
+        std::shared_ptr<Texture> m_Physical;
+        std::unique_ptr<Sampler> m_Sampler;
+        std::unique_ptr<Buffer>  m_PageTable;
+        std::unique_ptr<Buffer>  m_Feedback; // a bit per page
+
+        std::array<Readback, kReadbacks> m_Readbacks;
+        std::size_t                      m_NextReadback  = 0;
+        uint64_t                         m_FeedbackFrame = 0;
+        std::vector<uint32_t>            m_FeedbackWords;
+
+        std::vector<Load>   m_Loads;
+        VirtualTextureStats m_Stats;
+    };
+
+} // namespace neuron::render
@@ -1,6 +1,313 @@
 #include "scene.hpp"
 
-namespace neuron {
-namespace scene {
-} // scene
-} // neuron
\ No newline at end of file
+#include "neuron/ecs/components.hpp"
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace neuron::scene {
+    namespace {
+        // The nearest ancestor with a T. cascade runs parents first, so it's already up to date, and entities in between without one don't cut the chain
+        template <typename T>
+        const T *nearestAncestor(const flecs::entity entity) {
+            for (flecs::entity ancestor = entity.parent(); ancestor.is_valid(); ancestor = ancestor.parent()) {
+                if (const T *component = ancestor.get<T>(); component != nullptr) {
+                    return component;
+                }
+            }
+            return nullptr;
+        }
+    } // namespace
+
+    Scene::Scene(const int32_t threads) {
+        const int32_t threadCount = threads < 0 ? static_cast<int32_t>(std::max(std::thread::hardware_concurrency(), 1U)) : threads;
+        if (threadCount > 1) {
+            m_World.set_threads(threadCount);
+        }
+
+        registerComponents();
+        createPhases();
+        registerSystems();
+
+        m_SceneRoot = m_World.entity("SceneRoot");
+    }
+
+    void Scene::registerComponents() {
+        m_World.component<ecs::Position>();
+        m_World.component<ecs::Rotation>();
+        m_World.component<ecs::Scale>();
+        m_World.component<ecs::CalculatedTransformMatrix>();
+        m_World.component<ecs::GlobalTransformMatrix>();
+        m_World.component<ecs::Visibility>();
+        m_World.component<ecs::CalculatedVisibility>();
+        m_World.component<ecs::GlobalPosition>();
+        m_World.component<ecs::Bounds>();
+        m_World.component<ecs::MeshBounds>();
+        m_World.component<ecs::CullState>();
+        m_World.component<ecs::MeshRenderer>();
+        m_World.component<ecs::RenderOnCameraLayer>();
+        m_World.component<ecs::CameraLayer>();
+        m_World.component<ecs::Camera>();
+        m_World.component<ecs::OrthographicCameraProjection>();
+        m_World.component<ecs::PerspectiveCameraProjection>();
+        m_World.component<ecs::tags::HasCustomVisibility>();
+        m_World.component<ecs::tags::HasCustomTransformMatrix>();
+
+        // the calculated components get added along with whatever they are calculated from, so users only ever have to set the inputs
+        m_World.component<ecs::Position>().add(flecs::With, m_World.component<ecs::CalculatedTransformMatrix>());
+        m_World.component<ecs::Rotation>().add(flecs::With, m_World.component<ecs::CalculatedTransformMatrix>());
+        m_World.component<ecs::Scale>().add(flecs::With, m_World.component<ecs::CalculatedTransformMatrix>());
+        m_World.component<ecs::CalculatedTransformMatrix>().add(flecs::With, m_World.component<ecs::GlobalTransformMatrix>());
+        m_World.component<ecs::GlobalTransformMatrix>().add(flecs::With, m_World.component<ecs::GlobalPosition>());
+        m_World.component<ecs::Visibility>().add(flecs::With, m_World.component<ecs::CalculatedVisibility>());
+        m_World.component<ecs::MeshRenderer>().add(flecs::With, m_World.component<ecs::CalculatedVisibility>());
+        m_World.component<ecs::Bounds>().add(flecs::With, m_World.component<ecs::CullState>());
+        m_World.component<ecs::OrthographicCameraProjection>().add(flecs::With, m_World.component<ecs::Camera>());
+        m_World.component<ecs::PerspectiveCameraProjection>().add(flecs::With, m_World.component<ecs::Camera>());
+    }
+
+    void Scene::createPhases() {
+        for (std::size_t i = 0; i < kPhaseCount; i++) {
+            const std::string name = "neuron::phase::" + std::string(phaseName(static_cast<Phase>(i)));
+
+            // these deliberately don't get the flecs::Phase tag, so world.progress() won't pick up the systems in them
+            m_Phases[i]         = m_World.entity(name.c_str());
+            m_PhasePipelines[i] = m_World.pipeline().with(flecs::System).with(m_Phases[i]).without(flecs::Disabled).build();
+        }
+    }
+
+    void Scene::registerSystems() {
+        const flecs::entity transform = phase(Phase::Transform);
+
+        m_World.system<ecs::CalculatedTransformMatrix, const ecs::Position *, const ecs::Rotation *, const ecs::Scale *>("neuron::system::LocalTransform")
+            .kind(transform)
+            .without<ecs::tags::HasCustomTransformMatrix>()
+            .multi_threaded()
+            .each([](ecs::CalculatedTransformMatrix &local, const ecs::Position *position, const ecs::Rotation *rotation, const ecs::Scale *scale) {
+                glm::mat4 matrix = glm::identity<glm::mat4>();
+                if (position != nullptr) {
+                    matrix = glm::translate(matrix, position->position);
+                }
+                if (rotation != nullptr) {
+                    matrix = matrix * glm::mat4_cast(rotation->rotation);
+                }
+                if (scale != nullptr) {
+                    matrix = glm::scale(matrix, scale->scale);
+                }
+                local.matrix = matrix;
+            });
+
+        // cascade iterates breadth first so parents are always done before their children, which also means this one can't be split over threads
+        m_World.system<const ecs::CalculatedTransformMatrix, const ecs::GlobalTransformMatrix *, ecs::GlobalTransformMatrix, ecs::GlobalPosition *>("neuron::system::GlobalTransform")
+            .kind(transform)
+            .term_at(1)
+            .parent()
+            .cascade()
+            .each([](flecs::entity entity, const ecs::CalculatedTransformMatrix &local, const ecs::GlobalTransformMatrix *parent, ecs::GlobalTransformMatrix &global,
+                     ecs::GlobalPosition *position) {
+                if (parent == nullptr) {
+                    parent = nearestAncestor<ecs::GlobalTransformMatrix>(entity);
+                }
+                global.matrix = parent != nullptr ? parent->matrix * local.matrix : local.matrix;
+                if (position != nullptr) {
+                    position->position = glm::vec3(global.matrix[3]);
+                }
+            });
+
+        // bounds follow the mesh asset as it goes from placeholder to loaded, gets hot reloaded or is evicted, without looking at meshes that didn't change
+        m_World.system<const ecs::MeshRenderer, ecs::MeshBounds, ecs::Bounds>("neuron::system::MeshBounds")
+            .kind(transform)
+            .multi_threaded()
+            .each([](const ecs::MeshRenderer &renderer, ecs::MeshBounds &source, ecs::Bounds &bounds) {
+                if (!renderer.mesh.isValid()) {
+                    return;
+                }
+
+                auto          *meshes  = asset::assetTable<asset::Mesh>();
+                const uint32_t version = meshes->version(renderer.mesh);
+                if (source.mesh == renderer.mesh.id() && source.version == version) {
+                    return;
+                }
+
+                EpochGuard         guard;
+                const asset::Mesh *mesh = meshes->peekAsset(renderer.mesh);
+                if (mesh == nullptr || mesh->object() == nullptr) {
+                    return; // stale, the bounds stay as they were
+                }
+                bounds.local = mesh->object()->bounds();
+                source       = {renderer.mesh.id(), version};
+            });
+
+        m_World.system<ecs::Camera, const ecs::PerspectiveCameraProjection>("neuron::system::PerspectiveProjection")
+            .kind(transform)
+            .each([](ecs::Camera &camera, const ecs::PerspectiveCameraProjection &projection) {
+                camera.projectionMatrix = glm::perspective(projection.yFov, projection.aspectRatio, projection.zNear, projection.zFar);
+            });
+
+        m_World.system<ecs::Camera, const ecs::OrthographicCameraProjection>("neuron::system::OrthographicProjection")
+            .kind(transform)
+            .each([](ecs::Camera &camera, const ecs::OrthographicCameraProjection &projection) {
+                camera.projectionMatrix = glm::ortho(projection.minBounds.x, projection.maxBounds.x, projection.minBounds.y, projection.maxBounds.y, projection.zNear, projection.zFar);
+            });
+
+        m_World.system<ecs::CalculatedVisibility, const ecs::Visibility *, const ecs::CalculatedVisibility *>("neuron::system::Visibility")
+            .kind(phase(Phase::Visibility))
+            .without<ecs::tags::HasCustomVisibility>()
+            .term_at(2)
+            .parent()
+            .cascade()
+            .each([](flecs::entity entity, ecs::CalculatedVisibility &calculated, const ecs::Visibility *visibility, const ecs::CalculatedVisibility *parent) {
+                if (parent == nullptr) {
+                    parent = nearestAncestor<ecs::CalculatedVisibility>(entity);
+                }
+                const bool inherited          = parent == nullptr || parent->visibleForChildren;
+                calculated.visible            = inherited && (visibility == nullptr || visibility->visible);
+                calculated.visibleForChildren = inherited && (visibility == nullptr || visibility->visible || visibility->onlySelf);
+            });
+
+        m_World.system<const ecs::Bounds, const ecs::GlobalTransformMatrix, const ecs::CalculatedVisibility *, ecs::CullState>("neuron::system::Cull")
+            .kind(phase(Phase::Cull))
+            .multi_threaded()
+            .run([this](flecs::iter &it) {
+                // counted locally and published once per thread so the workers don't fight over the counters
+                uint32_t tested = 0, frustumCulled = 0, occlusionCulled = 0;
+
+                while (it.next()) {
+                    const auto bounds = it.field<const ecs::Bounds>(0);
+                    const auto global = it.field<const ecs::GlobalTransformMatrix>(1);
+                    const auto state  = it.field<ecs::CullState>(3);
+
+                    const ecs::CalculatedVisibility *visibility = it.is_set(2) ? &it.field<const ecs::CalculatedVisibility>(2)[0] : nullptr;
+
+                    for (const auto i : it) {
+                        if (visibility != nullptr && !visibility[i].visible) {
+                            state[i].culled = true;
+                            continue;
+                        }
+
+                        if (!m_HasCamera) {
+                            state[i].culled = false;
+                            continue;
+                        }
+
+                        tested++;
+                        switch (m_Culler.classify(bounds[i].local.transformed(global[i].matrix))) {
+                        case render::CullResult::FrustumCulled:
+                            frustumCulled++;
+                            state[i].culled = true;
+                            break;
+                        case render::CullResult::OcclusionCulled:
+                            occlusionCulled++;
+                            state[i].culled = true;
+                            break;
+                        default:
+                            state[i].culled = false;
+                            break;
+                        }
+                    }
+                }
+
+                m_Tested.fetch_add(tested, std::memory_order_relaxed);
+                m_FrustumCulled.fetch_add(frustumCulled, std::memory_order_relaxed);
+                m_OcclusionCulled.fetch_add(occlusionCulled, std::memory_order_relaxed);
+            });
+
+        m_World.system<const ecs::MeshRenderer, const ecs::GlobalTransformMatrix, const ecs::CalculatedVisibility *, const ecs::CullState *>("neuron::system::BuildRenderLists")
+            .kind(phase(Phase::BuildRenderLists))
+            .each([this](const ecs::MeshRenderer &renderer, const ecs::GlobalTransformMatrix &global, const ecs::CalculatedVisibility *visibility, const ecs::CullState *cull) {
+                if ((cull != nullptr && cull->culled) || (visibility != nullptr && !visibility->visible)) {
+                    return;
+                }
+
+                m_Batcher.submit(renderer.mesh, renderer.shader, renderer.material, global.matrix);
+            });
+
+        // mesh renderers get bounds from their mesh unless someone already gave them some, the MeshBounds system fills them in before the first cull
+        m_World.observer<const ecs::MeshRenderer>("neuron::observer::MeshBounds").event(flecs::OnSet).each([](flecs::entity entity, const ecs::MeshRenderer &) {
+            if (!entity.has<ecs::Bounds>()) {
+                entity.add<ecs::MeshBounds>();
+                entity.set<ecs::Bounds>({});
+            }
+        });
+    }
+
+    void Scene::progress(const float deltaTime) {
+        m_World.frame_begin(deltaTime);
+
+        for (std::size_t i = 0; i < kPhaseCount; i++) {
+            const auto start = std::chrono::steady_clock::now();
+
+            beforePhase(static_cast<Phase>(i));
+            m_World.run_pipeline(m_PhasePipelines[i], deltaTime);
+            afterPhase(static_cast<Phase>(i));
+
+            m_PhaseTimings[i] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        m_World.frame_end();
+    }
+
+    void Scene::beforePhase(const Phase phase) {
+        switch (phase) {
+        case Phase::Cull: {
+            m_HasCamera = m_ActiveCamera.is_alive() && m_ActiveCamera.has<ecs::Camera>() && m_ActiveCamera.has<ecs::GlobalTransformMatrix>();
+            if (m_HasCamera) {
+                m_ViewProjection = m_ActiveCamera.get<ecs::Camera>()->projectionMatrix * glm::inverse(m_ActiveCamera.get<ecs::GlobalTransformMatrix>()->matrix);
+                m_Culler.setViewProjection(m_ViewProjection);
+            }
+
+            m_Tested.store(0, std::memory_order_relaxed);
+            m_FrustumCulled.store(0, std::memory_order_relaxed);
+            m_OcclusionCulled.store(0, std::memory_order_relaxed);
+            break;
+        }
+        case Phase::Submit:
+            m_Batcher.flush(m_MaterialBinder);
+            break;
+        default:
+            break;
+        }
+    }
+
+    void Scene::afterPhase(const Phase phase) {
+        if (phase == Phase::Cull) {
+            m_CullingStats = {m_Tested.load(std::memory_order_relaxed), m_FrustumCulled.load(std::memory_order_relaxed), m_OcclusionCulled.load(std::memory_order_relaxed)};
+        }
+    }
+
+    flecs::entity Scene::createEntity(const flecs::entity parent) {
+        return m_World.entity().child_of(parent ? parent : m_SceneRoot);
+    }
+
+    flecs::entity Scene::createEntity(const std::string_view name, const flecs::entity parent) {
+        return m_World.entity(std::string(name).c_str()).child_of(parent ? parent : m_SceneRoot);
+    }
+
+    flecs::entity Scene::phase(const Phase phase) const {
+        return m_Phases[static_cast<std::size_t>(phase)];
+    }
+
+    std::string_view Scene::phaseName(const Phase phase) {
+        switch (phase) {
+        case Phase::Input:
+            return "Input";
+        case Phase::Simulate:
+            return "Simulate";
+        case Phase::Transform:
+            return "Transform";
+        case Phase::Visibility:
+            return "Visibility";
+        case Phase::Cull:
+            return "Cull";
+        case Phase::BuildRenderLists:
+            return "BuildRenderLists";
+        case Phase::Submit:
+            return "Submit";
+        }
+        return "Unknown";
+    }
+} // namespace neuron::scene
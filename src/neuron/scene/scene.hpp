@@ -1,18 +1,108 @@
 #pragma once
 
+#include "neuron/render/culling.hpp"
+#include "neuron/render/instance_batcher.hpp"
+
+#include <array>
+#include <atomic>
 #include <flecs.h>
+#include <string_view>
 
 namespace neuron::scene {
 
+    /**
+     * Owns the ecs world for a scene and runs it as a fixed sequence of phases. Each phase is its own flecs pipeline so it can be timed on its own,
+     * and systems marked multi_threaded() are spread over the flecs worker threads inside their phase (the phase boundaries are sync points).
+     *
+     * User systems go into a phase with `.kind(scene.phase(Scene::Phase::Simulate))`.
+     */
     class Scene {
       public:
-        Scene();
+        enum class Phase {
+            Input,
+            Simulate,
+            Transform,
+            Visibility,
+            Cull,
+            BuildRenderLists,
+            Submit,
+        };
+
+        static constexpr std::size_t kPhaseCount = static_cast<std::size_t>(Phase::Submit) + 1;
+
+        // The calling thread counts as one of the threads. Negative counts use every hardware thread, 0 or 1 runs everything on the calling thread.
+        explicit Scene(int32_t threads = -1);
         virtual ~Scene() = default;
 
+        Scene(const Scene &other)            = delete;
+        Scene &operator=(const Scene &other) = delete;
+
+        // Runs every phase once. Has to be called on the thread that owns the GL context since the submit phase draws.
+        void progress(float deltaTime);
+
+        // New entities are parented to the scene root unless another parent is given
+        flecs::entity createEntity(flecs::entity parent = {});
+        flecs::entity createEntity(std::string_view name, flecs::entity parent = {});
+
+        [[nodiscard]] flecs::entity phase(Phase phase) const;
+
+        [[nodiscard]] static std::string_view phaseName(Phase phase);
+
+        // in milliseconds, from the last call to progress()
+        [[nodiscard]] inline const std::array<double, kPhaseCount> &phaseTimings() const { return m_PhaseTimings; }
+
+        [[nodiscard]] inline double phaseTiming(Phase phase) const { return m_PhaseTimings[static_cast<std::size_t>(phase)]; }
+
+        // The camera entity needs a `Camera` and a `GlobalTransformMatrix`
+        inline void setActiveCamera(const flecs::entity camera) { m_ActiveCamera = camera; }
+
+        [[nodiscard]] inline flecs::entity activeCamera() const { return m_ActiveCamera; }
+
+        inline void setOcclusionBuffer(const render::OcclusionBuffer *buffer) { m_Culler.setOcclusionBuffer(buffer); }
+
+        inline void setMaterialBinder(render::InstanceBatcher::MaterialBinder binder) { m_MaterialBinder = std::move(binder); }
+
+        [[nodiscard]] inline const render::CullingStats &cullingStats() const { return m_CullingStats; }
+
+        [[nodiscard]] inline const render::InstancingStats &instancingStats() const { return m_Batcher.stats(); }
+
+        // view projection of the active camera, as of the last cull phase
+        [[nodiscard]] inline const glm::mat4 &viewProjection() const { return m_ViewProjection; }
+
+        [[nodiscard]] inline flecs::world &world() { return m_World; }
+
+        [[nodiscard]] inline const flecs::world &world() const { return m_World; }
+
+        [[nodiscard]] inline flecs::entity root() const { return m_SceneRoot; }
+
       private:
+        void registerComponents();
+        void createPhases();
+        void registerSystems();
+
+        // built-in work that happens around the systems of a phase, and gets timed with it
+        void beforePhase(Phase phase);
+        void afterPhase(Phase phase);
+
         flecs::world m_World;
 
         flecs::entity m_SceneRoot;
+        flecs::entity m_ActiveCamera;
+
+        std::array<flecs::entity, kPhaseCount> m_Phases;
+        std::array<flecs::entity, kPhaseCount> m_PhasePipelines;
+        std::array<double, kPhaseCount>        m_PhaseTimings{};
+
+        render::FrustumCuller                   m_Culler;
+        render::InstanceBatcher                 m_Batcher;
+        render::InstanceBatcher::MaterialBinder m_MaterialBinder;
+        glm::mat4                               m_ViewProjection{1.0f};
+        bool                                    m_HasCamera = false;
+
+        std::atomic<uint32_t> m_Tested{0};
+        std::atomic<uint32_t> m_FrustumCulled{0};
+        std::atomic<uint32_t> m_OcclusionCulled{0};
+        render::CullingStats  m_CullingStats;
     };
 
 } // namespace neuron::scene
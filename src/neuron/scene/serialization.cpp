@@ -0,0 +1,565 @@
+#include "serialization.hpp"
+
+#include "neuron/ecs/components.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+
+/*
+ * Layout (all integers little endian, as written by the host):
+ *
+ *   char[4]  magic "NSCN"
+ *   u32      version
+ *   u64      entity count
+ *   u32      component type count
+ *   u32      block count
+ *
+ *   per component type:  u32 name length, name, u32 size of one element in the file (0 for tags and components which are recalculated every frame)
+ *
+ *   per block:           u32 component count, u32[component count] component type indices,
+ *                        u64 parent entity index (~0 for the scene root), u64 first entity index, u64 entity count,
+ *                        then for every component with a non-zero size its column (entity count * size bytes), each column starting 16 byte aligned
+ *
+ * Entity indices are assigned in block order, and blocks are ordered so that a parent always comes before its children.
+ */
+
+namespace neuron::scene {
+    namespace {
+        constexpr char        kMagic[4]        = {'N', 'S', 'C', 'N'};
+        constexpr uint64_t    kNoEntity        = ~0ULL;
+        constexpr std::size_t kColumnAlignment = 16;
+
+        // the smallest a component type (empty name) and a block (no components) can be in the file
+        constexpr std::size_t kMinFormatBytes = 2 * sizeof(uint32_t);
+        constexpr std::size_t kMinBlockBytes  = sizeof(uint32_t) + 3 * sizeof(uint64_t);
+    } // namespace
+
+    namespace detail {
+        struct SaveContext {
+            const std::unordered_map<ecs_entity_t, uint64_t> &entityIndices;
+        };
+
+        struct LoadContext {
+            uint64_t                                    firstEntity;
+            std::vector<std::pair<uint64_t, uint64_t>> &cameraLayerReferences; // (entity index, camera layer entity index)
+        };
+
+        struct ComponentFormat {
+            std::string name;
+            ecs_entity_t (*component)(const flecs::world &world);
+            uint32_t    fileSize;
+            std::size_t runtimeSize;
+
+            // converts a column to its file representation. Only called when fileSize is non-zero
+            void (*encode)(const void *column, std::byte *out, std::size_t count, const SaveContext &context);
+
+            // the reverse of encode, null if the file data can be used directly
+            void (*decode)(const std::byte *in, void *column, std::size_t count, LoadContext &context);
+
+            // collects the meshes referenced from a column in file representation, null for components which don't reference any
+            void (*meshes)(const std::byte *in, std::size_t count, std::vector<asset::stable_id_t> &out) = nullptr;
+        };
+    } // namespace detail
+
+    using detail::ComponentFormat;
+    using detail::LoadContext;
+    using detail::SaveContext;
+
+    namespace {
+        template <typename T>
+        ecs_entity_t componentId(const flecs::world &world) {
+            return world.component<T>().id();
+        }
+
+        template <typename T>
+        void encodePod(const void *column, std::byte *out, const std::size_t count, const SaveContext &) {
+            std::memcpy(out, column, count * sizeof(T));
+        }
+
+        template <typename T, typename R>
+        void encodeRecords(const void *column, std::byte *out, const std::size_t count, const SaveContext &context, R (*convert)(const T &, const SaveContext &)) {
+            const auto *values = static_cast<const T *>(column);
+            for (std::size_t i = 0; i < count; i++) {
+                const R record = convert(values[i], context);
+                std::memcpy(out + i * sizeof(R), &record, sizeof(R));
+            }
+        }
+
+        template <typename T, typename R>
+        void decodeRecords(const std::byte *in, void *column, const std::size_t count, LoadContext &context, T (*convert)(const R &, uint64_t, LoadContext &)) {
+            for (std::size_t i = 0; i < count; i++) {
+                R record;
+                std::memcpy(&record, in + i * sizeof(R), sizeof(R));
+                const T value = convert(record, context.firstEntity + i, context);
+                std::memcpy(static_cast<std::byte *>(column) + i * sizeof(T), &value, sizeof(T));
+            }
+        }
+
+        template <std::derived_from<asset::Asset> T>
+        asset::stable_id_t assetId(const asset::AssetHandle<T> &handle) {
+            return handle.isValid() ? asset::assetTable<T>()->stableId(handle) : 0;
+        }
+
+        template <std::derived_from<asset::Asset> T>
+        asset::AssetHandle<T> findAsset(const asset::stable_id_t stableId) {
+            if (stableId == 0) {
+                return {};
+            }
+
+            const auto handle = asset::assetTable<T>()->findByStableId(stableId);
+            if (!handle.isValid()) {
+                throw std::runtime_error("Scene refers to an asset which isn't loaded (stable id " + std::to_string(stableId) + ")");
+            }
+            return handle;
+        }
+
+        struct MeshRendererRecord {
+            asset::stable_id_t mesh;
+            asset::stable_id_t shader;
+            uint32_t           material;
+            uint32_t           padding;
+        };
+
+        struct CameraLayerRecord {
+            asset::stable_id_t renderTarget;
+            asset::stable_id_t postProcessingPipeline;
+        };
+
+        struct RenderOnCameraLayerRecord {
+            uint64_t cameraLayer;
+        };
+
+        template <typename T>
+        ComponentFormat pod(std::string name, const bool persistent = true) {
+            return {std::move(name), &componentId<T>, persistent ? static_cast<uint32_t>(sizeof(T)) : 0, sizeof(T), &encodePod<T>, nullptr};
+        }
+
+        template <typename T>
+        ComponentFormat tag(std::string name) {
+            return {std::move(name), &componentId<T>, 0, 0, nullptr, nullptr};
+        }
+
+        // the names are what ends up in the file, so they must never change for an existing component
+        std::vector<ComponentFormat> createComponentFormats() {
+            std::vector<ComponentFormat> formats{
+                pod<ecs::Position>("Position"),
+                pod<ecs::Rotation>("Rotation"),
+                pod<ecs::Scale>("Scale"),
+                pod<ecs::Visibility>("Visibility"),
+                pod<ecs::Bounds>("Bounds"),
+                pod<ecs::Camera>("Camera"),
+                pod<ecs::OrthographicCameraProjection>("OrthographicCameraProjection"),
+                pod<ecs::PerspectiveCameraProjection>("PerspectiveCameraProjection"),
+
+                // recalculated every frame, only the fact that they're there gets saved
+                pod<ecs::CalculatedTransformMatrix>("CalculatedTransformMatrix", false),
+                pod<ecs::GlobalTransformMatrix>("GlobalTransformMatrix", false),
+                pod<ecs::GlobalPosition>("GlobalPosition", false),
+                pod<ecs::CalculatedVisibility>("CalculatedVisibility", false),
+                pod<ecs::CullState>("CullState", false),
+                pod<ecs::MeshBounds>("MeshBounds", false),
+
+                tag<ecs::tags::HasCustomVisibility>("HasCustomVisibility"),
+                tag<ecs::tags::HasCustomTransformMatrix>("HasCustomTransformMatrix"),
+            };
+
+            formats.push_back({
+                "MeshRenderer",
+                &componentId<ecs::MeshRenderer>,
+                sizeof(MeshRendererRecord),
+                sizeof(ecs::MeshRenderer),
+                [](const void *column, std::byte *out, const std::size_t count, const SaveContext &context) {
+                    encodeRecords<ecs::MeshRenderer, MeshRendererRecord>(column, out, count, context, [](const ecs::MeshRenderer &renderer, const SaveContext &) {
+                        return MeshRendererRecord{assetId(renderer.mesh), assetId(renderer.shader), renderer.material, 0};
+                    });
+                },
+                [](const std::byte *in, void *column, const std::size_t count, LoadContext &context) {
+                    decodeRecords<ecs::MeshRenderer, MeshRendererRecord>(in, column, count, context, [](const MeshRendererRecord &record, uint64_t, LoadContext &) {
+                        return ecs::MeshRenderer{findAsset<asset::Mesh>(record.mesh), findAsset<asset::Shader>(record.shader), record.material};
+                    });
+                },
+                [](const std::byte *in, const std::size_t count, std::vector<asset::stable_id_t> &out) {
+                    for (std::size_t i = 0; i < count; i++) {
+                        MeshRendererRecord record;
+                        std::memcpy(&record, in + i * sizeof(MeshRendererRecord), sizeof(MeshRendererRecord));
+                        if (record.mesh != 0) {
+                            out.push_back(record.mesh);
+                        }
+                    }
+                },
+            });
+
+            formats.push_back({
+                "CameraLayer",
+                &componentId<ecs::CameraLayer>,
+                sizeof(CameraLayerRecord),
+                sizeof(ecs::CameraLayer),
+                [](const void *column, std::byte *out, const std::size_t count, const SaveContext &context) {
+                    encodeRecords<ecs::CameraLayer, CameraLayerRecord>(column, out, count, context, [](const ecs::CameraLayer &layer, const SaveContext &) {
+                        return CameraLayerRecord{assetId(layer.renderTarget), assetId(layer.postProcessingPipeline)};
+                    });
+                },
+                [](const std::byte *in, void *column, const std::size_t count, LoadContext &context) {
+                    decodeRecords<ecs::CameraLayer, CameraLayerRecord>(in, column, count, context, [](const CameraLayerRecord &record, uint64_t, LoadContext &) {
+                        return ecs::CameraLayer{findAsset<asset::RenderTarget>(record.renderTarget), findAsset<asset::PostProcessingPipeline>(record.postProcessingPipeline)};
+                    });
+                },
+            });
+
+            // the camera layer can be anywhere in the file, so the reference gets patched once everything has been created
+            formats.push_back({
+                "RenderOnCameraLayer",
+                &componentId<ecs::RenderOnCameraLayer>,
+                sizeof(RenderOnCameraLayerRecord),
+                sizeof(ecs::RenderOnCameraLayer),
+                [](const void *column, std::byte *out, const std::size_t count, const SaveContext &context) {
+                    encodeRecords<ecs::RenderOnCameraLayer, RenderOnCameraLayerRecord>(column, out, count, context, [](const ecs::RenderOnCameraLayer &render, const SaveContext &ctx) {
+                        const auto it = ctx.entityIndices.find(render.cameraLayer.id());
+                        return RenderOnCameraLayerRecord{it == ctx.entityIndices.end() ? kNoEntity : it->second};
+                    });
+                },
+                [](const std::byte *in, void *column, const std::size_t count, LoadContext &context) {
+                    decodeRecords<ecs::RenderOnCameraLayer, RenderOnCameraLayerRecord>(in, column, count, context, [](const RenderOnCameraLayerRecord &record, const uint64_t entity, LoadContext &ctx) {
+                        if (record.cameraLayer != kNoEntity) {
+                            ctx.cameraLayerReferences.emplace_back(entity, record.cameraLayer);
+                        }
+                        return ecs::RenderOnCameraLayer{};
+                    });
+                },
+            });
+
+            return formats;
+        }
+
+        const std::vector<ComponentFormat> &componentFormats() {
+            static const std::vector<ComponentFormat> formats = createComponentFormats();
+            return formats;
+        }
+
+        class Writer {
+          public:
+            explicit Writer(const std::filesystem::path &path) : m_File(path, std::ios::binary) {
+                if (!m_File.is_open()) {
+                    throw std::runtime_error("Could not open file " + path.string());
+                }
+            }
+
+            template <typename T>
+            void write(const T &value) {
+                bytes(&value, sizeof(T));
+            }
+
+            void bytes(const void *data, const std::size_t size) {
+                m_File.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+                m_Offset += size;
+            }
+
+            void align(const std::size_t alignment) {
+                static constexpr char zeros[kColumnAlignment] = {};
+                if (const std::size_t rem = m_Offset % alignment; rem != 0) {
+                    bytes(zeros, alignment - rem);
+                }
+            }
+
+          private:
+            std::ofstream m_File;
+            std::size_t   m_Offset = 0;
+        };
+
+        class Reader {
+          public:
+            explicit Reader(const std::span<const std::byte> data) : m_Data(data) {}
+
+            template <typename T>
+            T read() {
+                T value;
+                std::memcpy(&value, take(sizeof(T)), sizeof(T));
+                return value;
+            }
+
+            const std::byte *take(const std::size_t size) {
+                if (size > m_Data.size() - m_Offset) {
+                    throw std::runtime_error("Malformed scene file: unexpected end of file");
+                }
+                const std::byte *data = m_Data.data() + m_Offset;
+                m_Offset += size;
+                return data;
+            }
+
+            [[nodiscard]] std::size_t remaining() const { return m_Data.size() - m_Offset; }
+
+            void align(const std::size_t alignment) {
+                if (const std::size_t rem = m_Offset % alignment; rem != 0) {
+                    take(alignment - rem);
+                }
+            }
+
+          private:
+            std::span<const std::byte> m_Data;
+            std::size_t                m_Offset = 0;
+        };
+
+        struct Block {
+            ecs_table_t          *table;
+            uint64_t              parent;
+            uint64_t              firstEntity;
+            std::vector<uint32_t> components;
+        };
+    } // namespace
+
+    void saveScene(const Scene &scene, const std::filesystem::path &path) {
+        const flecs::world &world  = scene.world();
+        ecs_world_t        *cworld = world.c_ptr();
+
+        const auto                            &formats = componentFormats();
+        std::unordered_map<ecs_id_t, uint32_t> formatIndices;
+        for (uint32_t i = 0; i < formats.size(); i++) {
+            formatIndices[formats[i].component(world)] = i;
+        }
+
+        // breadth first, so every table shows up before the tables of its children
+        std::vector<ecs_table_t *>        tables;
+        std::unordered_set<ecs_table_t *> seenTables;
+        std::vector<flecs::entity>        frontier{scene.root()};
+        std::vector<flecs::entity>        next;
+        while (!frontier.empty()) {
+            next.clear();
+            for (const auto &parent : frontier) {
+                parent.children([&](const flecs::entity child) {
+                    if (ecs_table_t *table = ecs_get_table(cworld, child); seenTables.insert(table).second) {
+                        tables.push_back(table);
+                    }
+                    next.push_back(child);
+                });
+            }
+            std::swap(frontier, next);
+        }
+
+        std::unordered_map<ecs_entity_t, uint64_t> entityIndices;
+        std::vector<Block>                         blocks;
+        uint64_t                                   entityCount = 0;
+        for (ecs_table_t *table : tables) {
+            Block block{table, kNoEntity, entityCount, {}};
+
+            const ecs_type_t *type = ecs_table_get_type(table);
+            for (int32_t i = 0; i < type->count; i++) {
+                const ecs_id_t id = type->array[i];
+                if (ECS_IS_PAIR(id) && ECS_PAIR_FIRST(id) == EcsChildOf) {
+                    const ecs_entity_t parent = ecs_pair_second(cworld, id);
+                    block.parent              = parent == scene.root().id() ? kNoEntity : entityIndices.at(parent);
+                } else if (const auto it = formatIndices.find(id); it != formatIndices.end()) {
+                    block.components.push_back(it->second);
+                }
+            }
+
+            const ecs_entity_t *entities = ecs_table_entities(table);
+            for (int32_t i = 0; i < ecs_table_count(table); i++) {
+                entityIndices[entities[i]] = entityCount++;
+            }
+
+            blocks.push_back(std::move(block));
+        }
+
+        Writer writer(path);
+        writer.bytes(kMagic, sizeof(kMagic));
+        writer.write<uint32_t>(kSceneFormatVersion);
+        writer.write<uint64_t>(entityCount);
+        writer.write<uint32_t>(static_cast<uint32_t>(formats.size()));
+        writer.write<uint32_t>(static_cast<uint32_t>(blocks.size()));
+
+        for (const auto &format : formats) {
+            writer.write<uint32_t>(static_cast<uint32_t>(format.name.size()));
+            writer.bytes(format.name.data(), format.name.size());
+            writer.write<uint32_t>(format.fileSize);
+        }
+
+        const SaveContext      context{entityIndices};
+        std::vector<std::byte> scratch;
+        for (const auto &block : blocks) {
+            const auto count = static_cast<std::size_t>(ecs_table_count(block.table));
+
+            writer.write<uint32_t>(static_cast<uint32_t>(block.components.size()));
+            for (const uint32_t component : block.components) {
+                writer.write<uint32_t>(component);
+            }
+            writer.write<uint64_t>(block.parent);
+            writer.write<uint64_t>(block.firstEntity);
+            writer.write<uint64_t>(count);
+
+            for (const uint32_t component : block.components) {
+                const ComponentFormat &format = formats[component];
+                if (format.fileSize == 0) {
+                    continue;
+                }
+
+                scratch.resize(count * format.fileSize);
+                format.encode(ecs_table_get_id(cworld, block.table, format.component(world), 0), scratch.data(), count, context);
+
+                writer.align(kColumnAlignment);
+                writer.bytes(scratch.data(), scratch.size());
+            }
+        }
+    }
+
+    SceneData SceneData::decode(const std::filesystem::path &path) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file " + path.string());
+        }
+
+        SceneData scene;
+
+        // one read for the whole file, columns are later handed to flecs straight from this buffer
+        scene.m_Buffer.resize(static_cast<std::size_t>(file.tellg()));
+        file.seekg(0, std::ios::beg).read(reinterpret_cast<char *>(scene.m_Buffer.data()), static_cast<std::streamsize>(scene.m_Buffer.size()));
+        file.close();
+
+        Reader reader(scene.m_Buffer);
+        if (std::memcmp(reader.take(sizeof(kMagic)), kMagic, sizeof(kMagic)) != 0) {
+            throw std::runtime_error("Malformed scene file: bad magic");
+        }
+        if (const auto version = reader.read<uint32_t>(); version != kSceneFormatVersion) {
+            throw std::runtime_error("Unsupported scene file version " + std::to_string(version));
+        }
+
+        scene.m_EntityCount    = reader.read<uint64_t>();
+        const auto formatCount = reader.read<uint32_t>();
+        const auto blockCount  = reader.read<uint32_t>();
+
+        // nothing gets sized by the header before the file is known to be big enough for it. Blocks hold at most INT32_MAX entities each
+        if (formatCount > reader.remaining() / kMinFormatBytes || blockCount > reader.remaining() / kMinBlockBytes ||
+            scene.m_EntityCount > static_cast<uint64_t>(blockCount) * INT32_MAX) {
+            throw std::runtime_error("Malformed scene file: counts don't fit the file size");
+        }
+
+        // file component index -> format (or null if this build doesn't know that component) and its size in the file
+        const auto                          &formats = componentFormats();
+        std::vector<const ComponentFormat *> fileFormats(formatCount, nullptr);
+        std::vector<uint32_t>                fileSizes(formatCount);
+        for (uint32_t i = 0; i < formatCount; i++) {
+            const auto        length = reader.read<uint32_t>();
+            const std::string name(reinterpret_cast<const char *>(reader.take(length)), length);
+            fileSizes[i] = reader.read<uint32_t>();
+
+            for (const auto &format : formats) {
+                if (format.name == name) {
+                    if (format.fileSize != fileSizes[i]) {
+                        throw std::runtime_error("Malformed scene file: size of component " + name + " doesn't match");
+                    }
+                    fileFormats[i] = &format;
+                }
+            }
+        }
+
+        uint64_t nextEntity = 0;
+        scene.m_Blocks.reserve(blockCount);
+        for (uint32_t b = 0; b < blockCount; b++) {
+            const auto            componentCount = reader.read<uint32_t>();
+            std::vector<uint32_t> components(componentCount);
+            for (auto &component : components) {
+                component = reader.read<uint32_t>();
+                if (component >= formatCount) {
+                    throw std::runtime_error("Malformed scene file: component index out of range");
+                }
+            }
+
+            BlockData block;
+            block.parent      = reader.read<uint64_t>();
+            block.firstEntity = reader.read<uint64_t>();
+            block.count       = reader.read<uint64_t>();
+
+            // blocks have to be contiguous and in order, which also guarantees that parents exist before their children
+            if (block.firstEntity != nextEntity || block.count > scene.m_EntityCount - block.firstEntity || block.count > static_cast<uint64_t>(INT32_MAX) ||
+                (block.parent != kNoEntity && block.parent >= block.firstEntity)) {
+                throw std::runtime_error("Malformed scene file: bad block header");
+            }
+            nextEntity += block.count;
+
+            for (const uint32_t component : components) {
+                const std::byte *column = nullptr;
+                if (fileSizes[component] != 0) {
+                    reader.align(kColumnAlignment);
+                    column = reader.take(block.count * fileSizes[component]);
+                }
+
+                const ComponentFormat *format = fileFormats[component];
+                if (format == nullptr) {
+                    continue; // skip the data of components we don't know about
+                }
+
+                if (block.columns.size() >= FLECS_ID_DESC_MAX - 2) {
+                    throw std::runtime_error("Malformed scene file: too many components on one entity");
+                }
+
+                if (column != nullptr && format->meshes != nullptr) {
+                    format->meshes(column, block.count, scene.m_MeshDependencies);
+                }
+                block.columns.emplace_back(format, column);
+            }
+
+            scene.m_Blocks.push_back(std::move(block));
+        }
+
+        if (nextEntity != scene.m_EntityCount) {
+            throw std::runtime_error("Malformed scene file: entity count doesn't match the blocks");
+        }
+
+        std::ranges::sort(scene.m_MeshDependencies);
+        const auto duplicates = std::ranges::unique(scene.m_MeshDependencies);
+        scene.m_MeshDependencies.erase(duplicates.begin(), duplicates.end());
+
+        return scene;
+    }
+
+    void SceneData::instantiate(Scene &scene, const flecs::entity parent) const {
+        flecs::world &world = scene.world();
+
+        // grown block by block, so it never gets ahead of the entities the file actually has
+        std::vector<ecs_entity_t>                  entities;
+        std::vector<std::pair<uint64_t, uint64_t>> cameraLayerReferences;
+        std::vector<std::vector<std::byte>>        scratch;
+
+        for (const auto &block : m_Blocks) {
+            ecs_bulk_desc_t desc{};
+            void           *columns[FLECS_ID_DESC_MAX] = {};
+            int32_t         idCount                    = 0;
+
+            desc.ids[idCount++] = ecs_pair(EcsChildOf, block.parent == kNoEntity ? parent.id() : entities[block.parent]);
+
+            LoadContext context{block.firstEntity, cameraLayerReferences};
+            scratch.clear();
+            for (const auto &[format, column] : block.columns) {
+                desc.ids[idCount] = format->component(world);
+                if (column != nullptr && format->decode != nullptr) {
+                    auto &converted = scratch.emplace_back(block.count * format->runtimeSize);
+                    format->decode(column, converted.data(), block.count, context);
+                    columns[idCount] = converted.data();
+                } else {
+                    columns[idCount] = const_cast<std::byte *>(column); // null for tags and components that don't persist their data
+                }
+                idCount++;
+            }
+
+            desc.count = static_cast<int32_t>(block.count);
+            desc.data  = columns;
+
+            const ecs_entity_t *created = ecs_bulk_init(world.c_ptr(), &desc);
+            entities.insert(entities.end(), created, created + block.count);
+        }
+
+        for (const auto &[entity, cameraLayer] : cameraLayerReferences) {
+            if (cameraLayer >= m_EntityCount) {
+                throw std::runtime_error("Malformed scene file: camera layer index out of range");
+            }
+            flecs::entity(world, entities[entity]).set<ecs::RenderOnCameraLayer>({flecs::entity(world, entities[cameraLayer])});
+        }
+    }
+
+    void loadScene(Scene &scene, const std::filesystem::path &path) {
+        SceneData::decode(path).instantiate(scene, scene.root());
+    }
+} // namespace neuron::scene
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "neuron/asset/asset.hpp"
+#include "neuron/scene/scene.hpp"
+
+#include <filesystem>
+#include <utility>
+#include <vector>
+
+namespace neuron::scene {
+
+    static constexpr uint32_t kSceneFormatVersion = 1;
+
+    namespace detail {
+        struct ComponentFormat;
+    }
+
+    /**
+     * Writes every entity below the scene root to a binary file. Entities are grouped by archetype (and parent, since flecs keeps those in separate tables),
+     * and every group stores its component columns as contiguous blocks so loading can hand them to flecs in bulk.
+     * Assets are written as their stable ids (see AssetTable::setStableId), entity names are not saved.
+     */
+    void saveScene(const Scene &scene, const std::filesystem::path &path);
+
+    /**
+     * A scene file which has been read and validated but not turned into entities yet. Decoding doesn't touch the ecs world, the asset tables or GL,
+     * so it can run on a worker thread, and instantiating is then mostly a handful of bulk creates.
+     */
+    class SceneData {
+      public:
+        SceneData() = default;
+
+        // the blocks point into the file buffer, which survives moves but not copies
+        SceneData(const SceneData &other)                = delete;
+        SceneData(SceneData &&other) noexcept            = default;
+        SceneData &operator=(const SceneData &other)     = delete;
+        SceneData &operator=(SceneData &&other) noexcept = default;
+
+        static SceneData decode(const std::filesystem::path &path);
+
+        // Creates the entities as children of `parent`. Every asset referenced from the file must be registered with the stable id it was saved with by now.
+        void instantiate(Scene &scene, flecs::entity parent) const;
+
+        [[nodiscard]] inline uint64_t entityCount() const { return m_EntityCount; }
+
+        // stable ids of every mesh used by a MeshRenderer, sorted and without duplicates
+        [[nodiscard]] inline const std::vector<asset::stable_id_t> &meshDependencies() const { return m_MeshDependencies; }
+
+        [[nodiscard]] inline std::size_t sizeInBytes() const { return m_Buffer.size(); }
+
+      private:
+        struct BlockData {
+            uint64_t parent      = 0;
+            uint64_t firstEntity = 0;
+            uint64_t count       = 0;
+
+            // null columns are tags and components which don't persist their data
+            std::vector<std::pair<const detail::ComponentFormat *, const std::byte *>> columns;
+        };
+
+        std::vector<std::byte>          m_Buffer;
+        std::vector<BlockData>          m_Blocks;
+        uint64_t                        m_EntityCount = 0;
+        std::vector<asset::stable_id_t> m_MeshDependencies;
+    };
+
+    // Loads a saved scene below the root of `scene`, see SceneData::instantiate for the requirements on assets
+    void loadScene(Scene &scene, const std::filesystem::path &path);
+
+} // namespace neuron::scene
@@ -0,0 +1,327 @@
+#include "world_partition.hpp"
+
+#include "neuron/ecs/components.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <ranges>
+#include <string>
+
+namespace neuron::scene {
+    WorldPartition::WorldPartition(Scene &scene, ThreadPool &pool, Settings settings) : m_Scene(scene), m_Pool(pool), m_Settings(std::move(settings)) {
+        if (m_Settings.cellSize <= 0.0f || m_Settings.unloadRadius < m_Settings.loadRadius) {
+            throw std::runtime_error("Invalid world partition settings: the cell size must be positive and the unload radius can't be smaller than the load radius");
+        }
+
+        // the set of cells is fixed, so one directory scan up front saves touching the filesystem for every empty cell in range
+        for (const auto &entry : std::filesystem::directory_iterator(m_Settings.directory)) {
+            if (!entry.is_regular_file() || entry.path().extension() != ".nscn") {
+                continue;
+            }
+
+            CellCoord coord{};
+            if (std::sscanf(entry.path().filename().string().c_str(), "cell_%d_%d.nscn", &coord.x, &coord.z) == 2) {
+                m_AvailableCells.insert(coord);
+            }
+        }
+    }
+
+    WorldPartition::~WorldPartition() {
+        unloadAll();
+    }
+
+    std::filesystem::path WorldPartition::cellFileName(const CellCoord coord) {
+        return "cell_" + std::to_string(coord.x) + "_" + std::to_string(coord.z) + ".nscn";
+    }
+
+    CellCoord WorldPartition::cellAt(const glm::vec3 &position) const {
+        return {static_cast<int32_t>(std::floor(position.x / m_Settings.cellSize)), static_cast<int32_t>(std::floor(position.z / m_Settings.cellSize))};
+    }
+
+    float WorldPartition::distanceTo(const CellCoord coord, const glm::vec3 &focus) const {
+        const glm::vec2 min     = glm::vec2(coord.x, coord.z) * m_Settings.cellSize;
+        const glm::vec2 max     = min + m_Settings.cellSize;
+        const glm::vec2 point   = glm::vec2(focus.x, focus.z);
+        const glm::vec2 nearest = glm::clamp(point, min, max);
+        return glm::length(point - nearest);
+    }
+
+    void WorldPartition::update() {
+        const flecs::entity camera = m_Scene.activeCamera();
+        if (!camera.is_valid() || !camera.has<ecs::GlobalPosition>()) {
+            return;
+        }
+
+        update(camera.get<ecs::GlobalPosition>()->position);
+    }
+
+    void WorldPartition::update(const glm::vec3 &focus) {
+        const auto start = std::chrono::steady_clock::now();
+
+        // unload what went out of range. Cells still on a worker can't be stopped, they get thrown away once they're done
+        for (auto it = m_Cells.begin(); it != m_Cells.end();) {
+            Cell &cell = it->second;
+            if (distanceTo(cell.coord, focus) <= m_Settings.unloadRadius) {
+                cell.cancelled = false; // came back into range while loading
+                ++it;
+                continue;
+            }
+
+            if (cell.state == CellState::Loading) {
+                cell.cancelled = true;
+                ++it;
+                continue;
+            }
+
+            releaseCell(cell);
+            it = m_Cells.erase(it);
+        }
+
+        pollLoads();
+
+        // queue what came into range, nearest first
+        const CellCoord                               center = cellAt(focus);
+        const auto                                    reach  = static_cast<int32_t>(std::ceil(m_Settings.loadRadius / m_Settings.cellSize));
+        std::vector<std::pair<float, CellCoord>> wanted;
+        for (int32_t z = center.z - reach; z <= center.z + reach; z++) {
+            for (int32_t x = center.x - reach; x <= center.x + reach; x++) {
+                const CellCoord coord{x, z};
+                if (!m_AvailableCells.contains(coord) || m_FailedCells.contains(coord) || m_Cells.contains(coord)) {
+                    continue;
+                }
+
+                if (const float distance = distanceTo(coord, focus); distance <= m_Settings.loadRadius) {
+                    wanted.emplace_back(distance, coord);
+                }
+            }
+        }
+        std::ranges::sort(wanted, {}, &std::pair<float, CellCoord>::first);
+
+        const auto inFlight = static_cast<uint32_t>(std::ranges::count_if(m_Cells, [](const auto &entry) { return entry.second.state == CellState::Loading; }));
+        const auto slots    = std::min<std::size_t>(m_Settings.maxInFlightLoads > inFlight ? m_Settings.maxInFlightLoads - inFlight : 0, wanted.size());
+        for (std::size_t i = 0; i < slots; i++) {
+            startLoad(wanted[i].second);
+        }
+        m_Stats.queuedCells = static_cast<uint32_t>(wanted.size() - slots);
+
+        // GL thread work, nearest cell first. At least one step always runs so a tiny budget still makes progress
+        std::vector<std::pair<float, Cell *>> uploads;
+        for (auto &cell : m_Cells | std::views::values) {
+            if (cell.state == CellState::Uploading) {
+                uploads.emplace_back(distanceTo(cell.coord, focus), &cell);
+            }
+        }
+        std::ranges::sort(uploads, {}, &std::pair<float, Cell *>::first);
+
+        const auto budget     = std::chrono::duration<double, std::milli>(m_Settings.uploadBudgetMs);
+        bool       progressed = false;
+        for (Cell *cell : uploads | std::views::values) {
+            try {
+                bool resident = false;
+                while (!resident && (!progressed || std::chrono::steady_clock::now() - start < budget)) {
+                    resident   = uploadStep(*cell);
+                    progressed = true;
+                }
+            } catch (const std::exception &e) {
+                std::cerr << "Failed to load world cell " << cell->coord.x << ", " << cell->coord.z << ": " << e.what() << std::endl;
+                m_FailedCells.insert(cell->coord);
+                m_Stats.failedLoads++;
+                releaseCell(*cell);
+                m_Cells.erase(cell->coord); // only invalidates this pointer
+            }
+
+            if (std::chrono::steady_clock::now() - start >= budget) {
+                break;
+            }
+        }
+
+        updateStats();
+
+        m_Stats.updateMs     = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        m_Stats.peakUpdateMs = std::max(m_Stats.peakUpdateMs, m_Stats.updateMs);
+    }
+
+    void WorldPartition::unloadAll() {
+        for (auto it = m_Cells.begin(); it != m_Cells.end();) {
+            if (it->second.state == CellState::Loading) {
+                it->second.cancelled = true;
+                ++it;
+                continue;
+            }
+
+            releaseCell(it->second);
+            it = m_Cells.erase(it);
+        }
+
+        updateStats();
+    }
+
+    void WorldPartition::startLoad(const CellCoord coord) {
+        Cell &cell = m_Cells[coord];
+        cell.coord = coord;
+        cell.state = CellState::Loading;
+
+        cell.pending = m_Pool.submit([path = m_Settings.directory / cellFileName(coord), resolver = m_Settings.meshResolver] {
+            LoadResult result{SceneData::decode(path), {}};
+
+            // the table lookup is only a hint, uploadStep checks again since another cell may get there first
+            const auto meshes = asset::assetTable<asset::Mesh>();
+            for (const asset::stable_id_t id : result.scene.meshDependencies()) {
+                if (meshes->findByStableId(id).isValid()) {
+                    continue;
+                }
+
+                const auto meshPath = resolver ? resolver(id) : std::nullopt;
+                if (!meshPath) {
+                    throw std::runtime_error("Could not find the file for mesh " + std::to_string(id) + " used by " + path.string());
+                }
+
+                result.meshes.emplace_back(id, asset::Mesh::loadData(*meshPath));
+            }
+
+            return result;
+        });
+    }
+
+    void WorldPartition::pollLoads() {
+        for (auto it = m_Cells.begin(); it != m_Cells.end();) {
+            Cell &cell = it->second;
+            if (cell.state != CellState::Loading || cell.pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                ++it;
+                continue;
+            }
+
+            try {
+                cell.result = cell.pending.get();
+            } catch (const std::exception &e) {
+                std::cerr << "Failed to load world cell " << cell.coord.x << ", " << cell.coord.z << ": " << e.what() << std::endl;
+                m_FailedCells.insert(cell.coord);
+                m_Stats.failedLoads++;
+                it = m_Cells.erase(it);
+                continue;
+            }
+
+            if (cell.cancelled) {
+                it = m_Cells.erase(it);
+                continue;
+            }
+
+            cell.state = CellState::Uploading;
+            ++it;
+        }
+    }
+
+    bool WorldPartition::uploadStep(Cell &cell) {
+        const auto &dependencies = cell.result.scene.meshDependencies();
+        if (cell.nextMesh < dependencies.size()) {
+            const asset::stable_id_t id = dependencies[cell.nextMesh++];
+
+            const auto data = std::ranges::find(cell.result.meshes, id, &std::pair<asset::stable_id_t, Mesh::Data>::first);
+            retainMesh(cell, id, data == cell.result.meshes.end() ? nullptr : &data->second);
+            return false;
+        }
+
+        cell.root = m_Scene.createEntity(cellFileName(cell.coord).stem().string());
+        cell.result.scene.instantiate(m_Scene, cell.root);
+
+        cell.entityCount = cell.result.scene.entityCount();
+        m_Stats.residentEntities += cell.entityCount;
+        m_Stats.loadsCompleted++;
+
+        cell.result = {}; // the entities have their own copy of everything now
+        cell.state  = CellState::Resident;
+        return true;
+    }
+
+    void WorldPartition::retainMesh(Cell &cell, const asset::stable_id_t id, Mesh::Data *data) {
+        const auto table = asset::assetTable<asset::Mesh>();
+
+        auto [it, inserted] = m_Meshes.try_emplace(id);
+        if (inserted) {
+            if (const auto existing = table->findByStableId(id); existing.isValid()) {
+                it->second.handle = existing;
+            } else if (data != nullptr) {
+                it->second.handle = table->initAsset(std::make_unique<asset::Mesh>(std::make_shared<Mesh>(*data)));
+                it->second.bytes  = data->sizeInBytes();
+                it->second.owned  = true;
+                table->setStableId(it->second.handle, id);
+            } else {
+                // the mesh was registered when the worker checked and has been released since
+                m_Meshes.erase(it);
+                throw std::runtime_error("Mesh " + std::to_string(id) + " disappeared while its world cell was loading");
+            }
+        }
+
+        it->second.users++;
+        cell.retainedMeshes.push_back(id);
+    }
+
+    void WorldPartition::releaseCell(Cell &cell) {
+        if (cell.root.is_valid()) {
+            m_Stats.residentEntities -= cell.entityCount;
+            cell.root.destruct(); // takes the children with it
+            m_Stats.unloads++;
+        }
+
+        const auto table = asset::assetTable<asset::Mesh>();
+        for (const asset::stable_id_t id : cell.retainedMeshes) {
+            const auto it = m_Meshes.find(id);
+            if (it == m_Meshes.end() || --it->second.users != 0) {
+                continue;
+            }
+
+            if (it->second.owned) {
+                table->releaseAsset(it->second.handle);
+            }
+            m_Meshes.erase(it);
+        }
+        cell.retainedMeshes.clear();
+    }
+
+    void WorldPartition::updateStats() {
+        m_Stats.residentCells     = 0;
+        m_Stats.inFlightLoads     = 0;
+        m_Stats.pendingUploads    = 0;
+        m_Stats.pendingBytes      = 0;
+        m_Stats.residentMeshBytes = 0;
+
+        for (const auto &cell : m_Cells | std::views::values) {
+            switch (cell.state) {
+            case CellState::Loading:
+                m_Stats.inFlightLoads++;
+                break;
+            case CellState::Uploading:
+                m_Stats.pendingUploads++;
+                m_Stats.pendingBytes += cell.result.scene.sizeInBytes();
+                for (const auto &data : cell.result.meshes | std::views::values) {
+                    m_Stats.pendingBytes += data.sizeInBytes();
+                }
+                break;
+            case CellState::Resident:
+                m_Stats.residentCells++;
+                break;
+            }
+        }
+
+        for (const auto &mesh : m_Meshes | std::views::values) {
+            m_Stats.residentMeshBytes += mesh.bytes;
+        }
+    }
+
+    WorldPartition::MeshResolver WorldPartition::directoryResolver(const std::filesystem::path &directory) {
+        auto paths = std::make_shared<std::unordered_map<asset::stable_id_t, std::filesystem::path>>();
+        for (const auto &entry : std::filesystem::recursive_directory_iterator(directory)) {
+            if (entry.is_regular_file()) {
+                paths->emplace(asset::stableIdFromPath(entry.path()), entry.path());
+            }
+        }
+
+        return [paths](const asset::stable_id_t id) -> std::optional<std::filesystem::path> {
+            const auto it = paths->find(id);
+            return it == paths->end() ? std::nullopt : std::optional(it->second);
+        };
+    }
+} // namespace neuron::scene
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "neuron/asset/mesh.hpp"
+#include "neuron/scene/scene.hpp"
+#include "neuron/scene/serialization.hpp"
+#include "neuron/thread_pool.hpp"
+
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <glm/glm.hpp>
+
+namespace neuron::scene {
+
+    // cells are laid out on the xz plane
+    struct CellCoord {
+        int32_t x;
+        int32_t z;
+
+        bool operator==(const CellCoord &other) const = default;
+    };
+
+    struct CellCoordHash {
+        inline std::size_t operator()(const CellCoord &coord) const {
+            return std::hash<uint64_t>()(static_cast<uint64_t>(static_cast<uint32_t>(coord.x)) << 32 | static_cast<uint32_t>(coord.z));
+        }
+    };
+
+    struct StreamingStats {
+        uint32_t residentCells  = 0;
+        uint32_t queuedCells    = 0; // in range, waiting for a free load slot
+        uint32_t inFlightLoads  = 0; // being read and decoded on the worker threads
+        uint32_t pendingUploads = 0; // decoded, waiting for their turn on the GL thread
+
+        uint64_t    residentEntities  = 0;
+        std::size_t residentMeshBytes = 0; // vertex and index data of meshes uploaded by the partition
+        std::size_t pendingBytes      = 0; // decoded cell and mesh data not uploaded yet
+
+        uint64_t loadsCompleted = 0;
+        uint64_t unloads        = 0;
+        uint64_t failedLoads    = 0;
+
+        // main thread time spent in update(), in milliseconds
+        double updateMs     = 0.0;
+        double peakUpdateMs = 0.0;
+    };
+
+    /**
+     * Splits a large world into square cells stored as scene files (`cell_<x>_<z>.nscn` in one directory) and keeps the ones around a focus point loaded.
+     *
+     * Reading and decoding the cell files (and the meshes they use) happens on a thread pool. Everything that needs the ecs world or GL, which is uploading meshes
+     * and creating the entities, happens in update() and is limited to a time budget per frame, nearest cells first.
+     * Cells load once they come within the load radius and only unload once they're past the (larger) unload radius, so moving along a cell border doesn't thrash.
+     */
+    class WorldPartition {
+      public:
+        // finds the file for a mesh which isn't registered in the mesh asset table yet
+        using MeshResolver = std::function<std::optional<std::filesystem::path>(asset::stable_id_t)>;
+
+        struct Settings {
+            std::filesystem::path directory;
+
+            float    cellSize         = 64.0f;
+            float    loadRadius       = 128.0f;
+            float    unloadRadius     = 192.0f;
+            uint32_t maxInFlightLoads = 4;
+            double   uploadBudgetMs   = 2.0;
+
+            // without a resolver every mesh used by a cell must already be loaded (shaders always must be)
+            MeshResolver meshResolver;
+        };
+
+        WorldPartition(Scene &scene, ThreadPool &pool, Settings settings);
+        ~WorldPartition();
+
+        WorldPartition(const WorldPartition &other)            = delete;
+        WorldPartition &operator=(const WorldPartition &other) = delete;
+
+        // Streams around the position of the active camera. Call on the GL thread once per frame, before Scene::progress.
+        void update();
+        void update(const glm::vec3 &focus);
+
+        // unloads everything, cells still loading get dropped when they finish
+        void unloadAll();
+
+        [[nodiscard]] CellCoord cellAt(const glm::vec3 &position) const;
+
+        [[nodiscard]] static std::filesystem::path cellFileName(CellCoord coord);
+
+        [[nodiscard]] inline const StreamingStats &stats() const { return m_Stats; }
+
+        [[nodiscard]] inline const Settings &settings() const { return m_Settings; }
+
+        // Resolves stable ids made with stableIdFromPath for every file below `directory`, with the path hashed the way it is spelled from the working directory
+        [[nodiscard]] static MeshResolver directoryResolver(const std::filesystem::path &directory);
+
+      private:
+        enum class CellState { Loading, Uploading, Resident };
+
+        struct LoadResult {
+            SceneData                                           scene;
+            std::vector<std::pair<asset::stable_id_t, Mesh::Data>> meshes;
+        };
+
+        struct Cell {
+            CellCoord               coord{};
+            CellState               state = CellState::Loading;
+            std::future<LoadResult> pending;
+            LoadResult              result;
+            std::size_t             nextMesh = 0;
+            bool                    cancelled = false;
+
+            std::vector<asset::stable_id_t> retainedMeshes;
+            flecs::entity                   root;
+            uint64_t                        entityCount = 0;
+        };
+
+        struct SharedMesh {
+            asset::AssetHandle<asset::Mesh> handle;
+            uint32_t                        users = 0;
+            std::size_t                     bytes = 0;
+            bool                            owned = false; // false if it was loaded by someone else before the partition needed it
+        };
+
+        [[nodiscard]] float distanceTo(CellCoord coord, const glm::vec3 &focus) const;
+
+        void startLoad(CellCoord coord);
+        void pollLoads();
+
+        // does one unit of GL thread work for the cell (one mesh upload or creating the entities), returns true once the cell is resident
+        bool uploadStep(Cell &cell);
+
+        void retainMesh(Cell &cell, asset::stable_id_t id, Mesh::Data *data);
+        void releaseCell(Cell &cell);
+
+        void updateStats();
+
+        Scene      &m_Scene;
+        ThreadPool &m_Pool;
+        Settings    m_Settings;
+
+        std::unordered_set<CellCoord, CellCoordHash>       m_AvailableCells;
+        std::unordered_set<CellCoord, CellCoordHash>       m_FailedCells;
+        std::unordered_map<CellCoord, Cell, CellCoordHash> m_Cells;
+        std::unordered_map<asset::stable_id_t, SharedMesh> m_Meshes;
+
+        StreamingStats m_Stats;
+    };
+
+} // namespace neuron::scene
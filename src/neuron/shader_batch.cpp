@@ -0,0 +1,208 @@
+#include "shader_batch.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace neuron {
+    namespace {
+        std::string shaderLog(const unsigned int shader) {
+            int length = 0;
+            glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+            std::string log(length, '\0');
+            glGetShaderInfoLog(shader, length, &length, log.data());
+            log.resize(length);
+            return log;
+        }
+
+        std::string programLog(const unsigned int program) {
+            int length = 0;
+            glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+            std::string log(length, '\0');
+            glGetProgramInfoLog(program, length, &length, log.data());
+            log.resize(length);
+            return log;
+        }
+    } // namespace
+
+    ShaderBatch::ShaderBatch(ProgramBinaryCache *cache) : m_Cache(cache) {
+    }
+
+    ShaderBatch::~ShaderBatch() {
+        // programs nobody collected still have GL objects
+        for (auto &program : m_Programs) {
+            if (program.state == State::Compiling) {
+                for (const unsigned int shader : program.shaders) {
+                    glDeleteShader(shader);
+                }
+                glDeleteProgram(program.program);
+            }
+        }
+    }
+
+    ShaderBatch::Id ShaderBatch::add(Sources sources, const ProgramParameters &parameters) {
+        Program program;
+        program.sources    = std::move(sources);
+        program.parameters = parameters;
+        m_Programs.push_back(std::move(program));
+        return m_Programs.size() - 1;
+    }
+
+    void ShaderBatch::submit() {
+        parallelSupported();
+
+        // the clock restarts for batches that are submitted again after everything finished
+        if (std::ranges::none_of(m_Programs, [](const Program &program) { return program.state == State::Compiling; })) {
+            m_Start = std::chrono::steady_clock::now();
+        }
+
+        std::vector<Program *> compiling;
+        for (auto &program : m_Programs) {
+            if (program.state != State::Added) {
+                continue;
+            }
+
+            if (m_Cache != nullptr) {
+                program.key = m_Cache->key(program.sources, program.parameters);
+                if (auto shader = m_Cache->loadBinary(program.key, program.parameters)) {
+                    program.shader = std::move(shader);
+                    program.state  = State::Done;
+                    continue;
+                }
+                program.parameters.binaryRetrievable = m_Cache->supported();
+            }
+
+            // every compile goes out before any link, and nothing asks for a status
+            for (const auto &[source, type] : program.sources) {
+                const unsigned int shader = glCreateShader(static_cast<GLenum>(type));
+                const char        *code   = source.c_str();
+                glShaderSource(shader, 1, &code, nullptr);
+                glCompileShader(shader);
+                program.shaders.push_back(shader);
+            }
+
+            program.state = State::Compiling;
+            compiling.push_back(&program);
+        }
+
+        for (Program *program : compiling) {
+            program->program = glCreateProgram();
+            for (const unsigned int shader : program->shaders) {
+                glAttachShader(program->program, shader);
+            }
+
+            glProgramParameteri(program->program, GL_PROGRAM_SEPARABLE, program->parameters.separable);
+            glProgramParameteri(program->program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, program->parameters.binaryRetrievable);
+            glLinkProgram(program->program);
+        }
+
+        updateElapsed();
+    }
+
+    bool ShaderBatch::poll() {
+        const bool parallel = parallelSupported();
+
+        bool done = true;
+        for (auto &program : m_Programs) {
+            if (program.state != State::Compiling) {
+                continue;
+            }
+
+            if (parallel) {
+                int complete = GL_FALSE;
+                glGetProgramiv(program.program, GL_COMPLETION_STATUS_KHR, &complete);
+                if (complete != GL_TRUE) {
+                    done = false;
+                    continue;
+                }
+            }
+            finish(program);
+        }
+
+        updateElapsed();
+        return done;
+    }
+
+    void ShaderBatch::wait() {
+        for (auto &program : m_Programs) {
+            if (program.state == State::Compiling) {
+                finish(program);
+            }
+        }
+        updateElapsed();
+    }
+
+    std::shared_ptr<Shader> ShaderBatch::result(const Id id) {
+        Program &program = m_Programs.at(id);
+        if (program.state == State::Added) {
+            throw std::logic_error("Shader batch program was never submitted");
+        }
+
+        if (program.state == State::Compiling) {
+            finish(program);
+            updateElapsed();
+        }
+
+        if (program.shader == nullptr) {
+            throw std::runtime_error(program.error);
+        }
+        return program.shader;
+    }
+
+    bool ShaderBatch::parallelSupported() {
+        static const bool supported = [] {
+            if (GLAD_GL_KHR_parallel_shader_compile) {
+                glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+                return true;
+            }
+            if (GLAD_GL_ARB_parallel_shader_compile) {
+                glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+                return true;
+            }
+            return false;
+        }();
+        return supported;
+    }
+
+    void ShaderBatch::finish(Program &program) {
+        const auto start = std::chrono::steady_clock::now();
+
+        int status = GL_FALSE;
+        glGetProgramiv(program.program, GL_LINK_STATUS, &status);
+        if (status == GL_TRUE) {
+            program.shader = Shader::adopt(program.program);
+        } else {
+            // a module that didn't compile makes the link fail too, its log is the more useful one
+            for (const unsigned int shader : program.shaders) {
+                glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+                if (status != GL_TRUE) {
+                    program.error = "Failed to compile shader: " + shaderLog(shader);
+                    break;
+                }
+            }
+
+            if (program.error.empty()) {
+                program.error = "Failed to link shader program: " + programLog(program.program);
+            }
+            glDeleteProgram(program.program);
+        }
+
+        // attached shaders are only flagged for deletion and go away with the program
+        for (const unsigned int shader : program.shaders) {
+            glDeleteShader(shader);
+        }
+        program.shaders.clear();
+        program.state = State::Done;
+
+        if (program.shader != nullptr && m_Cache != nullptr) {
+            // the compile itself overlapped with everything else in the batch, so only the time spent here is known
+            m_Cache->store(program.key, *program.shader, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+    }
+
+    void ShaderBatch::updateElapsed() {
+        const bool done = std::ranges::none_of(m_Programs, [](const Program &program) { return program.state != State::Done; });
+        if (done) {
+            m_ElapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_Start).count();
+        }
+    }
+} // namespace neuron
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "neuron/glwrap.hpp"
+#include "neuron/program_cache.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace neuron {
+
+    /**
+     * Compiles many programs at once. submit() hands every compile and link to the driver before asking for any status, since each status query
+     * waits for that one job. With KHR_parallel_shader_compile (or the ARB version) the driver works on them on its own threads and poll() only collects finished
+     * programs, using GL_COMPLETION_STATUS_KHR, so it never blocks. Without it, finishing a program waits for it like compiling one at a time would.
+     * Programs found in the binary cache skip compiling altogether. GL thread only.
+     */
+    class ShaderBatch {
+      public:
+        using Sources = ProgramBinaryCache::Sources;
+        using Id      = std::size_t;
+
+        // null for no cache
+        explicit ShaderBatch(ProgramBinaryCache *cache = &ProgramBinaryCache::global());
+        ~ShaderBatch();
+
+        ShaderBatch(const ShaderBatch &other)            = delete;
+        ShaderBatch &operator=(const ShaderBatch &other) = delete;
+
+        Id add(Sources sources, const ProgramParameters &parameters = {});
+
+        // Starts compiling everything added since the last submit
+        void submit();
+
+        // Collects programs the driver has finished, true once all submitted programs are done. Doesn't block when parallel compiling is supported
+        bool poll();
+
+        // blocks until every submitted program is done
+        void wait();
+
+        // Blocks if the program isn't done yet, and throws its compile or link error if it failed
+        [[nodiscard]] std::shared_ptr<Shader> result(Id id);
+
+        [[nodiscard]] inline std::size_t size() const { return m_Programs.size(); }
+
+        // from the submit that started the current work until everything was done
+        [[nodiscard]] inline double elapsedMs() const { return m_ElapsedMs; }
+
+        // also asks the driver to use as many compiler threads as it likes, the first time it's called
+        static bool parallelSupported();
+
+      private:
+        enum class State { Added, Compiling, Done };
+
+        struct Program {
+            Sources           sources;
+            ProgramParameters parameters;
+            uint64_t          key   = 0;
+            State             state = State::Added;
+
+            unsigned int              program = 0;
+            std::vector<unsigned int> shaders;
+
+            std::shared_ptr<Shader> shader;
+            std::string             error;
+        };
+
+        void finish(Program &program);
+
+        void updateElapsed();
+
+        ProgramBinaryCache  *m_Cache;
+        std::vector<Program> m_Programs;
+
+        std::chrono::steady_clock::time_point m_Start;
+        double                                m_ElapsedMs = 0.0;
+    };
+
+} // namespace neuron
@@ -0,0 +1,124 @@
+#include "shader_preprocessor.hpp"
+
+#include "neuron/glwrap.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace neuron {
+    namespace {
+        // the directive on a line, if it's one, with the rest of the line after it
+        bool directive(const std::string &line, const std::string_view name, std::string &rest) {
+            const auto hash = line.find_first_not_of(" \t");
+            if (hash == std::string::npos || line[hash] != '#') {
+                return false;
+            }
+
+            const auto start = line.find_first_not_of(" \t", hash + 1);
+            if (start == std::string::npos || line.compare(start, name.size(), name) != 0) {
+                return false;
+            }
+
+            // `#include_foo` isn't `#include`
+            const auto end = start + name.size();
+            if (end < line.size() && line[end] != ' ' && line[end] != '\t' && line[end] != '"' && line[end] != '<') {
+                return false;
+            }
+
+            rest = line.substr(end);
+            return true;
+        }
+
+        std::string defineLines(const ShaderDefines &defines) {
+            std::string lines;
+            for (const auto &[name, value] : defines) {
+                lines += "#define " + name + (value.empty() ? "" : " " + value) + "\n";
+            }
+            return lines;
+        }
+    } // namespace
+
+    ShaderPreprocessor::ShaderPreprocessor(std::vector<std::filesystem::path> includeDirectories) : m_IncludeDirectories(std::move(includeDirectories)) {
+    }
+
+    PreprocessedShader ShaderPreprocessor::process(const std::filesystem::path &path, const ShaderDefines &defines) const {
+        PreprocessedShader out;
+        if (!append(std::filesystem::absolute(path).lexically_normal(), out, &defines) && !defines.empty()) {
+            // no #version means the default version, and the defines can simply go first
+            out.source = defineLines(defines) + "#line 1 0\n" + out.source;
+        }
+        return out;
+    }
+
+    const ShaderPreprocessor &ShaderPreprocessor::global() {
+        static const ShaderPreprocessor preprocessor;
+        return preprocessor;
+    }
+
+    bool ShaderPreprocessor::append(const std::filesystem::path &path, PreprocessedShader &out, const ShaderDefines *defines) const {
+        const std::size_t index   = out.files.size();
+        bool              defined = false;
+        out.files.push_back(path);
+
+        std::istringstream lines(ShaderModule::loadSource(path));
+        std::string        line;
+        std::string        rest;
+        std::size_t        number = 0;
+        while (std::getline(lines, line)) {
+            number++;
+            const std::string location = path.string() + ":" + std::to_string(number);
+
+            if (directive(line, "version", rest)) {
+                if (defines == nullptr) {
+                    throw std::runtime_error("Malformed shader: #version in included file " + location);
+                }
+
+                out.source += line + "\n" + defineLines(*defines);
+                out.source += "#line " + std::to_string(number + 1) + " " + std::to_string(index) + "\n";
+                defines = nullptr; // only once, and an include can't have one
+                defined = true;
+                continue;
+            }
+
+            if (directive(line, "pragma", rest) && rest.find("once") != std::string::npos) {
+                out.source += "\n"; // keeps the line numbers without needing a #line
+                continue;
+            }
+
+            if (!directive(line, "include", rest)) {
+                out.source += line + "\n";
+                continue;
+            }
+
+            const auto open = rest.find_first_of("\"<");
+            const auto close = open == std::string::npos ? std::string::npos : rest.find(rest[open] == '"' ? '"' : '>', open + 1);
+            if (close == std::string::npos) {
+                throw std::runtime_error("Malformed shader: bad #include at " + location);
+            }
+
+            const auto include = resolve(rest.substr(open + 1, close - open - 1), rest[open] == '"', path);
+            if (std::ranges::find(out.files, include) == out.files.end()) {
+                out.source += "#line 1 " + std::to_string(out.files.size()) + "\n";
+                append(include, out, nullptr);
+            }
+            out.source += "#line " + std::to_string(number + 1) + " " + std::to_string(index) + "\n";
+        }
+        return defined;
+    }
+
+    std::filesystem::path ShaderPreprocessor::resolve(const std::string &name, const bool quoted, const std::filesystem::path &from) const {
+        if (quoted) {
+            if (auto path = (from.parent_path() / name).lexically_normal(); std::filesystem::exists(path)) {
+                return path;
+            }
+        }
+
+        for (const auto &directory : m_IncludeDirectories) {
+            if (auto path = std::filesystem::absolute(directory / name).lexically_normal(); std::filesystem::exists(path)) {
+                return path;
+            }
+        }
+        throw std::runtime_error("Could not find shader include " + name + " (included from " + from.string() + ")");
+    }
+} // namespace neuron
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace neuron {
+
+    // name and value, the value may be empty
+    using ShaderDefines = std::vector<std::pair<std::string, std::string>>;
+
+    struct PreprocessedShader {
+        std::string source;
+
+        // The file itself first, then every included file. Indices match the source string numbers in the #line directives, so compile errors can be traced back
+        std::vector<std::filesystem::path> files;
+    };
+
+    /**
+     * Expands `#include "file"` (looked up next to the including file, then in the include directories) and `#include <file>` (include directories only),
+     * and puts the defines right after the #version line, or first if there is none. Every file is included at most once per shader, so include guards and `#pragma once` aren't needed.
+     * Only reads files, so it's safe to use from any thread.
+     */
+    class ShaderPreprocessor {
+      public:
+        explicit ShaderPreprocessor(std::vector<std::filesystem::path> includeDirectories = {});
+
+        [[nodiscard]] PreprocessedShader process(const std::filesystem::path &path, const ShaderDefines &defines = {}) const;
+
+        static const ShaderPreprocessor &global();
+
+      private:
+        // true if the defines were placed after a #version line
+        bool append(const std::filesystem::path &path, PreprocessedShader &out, const ShaderDefines *defines) const;
+
+        [[nodiscard]] std::filesystem::path resolve(const std::string &name, bool quoted, const std::filesystem::path &from) const;
+
+        std::vector<std::filesystem::path> m_IncludeDirectories;
+    };
+
+} // namespace neuron
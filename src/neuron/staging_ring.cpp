@@ -0,0 +1,71 @@
+#include "staging_ring.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace neuron {
+    StagingRing::StagingRing(const std::size_t size) : m_Capacity(size) {
+        constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+        m_Buffer  = std::make_unique<Buffer>(size, nullptr, Buffer::Storage{flags});
+        m_Mapping = static_cast<std::byte *>(m_Buffer->map(0, size, flags));
+    }
+
+    StagingRing::~StagingRing() {
+        m_Buffer->unmap();
+    }
+
+    std::optional<StagingRing::Allocation> StagingRing::allocate(const std::size_t size, const std::size_t alignment) {
+        if (size == 0 || size > m_Capacity) {
+            return std::nullopt;
+        }
+
+        std::lock_guard lock(m_Mutex);
+
+        std::size_t start = (m_Head + alignment - 1) / alignment * alignment;
+        if (start + size > m_Capacity) {
+            start = 0; // an allocation never wraps, the rest of the buffer is skipped instead
+        }
+
+        // free space is the span from the head to the oldest live block, and this takes everything from the head to its end
+        const std::size_t bytes = (start >= m_Head ? start - m_Head : m_Capacity - m_Head + start) + size;
+        if (m_Used + bytes > m_Capacity) {
+            return std::nullopt;
+        }
+
+        const uint64_t id = m_NextId++;
+        m_Blocks.push_back({id, bytes});
+        m_Used += bytes;
+        m_Head = (start + size) % m_Capacity;
+        return Allocation{id, start, size, m_Mapping + start};
+    }
+
+    void StagingRing::release(const Allocation &allocation, const uint64_t frame) {
+        std::lock_guard lock(m_Mutex);
+
+        const auto it = std::ranges::find(m_Blocks, allocation.id, &Block::id);
+        if (it == m_Blocks.end() || it->released) {
+            throw std::logic_error("Releasing a staging allocation twice");
+        }
+        it->released = true;
+        it->frame    = frame;
+    }
+
+    void StagingRing::reclaim(const uint64_t completedFrame) {
+        std::lock_guard lock(m_Mutex);
+        while (!m_Blocks.empty() && m_Blocks.front().released && m_Blocks.front().frame <= completedFrame) {
+            m_Used -= m_Blocks.front().bytes;
+            m_Blocks.pop_front();
+        }
+
+        // nothing is live, so the next allocation may as well start at the beginning
+        if (m_Blocks.empty()) {
+            m_Head = 0;
+        }
+    }
+
+    std::size_t StagingRing::used() const {
+        std::lock_guard lock(m_Mutex);
+        return m_Used;
+    }
+} // namespace neuron
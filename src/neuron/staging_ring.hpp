@@ -0,0 +1,69 @@
+#pragma once
+
+#include "neuron/glwrap.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+namespace neuron {
+
+    /**
+     * A persistently mapped upload buffer handed out as a ring. Any thread can allocate and write into the mapping; the GL thread sources uploads from
+     * the returned offsets with the buffer bound as GL_PIXEL_UNPACK_BUFFER (or as a copy source) and then releases the allocation with the frame that used it.
+     * Space comes back in allocation order once FrameFences reports that frame complete, so nothing is overwritten while the GPU may still read it.
+     */
+    class StagingRing {
+      public:
+        struct Allocation {
+            uint64_t    id     = 0;
+            std::size_t offset = 0; // into the buffer, for the upload call
+            std::size_t size   = 0;
+            std::byte  *data   = nullptr;
+        };
+
+        // GL thread
+        explicit StagingRing(std::size_t size);
+        ~StagingRing();
+
+        StagingRing(const StagingRing &other)            = delete;
+        StagingRing &operator=(const StagingRing &other) = delete;
+
+        // Never blocks, nullopt while there isn't enough free space
+        [[nodiscard]] std::optional<Allocation> allocate(std::size_t size, std::size_t alignment = 16);
+
+        // The allocation was read by commands recorded in `frame`. An allocation that was never used can be released with frame 0
+        void release(const Allocation &allocation, uint64_t frame);
+
+        // frees every released allocation at the front of the ring whose frame has completed
+        void reclaim(uint64_t completedFrame);
+
+        [[nodiscard]] inline const Buffer &buffer() const { return *m_Buffer; }
+
+        [[nodiscard]] inline std::size_t capacity() const { return m_Capacity; }
+
+        [[nodiscard]] std::size_t used() const;
+
+      private:
+        struct Block {
+            uint64_t    id;
+            std::size_t bytes; // including the padding in front of it
+            bool        released = false;
+            uint64_t    frame    = 0;
+        };
+
+        std::size_t             m_Capacity;
+        std::unique_ptr<Buffer> m_Buffer;
+        std::byte              *m_Mapping = nullptr;
+
+        mutable std::mutex m_Mutex;
+        std::deque<Block>  m_Blocks;
+        std::size_t        m_Head   = 0;
+        std::size_t        m_Used   = 0;
+        uint64_t           m_NextId = 1;
+    };
+
+} // namespace neuron
@@ -0,0 +1,278 @@
+#include "texture_atlas.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+namespace neuron {
+    namespace {
+        int roundUp(const int value, const int multiple) {
+            return (value + multiple - 1) / multiple * multiple;
+        }
+    } // namespace
+
+    SkylinePacker::SkylinePacker(const int width, const int height) : m_Width(width), m_Height(height) {
+        if (width <= 0 || height <= 0) {
+            throw std::runtime_error("Skyline packers need a size");
+        }
+        m_Skyline.push_back({0, 0, width});
+    }
+
+    std::optional<glm::ivec2> SkylinePacker::insert(const int width, const int height) {
+        if (width <= 0 || height <= 0) {
+            return std::nullopt;
+        }
+
+        // lowest top edge first, then the narrowest node, which wastes the least of what it leaves behind
+        std::size_t best       = m_Skyline.size();
+        int         bestBottom = INT32_MAX;
+        int         bestWidth  = INT32_MAX;
+        int         bestY      = 0;
+        for (std::size_t i = 0; i < m_Skyline.size(); i++) {
+            const auto y = fit(i, width, height);
+            if (!y) {
+                continue;
+            }
+            if (*y + height < bestBottom || (*y + height == bestBottom && m_Skyline[i].width < bestWidth)) {
+                best       = i;
+                bestBottom = *y + height;
+                bestWidth  = m_Skyline[i].width;
+                bestY      = *y;
+            }
+        }
+        if (best == m_Skyline.size()) {
+            return std::nullopt;
+        }
+
+        const glm::ivec2 position{m_Skyline[best].x, bestY};
+        m_Skyline.insert(m_Skyline.begin() + static_cast<std::ptrdiff_t>(best), Node{position.x, bestBottom, width});
+
+        // the nodes the new one covers are cut down or dropped
+        for (std::size_t i = best + 1; i < m_Skyline.size();) {
+            Node     &node  = m_Skyline[i];
+            const int right = position.x + width;
+            if (node.x >= right) {
+                break;
+            }
+            const int shrink = right - node.x;
+            if (shrink < node.width) {
+                node.x += shrink;
+                node.width -= shrink;
+                break;
+            }
+            m_Skyline.erase(m_Skyline.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+
+        // neighbours at the same height are one node
+        for (std::size_t i = 0; i + 1 < m_Skyline.size();) {
+            if (m_Skyline[i].y == m_Skyline[i + 1].y) {
+                m_Skyline[i].width += m_Skyline[i + 1].width;
+                m_Skyline.erase(m_Skyline.begin() + static_cast<std::ptrdiff_t>(i + 1));
+            } else {
+                i++;
+            }
+        }
+
+        m_Used += static_cast<uint64_t>(width) * static_cast<uint64_t>(height);
+        return position;
+    }
+
+    std::optional<int> SkylinePacker::fit(std::size_t index, const int width, const int height) const {
+        const int x = m_Skyline[index].x;
+        if (x + width > m_Width) {
+            return std::nullopt;
+        }
+
+        int y         = m_Skyline[index].y;
+        int remaining = width;
+        while (remaining > 0) {
+            if (index >= m_Skyline.size()) {
+                return std::nullopt;
+            }
+            y = std::max(y, m_Skyline[index].y);
+            if (y + height > m_Height) {
+                return std::nullopt;
+            }
+            remaining -= m_Skyline[index].width;
+            index++;
+        }
+        return y;
+    }
+
+    TextureAtlas::TextureAtlas() : TextureAtlas(Settings{}) {}
+
+    TextureAtlas::TextureAtlas(const Settings settings) : m_Settings(settings) {
+        if (settings.layerSize <= 0 || settings.padding < 0) {
+            throw std::runtime_error("Texture atlases need a layer size and a padding of at least 0");
+        }
+
+        // a gutter of p texels is gone after log2(p) halvings
+        while (m_Levels < Texture::mipLevels(settings.layerSize, settings.layerSize) && (settings.padding >> m_Levels) > 0) {
+            m_Levels++;
+        }
+        m_Alignment = 1 << (m_Levels - 1);
+    }
+
+    bool TextureAtlas::accepts(const int width, const int height) const {
+        const int limit = m_Settings.layerSize;
+        return width > 0 && height > 0 && roundUp(width + 2 * m_Settings.padding, m_Alignment) <= limit &&
+               roundUp(height + 2 * m_Settings.padding, m_Alignment) <= limit;
+    }
+
+    uint32_t TextureAtlas::add(Image image) {
+        if (m_Packed) {
+            throw std::runtime_error("Texture atlases can't take images once they're packed");
+        }
+        if (!accepts(image.width, image.height)) {
+            throw std::runtime_error("A " + std::to_string(image.width) + "x" + std::to_string(image.height) + " image doesn't fit in a " +
+                                     std::to_string(m_Settings.layerSize) + " texel atlas layer");
+        }
+
+        m_Regions.push_back({.size = {image.width, image.height}});
+        m_Images.push_back(std::move(image));
+        return static_cast<uint32_t>(m_Regions.size() - 1);
+    }
+
+    void TextureAtlas::pack() {
+        if (m_Packed) {
+            throw std::runtime_error("Texture atlases can only be packed once");
+        }
+        const auto start = std::chrono::steady_clock::now();
+
+        // tallest first, then widest, which is what skylines pack best
+        std::vector<uint32_t> order(m_Regions.size());
+        std::iota(order.begin(), order.end(), 0U);
+        std::ranges::stable_sort(order, [this](const uint32_t a, const uint32_t b) {
+            const glm::ivec2 sizeA = m_Regions[a].size;
+            const glm::ivec2 sizeB = m_Regions[b].size;
+            return sizeA.y != sizeB.y ? sizeA.y > sizeB.y : sizeA.x > sizeB.x;
+        });
+
+        const int                  size    = m_Settings.layerSize;
+        const int                  padding = m_Settings.padding;
+        std::vector<SkylinePacker> packers;
+        for (const uint32_t id : order) {
+            Region          &region = m_Regions[id];
+            const glm::ivec2 rect{roundUp(region.size.x + 2 * padding, m_Alignment), roundUp(region.size.y + 2 * padding, m_Alignment)};
+
+            // the first layer with room, so earlier layers fill up before new ones are opened
+            std::optional<glm::ivec2> corner;
+            for (std::size_t layer = 0; layer < packers.size() && !corner; layer++) {
+                if ((corner = packers[layer].insert(rect.x, rect.y))) {
+                    region.layer = static_cast<uint32_t>(layer);
+                }
+            }
+            if (!corner) {
+                corner       = packers.emplace_back(size, size).insert(rect.x, rect.y);
+                region.layer = static_cast<uint32_t>(packers.size() - 1);
+            }
+
+            region.position = *corner + padding;
+            region.offset   = glm::vec2(region.position) / static_cast<float>(size);
+            region.scale    = glm::vec2(region.size) / static_cast<float>(size);
+        }
+
+        for (std::size_t layer = 0; layer < packers.size(); layer++) {
+            Image image{size, size, std::vector<uint8_t>(static_cast<std::size_t>(size) * static_cast<std::size_t>(size) * 4)};
+            for (uint32_t id = 0; id < m_Regions.size(); id++) {
+                if (m_Regions[id].layer == layer) {
+                    blit(image, m_Images[id], m_Regions[id]);
+                }
+            }
+
+            auto &levels = m_Layers.emplace_back();
+            levels.push_back(std::move(image));
+            while (static_cast<int>(levels.size()) < m_Levels) {
+                levels.push_back(levels.back().downsample(m_Settings.srgb));
+            }
+        }
+
+        m_Stats.images = static_cast<uint32_t>(m_Regions.size());
+        m_Stats.layers = static_cast<uint32_t>(m_Layers.size());
+        for (const Region &region : m_Regions) {
+            m_Stats.imageTexels += static_cast<uint64_t>(region.size.x) * static_cast<uint64_t>(region.size.y);
+        }
+        m_Stats.layerTexels = static_cast<uint64_t>(size) * static_cast<uint64_t>(size) * m_Layers.size();
+        m_Stats.packMs      = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        m_Images.clear();
+        m_Images.shrink_to_fit();
+        m_Packed = true;
+    }
+
+    const TextureAtlas::Region &TextureAtlas::region(const uint32_t id) const {
+        if (id >= m_Regions.size()) {
+            throw std::runtime_error("No texture atlas region " + std::to_string(id));
+        }
+        return m_Regions[id];
+    }
+
+    bool TextureAtlas::remap(Mesh::Data &data, const uint32_t id) const {
+        constexpr float kTolerance = 1e-4f;
+
+        const bool inside = std::ranges::all_of(data.vertices, [](const StandardVertex &vertex) {
+            const glm::vec2 uv = vertex.texCoord;
+            return uv.x >= -kTolerance && uv.y >= -kTolerance && uv.x <= 1.0f + kTolerance && uv.y <= 1.0f + kTolerance;
+        });
+        if (!inside) {
+            return false;
+        }
+
+        const Region &target = region(id);
+        for (StandardVertex &vertex : data.vertices) {
+            vertex.texCoord = target.apply(glm::clamp(vertex.texCoord, 0.0f, 1.0f));
+        }
+        return true;
+    }
+
+    std::shared_ptr<Texture> TextureAtlas::upload() const {
+        if (!m_Packed || m_Layers.empty()) {
+            throw std::runtime_error("Only packed texture atlases with images in them can be uploaded");
+        }
+
+        const auto format  = m_Settings.srgb ? Texture::InternalFormat::SRGB8_ALPHA8 : Texture::InternalFormat::RGBA8;
+        auto       texture = Texture::createArray2d(m_Settings.layerSize, m_Settings.layerSize, static_cast<int>(m_Layers.size()), format, m_Levels);
+
+        // the pixels are in client memory
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        for (std::size_t layer = 0; layer < m_Layers.size(); layer++) {
+            for (std::size_t level = 0; level < m_Layers[layer].size(); level++) {
+                const Image &image = m_Layers[layer][level];
+                texture->subImage3d(static_cast<int>(level), 0, 0, static_cast<int>(layer), image.width, image.height, 1, Texture::Format::RGBA,
+                                    Texture::DataType::UnsignedByte, image.pixels.data());
+            }
+        }
+        return texture;
+    }
+
+    std::unique_ptr<Buffer> TextureAtlas::regionBuffer() const {
+        if (!m_Packed || m_Regions.empty()) {
+            throw std::runtime_error("Only packed texture atlases with images in them have regions");
+        }
+
+        std::vector<GpuRegion> regions;
+        regions.reserve(m_Regions.size());
+        for (const Region &region : m_Regions) {
+            regions.push_back({glm::vec4(region.offset.x, region.offset.y, region.scale.x, region.scale.y), region.layer, {}});
+        }
+        return std::make_unique<Buffer>(regions.size() * sizeof(GpuRegion), regions.data(), Buffer::Storage{0});
+    }
+
+    void TextureAtlas::blit(Image &layer, const Image &image, const Region &region) const {
+        const int        padding = m_Settings.padding;
+        const glm::ivec2 corner  = region.position - padding;
+        const glm::ivec2 rect{roundUp(region.size.x + 2 * padding, m_Alignment), roundUp(region.size.y + 2 * padding, m_Alignment)};
+
+        for (int y = 0; y < rect.y; y++) {
+            const int      sourceY = std::clamp(y - padding, 0, image.height - 1);
+            uint8_t       *row     = layer.pixels.data() + (static_cast<std::size_t>(corner.y + y) * layer.width + corner.x) * 4;
+            const uint8_t *source  = image.pixels.data() + static_cast<std::size_t>(sourceY) * image.width * 4;
+            for (int x = 0; x < rect.x; x++) {
+                const int sourceX = std::clamp(x - padding, 0, image.width - 1);
+                std::copy_n(source + sourceX * 4, 4, row + x * 4);
+            }
+        }
+    }
+} // namespace neuron
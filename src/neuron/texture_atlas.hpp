@@ -0,0 +1,137 @@
+#pragma once
+
+#include "neuron/glwrap.hpp"
+#include "neuron/image.hpp"
+#include "neuron/mesh.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace neuron {
+
+    // Rectangles into a fixed size bin, each placed where it leaves the lowest top edge (bottom left skyline)
+    class SkylinePacker {
+      public:
+        SkylinePacker(int width, int height);
+
+        // the top left corner, nullopt if it doesn't fit anywhere
+        [[nodiscard]] std::optional<glm::ivec2> insert(int width, int height);
+
+        [[nodiscard]] inline uint64_t usedTexels() const { return m_Used; }
+
+        [[nodiscard]] inline float occupancy() const { return static_cast<float>(m_Used) / (static_cast<float>(m_Width) * static_cast<float>(m_Height)); }
+
+      private:
+        struct Node {
+            int x;
+            int y; // the lowest free row over [x, x + width)
+            int width;
+        };
+
+        // the row a rectangle resting on `index` would start at, nullopt if it runs off the bin
+        [[nodiscard]] std::optional<int> fit(std::size_t index, int width, int height) const;
+
+        int               m_Width;
+        int               m_Height;
+        std::vector<Node> m_Skyline;
+        uint64_t          m_Used = 0;
+    };
+
+    struct TextureAtlasStats {
+        uint32_t images      = 0;
+        uint32_t layers      = 0;
+        uint64_t imageTexels = 0; // without padding
+        uint64_t layerTexels = 0; // of every layer, the whole array
+
+        double packMs = 0.0;
+
+        [[nodiscard]] inline float efficiency() const { return layerTexels == 0 ? 0.0f : static_cast<float>(imageTexels) / static_cast<float>(layerTexels); }
+    };
+
+    /**
+     * Packs small images into the layers of one 2D array texture, so draws with different textures can share a bind and be merged. Images are collected with
+     * add() and packed all at once by pack(), largest first, which packs much tighter than placing them as they come. pack() is CPU only and meant for import
+     * time, upload() makes the texture on the GL thread.
+     *
+     * Every image gets a gutter of its own edge texels, and rectangles are aligned so the gutters survive down the mip chain, which stops at the level where
+     * the gutter would be gone. Wrapping isn't possible inside an atlas, so meshes whose texture coordinates tile can't use it.
+     */
+    class TextureAtlas {
+      public:
+        // what res/texture_atlas.glsl expects
+        static constexpr unsigned int kRegionBinding = 8;
+
+        struct Settings {
+            int  layerSize = 2048;
+            int  padding   = 4; // texels of gutter around every image
+            bool srgb      = true;
+        };
+
+        struct Region {
+            uint32_t   layer = 0;
+            glm::ivec2 position{0}; // of the image, inside the gutter
+            glm::ivec2 size{0};
+            glm::vec2  offset{0.0f}; // texture coordinates in the layer are offset + uv * scale
+            glm::vec2  scale{1.0f};
+
+            [[nodiscard]] inline glm::vec2 apply(const glm::vec2 uv) const { return offset + uv * scale; }
+        };
+
+        TextureAtlas();
+        explicit TextureAtlas(Settings settings);
+
+        // whether an image of this size fits in a layer with its gutter
+        [[nodiscard]] bool accepts(int width, int height) const;
+
+        // The id of the image's region once packed. Throws std::runtime_error for images that aren't accepted() or after pack()
+        uint32_t add(Image image);
+
+        // Places every image and composes the layers and their mip levels. Only once
+        void pack();
+
+        [[nodiscard]] const Region &region(uint32_t id) const;
+
+        // Rewrites the texture coordinates of `data` to the region, leaving the layer to the draw. False (and nothing changed) if they go outside [0, 1]
+        [[nodiscard]] bool remap(Mesh::Data &data, uint32_t id) const;
+
+        // GL thread, after pack()
+        [[nodiscard]] std::shared_ptr<Texture> upload() const;
+
+        // Every region as res/texture_atlas.glsl reads them, indexed by id. GL thread, after pack()
+        [[nodiscard]] std::unique_ptr<Buffer> regionBuffer() const;
+
+        // per layer, finest level first
+        [[nodiscard]] inline const std::vector<std::vector<Image>> &layers() const { return m_Layers; }
+
+        [[nodiscard]] inline bool packed() const { return m_Packed; }
+
+        [[nodiscard]] inline const TextureAtlasStats &stats() const { return m_Stats; }
+
+      private:
+        // a region as std430 lays it out
+        struct GpuRegion {
+            glm::vec4 rect; // offset, scale
+            uint32_t  layer;
+            uint32_t  padding[3];
+        };
+
+        // copies the image in with its edges stretched out over the gutter
+        void blit(Image &layer, const Image &image, const Region &region) const;
+
+        Settings m_Settings;
+        int      m_Levels    = 1;
+        int      m_Alignment = 1; // of rectangle corners and sizes, so gutters stay whole in every level
+
+        std::vector<Image>              m_Images; // until pack()
+        std::vector<Region>             m_Regions;
+        std::vector<std::vector<Image>> m_Layers;
+        bool                            m_Packed = false;
+
+        TextureAtlasStats m_Stats;
+    };
+
+} // namespace neuron
@@ -0,0 +1,61 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+
+namespace neuron {
+    ThreadPool::ThreadPool(const uint32_t threads) {
+        const uint32_t count = threads == 0 ? std::max(std::thread::hardware_concurrency(), 2U) - 1 : threads;
+
+        m_Threads.reserve(count);
+        for (uint32_t i = 0; i < count; i++) {
+            m_Threads.emplace_back([this](const std::stop_token &stop) { workerLoop(stop); });
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard lock(m_Mutex);
+            m_Queue.clear();
+        }
+
+        for (auto &thread : m_Threads) {
+            thread.request_stop();
+        }
+        m_Threads.clear(); // joins
+    }
+
+    std::size_t ThreadPool::queued() const {
+        std::lock_guard lock(m_Mutex);
+        return m_Queue.size();
+    }
+
+    ThreadPool &ThreadPool::global() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    void ThreadPool::enqueue(std::move_only_function<void()> job) {
+        {
+            std::lock_guard lock(m_Mutex);
+            m_Queue.push_back(std::move(job));
+        }
+        m_Condition.notify_one();
+    }
+
+    void ThreadPool::workerLoop(const std::stop_token &stop) {
+        while (true) {
+            std::move_only_function<void()> job;
+            {
+                std::unique_lock lock(m_Mutex);
+                if (!m_Condition.wait(lock, stop, [this] { return !m_Queue.empty(); })) {
+                    return; // stop requested
+                }
+
+                job = std::move(m_Queue.front());
+                m_Queue.pop_front();
+            }
+
+            job();
+        }
+    }
+} // namespace neuron
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace neuron {
+
+    /**
+     * A plain FIFO pool of worker threads for CPU work that has to stay off the GL context thread (file IO, decoding, compression).
+     * Jobs must not touch GL. Jobs still queued when the pool is destroyed are dropped, running ones are waited for.
+     */
+    class ThreadPool {
+      public:
+        // 0 uses every hardware thread except one, which is left for the main thread
+        explicit ThreadPool(uint32_t threads = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &other)            = delete;
+        ThreadPool &operator=(const ThreadPool &other) = delete;
+
+        template <typename F>
+        auto submit(F &&function) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+            using result_t = std::invoke_result_t<std::decay_t<F>>;
+
+            std::packaged_task<result_t()> task(std::forward<F>(function));
+            auto                           future = task.get_future();
+            enqueue(std::move(task));
+            return future;
+        }
+
+        [[nodiscard]] inline std::size_t threadCount() const { return m_Threads.size(); }
+
+        // jobs which haven't been picked up by a worker yet
+        [[nodiscard]] std::size_t queued() const;
+
+        // shared pool for engine systems which don't need their own
+        static ThreadPool &global();
+
+      private:
+        void enqueue(std::move_only_function<void()> job);
+        void workerLoop(const std::stop_token &stop);
+
+        mutable std::mutex                          m_Mutex;
+        std::condition_variable_any                 m_Condition;
+        std::deque<std::move_only_function<void()>> m_Queue;
+        std::vector<std::jthread>                   m_Threads;
+    };
+
+} // namespace neuron
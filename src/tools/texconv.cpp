@@ -0,0 +1,174 @@
+#include "neuron/bc_encoder.hpp"
+#include "neuron/dds.hpp"
+#include "neuron/image.hpp"
+#include "neuron/mapped_file.hpp"
+#include "neuron/thread_pool.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * Offline texture conversion:
+ *
+ *   texconv <input> <output.dds> [--format bc1|bc3|bc4|bc5|bc7] [--linear] [--no-mips] [--threads N]
+ *   texconv --bench <input> [--threads N]               PSNR and throughput of every format, single threaded and on the pool
+ *   texconv --validate <file.dds>...                    checks files the way the engine does before loading them
+ */
+
+namespace {
+    struct Options {
+        std::string              mode    = "convert";
+        neuron::BcFormat         format  = neuron::BcFormat::BC7;
+        bool                     srgb    = true;
+        bool                     mips    = true;
+        uint32_t                 threads = 0; // 0 is every hardware thread but one
+        std::vector<std::string> paths;
+    };
+
+    int usage() {
+        std::cerr << "usage: texconv <input> <output.dds> [--format bc1|bc3|bc4|bc5|bc7] [--linear] [--no-mips] [--threads N]\n"
+                     "       texconv --bench <input> [--threads N]\n"
+                     "       texconv --validate <file.dds>..."
+                  << std::endl;
+        return 2;
+    }
+
+    std::optional<Options> parse(const int argc, char **argv) {
+        Options options;
+        for (int i = 1; i < argc; i++) {
+            const std::string_view arg = argv[i];
+            if (arg == "--bench" || arg == "--validate") {
+                options.mode = arg.substr(2);
+            } else if (arg == "--linear") {
+                options.srgb = false;
+            } else if (arg == "--no-mips") {
+                options.mips = false;
+            } else if (arg == "--format" && i + 1 < argc) {
+                const auto format = neuron::BcImage::parse(argv[++i]);
+                if (!format) {
+                    return std::nullopt;
+                }
+                options.format = *format;
+            } else if (arg == "--threads" && i + 1 < argc) {
+                options.threads = static_cast<uint32_t>(std::stoul(argv[++i]));
+            } else if (arg.starts_with("--")) {
+                return std::nullopt;
+            } else {
+                options.paths.emplace_back(arg);
+            }
+        }
+
+        const std::size_t paths = options.paths.size();
+        if ((options.mode == "convert" && paths != 2) || (options.mode == "bench" && paths != 1) || (options.mode == "validate" && paths == 0)) {
+            return std::nullopt;
+        }
+        return options;
+    }
+
+    double millisecondsSince(const std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    double megapixelsPerSecond(const neuron::Image &image, const double ms) {
+        return static_cast<double>(image.width) * static_cast<double>(image.height) / (ms * 1000.0);
+    }
+
+    int convert(const Options &options, neuron::ThreadPool &pool) {
+        auto                       start = std::chrono::steady_clock::now();
+        std::vector<neuron::Image> levels;
+        levels.push_back(neuron::Image::load(options.paths[0]));
+        if (options.mips) {
+            levels = std::move(levels.front()).mipChain(options.srgb);
+        }
+        const double loadMs = millisecondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        std::vector<neuron::BcImage> encoded;
+        for (const auto &level : levels) {
+            encoded.push_back(neuron::BcImage::encode(level, options.format, &pool));
+        }
+        const double encodeMs = millisecondsSince(start);
+
+        neuron::DdsFile::write(options.paths[1], encoded, options.srgb);
+
+        const int channels = neuron::BcImage::channels(options.format);
+        std::printf("%s: %dx%d, %zu levels, %s, PSNR %.2f dB, load %.1f ms, encode %.1f ms (%.1f MPix/s on the top level)\n", options.paths[1].c_str(),
+                    levels.front().width, levels.front().height, levels.size(), neuron::BcImage::name(options.format).data(),
+                    levels.front().psnr(encoded.front().decode(), channels), loadMs, encodeMs, megapixelsPerSecond(levels.front(), encodeMs));
+        return 0;
+    }
+
+    int bench(const Options &options, neuron::ThreadPool &pool) {
+        const neuron::Image image = neuron::Image::load(options.paths[0]);
+        std::printf("%s: %dx%d, %zu threads\n", options.paths[0].c_str(), image.width, image.height, pool.threadCount());
+        std::printf("%-6s %10s %14s %14s\n", "format", "PSNR (dB)", "1 thread", "pool");
+
+        for (const auto format : {neuron::BcFormat::BC1, neuron::BcFormat::BC3, neuron::BcFormat::BC4, neuron::BcFormat::BC5, neuron::BcFormat::BC7}) {
+            auto       start    = std::chrono::steady_clock::now();
+            const auto single   = neuron::BcImage::encode(image, format);
+            const auto serialMs = millisecondsSince(start);
+
+            start               = std::chrono::steady_clock::now();
+            const auto parallel = neuron::BcImage::encode(image, format, &pool);
+            const auto poolMs   = millisecondsSince(start);
+
+            if (single.blocks != parallel.blocks) {
+                std::cerr << "threaded encode of " << neuron::BcImage::name(format) << " differs from the single threaded one" << std::endl;
+                return 1;
+            }
+
+            std::printf("%-6s %10.2f %8.1f MPix/s %8.1f MPix/s\n", neuron::BcImage::name(format).data(), image.psnr(single.decode(), neuron::BcImage::channels(format)),
+                        megapixelsPerSecond(image, serialMs), megapixelsPerSecond(image, poolMs));
+        }
+        return 0;
+    }
+
+    int validate(const Options &options) {
+        int failed = 0;
+        for (const auto &path : options.paths) {
+            try {
+                const neuron::MappedFile file(path);
+                const auto               info = neuron::DdsFile::validate(file.bytes());
+                std::printf("%s: %dx%d, %d levels, %d layers, %d faces, %zu bytes of blocks\n", path.c_str(), info.width, info.height, info.levels, info.layers, info.faces,
+                            info.dataBytes());
+            } catch (const std::exception &e) {
+                std::printf("%s: %s\n", path.c_str(), e.what());
+                failed++;
+            }
+        }
+        return failed == 0 ? 0 : 1;
+    }
+} // namespace
+
+int main(const int argc, char **argv) {
+    std::optional<Options> options;
+    try {
+        options = parse(argc, argv);
+    } catch (const std::exception &) {
+        options.reset(); // a --threads that isn't a number
+    }
+    if (!options) {
+        return usage();
+    }
+
+    try {
+        neuron::ThreadPool pool(options->threads);
+        if (options->mode == "bench") {
+            return bench(*options, pool);
+        }
+        if (options->mode == "validate") {
+            return validate(*options);
+        }
+        return convert(*options, pool);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
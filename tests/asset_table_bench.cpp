@@ -0,0 +1,125 @@
+#include "gl_fakes.hpp"
+
+#include "neuron/asset/asset.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Lookups per second with 1 to 32 reader threads, while one writer replaces an asset every 100us. Compares the slot map with what it replaced, a
+ * hash map behind a reader-writer lock. `asset_table_bench [assets] [milliseconds per run]`
+ */
+
+using namespace neuron::asset;
+
+namespace {
+    // what the readers saw, so the lookups can't be optimized away
+    std::atomic<uint64_t> g_Sink{0};
+
+    struct Value final : Asset {
+        explicit Value(const uint64_t value) : value(value) {}
+
+        uint64_t value;
+    };
+
+    class LockedMap {
+      public:
+        uint64_t insert(const uint64_t value) {
+            std::unique_lock lock(m_Mutex);
+            m_Assets[m_Next] = std::make_shared<Value>(value);
+            return m_Next++;
+        }
+
+        void replace(const uint64_t key, const uint64_t value) {
+            auto             asset = std::make_shared<Value>(value);
+            std::unique_lock lock(m_Mutex);
+            m_Assets[key] = std::move(asset);
+        }
+
+        [[nodiscard]] std::shared_ptr<Value> get(const uint64_t key) const {
+            std::shared_lock lock(m_Mutex);
+            return m_Assets.at(key);
+        }
+
+      private:
+        mutable std::shared_mutex                            m_Mutex;
+        std::unordered_map<uint64_t, std::shared_ptr<Value>> m_Assets;
+        uint64_t                                             m_Next = 0;
+    };
+
+    // total lookups per second over every reader
+    template <typename Lookup, typename Replace>
+    double run(const int readers, const std::chrono::milliseconds duration, const std::size_t count, const Lookup &lookup, const Replace &replace) {
+        // readers watch the clock themselves, a reader-writer lock can starve the writer for longer than a run
+        const auto            start    = std::chrono::steady_clock::now();
+        const auto            deadline = start + duration;
+        std::atomic<uint64_t> total{0};
+
+        std::vector<std::jthread> threads;
+        for (int r = 0; r < readers; r++) {
+            threads.emplace_back([&, r] {
+                std::minstd_rand random(static_cast<uint32_t>(r + 1));
+                uint64_t         lookups = 0;
+                uint64_t         sum     = 0;
+                while (std::chrono::steady_clock::now() < deadline) {
+                    for (int i = 0; i < 256; i++) {
+                        sum += lookup(random() % count);
+                    }
+                    lookups += 256;
+                }
+                total.fetch_add(lookups, std::memory_order_relaxed);
+                g_Sink.fetch_add(sum, std::memory_order_relaxed);
+            });
+        }
+
+        for (uint64_t i = 0; std::chrono::steady_clock::now() < deadline; i++) {
+            replace(i % count, i);
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        threads.clear();
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return static_cast<double>(total.load()) / seconds;
+    }
+} // namespace
+
+int main(const int argc, char **argv) {
+    neuron::test::FakeGl::install();
+
+    const std::size_t               count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000;
+    const std::chrono::milliseconds duration(argc > 2 ? std::atoi(argv[2]) : 500);
+
+    auto                           *table = assetTable<Value>();
+    std::vector<AssetHandle<Value>> handles;
+    LockedMap                       locked;
+    for (std::size_t i = 0; i < count; i++) {
+        handles.push_back(table->initAsset(std::make_unique<Value>(i)));
+        locked.insert(i);
+    }
+
+    const auto slotLookup  = [&](const std::size_t i) { return handles[i].getFromGlobal()->value; };
+    const auto slotReplace = [&](const std::size_t i, const uint64_t value) {
+        table->replaceAsset(handles[i], std::make_unique<Value>(value));
+        neuron::test::FakeGl::signalAllFences();
+        collectRetiredAssets();
+    };
+    const auto lockedLookup  = [&](const std::size_t i) { return locked.get(i)->value; };
+    const auto lockedReplace = [&](const std::size_t i, const uint64_t value) { locked.replace(i, value); };
+
+    std::printf("%zu assets, %u hardware threads\n", count, std::thread::hardware_concurrency());
+    std::printf("readers  slot map (M/s)  per thread  locked map (M/s)  per thread  speedup\n");
+    for (const int readers : {1, 2, 4, 8, 16, 32}) {
+        const double slot   = run(readers, duration, count, slotLookup, slotReplace) / 1e6;
+        const double locked = run(readers, duration, count, lockedLookup, lockedReplace) / 1e6;
+        std::printf("%7d  %14.1f  %10.1f  %16.1f  %10.1f  %6.1fx\n", readers, slot, slot / readers, locked, locked / readers, slot / locked);
+    }
+
+    cleanupAssetTables();
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include "gl_fakes.hpp"
+#include "test.hpp"
+
+#include "neuron/asset/asset.hpp"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace neuron::asset;
+
+namespace {
+    struct Value final : Asset {
+        explicit Value(const int value) : value(value) {}
+
+        int value;
+    };
+
+    // what each asset was created for, written before its handle is handed to readers
+    struct Tagged final : Asset {
+        std::atomic<uint32_t> generation{0};
+    };
+} // namespace
+
+TEST_CASE(lookupsThroughStaleHandlesFailAfterReuse) {
+    auto *table = assetTable<Value>();
+
+    const auto old = table->initAsset(std::make_unique<Value>(1));
+    table->releaseAsset(old);
+    const auto reused = table->initAsset(std::make_unique<Value>(2));
+
+    REQUIRE(reused.index() == old.index());
+    CHECK(table->tryGetAsset(old) == nullptr);
+    CHECK(table->peekAsset(old) == nullptr);
+    CHECK(table->tryGetAsset(reused)->value == 2);
+    table->releaseAsset(reused);
+}
+
+// Readers look up the newest handle while a writer keeps releasing it and reusing the slot. A reader must get the asset made for its handle or nothing
+TEST_CASE(concurrentReuseNeverHandsOutAnotherAsset) {
+    auto *table = assetTable<Tagged>();
+
+    std::atomic<AssetHandle<Tagged>> current;
+    std::atomic<bool>                stop{false};
+    std::atomic<uint64_t>            mismatches{0};
+    std::atomic<uint64_t>            hits{0};
+
+    const auto publish = [&] {
+        const auto handle = table->initAsset(std::make_unique<Tagged>());
+        table->peekAsset(handle)->generation.store(handle.generation(), std::memory_order_relaxed);
+        current.store(handle, std::memory_order_release);
+        return handle;
+    };
+    auto handle = publish();
+
+    std::vector<std::jthread> readers;
+    for (int i = 0; i < 4; i++) {
+        readers.emplace_back([&] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                const auto         seen = current.load(std::memory_order_acquire);
+                neuron::EpochGuard guard;
+                if (const Tagged *asset = table->tryGetAsset(seen); asset != nullptr) {
+                    hits.fetch_add(1, std::memory_order_relaxed);
+                    if (asset->generation.load(std::memory_order_relaxed) != seen.generation()) {
+                        mismatches.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < 200'000; i++) {
+        table->releaseAsset(handle);
+        handle = publish();
+        if (i % 1000 == 0) {
+            neuron::test::FakeGl::signalAllFences();
+            collectRetiredAssets();
+        }
+    }
+    stop = true;
+    readers.clear();
+
+    CHECK(mismatches == 0);
+    CHECK(hits > 0);
+    table->releaseAsset(handle);
+}
+
+TEST_CASE(stableIdsFollowReassignment) {
+    auto *table = assetTable<Value>();
+
+    const auto first  = table->initAsset(std::make_unique<Value>(1));
+    const auto second = table->initAsset(std::make_unique<Value>(2));
+
+    table->setStableId(first, 10);
+    table->setStableId(first, 11);
+    CHECK(table->stableId(first) == 11);
+    CHECK(table->findByStableId(11) == first);
+    CHECK(!table->findByStableId(10).isValid());
+
+    // taking the id for another handle takes it away from the first
+    table->setStableId(second, 11);
+    CHECK(table->findByStableId(11) == second);
+    CHECK(table->stableId(first) == 0);
+
+    table->releaseAsset(second);
+    CHECK(!table->findByStableId(11).isValid());
+    table->releaseAsset(first);
+}
+
+int main() {
+    neuron::test::FakeGl::install();
+    const int result = neuron::test::runTests();
+    cleanupAssetTables();
+    return result;
+}
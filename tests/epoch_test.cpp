@@ -0,0 +1,132 @@
+#include "gl_fakes.hpp"
+#include "test.hpp"
+
+#include "neuron/asset/asset.hpp"
+#include "neuron/epoch.hpp"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace neuron::asset;
+
+namespace {
+    std::atomic<int> g_Alive{0};
+
+    // poisons itself on destruction, so a reader that gets to a destroyed asset before its memory is reused notices
+    struct Counted final : Asset {
+        explicit Counted(const int value) : value(value) { g_Alive++; }
+        ~Counted() override {
+            value = -1;
+            g_Alive--;
+        }
+
+        std::atomic<int> value;
+    };
+
+    // The first collect ends the frame the assets were retired in and the second sees its fence signalled, so only pinned readers hold them back
+    void collect() {
+        neuron::test::FakeGl::signalAllFences();
+        collectRetiredAssets();
+        neuron::test::FakeGl::signalAllFences();
+        collectRetiredAssets();
+    }
+} // namespace
+
+TEST_CASE(pinnedReaderKeepsReplacedAssetAlive) {
+    auto *table = assetTable<Counted>();
+
+    const auto handle = table->initAsset(std::make_unique<Counted>(0));
+    const int  before = g_Alive;
+
+    {
+        const auto ref = handle.getFromGlobal();
+        table->replaceAsset(handle, std::make_unique<Counted>(1));
+        collect();
+        CHECK(ref->value == 0);
+        CHECK(g_Alive == before + 1);
+    }
+
+    collect();
+    CHECK(g_Alive == before);
+    CHECK(handle.getFromGlobal()->value == 1);
+    table->releaseAsset(handle);
+    collect();
+}
+
+TEST_CASE(nestedGuardsPinUntilTheOutermostEnds) {
+    auto *table = assetTable<Counted>();
+
+    const auto handle = table->initAsset(std::make_unique<Counted>(0));
+    const int  before = g_Alive;
+
+    {
+        neuron::EpochGuard outer;
+        const Counted     *asset = table->tryGetAsset(handle);
+        {
+            neuron::EpochGuard inner;
+            table->replaceAsset(handle, std::make_unique<Counted>(1));
+        }
+        collect();
+        CHECK(asset->value == 0);
+    }
+
+    collect();
+    CHECK(g_Alive == before);
+    table->releaseAsset(handle);
+    collect();
+}
+
+// Readers keep taking references while a writer replaces the asset as fast as it can and collects in between. Any reader that sees a destroyed asset
+// means it was reclaimed while pinned
+TEST_CASE(concurrentReadersNeverSeeReclaimedAssets) {
+    auto *table = assetTable<Counted>();
+
+    const auto handle = table->initAsset(std::make_unique<Counted>(0));
+    const int  before = g_Alive;
+
+    std::atomic<bool>     stop{false};
+    std::atomic<uint64_t> reclaimed{0};
+    std::atomic<uint64_t> reads{0};
+
+    std::vector<std::jthread> readers;
+    for (int i = 0; i < 8; i++) {
+        readers.emplace_back([&] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                const auto ref   = handle.getFromGlobal();
+                const int  first = ref->value.load(std::memory_order_relaxed);
+                std::this_thread::yield();
+                if (first < 0 || ref->value.load(std::memory_order_relaxed) != first) {
+                    reclaimed.fetch_add(1, std::memory_order_relaxed);
+                }
+                reads.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    for (int i = 1; i <= 20'000; i++) {
+        table->replaceAsset(handle, std::make_unique<Counted>(i));
+        if (i % 10 == 0) {
+            collect();
+        }
+    }
+    stop = true;
+    readers.clear();
+
+    CHECK(reclaimed == 0);
+    CHECK(reads > 0);
+
+    // with every reader gone nothing but the live asset is left
+    collect();
+    CHECK(g_Alive == before);
+    table->releaseAsset(handle);
+    collect();
+}
+
+int main() {
+    neuron::test::FakeGl::install();
+    const int result = neuron::test::runTests();
+    cleanupAssetTables();
+    return result;
+}
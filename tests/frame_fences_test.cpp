@@ -0,0 +1,158 @@
+#include "gl_fakes.hpp"
+#include "test.hpp"
+
+#include "neuron/asset/asset.hpp"
+#include "neuron/frame_fences.hpp"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+using namespace neuron::asset;
+using neuron::test::FakeGl;
+
+namespace {
+    std::atomic<int> g_Alive{0};
+
+    struct Counted final : Asset {
+        explicit Counted(const int value) : value(value) { g_Alive++; }
+        ~Counted() override { g_Alive--; }
+
+        [[nodiscard]] std::size_t gpuBytes() const override { return 100; }
+
+        int value;
+    };
+
+    // ends the frame, which fences it, and returns that fence
+    uint64_t endFrame() {
+        collectRetiredAssets();
+        return FakeGl::fencesCreated();
+    }
+} // namespace
+
+TEST_CASE(completedFrameFollowsSignaledFencesInOrder) {
+    auto &fences = neuron::FrameFences::global();
+    FakeGl::signalAllFences();
+    endFrame();
+
+    const uint64_t first  = fences.recordingFrame();
+    const uint64_t fence1 = endFrame();
+    const uint64_t fence2 = endFrame();
+    endFrame();
+    CHECK(fences.recordingFrame() == first + 3);
+    CHECK(fences.completedFrame() < first);
+
+    // polling never waits, and a later fence isn't looked at before an earlier one signals
+    FakeGl::signalFencesUpTo(fence1);
+    endFrame();
+    CHECK(fences.completedFrame() == first);
+    CHECK(FakeGl::blockingWaits() == 0);
+
+    FakeGl::signalFencesUpTo(fence2);
+    endFrame();
+    CHECK(fences.completedFrame() == first + 1);
+}
+
+TEST_CASE(retiredAssetsWaitForTheFenceOfTheirFrame) {
+    auto *table = assetTable<Counted>();
+    FakeGl::signalAllFences();
+    endFrame();
+    const int before = g_Alive;
+
+    StrongAssetHandle<Counted> first  = table->initShared(std::make_unique<Counted>(1));
+    StrongAssetHandle<Counted> second = table->initShared(std::make_unique<Counted>(2));
+
+    first.reset();
+    const uint64_t firstFence = endFrame();
+    second.reset();
+    const uint64_t secondFence = endFrame();
+    CHECK(table->memoryStats().pendingCount == 2);
+    CHECK(table->memoryStats().pendingGpuBytes == 200);
+
+    // nothing is reader pinned, only the GPU holds them back
+    endFrame();
+    CHECK(g_Alive == before + 2);
+
+    FakeGl::signalFencesUpTo(firstFence);
+    endFrame();
+    CHECK(g_Alive == before + 1);
+    CHECK(table->memoryStats().pendingCount == 1);
+
+    FakeGl::signalFencesUpTo(secondFence);
+    endFrame();
+    CHECK(g_Alive == before);
+    CHECK(table->memoryStats().pendingGpuBytes == 0);
+}
+
+TEST_CASE(strongHandlesReleaseWithTheLastReference) {
+    auto *table = assetTable<Counted>();
+
+    StrongAssetHandle<Counted> strong = table->initShared(std::make_unique<Counted>(1));
+    const auto                 weak   = strong.weak();
+    {
+        const StrongAssetHandle<Counted> copy = strong;
+        CHECK(table->refCount(strong) == 2);
+        CHECK(weak.lock().getFromGlobal()->value == 1);
+    }
+    CHECK(table->refCount(strong) == 1);
+
+    const AssetHandle<Counted> plain = strong;
+    strong.reset();
+    CHECK(weak.expired());
+    CHECK(!weak.lock());
+    CHECK(table->tryGetAsset(plain) == nullptr);
+
+    FakeGl::signalAllFences();
+    endFrame();
+    FakeGl::signalAllFences();
+    endFrame();
+}
+
+// Frames run three ahead of the GPU for long enough that the fence queue and the frame numbers go around many times, while other assets churn through
+// the table's slots. A handle that was never released keeps working and the stale handles of reused slots keep failing
+TEST_CASE(handlesStayValidAcrossManyFramesInFlight) {
+    auto *table = assetTable<Counted>();
+    FakeGl::signalAllFences();
+    endFrame();
+    const int before = g_Alive;
+
+    StrongAssetHandle<Counted>        held = table->initShared(std::make_unique<Counted>(-1));
+    std::vector<AssetHandle<Counted>> stale;
+    std::vector<uint64_t>             inFlight;
+
+    for (int frame = 0; frame < 1000; frame++) {
+        StrongAssetHandle<Counted> churn = table->initShared(std::make_unique<Counted>(frame));
+        if (frame % 100 == 0) {
+            stale.push_back(churn);
+        }
+        churn.reset();
+
+        inFlight.push_back(endFrame());
+        if (inFlight.size() > 3) {
+            FakeGl::signalFencesUpTo(inFlight[inFlight.size() - 4]);
+        }
+
+        REQUIRE(held.getFromGlobal()->value == -1);
+        REQUIRE(g_Alive <= before + 1 + 5);
+    }
+
+    CHECK(table->refCount(held) == 1);
+    for (const auto handle : stale) {
+        CHECK(table->tryGetAsset(handle) == nullptr);
+        CHECK(table->refCount(handle) == 0);
+    }
+
+    held.reset();
+    FakeGl::signalAllFences();
+    endFrame();
+    FakeGl::signalAllFences();
+    endFrame();
+    CHECK(g_Alive == before);
+}
+
+int main() {
+    FakeGl::install();
+    const int result = neuron::test::runTests();
+    cleanupAssetTables();
+    return result;
+}
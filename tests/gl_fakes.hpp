@@ -0,0 +1,145 @@
+#pragma once
+
+#include <glad/gl.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/*
+ * Stand-ins for the GL calls of the GPU-free parts of the engine, installed through glad's function pointers so the code under test runs unchanged.
+ * Fences signal when the test says so, buffers are plain memory that "mapping" hands out directly. Textures have no contents, framebuffers are always
+ * complete and remember their draw buffers. Timestamp queries never become available and memory barriers are only recorded.
+ */
+
+namespace neuron::test {
+    class FakeGl {
+      public:
+        // fences are numbered in creation order, starting at 1
+        static void signalFencesUpTo(const uint64_t fence) { state().signaled = fence; }
+
+        static void signalAllFences() { state().signaled = state().fences; }
+
+        [[nodiscard]] static uint64_t fencesCreated() { return state().fences; }
+
+        [[nodiscard]] static uint64_t fencesDeleted() { return state().deleted; }
+
+        // waits with a timeout block on nothing, they see whatever the test has signaled
+        [[nodiscard]] static uint64_t blockingWaits() { return state().blockingWaits; }
+
+        // the memory behind a fake buffer, for checking what was written through a mapping
+        [[nodiscard]] static std::vector<std::byte> &bufferMemory(const GLuint buffer) { return state().buffers.at(buffer - 1); }
+
+        // the last glNamedFramebufferDrawBuffers of a fake framebuffer
+        [[nodiscard]] static const std::vector<GLenum> &drawBuffers(const GLuint framebuffer) { return state().drawBuffers.at(framebuffer - 1); }
+
+        [[nodiscard]] static uint64_t texturesDeleted() { return state().texturesDeleted; }
+
+        [[nodiscard]] static uint64_t framebuffersDeleted() { return state().framebuffersDeleted; }
+
+        // every glMemoryBarrier so far, oldest first
+        [[nodiscard]] static std::vector<GLbitfield> &memoryBarriers() { return state().memoryBarriers; }
+
+        static void install() {
+            state() = {};
+
+            glad_glFenceSync = [](GLenum, GLbitfield) { return reinterpret_cast<GLsync>(static_cast<uintptr_t>(++state().fences)); };
+            glad_glClientWaitSync = [](GLsync sync, GLbitfield, const GLuint64 timeout) -> GLenum {
+                if (timeout > 0) {
+                    state().blockingWaits++;
+                }
+                return reinterpret_cast<uintptr_t>(sync) <= state().signaled ? GL_ALREADY_SIGNALED : GL_TIMEOUT_EXPIRED;
+            };
+            glad_glDeleteSync = [](GLsync) { state().deleted++; };
+            glad_glFinish     = [] { signalAllFences(); };
+
+            glad_glCreateBuffers = [](const GLsizei count, GLuint *buffers) {
+                for (GLsizei i = 0; i < count; i++) {
+                    state().buffers.emplace_back();
+                    buffers[i] = static_cast<GLuint>(state().buffers.size());
+                }
+            };
+            glad_glNamedBufferStorage = [](const GLuint buffer, const GLsizeiptr size, const void *, GLbitfield) { bufferMemory(buffer).resize(static_cast<std::size_t>(size)); };
+            glad_glNamedBufferData = [](const GLuint buffer, const GLsizeiptr size, const void *data, GLenum) {
+                bufferMemory(buffer).resize(static_cast<std::size_t>(size));
+                if (data != nullptr) {
+                    std::memcpy(bufferMemory(buffer).data(), data, static_cast<std::size_t>(size));
+                }
+            };
+            glad_glMapNamedBufferRange = [](const GLuint buffer, const GLintptr offset, GLsizeiptr, GLbitfield) -> void * { return bufferMemory(buffer).data() + offset; };
+            glad_glUnmapNamedBuffer    = [](GLuint) -> GLboolean { return GL_TRUE; };
+            glad_glDeleteBuffers       = [](GLsizei, const GLuint *) {};
+
+            glad_glCreateTextures = [](GLenum, const GLsizei count, GLuint *textures) {
+                for (GLsizei i = 0; i < count; i++) {
+                    textures[i] = ++state().textures;
+                }
+            };
+            glad_glTextureStorage2D = [](GLuint, GLsizei, GLenum, GLsizei, GLsizei) {};
+            glad_glDeleteTextures   = [](const GLsizei count, const GLuint *) { state().texturesDeleted += static_cast<uint64_t>(count); };
+
+            glad_glCreateFramebuffers = [](const GLsizei count, GLuint *framebuffers) {
+                for (GLsizei i = 0; i < count; i++) {
+                    state().drawBuffers.emplace_back();
+                    framebuffers[i] = static_cast<GLuint>(state().drawBuffers.size());
+                }
+            };
+            glad_glNamedFramebufferTexture     = [](GLuint, GLenum, GLuint, GLint) {};
+            glad_glNamedFramebufferDrawBuffers = [](const GLuint framebuffer, const GLsizei count, const GLenum *buffers) {
+                state().drawBuffers.at(framebuffer - 1).assign(buffers, buffers + count);
+            };
+            glad_glCheckNamedFramebufferStatus = [](GLuint, GLenum) -> GLenum { return GL_FRAMEBUFFER_COMPLETE; };
+            glad_glDeleteFramebuffers          = [](const GLsizei count, const GLuint *) { state().framebuffersDeleted += static_cast<uint64_t>(count); };
+            glad_glBindFramebuffer             = [](GLenum, GLuint) {};
+            glad_glViewport                    = [](GLint, GLint, GLsizei, GLsizei) {};
+
+            glad_glCreateVertexArrays = [](const GLsizei count, GLuint *vertexArrays) {
+                for (GLsizei i = 0; i < count; i++) {
+                    vertexArrays[i] = ++state().objects;
+                }
+            };
+            glad_glDeleteVertexArrays       = [](GLsizei, const GLuint *) {};
+            glad_glBindVertexArray          = [](GLuint) {};
+            glad_glVertexArrayVertexBuffer  = [](GLuint, GLuint, GLuint, GLintptr, GLsizei) {};
+            glad_glVertexArrayElementBuffer = [](GLuint, GLuint) {};
+            glad_glVertexArrayAttribBinding = [](GLuint, GLuint, GLuint) {};
+            glad_glVertexArrayAttribFormat  = [](GLuint, GLuint, GLint, GLenum, GLboolean, GLuint) {};
+            glad_glEnableVertexArrayAttrib  = [](GLuint, GLuint) {};
+
+            glad_glCreateQueries = [](GLenum, const GLsizei count, GLuint *queries) {
+                for (GLsizei i = 0; i < count; i++) {
+                    queries[i] = ++state().objects;
+                }
+            };
+            glad_glDeleteQueries       = [](GLsizei, const GLuint *) {};
+            glad_glQueryCounter        = [](GLuint, GLenum) {};
+            glad_glGetQueryObjectiv    = [](GLuint, GLenum, GLint *value) { *value = 0; };
+            glad_glGetQueryObjectui64v = [](GLuint, GLenum, GLuint64 *value) { *value = 0; };
+
+            glad_glMemoryBarrier = [](const GLbitfield barriers) { state().memoryBarriers.push_back(barriers); };
+        }
+
+      private:
+        struct State {
+            uint64_t fences        = 0;
+            uint64_t signaled      = 0;
+            uint64_t deleted       = 0;
+            uint64_t blockingWaits = 0;
+
+            GLuint   textures            = 0;
+            GLuint   objects             = 0; // vertex arrays and queries
+            uint64_t texturesDeleted     = 0;
+            uint64_t framebuffersDeleted = 0;
+
+            std::vector<std::vector<std::byte>> buffers;
+            std::vector<std::vector<GLenum>>    drawBuffers;
+            std::vector<GLbitfield>             memoryBarriers;
+        };
+
+        static State &state() {
+            static State state;
+            return state;
+        }
+    };
+} // namespace neuron::test
@@ -0,0 +1,78 @@
+#include "neuron/asset/import_cache.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+
+/*
+ * Imports a model with assimp a few times and loads it from a warm import cache as often, reporting the best time of each. Run it from the run
+ * directory or pass the model: `import_cache_bench [model] [runs]`
+ */
+
+using namespace neuron;
+
+namespace {
+    double elapsedMs(const std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::size_t totalBytes(const std::vector<Mesh::Data> &meshes) {
+        std::size_t bytes = 0;
+        for (const auto &mesh : meshes) {
+            bytes += mesh.sizeInBytes();
+        }
+        return bytes;
+    }
+} // namespace
+
+int main(const int argc, char **argv) {
+    const std::filesystem::path model = argc > 1 ? argv[1] : "res/test.glb";
+    const int                   runs  = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 10;
+    if (!std::filesystem::exists(model)) {
+        std::fprintf(stderr, "%s does not exist\n", model.string().c_str());
+        return 1;
+    }
+
+    const auto         directory = std::filesystem::temp_directory_path() / "neuron_import_cache_bench";
+    asset::ImportCache cache({.directory = directory});
+    cache.clear();
+
+    double      importMs = 1e30;
+    std::size_t bytes    = 0;
+    for (int run = 0; run < runs; run++) {
+        const auto start  = std::chrono::steady_clock::now();
+        const auto meshes = Mesh::Data::loadWithAssimp(model);
+        importMs          = std::min(importMs, elapsedMs(start));
+        bytes             = totalBytes(meshes);
+    }
+
+    // the first load misses and writes the entry, everything after maps it
+    auto       start  = std::chrono::steady_clock::now();
+    const auto filled = cache.loadMeshes(model);
+    const auto coldMs = elapsedMs(start);
+
+    double warmMs = 1e30;
+    for (int run = 0; run < runs; run++) {
+        start             = std::chrono::steady_clock::now();
+        const auto meshes = cache.loadMeshes(model);
+        warmMs            = std::min(warmMs, elapsedMs(start));
+        if (totalBytes(meshes) != totalBytes(filled)) {
+            std::fprintf(stderr, "the cached meshes differ from the imported ones\n");
+            return 1;
+        }
+    }
+
+    const auto stats = cache.stats();
+    std::printf("%s: %zu meshes, %.1f KiB of vertex and index data, %.1f KiB cache entry\n", model.string().c_str(), filled.size(),
+                static_cast<double>(bytes) / 1024.0, static_cast<double>(std::filesystem::file_size(cache.entryPath(cache.key(model)))) / 1024.0);
+    std::printf("assimp import:   %8.2f ms\n", importMs);
+    std::printf("cold cache load: %8.2f ms (import and write)\n", coldMs);
+    std::printf("warm cache load: %8.2f ms (%.1fx faster than importing, %llu hits, %llu misses)\n", warmMs, importMs / warmMs,
+                static_cast<unsigned long long>(stats.hits), static_cast<unsigned long long>(stats.misses));
+
+    cache.clear();
+    std::filesystem::remove_all(directory);
+    return 0;
+}
@@ -0,0 +1,280 @@
+#include "gl_fakes.hpp"
+#include "test.hpp"
+
+#include "neuron/render/render_graph.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace neuron;
+using namespace neuron::render;
+using neuron::test::FakeGl;
+
+namespace neuron::render {
+    struct RenderGraphTest {
+        static std::vector<uint32_t> schedule(const std::vector<bool> &kept, const std::vector<std::vector<uint32_t>> &producers,
+                                              const std::vector<std::vector<uint32_t>> &before) {
+            return RenderGraph::schedule(kept, producers, before);
+        }
+    };
+} // namespace neuron::render
+
+namespace {
+    constexpr RenderTargetDesc kColor{.width = 64, .height = 64};
+
+    // a graph whose passes note their names as they run
+    struct Frame {
+        RenderTargetPool         pool;
+        RenderGraph              graph{pool};
+        std::vector<std::string> ran;
+
+        Frame() { pool.beginFrame(); }
+
+        void pass(const std::string &name, const RenderGraph::Setup &setup, const RenderGraph::Execute &execute = {}) {
+            graph.addPass(name, setup, [this, name, execute](const RenderGraph::PassContext &context) {
+                ran.push_back(name);
+                if (execute) {
+                    execute(context);
+                }
+            });
+        }
+
+        [[nodiscard]] bool before(const std::string &first, const std::string &second) const {
+            const auto a = std::ranges::find(ran, first);
+            const auto b = std::ranges::find(ran, second);
+            return a != ran.end() && b != ran.end() && a < b;
+        }
+    };
+
+    std::shared_ptr<Texture> texture() {
+        return Texture::createStorage2d(kColor.width, kColor.height, kColor.format, 1);
+    }
+
+    std::shared_ptr<Buffer> buffer() {
+        return std::make_shared<Buffer>(256, nullptr, Buffer::Storage{0});
+    }
+} // namespace
+
+TEST_CASE(passesNothingReadsAreCulledWithTheirTransients) {
+    Frame      frame;
+    const auto output = frame.graph.importTexture("Output", texture());
+
+    frame.pass("Unread", [](RenderGraph::PassBuilder &builder) {
+        const auto target = builder.create("Unread", kColor);
+        builder.write(target, ResourceUsage::Attachment);
+    });
+    frame.pass("Output", [output](RenderGraph::PassBuilder &builder) { builder.write(output, ResourceUsage::Attachment); });
+    frame.pass("Side Effect", [](RenderGraph::PassBuilder &builder) { builder.sideEffect(); });
+    frame.graph.execute();
+
+    CHECK((frame.ran == std::vector<std::string>{"Output", "Side Effect"}));
+    CHECK(frame.graph.stats().passes == 3);
+    CHECK(frame.graph.stats().culled == 1);
+    CHECK(frame.graph.stats().transients == 0);
+    CHECK(frame.pool.stats().acquired == 0);
+}
+
+// Each graph is built so that, without the dependency under test, the scheduler would rather run the later declared pass first because its input was
+// produced last
+TEST_CASE(passesRunAfterTheirDependencies) {
+    {
+        Frame      frame;
+        const auto output = frame.graph.importTexture("Output", texture());
+        auto       color  = RenderGraph::kNoResource;
+        frame.pass("Write", [&color](RenderGraph::PassBuilder &builder) {
+            color = builder.create("Color", kColor);
+            builder.write(color, ResourceUsage::Attachment);
+        });
+        frame.pass("Read", [&color, output](RenderGraph::PassBuilder &builder) {
+            builder.read(color, ResourceUsage::Sampled);
+            builder.write(output, ResourceUsage::Attachment);
+        });
+        frame.graph.execute();
+        CHECK(frame.before("Write", "Read"));
+    }
+
+    // write after read
+    {
+        Frame      frame;
+        const auto shared = frame.graph.importTexture("Shared", texture());
+        const auto other  = frame.graph.importBuffer("Other", buffer());
+        auto       color  = RenderGraph::kNoResource;
+        frame.pass("Produce", [&color](RenderGraph::PassBuilder &builder) {
+            color = builder.create("Color", kColor);
+            builder.write(color, ResourceUsage::Attachment);
+        });
+        frame.pass("Read Shared", [shared, other](RenderGraph::PassBuilder &builder) {
+            builder.read(shared, ResourceUsage::Sampled);
+            builder.write(other, ResourceUsage::Storage);
+        });
+        frame.pass("Overwrite Shared", [&color, shared](RenderGraph::PassBuilder &builder) {
+            builder.read(color, ResourceUsage::Sampled);
+            builder.write(shared, ResourceUsage::Attachment);
+        });
+        frame.graph.execute();
+        CHECK(frame.ran.size() == 3);
+        CHECK(frame.before("Read Shared", "Overwrite Shared"));
+    }
+
+    // write after write
+    {
+        Frame      frame;
+        const auto shared = frame.graph.importTexture("Shared", texture());
+        auto       color  = RenderGraph::kNoResource;
+        frame.pass("Produce", [&color](RenderGraph::PassBuilder &builder) {
+            color = builder.create("Color", kColor);
+            builder.write(color, ResourceUsage::Attachment);
+        });
+        frame.pass("Clear Shared", [shared](RenderGraph::PassBuilder &builder) { builder.write(shared, ResourceUsage::Transfer); });
+        frame.pass("Draw Shared", [&color, shared](RenderGraph::PassBuilder &builder) {
+            builder.read(color, ResourceUsage::Sampled);
+            builder.write(shared, ResourceUsage::Attachment);
+        });
+        frame.graph.execute();
+        CHECK(frame.ran.size() == 3);
+        CHECK(frame.before("Clear Shared", "Draw Shared"));
+    }
+}
+
+// The first transient is done with once its reader ran, which the scheduler moves up to before the second one is written
+TEST_CASE(laterTransientsReuseReleasedTargets) {
+    Frame      frame;
+    const auto output = frame.graph.importTexture("Output", texture());
+
+    auto           first         = RenderGraph::kNoResource;
+    auto           second        = RenderGraph::kNoResource;
+    const Texture *firstTexture  = nullptr;
+    const Texture *secondTexture = nullptr;
+    frame.pass(
+        "Write First",
+        [&first](RenderGraph::PassBuilder &builder) {
+            first = builder.create("First", kColor);
+            builder.write(first, ResourceUsage::Attachment);
+        },
+        [&](const RenderGraph::PassContext &context) { firstTexture = context.texture(first).get(); });
+    frame.pass(
+        "Write Second",
+        [&second](RenderGraph::PassBuilder &builder) {
+            second = builder.create("Second", kColor);
+            builder.write(second, ResourceUsage::Attachment);
+        },
+        [&](const RenderGraph::PassContext &context) { secondTexture = context.texture(second).get(); });
+    frame.pass("Read First", [&first, output](RenderGraph::PassBuilder &builder) {
+        builder.read(first, ResourceUsage::Sampled);
+        builder.write(output, ResourceUsage::Attachment);
+    });
+    frame.pass("Read Second", [&second, output](RenderGraph::PassBuilder &builder) {
+        builder.read(second, ResourceUsage::Sampled);
+        builder.write(output, ResourceUsage::Attachment);
+    });
+    frame.graph.execute();
+
+    CHECK((frame.ran == std::vector<std::string>{"Write First", "Read First", "Write Second", "Read Second"}));
+    CHECK(frame.graph.stats().transients == 2);
+    REQUIRE(firstTexture != nullptr);
+    CHECK(secondTexture == firstTexture);
+    CHECK(frame.pool.stats().created == 1);
+    CHECK(frame.pool.stats().aliased == 1);
+}
+
+TEST_CASE(barriersFollowOnlyIncoherentWrites) {
+    Frame      frame;
+    const auto output = frame.graph.importTexture("Output", texture());
+    const auto data   = frame.graph.importBuffer("Data", buffer());
+    auto      &issued = FakeGl::memoryBarriers();
+    issued.clear();
+
+    std::vector<std::size_t> barriersBefore;
+    const auto               note = [&](const RenderGraph::PassContext &) { barriersBefore.push_back(issued.size()); };
+
+    auto color  = RenderGraph::kNoResource;
+    auto stored = RenderGraph::kNoResource;
+    frame.pass(
+        "Render",
+        [&color](RenderGraph::PassBuilder &builder) {
+            color = builder.create("Color", kColor);
+            builder.write(color, ResourceUsage::Attachment);
+        },
+        note);
+    frame.pass(
+        "Sample",
+        [&color, data](RenderGraph::PassBuilder &builder) {
+            builder.read(color, ResourceUsage::Sampled);
+            builder.write(data, ResourceUsage::Storage);
+        },
+        note);
+    frame.pass(
+        "Image Store",
+        [&stored, data](RenderGraph::PassBuilder &builder) {
+            builder.read(data, ResourceUsage::Uniform);
+            stored = builder.create("Stored", kColor);
+            builder.write(stored, ResourceUsage::Image);
+        },
+        note);
+    frame.pass(
+        "Sample Stored",
+        [&stored, output](RenderGraph::PassBuilder &builder) {
+            builder.read(stored, ResourceUsage::Sampled);
+            builder.write(output, ResourceUsage::Attachment);
+        },
+        note);
+    frame.graph.execute();
+
+    // an attachment write is coherent for the sampler, the storage and image writes each need one before their reader
+    CHECK((barriersBefore == std::vector<std::size_t>{0, 0, 1, 2}));
+    REQUIRE(issued.size() == 2);
+    CHECK(issued[0] == GL_UNIFORM_BARRIER_BIT);
+    CHECK(issued[1] == GL_TEXTURE_FETCH_BARRIER_BIT);
+    CHECK(frame.graph.stats().barriers == 2);
+
+    // whatever the writes weren't covered for yet is flushed before the next frame
+    frame.pool.beginFrame();
+    frame.graph.execute();
+    REQUIRE(issued.size() == 3);
+    CHECK((issued[2] & GL_SHADER_STORAGE_BARRIER_BIT) != 0);
+    CHECK((issued[2] & GL_TEXTURE_FETCH_BARRIER_BIT) == 0);
+}
+
+TEST_CASE(readingATransientBeforeItsWrittenThrows) {
+    Frame      frame;
+    const auto output = frame.graph.importTexture("Output", texture());
+
+    auto color = RenderGraph::kNoResource;
+    frame.pass("Read", [&color, output](RenderGraph::PassBuilder &builder) {
+        color = builder.create("Color", kColor);
+        builder.read(color, ResourceUsage::Sampled);
+        builder.write(output, ResourceUsage::Attachment);
+    });
+
+    bool threw = false;
+    try {
+        frame.graph.execute();
+    } catch (const std::logic_error &) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+TEST_CASE(unorderablePassesThrow) {
+    // 1 and 2 wait on each other, 0 is free and 3 is culled
+    const std::vector<bool>                  kept      = {true, true, true, false};
+    const std::vector<std::vector<uint32_t>> producers = {{}, {2}, {}, {}};
+    const std::vector<std::vector<uint32_t>> before    = {{}, {}, {1}, {}};
+    CHECK((RenderGraphTest::schedule(kept, producers, {{}, {}, {}, {}}) == std::vector<uint32_t>{0, 2, 1}));
+
+    bool threw = false;
+    try {
+        (void)RenderGraphTest::schedule(kept, producers, before);
+    } catch (const std::logic_error &) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+int main() {
+    FakeGl::install();
+    return neuron::test::runTests();
+}
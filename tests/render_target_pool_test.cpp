@@ -0,0 +1,136 @@
+#include "gl_fakes.hpp"
+#include "test.hpp"
+
+#include "neuron/render/render_target_pool.hpp"
+
+#include <array>
+#include <stdexcept>
+#include <vector>
+
+using namespace neuron;
+using namespace neuron::render;
+using neuron::test::FakeGl;
+
+TEST_CASE(nullColorSlotsKeepTheLaterOutputsOnTheirAttachments) {
+    RenderTargetPool pool;
+    pool.beginFrame();
+
+    const auto &albedo   = pool.acquire({.width = 64, .height = 64});
+    const auto &emissive = pool.acquire({.width = 64, .height = 64});
+
+    const std::array<const RenderTargetPool::Target *, 3> colors = {&albedo, nullptr, &emissive};
+    const Framebuffer                                     &framebuffer = pool.framebuffer(colors);
+    CHECK((FakeGl::drawBuffers(framebuffer.handle()) == std::vector<GLenum>{GL_COLOR_ATTACHMENT0, GL_NONE, GL_COLOR_ATTACHMENT2}));
+
+    // the same attachments without the gap are another framebuffer
+    const std::array<const RenderTargetPool::Target *, 2> packed = {&albedo, &emissive};
+    const Framebuffer                                     &other  = pool.framebuffer(packed);
+    CHECK(&other != &framebuffer);
+    CHECK((FakeGl::drawBuffers(other.handle()) == std::vector<GLenum>{GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1}));
+    CHECK(&pool.framebuffer(colors) == &framebuffer);
+}
+
+namespace {
+    constexpr RenderTargetDesc kColor{.width = 64, .height = 64};
+    constexpr RenderTargetDesc kDepth{.width = 64, .height = 64, .format = Texture::InternalFormat::DEPTH_COMPONENT32F};
+} // namespace
+
+TEST_CASE(targetsAreReusedByDescriptorAcrossFrames) {
+    RenderTargetPool pool;
+    pool.beginFrame();
+    const auto    &color   = pool.acquire(kColor);
+    const Texture *texture = color.texture.get();
+    (void)pool.acquire(kDepth);
+    CHECK(pool.stats().created == 2);
+
+    pool.beginFrame();
+    CHECK(pool.acquire(kColor).texture.get() == texture);
+    CHECK(pool.stats().created == 0);
+
+    // nothing with this size is free, two of the same in one frame are two targets
+    CHECK(pool.acquire(kColor).texture.get() != texture);
+    CHECK(pool.acquire({.width = 32, .height = 32}).texture.get() != texture);
+    CHECK(pool.stats().created == 2);
+    CHECK(pool.stats().targets == 4);
+}
+
+TEST_CASE(releasedTargetsAliasWithinTheFrame) {
+    RenderTargetPool pool;
+    pool.beginFrame();
+
+    const auto &first = pool.acquire(kColor);
+    pool.release(first);
+    const auto &second = pool.acquire(kColor);
+    CHECK(&second == &first);
+    CHECK(pool.stats().aliased == 1);
+    CHECK(pool.stats().created == 1);
+
+    // two acquisitions' worth asked for, one target's worth held
+    const uint64_t bytes = kColor.byteSize();
+    CHECK(bytes == 64 * 64 * 4);
+    CHECK(pool.stats().requestedBytes == 2 * bytes);
+    CHECK(pool.stats().peakBytes == bytes);
+    CHECK(pool.stats().pooledBytes == bytes);
+    CHECK(pool.stats().savings() == 0.5f);
+
+    bool threw = false;
+    try {
+        pool.release(first);
+        pool.release(first);
+    } catch (const std::logic_error &) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    // reuse from an earlier frame isn't aliasing
+    pool.beginFrame();
+    (void)pool.acquire(kColor);
+    CHECK(pool.stats().aliased == 0);
+    CHECK(pool.stats().requestedBytes == bytes);
+}
+
+TEST_CASE(idleTargetsAreDeletedWithTheirFramebuffers) {
+    RenderTargetPool pool({.maxIdleFrames = 2});
+    const uint64_t   texturesDeleted     = FakeGl::texturesDeleted();
+    const uint64_t   framebuffersDeleted = FakeGl::framebuffersDeleted();
+
+    // the color target is only used in the first frame, but a framebuffer with it and the depth target keeps being asked for
+    pool.beginFrame();
+    const auto &color = pool.acquire(kColor);
+    const auto &depth = pool.acquire(kDepth);
+
+    const std::array<const RenderTargetPool::Target *, 1> colors = {&color};
+    const Framebuffer                                    &both   = pool.framebuffer(colors, &depth);
+    (void)pool.framebuffer({}, &depth);
+    CHECK(pool.stats().framebuffers == 2);
+
+    for (int frame = 0; frame < 2; frame++) {
+        pool.beginFrame();
+        CHECK(&pool.acquire(kDepth) == &depth);
+        CHECK(&pool.framebuffer(colors, &depth) == &both);
+        (void)pool.framebuffer({}, &depth);
+        CHECK(pool.stats().targets == 2);
+    }
+
+    pool.beginFrame();
+    CHECK(pool.stats().targets == 1);
+    CHECK(pool.stats().destroyed == 1);
+    CHECK(pool.stats().framebuffers == 1);
+    CHECK(pool.stats().pooledBytes == kDepth.byteSize());
+    CHECK(FakeGl::texturesDeleted() == texturesDeleted + 1);
+    CHECK(FakeGl::framebuffersDeleted() == framebuffersDeleted + 1);
+
+    // and the framebuffers no target went away for go once they're idle themselves
+    for (int frame = 0; frame < 3; frame++) {
+        pool.beginFrame();
+        (void)pool.acquire(kDepth);
+    }
+    CHECK(pool.stats().targets == 1);
+    CHECK(pool.stats().framebuffers == 0);
+    CHECK(FakeGl::framebuffersDeleted() == framebuffersDeleted + 2);
+}
+
+int main() {
+    FakeGl::install();
+    return neuron::test::runTests();
+}
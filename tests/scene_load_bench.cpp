@@ -0,0 +1,74 @@
+#include "neuron/ecs/components.hpp"
+#include "neuron/scene/scene.hpp"
+#include "neuron/scene/serialization.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+
+/*
+ * Saves a scene of 500k entities and loads it back a few times, reporting the best decode and instantiate times next to creating the same entities
+ * one at a time. `scene_load_bench [entities]`
+ */
+
+using namespace neuron;
+
+namespace {
+    double elapsedMs(const std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // a thousand groups of entities with a full transform and bounds, the shape of a typical streamed world
+    void populate(scene::Scene &scene, const int entities) {
+        const int groups = std::max(entities / 500, 1);
+        for (int g = 0; g < groups; g++) {
+            const flecs::entity group = scene.createEntity();
+            group.set<ecs::Position>({{static_cast<float>(g), 0.0f, 0.0f}});
+
+            for (int i = 0; i < entities / groups - 1; i++) {
+                const flecs::entity entity = scene.createEntity(group);
+                entity.set<ecs::Position>({{0.0f, static_cast<float>(i), 0.0f}});
+                entity.set<ecs::Rotation>({glm::quat(1.0f, 0.0f, 0.0f, 0.0f)});
+                entity.set<ecs::Scale>({glm::vec3(1.0f)});
+                entity.set<ecs::Bounds>({{glm::vec3(-0.5f), glm::vec3(0.5f)}});
+            }
+        }
+    }
+} // namespace
+
+int main(const int argc, char **argv) {
+    const int  entities = argc > 1 ? std::atoi(argv[1]) : 500'000;
+    const auto path     = std::filesystem::temp_directory_path() / "neuron_scene_load_bench.nscn";
+
+    double createMs = 0.0;
+    {
+        scene::Scene scene(0);
+        const auto   start = std::chrono::steady_clock::now();
+        populate(scene, entities);
+        createMs = elapsedMs(start);
+        scene::saveScene(scene, path);
+    }
+
+    double decodeMs      = 1e30;
+    double instantiateMs = 1e30;
+    for (int run = 0; run < 5; run++) {
+        auto                    start = std::chrono::steady_clock::now();
+        const scene::SceneData data  = scene::SceneData::decode(path);
+        decodeMs                      = std::min(decodeMs, elapsedMs(start));
+
+        scene::Scene scene(0);
+        start         = std::chrono::steady_clock::now();
+        data.instantiate(scene, scene.root());
+        instantiateMs = std::min(instantiateMs, elapsedMs(start));
+    }
+
+    std::printf("%d entities, %.1f MiB file\n", entities, static_cast<double>(std::filesystem::file_size(path)) / (1024.0 * 1024.0));
+    std::printf("one at a time: %8.1f ms\n", createMs);
+    std::printf("decode:        %8.1f ms\n", decodeMs);
+    std::printf("instantiate:   %8.1f ms (%.1fx faster than one at a time)\n", instantiateMs, createMs / instantiateMs);
+
+    std::filesystem::remove(path);
+    return 0;
+}
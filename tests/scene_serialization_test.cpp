@@ -0,0 +1,198 @@
+#include "test.hpp"
+
+#include "neuron/ecs/components.hpp"
+#include "neuron/scene/scene.hpp"
+#include "neuron/scene/serialization.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace neuron;
+
+namespace {
+    std::filesystem::path tempPath(const std::string &name) {
+        return std::filesystem::temp_directory_path() / ("neuron_" + name + ".nscn");
+    }
+
+    void writeFile(const std::filesystem::path &path, const std::string &bytes) {
+        std::ofstream(path, std::ios::binary).write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    std::string header(const uint64_t entityCount, const uint32_t formatCount, const uint32_t blockCount) {
+        std::string bytes = "NSCN";
+        bytes.append(reinterpret_cast<const char *>(&scene::kSceneFormatVersion), sizeof(uint32_t));
+        bytes.append(reinterpret_cast<const char *>(&entityCount), sizeof(entityCount));
+        bytes.append(reinterpret_cast<const char *>(&formatCount), sizeof(formatCount));
+        bytes.append(reinterpret_cast<const char *>(&blockCount), sizeof(blockCount));
+        return bytes;
+    }
+
+    // Everything that gets saved about an entity and its children, with children in a stable order. Entity ids differ between worlds, so camera
+    // layer references are described by what they point at
+    std::string describe(const flecs::entity entity) {
+        std::ostringstream out;
+        if (const auto *position = entity.get<ecs::Position>()) {
+            out << "position " << position->position.x << ' ' << position->position.y << ' ' << position->position.z << ';';
+        }
+        if (const auto *rotation = entity.get<ecs::Rotation>()) {
+            out << "rotation " << rotation->rotation.w << ' ' << rotation->rotation.x << ' ' << rotation->rotation.y << ' ' << rotation->rotation.z << ';';
+        }
+        if (const auto *scale = entity.get<ecs::Scale>()) {
+            out << "scale " << scale->scale.x << ' ' << scale->scale.y << ' ' << scale->scale.z << ';';
+        }
+        if (const auto *visibility = entity.get<ecs::Visibility>()) {
+            out << "visibility " << visibility->visible << visibility->onlySelf << ';';
+        }
+        if (entity.has<ecs::MeshBounds>()) {
+            out << "mesh bounds;";
+        } else if (const auto *bounds = entity.get<ecs::Bounds>()) {
+            out << "bounds " << bounds->local.min.x << ' ' << bounds->local.max.y << ';';
+        }
+        if (const auto *projection = entity.get<ecs::PerspectiveCameraProjection>()) {
+            out << "perspective " << projection->yFov << ' ' << projection->aspectRatio << ' ' << projection->zNear << ' ' << projection->zFar << ';';
+        }
+        if (const auto *renderer = entity.get<ecs::MeshRenderer>()) {
+            out << "renderer " << renderer->mesh.isValid() << renderer->shader.isValid() << ' ' << renderer->material << ';';
+        }
+        if (entity.has<ecs::CameraLayer>()) {
+            out << "camera layer;";
+        }
+        if (const auto *render = entity.get<ecs::RenderOnCameraLayer>()) {
+            out << "on layer under a camera " << (render->cameraLayer.has<ecs::CameraLayer>() && render->cameraLayer.parent().has<ecs::Camera>()) << ';';
+        }
+        if (entity.has<ecs::GlobalTransformMatrix>()) {
+            out << "global transform;";
+        }
+
+        std::vector<std::string> children;
+        entity.children([&](const flecs::entity child) { children.push_back(describe(child)); });
+        std::ranges::sort(children);
+        for (const auto &child : children) {
+            out << '{' << child << '}';
+        }
+        return out.str();
+    }
+
+    void buildScene(scene::Scene &scene) {
+        const flecs::entity group = scene.createEntity();
+        group.set<ecs::Position>({{1.0f, 2.0f, 3.0f}});
+        group.set<ecs::Visibility>({false, true});
+
+        const flecs::entity child = scene.createEntity(group);
+        child.set<ecs::Position>({{4.0f, 5.0f, 6.0f}});
+        child.set<ecs::Scale>({{2.0f, 2.0f, 2.0f}});
+        child.set<ecs::Bounds>({{glm::vec3(-1.0f), glm::vec3(1.0f)}});
+
+        // no transform of its own, only a grandchild with one
+        const flecs::entity empty = scene.createEntity(child);
+        scene.createEntity(empty).set<ecs::Rotation>({glm::quat(0.5f, 0.5f, 0.5f, 0.5f)});
+
+        const flecs::entity camera = scene.createEntity();
+        camera.set<ecs::Position>({{0.0f, 0.0f, 10.0f}});
+        camera.set<ecs::PerspectiveCameraProjection>({1.2f, 1.5f, 0.1f, 100.0f});
+
+        const flecs::entity layer = scene.createEntity(camera);
+        layer.set<ecs::CameraLayer>({});
+
+        // without assets, so the handles are saved as "none"
+        const flecs::entity renderer = scene.createEntity(child);
+        renderer.set<ecs::MeshRenderer>({{}, {}, 7});
+        renderer.set<ecs::RenderOnCameraLayer>({layer});
+
+        for (int i = 0; i < 100; i++) {
+            scene.createEntity(group).set<ecs::Position>({{static_cast<float>(i), 0.0f, 0.0f}});
+        }
+    }
+} // namespace
+
+TEST_CASE(roundTripKeepsComponentsAndHierarchy) {
+    const auto path = tempPath("round_trip");
+
+    scene::Scene original(0);
+    buildScene(original);
+    scene::saveScene(original, path);
+
+    scene::Scene loaded(0);
+    scene::loadScene(loaded, path);
+    CHECK(describe(loaded.root()) == describe(original.root()));
+
+    // and saving what was loaded gives the same file
+    const auto again = tempPath("round_trip_again");
+    scene::saveScene(loaded, again);
+    CHECK(std::filesystem::file_size(again) == std::filesystem::file_size(path));
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(again);
+}
+
+TEST_CASE(instantiatingTwiceMakesTwoCopies) {
+    const auto path = tempPath("twice");
+
+    scene::Scene original(0);
+    buildScene(original);
+    scene::saveScene(original, path);
+
+    const scene::SceneData data = scene::SceneData::decode(path);
+
+    scene::Scene loaded(0);
+    const flecs::entity first  = loaded.createEntity();
+    const flecs::entity second = loaded.createEntity();
+    data.instantiate(loaded, first);
+    data.instantiate(loaded, second);
+    CHECK(describe(first) == describe(original.root()));
+    CHECK(describe(second) == describe(original.root()));
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE(rejectsTruncatedFiles) {
+    const auto path = tempPath("truncated");
+
+    scene::Scene original(0);
+    buildScene(original);
+    scene::saveScene(original, path);
+
+    std::ifstream     file(path, std::ios::binary);
+    const std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+
+    for (const std::size_t size : {std::size_t(3), std::size_t(20), bytes.size() / 2, bytes.size() - 1}) {
+        writeFile(path, bytes.substr(0, size));
+        bool threw = false;
+        try {
+            (void)scene::SceneData::decode(path);
+        } catch (const std::runtime_error &) {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE(rejectsCountsTheFileCantHold) {
+    const auto path = tempPath("counts");
+
+    // a few bytes claiming a huge scene must fail before anything is sized by the claim
+    for (const auto &bytes : {header(1ULL << 40, 0, 1), header(1, 0xFFFFFFFF, 0), header(1, 0, 0xFFFFFFFF)}) {
+        writeFile(path, bytes + std::string(64, '\0'));
+        bool threw = false;
+        try {
+            (void)scene::SceneData::decode(path);
+        } catch (const std::runtime_error &) {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+
+    std::filesystem::remove(path);
+}
+
+int main() {
+    return neuron::test::runTests();
+}
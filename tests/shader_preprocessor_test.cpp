@@ -0,0 +1,52 @@
+#include "test.hpp"
+
+#include "neuron/shader_preprocessor.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace neuron;
+
+namespace {
+    const std::filesystem::path g_Directory = std::filesystem::temp_directory_path() / "neuron_shader_preprocessor_test";
+
+    std::filesystem::path writeShader(const std::string &name, const std::string &source) {
+        std::filesystem::create_directories(g_Directory);
+        const auto path = g_Directory / name;
+        std::ofstream(path) << source;
+        return path;
+    }
+
+    const ShaderDefines g_Defines = {{"SHADOWS", ""}, {"LIGHTS", "4"}};
+} // namespace
+
+TEST_CASE(definesFollowTheVersionLine) {
+    const auto path   = writeShader("version.frag", "// lit\n#version 460 core\nvoid main() {}\n");
+    const auto result = ShaderPreprocessor().process(path, g_Defines);
+
+    CHECK(result.source == "// lit\n#version 460 core\n#define SHADOWS\n#define LIGHTS 4\n#line 3 0\nvoid main() {}\n");
+}
+
+TEST_CASE(definesGoFirstWithoutAVersionLine) {
+    const auto path   = writeShader("no_version.frag", "void main() {}\n");
+    const auto result = ShaderPreprocessor().process(path, g_Defines);
+
+    CHECK(result.source == "#define SHADOWS\n#define LIGHTS 4\n#line 1 0\nvoid main() {}\n");
+    CHECK(ShaderPreprocessor().process(path).source == "void main() {}\n");
+}
+
+TEST_CASE(includesExpandOnceWithLineDirectives) {
+    writeShader("common.glsl", "#pragma once\nfloat common() { return 1.0; }\n");
+    const auto path   = writeShader("includes.frag", "#version 460 core\n#include \"common.glsl\"\n#include \"common.glsl\"\nvoid main() {}\n");
+    const auto result = ShaderPreprocessor().process(path);
+
+    CHECK(result.source == "#version 460 core\n#line 2 0\n#line 1 1\n\nfloat common() { return 1.0; }\n#line 3 0\n#line 4 0\nvoid main() {}\n");
+    CHECK(result.files.size() == 2);
+}
+
+int main() {
+    const int result = neuron::test::runTests();
+    std::filesystem::remove_all(g_Directory);
+    return result;
+}
@@ -0,0 +1,190 @@
+#include "gl_fakes.hpp"
+#include "test.hpp"
+
+#include "neuron/frame_fences.hpp"
+#include "neuron/staging_ring.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace neuron;
+using neuron::test::FakeGl;
+
+TEST_CASE(allocationsAreAlignedAndWrittenThroughTheMapping) {
+    StagingRing ring(100);
+
+    const auto first  = ring.allocate(40);
+    const auto second = ring.allocate(40);
+    REQUIRE(first && second);
+    CHECK(first->offset == 0);
+    CHECK(second->offset == 48);
+    CHECK(ring.used() == 88);
+
+    std::memset(second->data, 0xAB, second->size);
+    CHECK(FakeGl::bufferMemory(ring.buffer().handle())[48] == std::byte{0xAB});
+    CHECK(FakeGl::bufferMemory(ring.buffer().handle())[87] == std::byte{0xAB});
+    CHECK(FakeGl::bufferMemory(ring.buffer().handle())[88] == std::byte{0});
+}
+
+// An allocation never straddles the end, it starts over at 0 and the skipped tail counts as used until the block behind it is reclaimed
+TEST_CASE(allocationsWrapAroundInsteadOfStraddlingTheEnd) {
+    StagingRing ring(100);
+
+    const auto first  = ring.allocate(40);
+    const auto second = ring.allocate(40);
+    REQUIRE(first && second);
+    CHECK(!ring.allocate(40));
+
+    ring.release(*first, 5);
+    ring.reclaim(5);
+    CHECK(ring.used() == 48);
+
+    const auto wrapped = ring.allocate(40);
+    REQUIRE(wrapped.has_value());
+    CHECK(wrapped->offset == 0);
+    CHECK(ring.used() == 100);
+    CHECK(!ring.allocate(8));
+
+    // released out of order, it waits behind the older block
+    ring.release(*wrapped, 0);
+    ring.reclaim(10);
+    CHECK(ring.used() == 100);
+
+    ring.release(*second, 6);
+    ring.reclaim(10);
+    CHECK(ring.used() == 0);
+
+    const auto whole = ring.allocate(100);
+    REQUIRE(whole.has_value());
+    CHECK(whole->offset == 0);
+    CHECK(!ring.allocate(101));
+}
+
+TEST_CASE(spaceComesBackOnlyOnceTheFrameFenceSignals) {
+    auto       &fences = FrameFences::global();
+    StagingRing ring(256);
+    FakeGl::signalAllFences();
+    fences.endFrame();
+
+    // an upload recorded this frame, with the ring full behind it
+    const auto used = ring.allocate(256);
+    REQUIRE(used.has_value());
+    ring.release(*used, fences.recordingFrame());
+    fences.endFrame();
+    const uint64_t fence = FakeGl::fencesCreated();
+
+    // frames go by but the GPU hasn't caught up, so the space stays taken. Nothing blocks waiting for it
+    for (int i = 0; i < 3; i++) {
+        fences.endFrame();
+        ring.reclaim(fences.completedFrame());
+        CHECK(!ring.allocate(16));
+    }
+    CHECK(FakeGl::blockingWaits() == 0);
+
+    FakeGl::signalFencesUpTo(fence);
+    fences.endFrame();
+    ring.reclaim(fences.completedFrame());
+    CHECK(ring.used() == 0);
+    CHECK(ring.allocate(256).has_value());
+}
+
+namespace {
+    bool releaseThrows(StagingRing &ring, const StagingRing::Allocation &allocation, const uint64_t frame) {
+        try {
+            ring.release(allocation, frame);
+        } catch (const std::logic_error &) {
+            return true;
+        }
+        return false;
+    }
+} // namespace
+
+TEST_CASE(releasingTwiceThrows) {
+    StagingRing ring(64);
+    const auto  allocation = ring.allocate(16);
+    REQUIRE(allocation.has_value());
+
+    ring.release(*allocation, 0);
+    ring.reclaim(0);
+    CHECK(releaseThrows(ring, *allocation, 0));
+}
+
+// before it's reclaimed, a second release would otherwise move the frame the block waits for
+TEST_CASE(releasingTwiceBeforeReclaimThrows) {
+    StagingRing ring(64);
+    const auto  allocation = ring.allocate(16);
+    REQUIRE(allocation.has_value());
+
+    ring.release(*allocation, 2);
+    CHECK(releaseThrows(ring, *allocation, 7));
+
+    ring.reclaim(2);
+    CHECK(ring.used() == 0);
+}
+
+// Workers allocate and write while the "GL thread" releases and reclaims. Every byte a worker wrote has to still be there when it's released
+TEST_CASE(concurrentAllocationsNeverOverlap) {
+    StagingRing ring(4096);
+
+    std::atomic<int>                     finished{0};
+    std::atomic<uint64_t>                corrupted{0};
+    std::mutex                           mutex;
+    std::vector<StagingRing::Allocation> written;
+
+    std::vector<std::jthread> workers;
+    for (int w = 0; w < 4; w++) {
+        workers.emplace_back([&, w] {
+            for (int i = 0; i < 5000; i++) {
+                const auto allocation = ring.allocate(static_cast<std::size_t>(16 + (i * 7 + w * 13) % 200));
+                if (!allocation) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                std::memset(allocation->data, static_cast<int>(allocation->id & 0xFF), allocation->size);
+                std::lock_guard lock(mutex);
+                written.push_back(*allocation);
+            }
+            finished++;
+        });
+    }
+
+    for (uint64_t frame = 1;; frame++) {
+        // read before taking the batch, so the last batch has everything
+        const bool done = finished == 4;
+
+        std::vector<StagingRing::Allocation> batch;
+        {
+            std::lock_guard lock(mutex);
+            batch.swap(written);
+        }
+        for (const auto &allocation : batch) {
+            for (std::size_t i = 0; i < allocation.size; i++) {
+                if (allocation.data[i] != static_cast<std::byte>(allocation.id & 0xFF)) {
+                    corrupted++;
+                    break;
+                }
+            }
+            ring.release(allocation, frame);
+        }
+        ring.reclaim(frame - 1);
+
+        if (done) {
+            ring.reclaim(frame);
+            break;
+        }
+    }
+
+    CHECK(corrupted == 0);
+    CHECK(ring.used() == 0);
+}
+
+int main() {
+    FakeGl::install();
+    const int result = neuron::test::runTests();
+    FrameFences::global().clear();
+    return result;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+/*
+ * Tests are plain executables run by ctest. TEST_CASE registers a function, CHECK reports a failure and carries on, REQUIRE reports it and leaves the
+ * test case, and runTests() runs every case and returns the exit code.
+ */
+
+namespace neuron::test {
+    struct TestCase {
+        std::string_view name;
+        void (*run)();
+    };
+
+    inline std::vector<TestCase> &testCases() {
+        static std::vector<TestCase> cases;
+        return cases;
+    }
+
+    inline int &failureCount() {
+        static int failures = 0;
+        return failures;
+    }
+
+    struct Registration {
+        Registration(const std::string_view name, void (*run)()) { testCases().push_back({name, run}); }
+    };
+
+    inline bool fail(const char *file, const int line, const char *condition) {
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, condition);
+        failureCount()++;
+        return false;
+    }
+
+    inline int runTests() {
+        for (const auto &[name, run] : testCases()) {
+            const int before = failureCount();
+            run();
+            std::printf("%s %.*s\n", failureCount() == before ? "passed" : "FAILED", static_cast<int>(name.size()), name.data());
+        }
+        return failureCount() == 0 ? 0 : 1;
+    }
+} // namespace neuron::test
+
+#define TEST_CASE(name)                                                       \
+    static void                             name();                           \
+    static const neuron::test::Registration name##Registration(#name, &name); \
+    static void                             name()
+
+#define CHECK(condition) ((condition) ? true : neuron::test::fail(__FILE__, __LINE__, #condition))
+
+#define REQUIRE(condition)       \
+    do {                         \
+        if (!CHECK(condition)) { \
+            return;              \
+        }                        \
+    } while (false)
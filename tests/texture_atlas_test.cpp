@@ -0,0 +1,128 @@
+#include "test.hpp"
+
+#include "neuron/texture_atlas.hpp"
+
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+using namespace neuron;
+
+namespace {
+    Image blank(const int width, const int height) {
+        return {width, height, std::vector<uint8_t>(static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * 4)};
+    }
+
+    Mesh::Data withTexCoords(const std::vector<glm::vec2> &texCoords) {
+        Mesh::Data data{Mesh::Mode::Array, Mesh::PType::Triangles, false, {}, {}, {}};
+        for (const glm::vec2 texCoord : texCoords) {
+            StandardVertex vertex{};
+            vertex.texCoord = texCoord;
+            data.vertices.push_back(vertex);
+        }
+        return data;
+    }
+
+    bool sameTexCoords(const Mesh::Data &data, const std::vector<glm::vec2> &texCoords) {
+        if (data.vertices.size() != texCoords.size()) {
+            return false;
+        }
+        for (std::size_t i = 0; i < texCoords.size(); i++) {
+            if (data.vertices[i].texCoord != texCoords[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+} // namespace
+
+TEST_CASE(skylineFillsTheBinRowByRow) {
+    SkylinePacker packer(8, 8);
+    CHECK((packer.insert(4, 4) == glm::ivec2(0, 0)));
+    CHECK((packer.insert(4, 4) == glm::ivec2(4, 0)));
+    CHECK((packer.insert(4, 4) == glm::ivec2(0, 4)));
+    CHECK((packer.insert(4, 4) == glm::ivec2(4, 4)));
+
+    CHECK(!packer.insert(1, 1));
+    CHECK(packer.usedTexels() == 64);
+    CHECK(packer.occupancy() == 1.0f);
+}
+
+TEST_CASE(skylinePlacesWhereTheTopEdgeIsLowest) {
+    SkylinePacker packer(10, 10);
+    CHECK((packer.insert(3, 4) == glm::ivec2(0, 0)));
+
+    // next to the first one rather than on top of it
+    CHECK((packer.insert(3, 2) == glm::ivec2(3, 0)));
+
+    // across every node, so it rests on the highest of them
+    CHECK((packer.insert(10, 1) == glm::ivec2(0, 4)));
+
+    // only 5 rows are left
+    CHECK(!packer.insert(2, 6));
+    CHECK((packer.insert(2, 5) == glm::ivec2(0, 5)));
+    CHECK(packer.usedTexels() == 12 + 6 + 10 + 10);
+}
+
+TEST_CASE(skylineRejectsWhatCantFit) {
+    SkylinePacker packer(8, 8);
+    CHECK(!packer.insert(9, 1));
+    CHECK(!packer.insert(1, 9));
+    CHECK(!packer.insert(0, 1));
+    CHECK(!packer.insert(1, -1));
+    CHECK(packer.usedTexels() == 0);
+
+    bool threw = false;
+    try {
+        SkylinePacker empty(0, 8);
+    } catch (const std::runtime_error &) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+// Without a gutter the 16 texel image packs first in the corner and the 8 texel one right of it
+TEST_CASE(remapMovesTexCoordsIntoTheRegion) {
+    TextureAtlas   atlas({.layerSize = 64, .padding = 0, .srgb = false});
+    const uint32_t small = atlas.add(blank(8, 8));
+    const uint32_t large = atlas.add(blank(16, 16));
+    atlas.pack();
+
+    CHECK(atlas.stats().images == 2);
+    CHECK(atlas.stats().layers == 1);
+    CHECK((atlas.region(large).position == glm::ivec2(0, 0)));
+    CHECK((atlas.region(small).position == glm::ivec2(16, 0)));
+
+    Mesh::Data data = withTexCoords({{0.0f, 0.0f}, {1.0f, 1.0f}, {0.5f, 0.25f}});
+    REQUIRE(atlas.remap(data, small));
+    CHECK(sameTexCoords(data, {{0.25f, 0.0f}, {0.375f, 0.125f}, {0.3125f, 0.03125f}}));
+
+    // within the tolerance of the edge is clamped onto it
+    data = withTexCoords({{-0.00001f, 1.00001f}});
+    REQUIRE(atlas.remap(data, large));
+    CHECK(sameTexCoords(data, {{0.0f, 0.25f}}));
+}
+
+TEST_CASE(remapLeavesTilingTexCoordsAlone) {
+    TextureAtlas   atlas({.layerSize = 64, .padding = 0, .srgb = false});
+    const uint32_t id = atlas.add(blank(8, 8));
+    atlas.pack();
+
+    const std::vector<glm::vec2> tiling = {{0.0f, 0.0f}, {2.0f, 0.5f}};
+    Mesh::Data                   data   = withTexCoords(tiling);
+    CHECK(!atlas.remap(data, id));
+    CHECK(sameTexCoords(data, tiling));
+
+    bool threw = false;
+    try {
+        Mesh::Data inside = withTexCoords({{0.5f, 0.5f}});
+        (void)atlas.remap(inside, id + 1);
+    } catch (const std::runtime_error &) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+int main() {
+    return neuron::test::runTests();
+}
@@ -0,0 +1,154 @@
+#include "test.hpp"
+
+#include "neuron/render/virtual_page_cache.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+using namespace neuron::render;
+
+namespace {
+    // gives the page a slot straight away, as if its load finished in `frame`
+    std::optional<VirtualPageCache::Insertion> load(VirtualPageCache &cache, const VirtualPage &page, const uint64_t frame) {
+        const uint32_t index = cache.layout().index(page);
+        cache.feedback({&index, 1}, frame);
+        for (const auto &requested : cache.takeRequests(SIZE_MAX)) {
+            if (requested != page) {
+                (void)cache.insert(requested, frame);
+            }
+        }
+        return cache.insert(page, frame);
+    }
+
+    VirtualPageCache::Entry entry(const VirtualPageCache &cache, const VirtualPage &page) {
+        return cache.pageTable(static_cast<int>(page.level))[page.y * static_cast<uint32_t>(cache.layout().pagesX(static_cast<int>(page.level))) + page.x];
+    }
+} // namespace
+
+TEST_CASE(pageIndicesRoundTrip) {
+    for (const VirtualTextureLayout layout : {VirtualTextureLayout{1100, 600, 128}, VirtualTextureLayout{4096, 256, 128}, VirtualTextureLayout{128, 128, 128},
+                                              VirtualTextureLayout{1, 1, 128}}) {
+        uint32_t count = 0;
+        for (int level = 0; level < layout.levels(); level++) {
+            CHECK(layout.levelOffset(level) == count);
+            count += static_cast<uint32_t>(layout.pagesX(level) * layout.pagesY(level));
+        }
+        CHECK(layout.pageCount() == count);
+        CHECK(layout.pagesX(layout.levels() - 1) == 1 && layout.pagesY(layout.levels() - 1) == 1);
+
+        for (uint32_t i = 0; i < layout.pageCount(); i++) {
+            const VirtualPage page = layout.page(i);
+            REQUIRE(layout.index(page) == i);
+            REQUIRE(static_cast<int>(page.x) < layout.pagesX(static_cast<int>(page.level)));
+            REQUIRE(static_cast<int>(page.y) < layout.pagesY(static_cast<int>(page.level)));
+        }
+    }
+
+    // 9x5, 5x3, 3x2, 2x1 and 1x1 pages
+    CHECK((VirtualTextureLayout{1100, 600, 128}.levels() == 5));
+    CHECK((VirtualTextureLayout{1100, 600, 128}.pageCount() == 45 + 15 + 6 + 2 + 1));
+}
+
+TEST_CASE(feedbackRequestsAncestorsCoarsestFirst) {
+    const VirtualTextureLayout layout{1100, 600, 128};
+    VirtualPageCache           cache(layout, 16);
+
+    // only the pinned coarsest page to begin with
+    auto requests = cache.takeRequests(SIZE_MAX);
+    REQUIRE(requests.size() == 1);
+    CHECK((requests[0] == VirtualPage{0, 0, 4}));
+    REQUIRE(cache.insert(requests[0], 1));
+
+    const std::vector pages = {layout.index({8, 4, 0}), layout.index({8, 4, 0}), layout.index({0, 0, 1})};
+    cache.feedback(pages, 2);
+    CHECK(cache.stats().requested == 7);
+
+    requests = cache.takeRequests(SIZE_MAX);
+    REQUIRE(requests.size() == 7);
+    for (std::size_t i = 1; i < requests.size(); i++) {
+        CHECK(requests[i - 1].level >= requests[i].level);
+    }
+    CHECK((requests.front() == VirtualPage{1, 0, 3}));
+    CHECK((requests.back() == VirtualPage{8, 4, 0}));
+
+    // ancestors that are already loading aren't asked for again, and taking fewer leaves the finest waiting
+    cache.feedback(std::vector{layout.index({3, 3, 0})}, 3);
+    CHECK(cache.stats().requested == 2);
+    requests = cache.takeRequests(1);
+    REQUIRE(requests.size() == 1);
+    CHECK((requests[0] == VirtualPage{1, 1, 1}));
+    CHECK(cache.stats().loading == 8);
+}
+
+TEST_CASE(insertEvictsTheLeastRecentlyRequestedPage) {
+    // 2x2 pages under a single pinned one, with room for two of them
+    const VirtualTextureLayout layout{256, 256, 128};
+    VirtualPageCache           cache(layout, 3);
+    const VirtualPage          a{0, 0, 0};
+    const VirtualPage          b{1, 0, 0};
+    const VirtualPage          c{0, 1, 0};
+
+    REQUIRE(load(cache, a, 2));
+    REQUIRE(load(cache, b, 2));
+    CHECK(cache.stats().resident == 3);
+
+    // a is asked for again, so b is the one to go
+    cache.feedback(std::vector{layout.index(a)}, 3);
+    const auto inserted = load(cache, c, 4);
+    REQUIRE(inserted.has_value());
+    CHECK(inserted->evicted == b);
+    CHECK(!cache.slot(b));
+    CHECK(cache.slot(a).has_value());
+    CHECK(cache.slot(c) == inserted->slot);
+    CHECK(cache.stats().evictions == 1);
+
+    // every unpinned slot was asked for this frame, so there's nowhere to put it
+    cache.feedback(std::vector{layout.index(a), layout.index(b), layout.index(c)}, 5);
+    const auto requests = cache.takeRequests(SIZE_MAX);
+    REQUIRE(requests.size() == 1);
+    CHECK(!cache.insert(requests[0], 5));
+    CHECK(cache.stats().dropped == 1);
+    CHECK((cache.slot({0, 0, 1}).has_value()));
+}
+
+TEST_CASE(pageTableFallsBackToTheNearestResidentAncestor) {
+    // 4x4, 2x2 and 1x1 pages
+    const VirtualTextureLayout layout{512, 512, 128};
+    VirtualPageCache           cache(layout, 8);
+
+    const auto root = load(cache, {0, 0, 2}, 1);
+    REQUIRE(root.has_value());
+    for (const auto &e : cache.pageTable(0)) {
+        CHECK(e.slot == root->slot && e.level == 2);
+    }
+    (void)cache.takeDirtyLevels();
+
+    const auto parent = load(cache, {0, 0, 1}, 2);
+    REQUIRE(parent.has_value());
+    CHECK((entry(cache, {1, 1, 0}).slot == parent->slot));
+    CHECK((entry(cache, {1, 1, 0}).level == 1));
+    CHECK((entry(cache, {2, 0, 0}).slot == root->slot));
+    CHECK((entry(cache, {2, 0, 0}).level == 2));
+    CHECK((cache.takeDirtyLevels() == std::vector{0, 1}));
+
+    const auto page = load(cache, {1, 1, 0}, 3);
+    REQUIRE(page.has_value());
+    CHECK((entry(cache, {1, 1, 0}).slot == page->slot));
+    CHECK((entry(cache, {1, 1, 0}).level == 0));
+    CHECK((entry(cache, {0, 1, 0}).level == 1));
+    CHECK(cache.takeDirtyLevels() == std::vector{0});
+}
+
+TEST_CASE(tooFewSlotsThrow) {
+    bool threw = false;
+    try {
+        VirtualPageCache cache({256, 256, 128}, 1);
+    } catch (const std::runtime_error &) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+int main() {
+    return neuron::test::runTests();
+}
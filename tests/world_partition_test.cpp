@@ -0,0 +1,162 @@
+#include "gl_fakes.hpp"
+#include "test.hpp"
+
+#include "neuron/ecs/components.hpp"
+#include "neuron/scene/scene.hpp"
+#include "neuron/scene/serialization.hpp"
+#include "neuron/scene/world_partition.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace neuron;
+using neuron::test::FakeGl;
+
+namespace {
+    const std::filesystem::path g_Directory = std::filesystem::temp_directory_path() / "neuron_world_partition_test";
+
+    // one triangle
+    std::filesystem::path writeMesh(const std::string &name) {
+        const auto path = g_Directory / "meshes" / name;
+        std::ofstream(path) << "MODE array triangles\n"
+                               "v 0 0 0 ; c 1 1 1 1 ; n 0 1 0 ; t 0 0 ;\n"
+                               "v 1 0 0 ; c 1 1 1 1 ; n 0 1 0 ; t 1 0 ;\n"
+                               "v 0 0 1 ; c 1 1 1 1 ; n 0 1 0 ; t 0 1 ;\n";
+        return path;
+    }
+
+    // `count` entities, all drawing every one of `meshes`
+    void writeCell(const scene::CellCoord coord, const int count, const std::vector<asset::AssetHandle<asset::Mesh>> &meshes) {
+        scene::Scene cell(0);
+        for (int i = 0; i < count; i++) {
+            for (const auto &mesh : meshes) {
+                const flecs::entity entity = cell.createEntity();
+                entity.set<ecs::Position>({{static_cast<float>(coord.x) * 10.0f + static_cast<float>(i), 0.0f, static_cast<float>(coord.z) * 10.0f}});
+                entity.set<ecs::MeshRenderer>({mesh, {}, 0});
+            }
+        }
+        scene::saveScene(cell, g_Directory / scene::WorldPartition::cellFileName(coord));
+    }
+
+    // updates until nothing is queued, loading or waiting for its upload
+    void settle(scene::WorldPartition &partition, const glm::vec3 &focus) {
+        for (int i = 0; i < 10'000; i++) {
+            partition.update(focus);
+            const auto &stats = partition.stats();
+            if (stats.queuedCells == 0 && stats.inFlightLoads == 0 && stats.pendingUploads == 0) {
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    bool registered(const asset::stable_id_t id) {
+        return asset::assetTable<asset::Mesh>()->findByStableId(id).isValid();
+    }
+} // namespace
+
+// Cells are 10 wide on the x axis, loaded within 10 and unloaded past 20. Cell 0 uses mesh A, cell 1 both, cell 3 only B, so B stays shared while the
+// focus moves right and A goes with the last cell using it
+TEST_CASE(cellsStreamAroundTheFocus) {
+    std::filesystem::create_directories(g_Directory / "meshes");
+    const auto pathA = writeMesh("a.nmesh");
+    const auto pathB = writeMesh("b.nmesh");
+    const auto idA   = asset::stableIdFromPath(pathA);
+    const auto idB   = asset::stableIdFromPath(pathB);
+
+    // cells are saved with the stable ids of registered meshes, then the meshes go so the partition has to load them itself
+    {
+        auto      *table = asset::assetTable<asset::Mesh>();
+        const auto a     = table->initAsset(std::make_unique<asset::Mesh>(nullptr));
+        const auto b     = table->initAsset(std::make_unique<asset::Mesh>(nullptr));
+        table->setStableId(a, idA);
+        table->setStableId(b, idB);
+        writeCell({0, 0}, 3, {a});
+        writeCell({1, 0}, 1, {a, b});
+        writeCell({3, 0}, 1, {b});
+        table->releaseAsset(a);
+        table->releaseAsset(b);
+    }
+
+    const std::unordered_map<asset::stable_id_t, std::filesystem::path> paths{{idA, pathA}, {idB, pathB}};
+    const std::size_t                                                    meshBytes = asset::Mesh::loadData(pathA).sizeInBytes();
+
+    scene::Scene          world(0);
+    ThreadPool            pool(2);
+    scene::WorldPartition partition(world, pool,
+                                    {
+                                        .directory        = g_Directory,
+                                        .cellSize         = 10.0f,
+                                        .loadRadius       = 10.0f,
+                                        .unloadRadius     = 20.0f,
+                                        .maxInFlightLoads = 1,
+                                        .uploadBudgetMs   = 1000.0,
+                                        .meshResolver     = [&paths](const asset::stable_id_t id) -> std::optional<std::filesystem::path> { return paths.at(id); },
+                                    });
+
+    // one load at a time, and the cell the focus is in goes first
+    const glm::vec3 start{5.0f, 0.0f, 5.0f};
+    partition.update(start);
+    CHECK(partition.stats().inFlightLoads == 1);
+    CHECK(partition.stats().queuedCells == 1);
+    for (int i = 0; i < 10'000 && partition.stats().residentCells == 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        partition.update(start);
+    }
+    CHECK(partition.stats().residentCells == 1);
+    CHECK(partition.stats().residentEntities == 3);
+
+    settle(partition, start);
+    CHECK(partition.stats().residentCells == 2);
+    CHECK(partition.stats().residentEntities == 5);
+    CHECK(partition.stats().residentMeshBytes == 2 * meshBytes);
+    CHECK(registered(idA) && registered(idB));
+
+    // cell 0 is out of load range but inside the unload radius, so it stays
+    const glm::vec3 border{25.0f, 0.0f, 5.0f};
+    settle(partition, border);
+    CHECK(partition.stats().residentCells == 3);
+    CHECK(partition.stats().unloads == 0);
+    CHECK(partition.stats().loadsCompleted == 3);
+    CHECK(partition.stats().residentMeshBytes == 2 * meshBytes);
+
+    // cells 0 and 1 are past it now, which takes A with them. Cell 3 still holds B
+    const glm::vec3 far{45.0f, 0.0f, 5.0f};
+    settle(partition, far);
+    CHECK(partition.stats().residentCells == 1);
+    CHECK(partition.stats().unloads == 2);
+    CHECK(partition.stats().residentEntities == 1);
+    CHECK(partition.stats().residentMeshBytes == meshBytes);
+    CHECK(!registered(idA));
+    CHECK(registered(idB));
+
+    // going back starts cell 0 and drops cell 3, and leaving again before cell 0 is done throws it away unfinished
+    partition.update(start);
+    CHECK(partition.stats().inFlightLoads == 1);
+    CHECK(partition.stats().residentCells == 0);
+    CHECK(!registered(idB));
+    partition.update(far);
+    settle(partition, far);
+    CHECK(partition.stats().residentCells == 1);
+    CHECK(partition.stats().residentEntities == 1);
+    CHECK(partition.stats().loadsCompleted == 4);
+    CHECK(partition.stats().failedLoads == 0);
+    CHECK(!registered(idA));
+
+    partition.unloadAll();
+    CHECK(partition.stats().residentCells == 0);
+    CHECK(partition.stats().residentMeshBytes == 0);
+    CHECK(!registered(idB));
+}
+
+int main() {
+    FakeGl::install();
+    const int result = neuron::test::runTests();
+    asset::cleanupAssetTables();
+    std::filesystem::remove_all(g_Directory);
+    return result;
+}